@@ -33,6 +33,9 @@ parser.add_argument("--volume_fraction", metavar="FRAC", action="store",
                     "particles (range: [0.01-0.74], default: 0.50)")
 parser.add_argument("--bonds", action="store_true",
                     help="Add bonds between particle pairs, default: false")
+parser.add_argument("--space_filling_curve", action="store_true",
+                    help="Order cells and particles along a space-filling "
+                    "curve, default: false")
 group = parser.add_mutually_exclusive_group()
 group.add_argument("--output", metavar="FILEPATH", action="store",
                    type=str, required=False, default="benchmarks.csv",
@@ -88,6 +91,7 @@ system.box_l = 3 * (box_l,)
 #############################################################
 system.time_step = 0.01
 system.cell_system.skin = 0.5
+system.cell_system.use_space_filling_curve = args.space_filling_curve
 system.thermostat.turn_off()
 
 # Interaction setup
@@ -35,6 +35,9 @@ parser.add_argument("--volume_fraction", metavar="FRAC", action="store",
 parser.add_argument("--prefactor", metavar="PREFACTOR", action="store",
                     type=float, default=4., required=False,
                     help="P3M prefactor (default: 4)")
+parser.add_argument("--space_filling_curve", action="store_true",
+                    help="Order cells and particles along a space-filling "
+                    "curve, default: false")
 group = parser.add_mutually_exclusive_group()
 group.add_argument("--output", metavar="FILEPATH", action="store",
                    type=str, required=False, default="benchmarks.csv",
@@ -92,6 +95,7 @@ box_l = (n_part * 4. / 3. * np.pi * (lj_sig / 2.)**3
 #############################################################
 system.box_l = 3 * (box_l,)
 system.cell_system.set_regular_decomposition(use_verlet_lists=True)
+system.cell_system.use_space_filling_curve = args.space_filling_curve
 
 # Integration parameters
 #############################################################
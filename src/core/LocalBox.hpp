@@ -30,16 +30,19 @@ template <class T> class LocalBox {
   Utils::Vector<T, 3> m_upper_corner = {1, 1, 1};
   Utils::Array<int, 6> m_boundaries = {};
   CellStructureType m_cell_structure_type;
+  bool m_uniform = true;
 
 public:
   LocalBox() = default;
   LocalBox(Utils::Vector<T, 3> const &lower_corner,
            Utils::Vector<T, 3> const &local_box_length,
            Utils::Array<int, 6> const &boundaries,
-           CellStructureType const cell_structure_type)
+           CellStructureType const cell_structure_type,
+           bool uniform = true)
       : m_local_box_l(local_box_length), m_lower_corner(lower_corner),
         m_upper_corner(lower_corner + local_box_length),
-        m_boundaries(boundaries), m_cell_structure_type(cell_structure_type) {}
+        m_boundaries(boundaries), m_cell_structure_type(cell_structure_type),
+        m_uniform(uniform) {}
 
   /** Left (bottom, front) corner of this nodes local box. */
   Utils::Vector<T, 3> const &my_left() const { return m_lower_corner; }
@@ -58,6 +61,9 @@ public:
    */
   Utils::Array<int, 6> const &boundary() const { return m_boundaries; }
 
+  /** Whether the local boxes of all nodes have the same size. */
+  bool uniform() const { return m_uniform; }
+
   /** Return cell structure type. */
   CellStructureType const &cell_structure_type() const {
     return m_cell_structure_type;
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "adaptive_skin.hpp"
+
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "interactions.hpp"
+
+#include <boost/mpi/collectives/all_reduce.hpp>
+#include <boost/mpi/operations.hpp>
+#include <boost/optional.hpp>
+#include <boost/range/algorithm/min_element.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace AdaptiveSkin {
+
+SkinSearch::SkinSearch(double skin, Parameters const &params)
+    : m_params(params), m_skin(skin), m_max_skin(params.max_skin),
+      m_ref_skin(skin),
+      m_step(std::max(0.25 * (params.max_skin - params.min_skin),
+                      params.tolerance)) {}
+
+void SkinSearch::set_max_skin(double max_skin) {
+  m_max_skin =
+      std::max(m_params.min_skin, std::min(m_params.max_skin, max_skin));
+}
+
+std::pair<double, Action> SkinSearch::propose(Action action) {
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    auto const trial = std::clamp(m_ref_skin + m_direction * m_step,
+                                  m_params.min_skin, m_max_skin);
+    if (std::abs(trial - m_ref_skin) >= 0.5 * m_params.tolerance) {
+      m_skin = trial;
+      return {m_skin, action};
+    }
+    /* no room in this direction */
+    m_direction = -m_direction;
+  }
+  m_converged = true;
+  m_ref_cost = -1.;
+  m_skin = m_ref_skin;
+  return {m_skin, Action::CONVERGED};
+}
+
+std::pair<double, Action> SkinSearch::update(double cost) {
+  if (m_converged) {
+    /* The first measurement after convergence is the new reference, since
+     * the previous one might include the cost of a cell grid rebuild. */
+    if (m_ref_cost < 0.) {
+      m_ref_cost = cost;
+      return {m_skin, Action::KEEP};
+    }
+    if (std::abs(cost - m_ref_cost) <= m_params.drift * m_ref_cost) {
+      return {m_skin, Action::KEEP};
+    }
+    m_converged = false;
+    m_step = std::max(0.25 * (m_params.max_skin - m_params.min_skin),
+                      m_params.tolerance);
+    m_ref_skin = m_skin;
+    m_ref_cost = cost;
+    return propose(Action::RESTART);
+  }
+  if (m_ref_cost < 0. or m_skin == m_ref_skin) {
+    m_ref_skin = m_skin;
+    m_ref_cost = cost;
+    return propose(Action::TRIAL);
+  }
+  if (cost < m_ref_cost) {
+    m_ref_skin = m_skin;
+    m_ref_cost = cost;
+    return propose(Action::ACCEPT);
+  }
+  m_direction = -m_direction;
+  m_step *= 0.5;
+  if (m_step < m_params.tolerance) {
+    m_converged = true;
+    m_ref_cost = -1.;
+    m_skin = m_ref_skin;
+    return {m_skin, Action::CONVERGED};
+  }
+  return propose(Action::REJECT);
+}
+
+static Parameters parameters{};
+static boost::optional<SkinSearch> search;
+static std::vector<Decision> decisions;
+/** Integration steps since the adaptive skin was enabled */
+static int steps = 0;
+/** Integration steps in the current measurement window */
+static int window_steps = 0;
+/** Verlet list updates in the current measurement window */
+static int window_verlet_updates = 0;
+static std::chrono::steady_clock::time_point window_start;
+
+Parameters const &get_parameters() { return parameters; }
+
+std::vector<Decision> const &get_decisions() { return decisions; }
+
+static void start_window() {
+  window_steps = 0;
+  window_verlet_updates = 0;
+  window_start = std::chrono::steady_clock::now();
+}
+
+void set_parameters(Parameters const &params) {
+  if (params.interval < 0) {
+    throw std::domain_error("Parameter 'interval' must be >= 0");
+  }
+  if (params.min_skin < 0.) {
+    throw std::domain_error("Parameter 'min_skin' must be >= 0");
+  }
+  if (params.max_skin < params.min_skin) {
+    throw std::domain_error("Parameter 'max_skin' must be >= 'min_skin'");
+  }
+  if (params.tolerance <= 0.) {
+    throw std::domain_error("Parameter 'tolerance' must be > 0");
+  }
+  if (params.drift <= 0.) {
+    throw std::domain_error("Parameter 'drift' must be > 0");
+  }
+  parameters = params;
+  search = boost::none;
+  steps = 0;
+  start_window();
+}
+
+/** @brief Largest skin supported by the local boxes. */
+static double max_permissible_skin() {
+  auto const local_max_cutoff =
+      *boost::min_element(cell_structure.max_cutoff());
+  auto const max_cutoff = boost::mpi::all_reduce(
+      comm_cart, local_max_cutoff, boost::mpi::minimum<double>());
+  return max_cutoff - maximal_cutoff(n_nodes == 1);
+}
+
+/**
+ * @brief Whether the cell grid has to change for a new interaction range.
+ *
+ * This is the case when the cells are too small for the new range, or
+ * when the range became small enough to fit more cells into the local box.
+ */
+static bool cell_grid_needs_update(double range) {
+  auto const type = cell_structure.decomposition_type();
+  if (type == CellStructureType::CELL_STRUCTURE_NSQUARE) {
+    return false;
+  }
+  if (type != CellStructureType::CELL_STRUCTURE_REGULAR) {
+    return true;
+  }
+  auto const cell_size = cell_structure.max_range();
+  auto const local_length = local_geo.length();
+  auto update = false;
+  for (unsigned int i = 0; i < 3; ++i) {
+    auto const n_cells = std::round(local_length[i] / cell_size[i]);
+    update |= (range > cell_size[i]) or
+              (local_length[i] / (n_cells + 1.) >= range);
+  }
+  return boost::mpi::all_reduce(comm_cart, update, std::logical_or<>());
+}
+
+/**
+ * @brief Change the skin, rebuilding the cell grid only if necessary.
+ * @return Whether the cell grid was rebuilt.
+ */
+static bool change_skin(double new_skin) {
+  if (cell_grid_needs_update(maximal_cutoff(n_nodes == 1) + new_skin)) {
+    mpi_set_skin_local(new_skin);
+    return true;
+  }
+  ::skin = new_skin;
+  /* Verlet lists have to be rebuilt with the new skin */
+  cell_structure.set_resort_particles(Cells::RESORT_LOCAL);
+  return false;
+}
+
+void on_integration_start() {
+  start_window();
+  /* the skin was changed by the user */
+  if (search and search->skin() != ::skin) {
+    search = boost::none;
+  }
+}
+
+void on_integration_step(bool verlet_update) {
+  if (parameters.interval == 0) {
+    return;
+  }
+  ++steps;
+  ++window_steps;
+  if (verlet_update) {
+    ++window_verlet_updates;
+  }
+  if (window_steps < parameters.interval) {
+    return;
+  }
+
+  /* the slowest rank determines the cost */
+  auto const elapsed = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - window_start)
+                           .count();
+  auto const time_per_step =
+      boost::mpi::all_reduce(comm_cart, elapsed,
+                             boost::mpi::maximum<double>()) /
+      static_cast<double>(window_steps);
+  auto const verlet_reuse =
+      (window_verlet_updates > 0)
+          ? static_cast<double>(window_steps) / window_verlet_updates
+          : 0.;
+  start_window();
+
+  /* the skin has no effect without short-range interactions */
+  if (maximal_cutoff(n_nodes == 1) <= 0.) {
+    return;
+  }
+
+  if (not search or search->skin() != ::skin) {
+    search = SkinSearch(::skin, parameters);
+  }
+  search->set_max_skin(max_permissible_skin());
+  auto const old_skin = ::skin;
+  auto const decision = search->update(time_per_step);
+  auto const new_skin = decision.first;
+  auto const cell_grid_rebuilt =
+      (new_skin != old_skin) ? change_skin(new_skin) : false;
+  decisions.push_back({steps, old_skin, time_per_step, verlet_reuse, new_skin,
+                       decision.second, cell_grid_rebuilt});
+}
+
+} // namespace AdaptiveSkin
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_ADAPTIVE_SKIN_HPP
+#define ESPRESSO_SRC_CORE_ADAPTIVE_SKIN_HPP
+
+/** @file
+ *  Adaptive tuning of the Verlet list skin during integration.
+ *
+ *  The wall time of the integration loop is measured over windows of a
+ *  fixed number of steps. After each window, a pattern search moves the
+ *  skin towards lower cost: a trial skin is accepted if it is faster than
+ *  the reference skin, otherwise the search direction is reversed and the
+ *  step size halved. Once the step size drops below the tolerance, the
+ *  skin is kept until the cost at the optimal skin drifts, e.g. because
+ *  the density or the temperature changed, which restarts the search.
+ *
+ *  Implementation in adaptive_skin.cpp.
+ */
+
+#include <utility>
+#include <vector>
+
+namespace AdaptiveSkin {
+
+/** @brief Parameters of the adaptive skin. */
+struct Parameters {
+  /** Number of integration steps per measurement, 0 disables the
+   *  adaptive skin.
+   */
+  int interval = 0;
+  /** Smallest skin */
+  double min_skin = 0.;
+  /** Largest skin */
+  double max_skin = 0.;
+  /** Skin step size below which the search stops */
+  double tolerance = 0.01;
+  /** Relative change of the cost at the optimal skin that restarts
+   *  the search.
+   */
+  double drift = 0.2;
+};
+
+/** @brief Outcome of a measurement. */
+enum class Action : int {
+  /** First measurement at a skin, a trial skin is proposed */
+  TRIAL = 0,
+  /** The trial skin is faster and becomes the reference skin */
+  ACCEPT = 1,
+  /** The trial skin is slower, the search direction is reversed */
+  REJECT = 2,
+  /** The step size fell below the tolerance, the reference skin is kept */
+  CONVERGED = 3,
+  /** The cost at the optimal skin didn't change */
+  KEEP = 4,
+  /** The cost at the optimal skin drifted, the search restarts */
+  RESTART = 5,
+};
+
+/** @brief Record of a measurement and of the resulting decision. */
+struct Decision {
+  /** Integration steps since the adaptive skin was enabled */
+  int step;
+  /** Skin during the measurement */
+  double skin;
+  /** Wall time per integration step in seconds */
+  double time_per_step;
+  /** Average number of steps between Verlet list updates */
+  double verlet_reuse;
+  /** Skin after the decision */
+  double new_skin;
+  Action action;
+  /** Whether the cell grid had to be rebuilt for the new skin */
+  bool cell_grid_rebuilt;
+};
+
+/**
+ * @brief Pattern search of the skin with the lowest cost.
+ *
+ * The search is deterministic, hence all MPI ranks reach the same
+ * decisions when they are fed the same costs.
+ */
+class SkinSearch {
+  Parameters m_params;
+  /** Skin of the next measurement */
+  double m_skin;
+  /** Largest skin supported by the cell system */
+  double m_max_skin;
+  /** Best skin so far */
+  double m_ref_skin;
+  /** Cost at the best skin, negative if not measured yet */
+  double m_ref_cost = -1.;
+  double m_step;
+  int m_direction = 1;
+  bool m_converged = false;
+
+  std::pair<double, Action> propose(Action action);
+
+public:
+  SkinSearch(double skin, Parameters const &params);
+
+  /** @brief Skin of the next measurement. */
+  double skin() const { return m_skin; }
+  bool converged() const { return m_converged; }
+
+  /** @brief Limit the skin to a range supported by the cell system. */
+  void set_max_skin(double max_skin);
+
+  /**
+   * @brief Process the cost measured at @ref skin().
+   * @return The skin of the next measurement and the decision taken.
+   */
+  std::pair<double, Action> update(double cost);
+};
+
+Parameters const &get_parameters();
+
+/**
+ * @brief Set the parameters of the adaptive skin and restart the search
+ * from the current skin.
+ *
+ * @throws std::domain_error if a parameter is out of range.
+ */
+void set_parameters(Parameters const &params);
+
+/** @brief Decisions taken since the program started. */
+std::vector<Decision> const &get_decisions();
+
+/**
+ * @brief Start a new measurement window. Has to be called on all ranks
+ * before the integration loop.
+ */
+void on_integration_start();
+
+/**
+ * @brief Account for an integration step and adapt the skin at the end
+ * of a measurement window. Has to be called on all ranks after each
+ * integration step.
+ *
+ * @param verlet_update Whether the Verlet lists were rebuilt in this step.
+ */
+void on_integration_step(bool verlet_update);
+
+} // namespace AdaptiveSkin
+
+#endif
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ALGORITHM_COLOR_CELLS_HPP
+#define ALGORITHM_COLOR_CELLS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+namespace Algorithm {
+
+/**
+ * @brief Partition cells into groups that can be traversed concurrently.
+ *
+ * The @ref link_cell algorithm writes to the particles of a cell and
+ * to the particles of its red neighbors. The cells are colored greedily,
+ * such that no two cells of the same color share a cell in their write
+ * sets. All cells of one color can therefore be handed to different
+ * threads without write conflicts.
+ *
+ * The coloring only depends on the order of the input cells, hence the
+ * order in which forces are accumulated on a particle does not depend
+ * on the number of threads.
+ *
+ * @param cells   Cells to color.
+ * @return Cells grouped by color, in input order within each color.
+ */
+template <typename CellRef>
+std::vector<std::vector<CellRef>>
+color_cells(std::vector<CellRef> const &cells) {
+  /* colors of the cells that write to a given cell */
+  std::unordered_map<void const *, std::vector<std::size_t>> writers;
+  std::vector<std::vector<CellRef>> colors;
+
+  for (auto const cell : cells) {
+    std::vector<void const *> write_set = {cell};
+    for (auto const neighbor : cell->neighbors().red()) {
+      write_set.push_back(neighbor);
+    }
+
+    std::vector<bool> forbidden(colors.size(), false);
+    for (auto const target : write_set) {
+      for (auto const color : writers[target]) {
+        forbidden[color] = true;
+      }
+    }
+
+    auto const color = static_cast<std::size_t>(std::distance(
+        forbidden.begin(), std::find(forbidden.begin(), forbidden.end(), false)));
+    if (color == colors.size()) {
+      colors.emplace_back();
+    }
+    colors[color].push_back(cell);
+
+    for (auto const target : write_set) {
+      writers[target].push_back(color);
+    }
+  }
+
+  return colors;
+}
+} // namespace Algorithm
+
+#endif
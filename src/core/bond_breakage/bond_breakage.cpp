@@ -48,6 +48,8 @@ void insert_spec(int key, std::shared_ptr<BreakageSpec> obj) {
 
 void erase_spec(int key) { breakage_specs.erase(key); }
 
+bool has_spec(int bond_type) { return breakage_specs.count(bond_type) != 0; }
+
 // Variant holding any of the actions
 using Action = boost::variant<DeleteBond, DeleteAllBonds>;
 
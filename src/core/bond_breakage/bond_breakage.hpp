@@ -40,6 +40,9 @@ void insert_spec(int key, std::shared_ptr<BreakageSpec> obj);
 
 void erase_spec(int key);
 
+/** @brief Whether bonds of the bond type can break. */
+bool has_spec(int bond_type);
+
 /** @brief Check if the bond between the particles should break, if yes, queue
  *  it.
  */
@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_CELL_SYSTEM_BOND_TABLES_HPP
+#define ESPRESSO_SRC_CORE_CELL_SYSTEM_BOND_TABLES_HPP
+
+#include "BondList.hpp"
+#include "Particle.hpp"
+#include "bond_error.hpp"
+
+#include <utils/Span.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Flat table of all local bonds with the same bond id.
+ *
+ * The particles of each bond are stored contiguously, the particle
+ * that holds the bond first and its partners after it.
+ */
+struct BondTable {
+  /** Bond id of all bonds in the table */
+  int bond_id;
+  /** Number of particles per bond, including the bond owner */
+  std::size_t stride;
+  /** Particles of all bonds, bond after bond */
+  std::vector<Particle *> particles;
+
+  std::size_t size() const { return particles.size() / stride; }
+
+  /** @brief Particles of the i-th bond. */
+  Utils::Span<Particle *const> operator[](std::size_t i) const {
+    return {particles.data() + i * stride, stride};
+  }
+};
+
+/**
+ * @brief Bonds of the local particles, tabulated by bond id.
+ *
+ * The bond partners are resolved once when the tables are built, such
+ * that the bonds of one id can be evaluated in a loop over the table
+ * without looking up the bond parameters and the partners of each bond.
+ * Particles with bonds that are not tabulated, either because their
+ * bond id was rejected or because their partners could not be resolved,
+ * are kept in @ref untabulated and have to be visited by the regular
+ * bond handler. The tables point to local and ghost particles, they
+ * have to be rebuilt whenever the particles are resorted.
+ */
+class BondTables {
+  std::vector<BondTable> m_tables;
+  /** Position of the table of each bond id, or -1 */
+  std::vector<int> m_table_index;
+  std::vector<Particle *> m_untabulated;
+
+  BondTable &table(int bond_id, std::size_t stride) {
+    auto const key = static_cast<std::size_t>(bond_id);
+    if (key >= m_table_index.size()) {
+      m_table_index.resize(key + 1u, -1);
+    }
+    if (m_table_index[key] == -1) {
+      m_table_index[key] = static_cast<int>(m_tables.size());
+      m_tables.push_back(BondTable{bond_id, stride, {}});
+    }
+    return m_tables[static_cast<std::size_t>(m_table_index[key])];
+  }
+
+public:
+  auto const &tables() const { return m_tables; }
+  auto const &untabulated() const { return m_untabulated; }
+
+  /** @brief Whether the bonds with id @p bond_id are in a table. */
+  bool is_tabulated(int bond_id) const {
+    auto const key = static_cast<std::size_t>(bond_id);
+    return key < m_table_index.size() and m_table_index[key] != -1;
+  }
+
+  /**
+   * @brief Rebuild the tables.
+   *
+   * @param particles     Local particles.
+   * @param accept        Callable with (int), whether bonds with this
+   *                      bond id should be tabulated.
+   * @param resolve       Callable with (Utils::Span<const int>), returning
+   *                      the partner particles or throwing a
+   *                      @ref BondResolutionError.
+   */
+  template <class Range, class Accept, class Resolve>
+  void build(Range &&particles, Accept const &accept,
+             Resolve const &resolve) {
+    m_tables.clear();
+    m_table_index.clear();
+    m_untabulated.clear();
+
+    std::vector<int> rejected;
+    for (auto &p : particles) {
+      auto complete = true;
+      for (BondView const bond : p.bonds()) {
+        auto const bond_id = bond.bond_id();
+        auto const partner_ids = bond.partner_ids();
+        auto const key = static_cast<std::size_t>(bond_id);
+        if (key < rejected.size() and rejected[key]) {
+          complete = false;
+          continue;
+        }
+        if (not is_tabulated(bond_id) and not accept(bond_id)) {
+          rejected.resize(std::max(rejected.size(), key + 1u), 0);
+          rejected[key] = 1;
+          complete = false;
+          continue;
+        }
+        try {
+          auto const partners = resolve(partner_ids);
+          auto &t = table(bond_id, partner_ids.size() + 1u);
+          t.particles.push_back(&p);
+          t.particles.insert(t.particles.end(), partners.begin(),
+                             partners.end());
+        } catch (BondResolutionError const &) {
+          complete = false;
+        }
+      }
+      if (not complete) {
+        m_untabulated.push_back(&p);
+      }
+    }
+  }
+};
+
+#endif
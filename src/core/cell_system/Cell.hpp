@@ -21,12 +21,14 @@
 
 #include "Particle.hpp"
 #include "ParticleList.hpp"
+#include "cell_system/HotParticleData.hpp"
 
 #include <utils/Span.hpp>
 
 #include <boost/range/iterator_range.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -110,6 +112,20 @@ public:
   /** Interaction pairs */
   std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
 
+  /** Index of the first particle in the hot particle data */
+  std::uint32_t m_hot_offset = 0;
+  /** Interaction pairs, as indices into the hot particle data */
+  std::vector<std::pair<std::uint32_t, std::uint32_t>> m_hot_verlet_list;
+  /** Compressed row storage of the interaction partners of the particles
+   *  of this cell: the partners of the n-th particle are stored between
+   *  m_hot_neighbor_offsets[n] and m_hot_neighbor_offsets[n + 1] in
+   *  m_hot_neighbors, as indices into the hot particle data.
+   */
+  std::vector<std::uint32_t> m_hot_neighbor_offsets;
+  std::vector<std::uint32_t> m_hot_neighbors;
+  /** Interacting pairs of particle clusters */
+  std::vector<ClusterPair> m_cluster_pairs;
+
   /**
    * @brief All neighbors of the cell.
    */
@@ -36,16 +36,103 @@
 #include <boost/variant.hpp>
 
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 CellStructure::CellStructure(BoxGeometry const &box)
-    : m_decomposition{std::make_unique<AtomDecomposition>(box)} {}
+    : m_decomposition{std::make_unique<AtomDecomposition>(box)} {
+  update_cell_colors();
+}
+
+void CellStructure::set_n_threads(int n_threads) {
+  if (n_threads < 1) {
+    throw std::domain_error("Parameter 'n_threads' must be >= 1");
+  }
+#ifndef OPENMP
+  if (n_threads != 1) {
+    throw std::runtime_error("Parameter 'n_threads' must be 1 when ESPResSo "
+                             "is compiled without OpenMP support");
+  }
+#endif
+  m_n_threads = n_threads;
+  m_rebuild_verlet_list = true;
+  m_rebuild_cell_verlet_lists = true;
+}
+
+void CellStructure::update_cell_colors() {
+  auto const cells = local_cells();
+  m_cell_colors = Algorithm::color_cells(
+      std::vector<Cell *>(cells.begin(), cells.end()));
+
+  auto const ghost_cells = decomposition().ghost_cells();
+  std::unordered_set<Cell const *> const ghosts(ghost_cells.begin(),
+                                                ghost_cells.end());
+  std::vector<Cell *> interior;
+  std::vector<Cell *> boundary;
+  for (auto const cell : cells) {
+    auto const neighbors = cell->neighbors().red();
+    auto const is_interior =
+        std::none_of(neighbors.begin(), neighbors.end(),
+                     [&ghosts](Cell const *neighbor) {
+                       return ghosts.count(neighbor) != 0;
+                     });
+    (is_interior ? interior : boundary).push_back(cell);
+  }
+  m_interior_cell_colors = Algorithm::color_cells(interior);
+  m_boundary_cell_colors = Algorithm::color_cells(boundary);
+
+  m_rebuild_cell_verlet_lists = true;
+  m_rebuild_hot_particle_data = true;
+  m_rebuild_bond_tables = true;
+}
+
+void CellStructure::update_hot_particle_layout() {
+  if (m_rebuild_hot_particle_data) {
+    auto const local = decomposition().local_cells();
+    auto const ghost = decomposition().ghost_cells();
+    std::vector<Cell *> cells(local.begin(), local.end());
+    cells.insert(cells.end(), ghost.begin(), ghost.end());
+
+    m_hot_particle_data.set_layout(cells);
+    m_n_hot_local_particles = Cells::particles(local).size();
+    m_rebuild_hot_particle_data = false;
+    m_rebuild_hot_verlet_lists = true;
+    m_rebuild_cluster_pairs = true;
+  }
+}
+
+HotParticleData &CellStructure::update_hot_particle_data() {
+  update_hot_particle_layout();
+  m_hot_particle_data.gather();
+
+  return m_hot_particle_data;
+}
+
+namespace {
+template <class T> std::size_t memory(std::vector<T> const &v) {
+  return v.capacity() * sizeof(T);
+}
+} // namespace
+
+CellStructure::NeighborListMemory CellStructure::verlet_list_memory() {
+  NeighborListMemory result;
+  result.particle_pairs = memory(m_verlet_list);
+  for (auto const cell : local_cells()) {
+    result.particle_pairs += memory(cell->m_verlet_list);
+    result.index_pairs += memory(cell->m_hot_verlet_list);
+    result.compact += memory(cell->m_hot_neighbor_offsets) +
+                      memory(cell->m_hot_neighbors);
+    result.cluster_pairs += memory(cell->m_cluster_pairs);
+  }
+  return result;
+}
 
 void CellStructure::check_particle_index() {
   auto const max_id = get_max_local_particle_id();
@@ -181,23 +268,37 @@ unsigned map_data_parts(unsigned data_parts) {
 }
 
 void CellStructure::ghosts_count() {
+  ghosts_wait();
   ghost_communicator(decomposition().exchange_ghosts_comm(),
                      GHOSTTRANS_PARTNUM);
 }
 void CellStructure::ghosts_update(unsigned data_parts) {
+  ghosts_wait();
   ghost_communicator(decomposition().exchange_ghosts_comm(),
                      map_data_parts(data_parts));
 }
 void CellStructure::ghosts_reduce_forces() {
+  ghosts_wait();
   ghost_communicator(decomposition().collect_ghost_force_comm(),
                      GHOSTTRANS_FORCE);
 }
 #ifdef BOND_CONSTRAINT
 void CellStructure::ghosts_reduce_rattle_correction() {
+  ghosts_wait();
   ghost_communicator(decomposition().collect_ghost_force_comm(),
                      GHOSTTRANS_RATTLE);
 }
 #endif
+void CellStructure::ghosts_update_begin(unsigned data_parts) {
+  ghosts_wait();
+  m_pending_ghosts.start(decomposition().exchange_ghosts_comm(),
+                         map_data_parts(data_parts));
+}
+void CellStructure::ghosts_reduce_forces_begin() {
+  ghosts_wait();
+  m_pending_ghosts.start(decomposition().collect_ghost_force_comm(),
+                         GHOSTTRANS_FORCE);
+}
 
 Utils::Span<Cell *> CellStructure::local_cells() {
   return decomposition().local_cells();
@@ -234,6 +335,7 @@ struct UpdateParticleIndexVisitor {
 } // namespace
 
 void CellStructure::resort_particles(bool global_flag, BoxGeometry const &box) {
+  ghosts_wait();
   invalidate_ghosts();
 
   static std::vector<ParticleChange> diff;
@@ -246,6 +348,9 @@ void CellStructure::resort_particles(bool global_flag, BoxGeometry const &box) {
   }
 
   m_rebuild_verlet_list = true;
+  m_rebuild_cell_verlet_lists = true;
+  m_rebuild_hot_particle_data = true;
+  m_rebuild_bond_tables = true;
   m_le_pos_offset_at_last_resort = box.lees_edwards_bc().pos_offset;
 
 #ifdef ADDITIONAL_CHECKS
@@ -254,6 +359,14 @@ void CellStructure::resort_particles(bool global_flag, BoxGeometry const &box) {
 #endif
 }
 
+bool CellStructure::has_half_shell_ghosts() const {
+  if (m_type != CellStructureType::CELL_STRUCTURE_REGULAR) {
+    return false;
+  }
+  return dynamic_cast<RegularDecomposition const &>(decomposition())
+      .half_shell();
+}
+
 void CellStructure::set_atom_decomposition(boost::mpi::communicator const &comm,
                                            BoxGeometry const &box,
                                            LocalBox<double> &local_geo) {
@@ -265,8 +378,9 @@ void CellStructure::set_atom_decomposition(boost::mpi::communicator const &comm,
 void CellStructure::set_regular_decomposition(
     boost::mpi::communicator const &comm, double range, BoxGeometry const &box,
     LocalBox<double> &local_geo) {
-  set_particle_decomposition(
-      std::make_unique<RegularDecomposition>(comm, range, box, local_geo));
+  set_particle_decomposition(std::make_unique<RegularDecomposition>(
+      comm, range, box, local_geo, use_space_filling_curve,
+      use_half_shell_ghosts));
   m_type = CellStructureType::CELL_STRUCTURE_REGULAR;
   local_geo.set_cell_structure_type(m_type);
 }
@@ -276,7 +390,8 @@ void CellStructure::set_hybrid_decomposition(
     BoxGeometry const &box, LocalBox<double> &local_geo,
     std::set<int> n_square_types) {
   set_particle_decomposition(std::make_unique<HybridDecomposition>(
-      comm, cutoff_regular, box, local_geo, n_square_types));
+      comm, cutoff_regular, box, local_geo, n_square_types,
+      use_space_filling_curve));
   m_type = CellStructureType::CELL_STRUCTURE_HYBRID;
   local_geo.set_cell_structure_type(m_type);
 }
@@ -29,10 +29,13 @@
 #include "Particle.hpp"
 #include "ParticleList.hpp"
 #include "ParticleRange.hpp"
+#include "algorithm/color_cells.hpp"
 #include "algorithm/link_cell.hpp"
 #include "bond_error.hpp"
+#include "cell_system/BondTables.hpp"
 #include "cell_system/Cell.hpp"
 #include "cell_system/CellStructureType.hpp"
+#include "cell_system/HotParticleData.hpp"
 #include "config/config.hpp"
 #include "ghosts.hpp"
 
@@ -46,8 +49,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <stdexcept>
 #include <utility>
@@ -116,12 +122,20 @@ struct MinimalImageDistance {
   Distance operator()(Particle const &p1, Particle const &p2) const {
     return Distance(box.get_mi_vector(p1.pos(), p2.pos()));
   }
+  Utils::Vector3d operator()(Utils::Vector3d const &a,
+                             Utils::Vector3d const &b) const {
+    return box.get_mi_vector(a, b);
+  }
 };
 
 struct EuclidianDistance {
   Distance operator()(Particle const &p1, Particle const &p2) const {
     return Distance(p1.pos() - p2.pos());
   }
+  Utils::Vector3d operator()(Utils::Vector3d const &a,
+                             Utils::Vector3d const &b) const {
+    return a - b;
+  }
 };
 } // namespace detail
 
@@ -146,11 +160,80 @@ private:
   bool m_rebuild_verlet_list = true;
   std::vector<std::pair<Particle *, Particle *>> m_verlet_list;
   double m_le_pos_offset_at_last_resort = 0.;
+  /** Number of threads used in the parallel non-bonded loop */
+  int m_n_threads = 1;
+  /** Local cells grouped by color, see @ref Algorithm::color_cells */
+  std::vector<std::vector<Cell *>> m_cell_colors;
+  /** Whether the per-cell Verlet lists of the parallel loop are outdated */
+  bool m_rebuild_cell_verlet_lists = true;
+  /** Particle data used by @ref hot_non_bonded_loop */
+  HotParticleData m_hot_particle_data;
+  /** Whether the layout of the hot particle data is outdated */
+  bool m_rebuild_hot_particle_data = true;
+  /** Whether the per-cell hot Verlet lists are outdated */
+  bool m_rebuild_hot_verlet_lists = true;
+  /** Whether the per-cell cluster pair lists are outdated */
+  bool m_rebuild_cluster_pairs = true;
+  /** Whether the per-cell hot Verlet lists are stored compactly */
+  bool m_hot_verlet_lists_compact = false;
+  /** Number of entries of the local particles in the hot particle data */
+  std::size_t m_n_hot_local_particles = 0;
+  /** Bonds of the local particles used by @ref bond_table_loop */
+  BondTables m_bond_tables;
+  /** Whether the bond tables are outdated */
+  bool m_rebuild_bond_tables = true;
+  /** Ghost communication in flight, see @ref ghosts_update_begin */
+  PendingGhostCommunication m_pending_ghosts;
+  /** Local cells whose red neighbors are all local, grouped by color */
+  std::vector<std::vector<Cell *>> m_interior_cell_colors;
+  /** Local cells with ghost cells among their red neighbors,
+   *  grouped by color */
+  std::vector<std::vector<Cell *>> m_boundary_cell_colors;
+  /** Subset of the local cells visited by @ref for_each_colored_cell */
+  enum class CellSubset { ALL, INTERIOR, BOUNDARY };
+  CellSubset m_visited_cells = CellSubset::ALL;
 
 public:
   CellStructure(BoxGeometry const &box);
 
   bool use_verlet_list = true;
+  /** Run the short-range loop on the structure-of-arrays copy of the
+   *  particle properties, see @ref hot_non_bonded_loop. The cluster pair
+   *  lists, the compact Verlet lists, the mixed precision, the ghost
+   *  overlap and the tiles of the atom decomposition build on it.
+   */
+  bool use_hot_particle_data = false;
+  /** Store the Verlet lists of @ref hot_non_bonded_loop as compressed
+   *  rows of 32-bit particle indices instead of index pairs. Requires
+   *  @ref use_hot_particle_data and @ref use_verlet_list, and takes
+   *  precedence over the cluster pair lists and the tiles in the force
+   *  calculation.
+   */
+  bool use_compact_verlet_list = false;
+  /** Evaluate the distances and force factors of the cluster pair kernel
+   *  in single precision. Positions, velocities and force accumulation
+   *  stay in double precision.
+   */
+  bool use_mixed_precision = false;
+  /** Order the local cells and the particles within them along a
+   *  space-filling curve. Only affects the regular and hybrid
+   *  decompositions, and takes effect when the decomposition is set.
+   */
+  bool use_space_filling_curve = false;
+  /** Overlap the ghost communication of the integration steps with the
+   *  non-bonded loop over the hot particle data, see
+   *  @ref overlapped_hot_non_bonded_loop.
+   */
+  bool use_ghost_overlap = false;
+  /** Import the ghosts of the upper half shell only, using Newton's third
+   *  law across the node boundaries. Only affects the regular
+   *  decomposition, and takes effect when the decomposition is set.
+   */
+  bool use_half_shell_ghosts = false;
+  /** Evaluate the bonded forces from flat per-bond tables of particles,
+   *  see @ref bond_table_loop.
+   */
+  bool use_bond_tables = false;
 
   /**
    * @brief Update local particle index.
@@ -258,12 +341,56 @@ public:
 
   CellStructureType decomposition_type() const { return m_type; }
 
+  /**
+   * @brief Whether the ghost layer only holds the upper half shell.
+   *
+   * Then the neighbor cells of a particle are incomplete at the boundary
+   * of the local box, see @ref RegularDecomposition.
+   */
+  bool has_half_shell_ghosts() const;
+
+  /**
+   * @brief Set the number of threads for the non-bonded pair loop.
+   *
+   * @throws std::domain_error if @p n_threads is not strictly positive.
+   * @throws std::runtime_error if @p n_threads is larger than 1
+   *         and OpenMP support is not available.
+   */
+  void set_n_threads(int n_threads);
+
+  /** Number of threads used in the non-bonded pair loop. */
+  int get_n_threads() const { return m_n_threads; }
+
+  /** @brief Memory held by the neighbor lists, in bytes. */
+  struct NeighborListMemory {
+    /** Verlet lists of particle pointer pairs */
+    std::size_t particle_pairs = 0;
+    /** Hot Verlet lists of index pairs */
+    std::size_t index_pairs = 0;
+    /** Hot Verlet lists in compressed row storage */
+    std::size_t compact = 0;
+    /** Cluster pair lists */
+    std::size_t cluster_pairs = 0;
+  };
+
+  /** Memory reserved by the neighbor lists on this node. */
+  NeighborListMemory verlet_list_memory();
+
   /** Maximal cutoff supported by current cell system. */
   Utils::Vector3d max_cutoff() const;
 
   /** Maximal pair range supported by current cell system. */
   Utils::Vector3d max_range() const;
 
+  /** Number of cluster pairs in the lists of the local cells. */
+  std::size_t n_cluster_pairs() {
+    std::size_t n = 0;
+    for (auto const cell : local_cells()) {
+      n += cell->m_cluster_pairs.size();
+    }
+    return n;
+  }
+
   ParticleRange local_particles();
   ParticleRange ghost_particles();
 
@@ -423,6 +550,35 @@ public:
   void ghosts_reduce_rattle_correction();
 #endif
 
+  /**
+   * @brief Start updating the ghost particles, without waiting for the
+   * communication to complete.
+   *
+   * The ghost particles must not be accessed before @ref ghosts_wait.
+   * The functions of this class that communicate ghosts or move
+   * particles wait for the pending communication first.
+   *
+   * @param data_parts Particle parts to update, combination of @ref
+   * Cells::DataPart
+   */
+  void ghosts_update_begin(unsigned data_parts);
+
+  /**
+   * @brief Start adding the forces of the ghost particles to the real
+   * particles, without waiting for the communication to complete.
+   *
+   * Further forces can be added to the real particles in the meantime,
+   * any other particle data must not be accessed before
+   * @ref ghosts_wait.
+   */
+  void ghosts_reduce_forces_begin();
+
+  /** @brief Complete the pending ghost communication, if any. */
+  void ghosts_wait() { m_pending_ghosts.wait(); }
+
+  /** @brief Whether a ghost communication is pending. */
+  bool ghosts_pending() const { return m_pending_ghosts.active(); }
+
   /**
    * @brief Resort particles.
    */
@@ -497,10 +653,12 @@ private:
   /** @brief Set the particle decomposition, keeping the particles. */
   void set_particle_decomposition(
       std::unique_ptr<ParticleDecomposition> &&decomposition) {
+    ghosts_wait();
     clear_particle_index();
 
     /* Swap in new cell system */
     std::swap(m_decomposition, decomposition);
+    update_cell_colors();
 
     /* Add particles to new system */
     for (auto &p : Cells::particles(decomposition->local_cells())) {
@@ -554,25 +712,145 @@ private:
    * @param kernel Pair kernel functor.
    */
   template <class Kernel> void link_cell(Kernel kernel) {
-    auto const maybe_box = decomposition().minimum_image_distance();
     auto const first = boost::make_indirect_iterator(local_cells().begin());
     auto const last = boost::make_indirect_iterator(local_cells().end());
 
-    if (maybe_box) {
-      Algorithm::link_cell(
-          first, last,
-          [&kernel, df = detail::MinimalImageDistance{decomposition().box()}](
-              Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
+    with_distance_function([&](auto const &df) {
+      Algorithm::link_cell(first, last,
+                           [&kernel, &df](Particle &p1, Particle &p2) {
+                             kernel(p1, p2, df(p1, p2));
+                           });
+    });
+  }
+
+  /**
+   * @brief Call a loop with the distance function of the particle
+   * decomposition, i.e. @ref detail::MinimalImageDistance or
+   * @ref detail::EuclidianDistance.
+   *
+   * @tparam Loop Needs to be callable with both distance functions.
+   * @param loop Loop functor.
+   */
+  template <class Loop> void with_distance_function(Loop const &loop) {
+    if (decomposition().minimum_image_distance()) {
+      loop(detail::MinimalImageDistance{decomposition().box()});
     } else {
       if (decomposition().box().type() != BoxType::CUBOID) {
         throw std::runtime_error("Non-cuboid box type is not compatible with a "
                                  "particle decomposition that relies on "
                                  "EuclideanDistance for distance calculation.");
       }
-      Algorithm::link_cell(
-          first, last,
-          [&kernel, df = detail::EuclidianDistance{}](
-              Particle &p1, Particle &p2) { kernel(p1, p2, df(p1, p2)); });
+      loop(detail::EuclidianDistance{});
+    }
+  }
+
+  /** @brief Recalculate the coloring of the local cells, of all of them
+   *  and separately of the interior and the boundary cells. */
+  void update_cell_colors();
+
+  /** @brief Recompute the layout of the hot particle data if the
+   *  particles have been resorted. */
+  void update_hot_particle_layout();
+
+  /** @brief Colors of the cells of @ref m_visited_cells. */
+  std::vector<std::vector<Cell *>> const &visited_cell_colors() const {
+    return (m_visited_cells == CellSubset::INTERIOR) ? m_interior_cell_colors
+           : (m_visited_cells == CellSubset::BOUNDARY)
+               ? m_boundary_cell_colors
+               : m_cell_colors;
+  }
+
+  /**
+   * @brief Run a kernel on all local cells, using all threads.
+   *
+   * Cells of the same color are processed concurrently, colors are
+   * processed one after the other. Only the cells of
+   * @ref m_visited_cells are visited. While visiting the interior
+   * cells, the pending ghost communication progresses between colors.
+   *
+   * @tparam CellKernel Needs to be callable with (Cell *).
+   * @param cell_kernel Cell kernel functor.
+   */
+  template <class CellKernel>
+  void for_each_colored_cell(CellKernel const &cell_kernel) {
+    for (auto const &cells : visited_cell_colors()) {
+      auto const n_cells = static_cast<int>(cells.size());
+#ifdef OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(m_n_threads)
+#endif
+      for (int i = 0; i < n_cells; ++i) {
+        cell_kernel(cells[i]);
+      }
+      if (m_visited_cells == CellSubset::INTERIOR) {
+        m_pending_ghosts.test();
+      }
+    }
+  }
+
+  /** @brief Run a loop with @ref for_each_colored_cell restricted to
+   *  a subset of the local cells.
+   */
+  template <class Loop> void visit_cells(CellSubset subset, Loop const &loop) {
+    m_visited_cells = subset;
+    try {
+      loop();
+    } catch (...) {
+      m_visited_cells = CellSubset::ALL;
+      throw;
+    }
+    m_visited_cells = CellSubset::ALL;
+  }
+
+  /**
+   * @brief Run link_cell algorithm for local cells, using all threads.
+   *
+   * @tparam Kernel Needs to be callable with (Cell, Particle, Particle,
+   *                Distance).
+   * @param kernel Pair kernel functor.
+   */
+  template <class Kernel> void parallel_link_cell(Kernel const &kernel) {
+    with_distance_function([&](auto const &df) {
+      for_each_colored_cell([&kernel, &df](Cell *cell) {
+        auto const first = boost::make_indirect_iterator(&cell);
+        Algorithm::link_cell(first, std::next(first),
+                             [cell, &kernel, &df](Particle &p1, Particle &p2) {
+                               kernel(*cell, p1, p2, df(p1, p2));
+                             });
+      });
+    });
+  }
+
+  /** Non-bonded pair loop with per-cell verlet lists, using all threads.
+   *
+   * @param pair_kernel Kernel to apply
+   * @param verlet_criterion Filter for verlet lists.
+   */
+  template <class PairKernel, class VerletCriterion>
+  void parallel_verlet_list_loop(PairKernel const &pair_kernel,
+                                 const VerletCriterion &verlet_criterion) {
+    if (m_rebuild_cell_verlet_lists) {
+      for (auto cell : local_cells()) {
+        cell->m_verlet_list.clear();
+      }
+
+      parallel_link_cell([&](Cell &cell, Particle &p1, Particle &p2,
+                             Distance const &d) {
+        if (verlet_criterion(p1, p2, d)) {
+          cell.m_verlet_list.emplace_back(&p1, &p2);
+          pair_kernel(p1, p2, d);
+        }
+      });
+
+      m_rebuild_cell_verlet_lists = false;
+    } else {
+      with_distance_function([&](auto const &distance_function) {
+        for_each_colored_cell([&](Cell *cell) {
+          for (auto &pair : cell->m_verlet_list) {
+            pair_kernel(*pair.first, *pair.second,
+                        distance_function(*pair.first, *pair.second));
+          }
+        });
+      });
     }
   }
 
@@ -628,6 +906,46 @@ public:
     }
   }
 
+  /** Bonded loop over flat tables of the bonds, see @ref BondTables.
+   *
+   * The tables are rebuilt after the particles have been resorted.
+   * All bonds with the same id are handed to @p table_kernel at once,
+   * the other bonds are evaluated one by one with @p bond_kernel.
+   *
+   * @param accept       Callable with (int), whether the bonds with
+   *                     this id can be evaluated by @p table_kernel.
+   *                     Has to stay the same until the next resort.
+   * @param table_kernel Callable with (BondTable const &).
+   * @param bond_kernel  Kernel for the remaining bonds,
+   *                     see @ref execute_bond_handler.
+   */
+  template <class Accept, class TableKernel, class BondKernel>
+  void bond_table_loop(Accept const &accept, TableKernel const &table_kernel,
+                       BondKernel const &bond_kernel) {
+    if (m_rebuild_bond_tables) {
+      m_bond_tables.build(local_particles(), accept,
+                          [this](Utils::Span<const int> partner_ids) {
+                            return resolve_bond_partners(partner_ids);
+                          });
+      m_rebuild_bond_tables = false;
+    }
+
+    for (auto const &table : m_bond_tables.tables()) {
+      table_kernel(table);
+    }
+
+    for (auto p : m_bond_tables.untabulated()) {
+      execute_bond_handler(*p, [this, &bond_kernel](
+                                   Particle &p1, int bond_id,
+                                   Utils::Span<Particle *> partners) {
+        if (m_bond_tables.is_tabulated(bond_id)) {
+          return false;
+        }
+        return bond_kernel(p1, bond_id, partners);
+      });
+    }
+  }
+
   /** Non-bonded pair loop.
    * @param pair_kernel Kernel to apply
    */
@@ -651,7 +969,544 @@ public:
     }
   }
 
+  /** Non-bonded pair loop with potential use of verlet lists,
+   *  distributed over @ref get_n_threads "n_threads" threads.
+   *
+   *  The pair kernel is called concurrently on disjoint particle pairs
+   *  and must not modify shared state other than the forces of the
+   *  two particles it receives. The traversal order does not depend on
+   *  the number of threads. With a single thread, this is equivalent to
+   *  the serial @ref non_bonded_loop.
+   *
+   * @param pair_kernel Kernel to apply
+   * @param verlet_criterion Filter for verlet lists.
+   */
+  template <class PairKernel, class VerletCriterion>
+  void parallel_non_bonded_loop(PairKernel pair_kernel,
+                                const VerletCriterion &verlet_criterion) {
+    if (m_n_threads == 1) {
+      non_bonded_loop(pair_kernel, verlet_criterion);
+    } else if (use_verlet_list) {
+      parallel_verlet_list_loop(pair_kernel, verlet_criterion);
+    } else {
+      parallel_link_cell([&pair_kernel](Cell &, Particle &p1, Particle &p2,
+                                        Distance const &d) {
+        pair_kernel(p1, p2, d);
+      });
+    }
+  }
+
+  /**
+   * @brief Copy the particle properties into the hot particle data.
+   *
+   * The layout of the hot particle data is only recomputed after the
+   * particles have been resorted. The forces are reset to zero.
+   *
+   * @return The hot particle data.
+   */
+  HotParticleData &update_hot_particle_data();
+
+  /**
+   * @brief Run a non-bonded loop over the hot particle data while a
+   * ghost update started by @ref ghosts_update_begin is in flight.
+   *
+   * The loop is first restricted to the interior cells, whose pairs only
+   * involve real particles, and the communication progresses between
+   * the cell colors. Once the ghosts are complete, @p ghosts_ready is
+   * called and the loop is run over the remaining cells. The forces are
+   * summed in a different order than in a single pass, such that they
+   * only agree up to rounding. Without a pending update, this amounts to
+   * calling @p ghosts_ready, @ref update_hot_particle_data and @p loop.
+   *
+   * @param loop          Callable running @ref hot_non_bonded_loop or
+   *                      @ref cluster_non_bonded_loop.
+   * @param ghosts_ready  Callable run as soon as the ghosts are updated.
+   */
+  template <class Loop, class Callback>
+  void overlapped_hot_non_bonded_loop(Loop const &loop,
+                                      Callback const &ghosts_ready) {
+    if (not ghosts_pending()) {
+      ghosts_ready();
+      update_hot_particle_data();
+      loop();
+      return;
+    }
+
+    update_hot_particle_layout();
+    m_hot_particle_data.gather(0u, m_n_hot_local_particles);
+    visit_cells(CellSubset::INTERIOR, loop);
+
+    ghosts_wait();
+    ghosts_ready();
+    m_hot_particle_data.gather(m_n_hot_local_particles,
+                               m_hot_particle_data.size());
+    visit_cells(CellSubset::BOUNDARY, loop);
+  }
+
+  /** @brief Add the forces accumulated in the hot particle data
+   *  to the particles.
+   */
+  void scatter_hot_particle_forces() const {
+    m_hot_particle_data.scatter_forces();
+  }
+
+  /** Non-bonded pair loop over the hot particle data, with potential
+   *  use of verlet lists. The hot particle data has to be up to date,
+   *  see @ref update_hot_particle_data.
+   *
+   *  Pairs are visited in the same order as in @ref parallel_non_bonded_loop
+   *  and distributed over the same number of threads.
+   *
+   * @param pair_kernel Kernel to apply, needs to be callable with
+   *        (HotParticleData, index, index, Utils::Vector3d, double)
+   *        for the data, the two particle indices, the distance
+   *        vector and the squared distance.
+   * @param verlet_criterion Filter for verlet lists.
+   */
+  template <class HotPairKernel, class VerletCriterion>
+  void hot_non_bonded_loop(HotPairKernel const &pair_kernel,
+                           const VerletCriterion &verlet_criterion) {
+    with_distance_function([&](auto const &df) {
+      hot_non_bonded_loop_impl(pair_kernel, verlet_criterion, df);
+    });
+  }
+
+  /** Non-bonded loop over pairs of particle clusters in the hot particle
+   *  data. The cluster pair lists play the role of the verlet lists and
+   *  are rebuilt when the particles are resorted. The hot particle data
+   *  has to be up to date, see @ref update_hot_particle_data.
+   *
+   *  Only particle decompositions that rely on the minimum image
+   *  distance of a cuboid box are supported.
+   *
+   * @param cluster_kernel Kernel to apply, needs to be callable with
+   *        (HotParticleData, ClusterPair). The kernel is responsible for
+   *        checking the distance of the particles in the clusters.
+   * @param range Interaction range, including the skin.
+   */
+  template <class ClusterKernel>
+  void cluster_non_bonded_loop(ClusterKernel const &cluster_kernel,
+                               double range) {
+    auto const maybe_box = decomposition().minimum_image_distance();
+    if (not maybe_box or maybe_box->type() != BoxType::CUBOID) {
+      throw std::runtime_error("Cluster pair lists are only compatible with "
+                               "a particle decomposition that relies on the "
+                               "minimum image distance in a cuboid box.");
+    }
+
+    auto &data = m_hot_particle_data;
+
+    if (m_rebuild_cluster_pairs) {
+      auto const range2 = range * range;
+      for_each_colored_cell([&](Cell *cell) {
+        cell->m_cluster_pairs.clear();
+        hot_cluster_link_cell(*cell, [&](ClusterPair const &pair) {
+          if (cluster_distance2(data, pair, *maybe_box) <= range2) {
+            cell->m_cluster_pairs.push_back(pair);
+            cluster_kernel(data, pair);
+          }
+        });
+      });
+      if (m_visited_cells != CellSubset::INTERIOR) {
+        m_rebuild_cluster_pairs = false;
+      }
+    } else {
+      for_each_colored_cell([&](Cell *cell) {
+        for (auto const &pair : cell->m_cluster_pairs) {
+          cluster_kernel(data, pair);
+        }
+      });
+    }
+  }
+
+  /** Number of particles per tile of @ref tiled_non_bonded_loop */
+  static constexpr std::uint32_t tile_size = 16u * ClusterPair::size;
+
+  /** Non-bonded loop over all pairs of particle clusters in the hot
+   *  particle data, without pair lists. The clusters of a cell and of its
+   *  red neighbors are visited in tiles of @ref tile_size particles, such
+   *  that the positions of a pair of tiles stay in the cache while all of
+   *  their cluster pairs are evaluated. The pairs of tiles are distributed
+   *  over the threads as in @ref hot_tiled_non_bonded_loop. This is meant
+   *  for the atom decomposition, where every pair of particles is a
+   *  candidate and pair lists only add to the cost. The hot particle data
+   *  has to be up to date, see @ref update_hot_particle_data.
+   *
+   *  Only particle decompositions that rely on the minimum image
+   *  distance of a cuboid box are supported.
+   *
+   * @param cluster_kernel Kernel to apply, needs to be callable with
+   *        (HotParticleData, ClusterPair). The kernel is responsible for
+   *        checking the distance of the particles in the clusters.
+   */
+  template <class ClusterKernel>
+  void tiled_non_bonded_loop(ClusterKernel const &cluster_kernel) {
+    auto const maybe_box = decomposition().minimum_image_distance();
+    if (not maybe_box or maybe_box->type() != BoxType::CUBOID) {
+      throw std::runtime_error("Tiled pair loops are only compatible with "
+                               "a particle decomposition that relies on the "
+                               "minimum image distance in a cuboid box.");
+    }
+
+    auto &data = m_hot_particle_data;
+    auto const kernel = [&](ClusterPair const &pair) {
+      cluster_kernel(data, pair);
+    };
+    for_each_tile_pair([&kernel](TilePair const &tp) {
+      hot_link_tiles(tp.i_begin, tp.i_end, tp.j_begin, tp.j_end,
+                     tp.i_begin == tp.j_begin, kernel);
+    });
+  }
+
+  /** Non-bonded loop over all pairs of particles in the hot particle
+   *  data, without pair lists, distributed over
+   *  @ref get_n_threads "n_threads" threads. The particles of a cell and
+   *  of its red neighbors are grouped into tiles of @ref tile_size
+   *  particles, and the pairs of tiles are processed in rounds in which
+   *  every tile appears at most once, such that the tile pairs of a round
+   *  can run concurrently. This is meant for the atom decomposition with
+   *  pair interactions that have no cutoff, e.g. MMM1D, where every pair
+   *  of particles interacts and pair lists only add to the cost. The
+   *  traversal order does not depend on the number of threads. The hot
+   *  particle data has to be up to date, see
+   *  @ref update_hot_particle_data.
+   *
+   * @param pair_kernel Kernel to apply, needs to be callable with
+   *        (HotParticleData, index, index, Utils::Vector3d, double)
+   *        for the data, the two particle indices, the distance
+   *        vector and the squared distance.
+   */
+  template <class HotPairKernel>
+  void hot_tiled_non_bonded_loop(HotPairKernel const &pair_kernel) {
+    auto &data = m_hot_particle_data;
+    using index_type = HotParticleData::index_type;
+
+    with_distance_function([&](auto const &df) {
+      for_each_tile_pair([&](TilePair const &tp) {
+        auto const same_tile = (tp.i_begin == tp.j_begin);
+        for (auto i = tp.i_begin; i < tp.i_end; ++i) {
+          auto const pos_i = data.position(i);
+          for (index_type j = same_tile ? i + 1u : tp.j_begin; j < tp.j_end;
+               ++j) {
+            auto const d = df(pos_i, data.position(j));
+            pair_kernel(data, i, j, d, d.norm2());
+          }
+        }
+      });
+    });
+  }
+
 private:
+  /** Pair of tiles of the hot particle data. */
+  struct TilePair {
+    HotParticleData::index_type i_begin, i_end;
+    HotParticleData::index_type j_begin, j_end;
+  };
+
+  /**
+   * @brief Group the pairs of tiles of a cell and of the cell with its
+   * red neighbors into rounds, in which every tile appears at most once.
+   *
+   * The first round pairs every tile of the cell with itself. The pairs
+   * of distinct tiles of the cell follow in the rounds of a round-robin
+   * tournament, and the pairs with the tiles of the neighbors in the rounds
+   * of a cyclic shift.
+   */
+  static std::vector<std::vector<TilePair>> tile_pair_rounds(Cell &cell) {
+    using index_type = HotParticleData::index_type;
+    using Tile = std::pair<index_type, index_type>;
+    auto const make_tiles = [](Cell const &c, std::vector<Tile> &tiles) {
+      auto const begin = c.m_hot_offset;
+      auto const end = begin + static_cast<index_type>(c.particles().size());
+      for (auto t = begin; t < end; t += tile_size) {
+        tiles.emplace_back(t, std::min(t + tile_size, end));
+      }
+    };
+    std::vector<Tile> tiles;
+    std::vector<Tile> neighbor_tiles;
+    make_tiles(cell, tiles);
+    for (auto const neighbor : cell.neighbors().red()) {
+      make_tiles(*neighbor, neighbor_tiles);
+    }
+
+    auto const n = tiles.size();
+    std::vector<std::vector<TilePair>> rounds;
+    auto const pair = [](Tile const &a, Tile const &b) {
+      return TilePair{a.first, a.second, b.first, b.second};
+    };
+
+    rounds.emplace_back();
+    for (auto const &tile : tiles) {
+      rounds.back().push_back(pair(tile, tile));
+    }
+
+    /* circle method, with a dummy tile for an odd number of tiles */
+    auto const m = n + n % 2u;
+    for (std::size_t r = 0; r + 1u < m; ++r) {
+      rounds.emplace_back();
+      if (m - 1u < n) {
+        rounds.back().push_back(pair(tiles[r], tiles[m - 1u]));
+      }
+      for (std::size_t k = 1; k < m / 2u; ++k) {
+        auto const a = (r + k) % (m - 1u);
+        auto const b = (r + m - 1u - k) % (m - 1u);
+        rounds.back().push_back(pair(tiles[a], tiles[b]));
+      }
+    }
+
+    auto const n_shifts = std::max(n, neighbor_tiles.size());
+    for (std::size_t r = 0; n != 0u and r < n_shifts; ++r) {
+      rounds.emplace_back();
+      for (std::size_t a = 0; a < n; ++a) {
+        auto const b = (a + r) % n_shifts;
+        if (b < neighbor_tiles.size()) {
+          rounds.back().push_back(pair(tiles[a], neighbor_tiles[b]));
+        }
+      }
+    }
+    return rounds;
+  }
+
+  /**
+   * @brief Run a kernel on the pairs of tiles of the local cells, using
+   * all threads.
+   *
+   * The cells are visited one after the other, and the tile pairs of each
+   * round of @ref tile_pair_rounds are processed concurrently. Only the
+   * cells of @ref m_visited_cells are visited.
+   *
+   * @tparam TileKernel Needs to be callable with (TilePair).
+   * @param tile_kernel Tile pair kernel functor.
+   */
+  template <class TileKernel>
+  void for_each_tile_pair(TileKernel const &tile_kernel) {
+    for (auto const &cells : visited_cell_colors()) {
+      for (auto const cell : cells) {
+        for (auto const &round : tile_pair_rounds(*cell)) {
+          auto const n_pairs = static_cast<int>(round.size());
+#ifdef OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(m_n_threads)
+#endif
+          for (int k = 0; k < n_pairs; ++k) {
+            tile_kernel(round[k]);
+          }
+        }
+        if (m_visited_cells == CellSubset::INTERIOR) {
+          m_pending_ghosts.test();
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Visit all pairs of clusters in the hot particle data range
+   * [@p j_begin, @p j_end) with the clusters in [@p i_begin, @p i_end).
+   * With @p same_tile, only the pairs with j >= i are visited.
+   */
+  template <class ClusterPairKernel>
+  static void hot_link_tiles(std::uint32_t i_begin, std::uint32_t i_end,
+                             std::uint32_t j_begin, std::uint32_t j_end,
+                             bool same_tile,
+                             ClusterPairKernel const &kernel) {
+    auto constexpr cluster_size = ClusterPair::size;
+    for (auto i = i_begin; i < i_end; i += cluster_size) {
+      auto const n_i = std::min(cluster_size, i_end - i);
+      for (auto j = same_tile ? i : j_begin; j < j_end; j += cluster_size) {
+        kernel(ClusterPair{i, j, n_i, std::min(cluster_size, j_end - j)});
+      }
+    }
+  }
+
+  /**
+   * @brief Visit all pairs of clusters of a cell and of the cell with its
+   * red neighbors.
+   */
+  template <class ClusterPairKernel>
+  static void hot_cluster_link_cell(Cell &cell, ClusterPairKernel &&kernel) {
+    using index_type = HotParticleData::index_type;
+    auto constexpr cluster_size = ClusterPair::size;
+    auto const begin = cell.m_hot_offset;
+    auto const end = begin + static_cast<index_type>(cell.particles().size());
+
+    for (auto i = begin; i < end; i += cluster_size) {
+      auto const n_i = std::min(cluster_size, end - i);
+
+      /* Pairs in this cell */
+      for (auto j = i; j < end; j += cluster_size) {
+        kernel(ClusterPair{i, j, n_i, std::min(cluster_size, end - j)});
+      }
+
+      /* Pairs with neighbors */
+      for (auto const neighbor : cell.neighbors().red()) {
+        auto const n_begin = neighbor->m_hot_offset;
+        auto const n_end =
+            n_begin + static_cast<index_type>(neighbor->particles().size());
+        for (auto j = n_begin; j < n_end; j += cluster_size) {
+          kernel(ClusterPair{i, j, n_i, std::min(cluster_size, n_end - j)});
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Smallest squared minimum image distance between the particles
+   * of two clusters.
+   */
+  static double cluster_distance2(HotParticleData const &data,
+                                  ClusterPair const &pair,
+                                  BoxGeometry const &box) {
+    auto dist2 = std::numeric_limits<double>::max();
+    for (std::uint32_t a = 0; a < pair.n_i; ++a) {
+      auto const pos_i = data.position(pair.i + a);
+      for (std::uint32_t b = 0; b < pair.n_j; ++b) {
+        auto const d = box.get_mi_vector(pos_i, data.position(pair.j + b));
+        dist2 = std::min(dist2, d.norm2());
+      }
+    }
+    return dist2;
+  }
+
+  /**
+   * @brief Visit all pairs of a cell and of the cell with its red
+   * neighbors, as indices into the hot particle data.
+   */
+  template <class IndexKernel>
+  static void hot_link_cell(Cell &cell, IndexKernel &&kernel) {
+    using index_type = HotParticleData::index_type;
+    auto const begin = cell.m_hot_offset;
+    auto const end = begin + static_cast<index_type>(cell.particles().size());
+
+    for (auto i = begin; i < end; ++i) {
+      /* Pairs in this cell */
+      for (auto j = i + 1; j < end; ++j) {
+        kernel(i, j);
+      }
+
+      /* Pairs with neighbors */
+      for (auto const neighbor : cell.neighbors().red()) {
+        auto const n_begin = neighbor->m_hot_offset;
+        auto const n_end =
+            n_begin + static_cast<index_type>(neighbor->particles().size());
+        for (auto j = n_begin; j < n_end; ++j) {
+          kernel(i, j);
+        }
+      }
+    }
+  }
+
+  template <class HotPairKernel, class VerletCriterion, class DistanceFunc>
+  void hot_non_bonded_loop_impl(HotPairKernel const &pair_kernel,
+                                const VerletCriterion &verlet_criterion,
+                                DistanceFunc const &df) {
+    auto &data = m_hot_particle_data;
+    using index_type = HotParticleData::index_type;
+
+    if (not use_verlet_list) {
+      for_each_colored_cell([&](Cell *cell) {
+        hot_link_cell(*cell, [&](index_type i, index_type j) {
+          auto const d = df(data.position(i), data.position(j));
+          pair_kernel(data, i, j, d, d.norm2());
+        });
+      });
+    } else if (m_rebuild_hot_verlet_lists or
+               m_hot_verlet_lists_compact != use_compact_verlet_list) {
+      if (use_compact_verlet_list) {
+        rebuild_compact_hot_verlet_lists(pair_kernel, verlet_criterion, df);
+      } else {
+        rebuild_hot_verlet_lists(pair_kernel, verlet_criterion, df);
+      }
+      /* the lists of the boundary cells are rebuilt in a second pass */
+      if (m_visited_cells != CellSubset::INTERIOR) {
+        m_hot_verlet_lists_compact = use_compact_verlet_list;
+        m_rebuild_hot_verlet_lists = false;
+      }
+    } else if (m_hot_verlet_lists_compact) {
+      for_each_colored_cell([&](Cell *cell) {
+        auto const &offsets = cell->m_hot_neighbor_offsets;
+        auto const &neighbors = cell->m_hot_neighbors;
+        for (std::size_t n = 0; n + 1 < offsets.size(); ++n) {
+          auto const i = cell->m_hot_offset + static_cast<index_type>(n);
+          auto const pos_i = data.position(i);
+          for (auto k = offsets[n]; k < offsets[n + 1]; ++k) {
+            auto const j = neighbors[k];
+            auto const d = df(pos_i, data.position(j));
+            pair_kernel(data, i, j, d, d.norm2());
+          }
+        }
+      });
+    } else {
+      for_each_colored_cell([&](Cell *cell) {
+        for (auto const &pair : cell->m_hot_verlet_list) {
+          auto const d =
+              df(data.position(pair.first), data.position(pair.second));
+          pair_kernel(data, pair.first, pair.second, d, d.norm2());
+        }
+      });
+    }
+  }
+
+  /** Rebuild the hot Verlet lists as index pairs while running the
+   *  kernel on the pairs that are added.
+   */
+  template <class HotPairKernel, class VerletCriterion, class DistanceFunc>
+  void rebuild_hot_verlet_lists(HotPairKernel const &pair_kernel,
+                                const VerletCriterion &verlet_criterion,
+                                DistanceFunc const &df) {
+    auto &data = m_hot_particle_data;
+    using index_type = HotParticleData::index_type;
+
+    for_each_colored_cell([&](Cell *cell) {
+      std::vector<index_type>().swap(cell->m_hot_neighbor_offsets);
+      std::vector<index_type>().swap(cell->m_hot_neighbors);
+      cell->m_hot_verlet_list.clear();
+      hot_link_cell(*cell, [&](index_type i, index_type j) {
+        Distance const d(df(data.position(i), data.position(j)));
+        if (verlet_criterion(*data.particles[i], *data.particles[j], d)) {
+          cell->m_hot_verlet_list.emplace_back(i, j);
+          pair_kernel(data, i, j, d.vec21, d.dist2);
+        }
+      });
+    });
+  }
+
+  /** Rebuild the hot Verlet lists in compressed row storage while running
+   *  the kernel on the pairs that are added. The partners of each particle
+   *  are sorted by index, so that they are traversed in memory order.
+   */
+  template <class HotPairKernel, class VerletCriterion, class DistanceFunc>
+  void rebuild_compact_hot_verlet_lists(HotPairKernel const &pair_kernel,
+                                        const VerletCriterion &verlet_criterion,
+                                        DistanceFunc const &df) {
+    auto &data = m_hot_particle_data;
+    using index_type = HotParticleData::index_type;
+
+    for_each_colored_cell([&](Cell *cell) {
+      decltype(cell->m_hot_verlet_list)().swap(cell->m_hot_verlet_list);
+      auto &offsets = cell->m_hot_neighbor_offsets;
+      auto &neighbors = cell->m_hot_neighbors;
+      auto const begin = cell->m_hot_offset;
+      offsets.assign(cell->particles().size() + 1u, 0u);
+      neighbors.clear();
+
+      /* Pairs are visited row by row, so the rows are contiguous and only
+       * the row lengths have to be counted. */
+      hot_link_cell(*cell, [&](index_type i, index_type j) {
+        Distance const d(df(data.position(i), data.position(j)));
+        if (verlet_criterion(*data.particles[i], *data.particles[j], d)) {
+          neighbors.push_back(j);
+          ++offsets[i - begin + 1u];
+          pair_kernel(data, i, j, d.vec21, d.dist2);
+        }
+      });
+
+      std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+      for (std::size_t n = 0; n + 1 < offsets.size(); ++n) {
+        std::sort(neighbors.begin() + offsets[n],
+                  neighbors.begin() + offsets[n + 1]);
+      }
+    });
+  }
+
   /**
    * @brief Check that particle index is commensurate with particles.
    *
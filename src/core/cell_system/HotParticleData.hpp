@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_CELL_SYSTEM_HOT_PARTICLE_DATA_HPP
+#define ESPRESSO_SRC_CORE_CELL_SYSTEM_HOT_PARTICLE_DATA_HPP
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Pair of particle clusters in the hot particle data.
+ *
+ * A cluster is a group of up to @ref size consecutive particles of the
+ * same cell. A pair of a cluster with itself only stands for the pairs
+ * of distinct particles of that cluster.
+ */
+struct ClusterPair {
+  /** Maximal number of particles in a cluster */
+  static constexpr std::uint32_t size = 4;
+
+  /** Index of the first particle of the first cluster */
+  std::uint32_t i;
+  /** Index of the first particle of the second cluster */
+  std::uint32_t j;
+  /** Number of particles in the first cluster */
+  std::uint32_t n_i;
+  /** Number of particles in the second cluster */
+  std::uint32_t n_j;
+
+  bool is_self_pair() const { return i == j; }
+};
+
+/**
+ * @brief Structure-of-arrays copy of the particle properties
+ * needed by the non-bonded pair kernels.
+ *
+ * The particles of all cells are stored contiguously, cell after cell.
+ * The position of the first particle of a cell in the arrays is stored
+ * in @c Cell::m_hot_offset. Each entry keeps a pointer to the particle
+ * it was copied from, so that kernels can fall back to the full
+ * particle data for interactions that need more than positions, types
+ * and charges.
+ *
+ * The layout only changes when particles are resorted, the properties
+ * are copied in once per force calculation with @ref gather and the
+ * forces are added back to the particles with @ref scatter_forces.
+ * The properties of a range of cells can be copied separately, e.g.
+ * of the local cells while the ghosts are still being communicated.
+ */
+class HotParticleData {
+public:
+  using index_type = std::uint32_t;
+
+  std::array<std::vector<double>, 3> pos;
+  std::array<std::vector<double>, 3> force;
+  std::vector<int> type;
+#ifdef ELECTROSTATICS
+  std::vector<double> q;
+#endif
+#ifdef EXCLUSIONS
+  /** Whether the particle has non-bonded exclusions */
+  std::vector<char> has_exclusions;
+#endif
+  /** Particles the entries were copied from */
+  std::vector<Particle *> particles;
+
+  std::size_t size() const { return particles.size(); }
+
+  /**
+   * @brief Assign a contiguous range of entries to each cell.
+   *
+   * @param cells Cells, in storage order.
+   */
+  template <class CellRange> void set_layout(CellRange const &cells) {
+    particles.clear();
+    for (auto cell : cells) {
+      cell->m_hot_offset = static_cast<index_type>(particles.size());
+      for (auto &p : cell->particles()) {
+        particles.push_back(&p);
+      }
+    }
+
+    auto const n = particles.size();
+    for (std::size_t k = 0; k < 3; ++k) {
+      pos[k].resize(n);
+      force[k].resize(n);
+    }
+    type.resize(n);
+#ifdef ELECTROSTATICS
+    q.resize(n);
+#endif
+#ifdef EXCLUSIONS
+    has_exclusions.resize(n);
+#endif
+  }
+
+  /** @brief Copy properties from the particles and reset the forces. */
+  void gather() { gather(0u, size()); }
+
+  /** @brief Copy properties from the particles and reset the forces,
+   *  for the entries in [begin, end).
+   */
+  void gather(std::size_t begin, std::size_t end) {
+    for (std::size_t i = begin; i < end; ++i) {
+      auto const &p = *particles[i];
+      for (std::size_t k = 0; k < 3; ++k) {
+        pos[k][i] = p.pos()[k];
+        force[k][i] = 0.;
+      }
+      type[i] = p.type();
+#ifdef ELECTROSTATICS
+      q[i] = p.q();
+#endif
+#ifdef EXCLUSIONS
+      has_exclusions[i] = !p.exclusions().empty();
+#endif
+    }
+  }
+
+  /** @brief Add the accumulated forces to the particles. */
+  void scatter_forces() const {
+    auto const n = size();
+    for (std::size_t i = 0; i < n; ++i) {
+      auto &f = particles[i]->force();
+      for (std::size_t k = 0; k < 3; ++k) {
+        f[k] += force[k][i];
+      }
+    }
+  }
+
+  Utils::Vector3d position(std::size_t i) const {
+    return {pos[0][i], pos[1][i], pos[2][i]};
+  }
+
+  void add_force(std::size_t i, Utils::Vector3d const &f) {
+    for (std::size_t k = 0; k < 3; ++k) {
+      force[k][i] += f[k];
+    }
+  }
+};
+
+#endif
@@ -79,7 +79,8 @@ public:
   HybridDecomposition(boost::mpi::communicator comm, double cutoff_regular,
                       BoxGeometry const &box_geo,
                       LocalBox<double> const &local_box,
-                      std::set<int> n_square_types);
+                      std::set<int> n_square_types,
+                      bool space_filling_curve = false);
 
   Utils::Vector3i get_cell_grid() const {
     return m_regular_decomposition.cell_grid;
@@ -29,6 +29,7 @@
 
 #include <utils/Vector.hpp>
 #include <utils/index.hpp>
+#include <utils/morton.hpp>
 #include <utils/mpi/cart_comm.hpp>
 #include <utils/mpi/sendrecv.hpp>
 
@@ -42,8 +43,12 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <iterator>
+#include <limits>
+#include <numeric>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -54,8 +59,9 @@ Cell *RegularDecomposition::position_to_cell(const Utils::Vector3d &pos) {
   Utils::Vector3i cpos;
 
   for (int i = 0; i < 3; i++) {
-    cpos[i] = static_cast<int>(std::floor(pos[i] * inv_cell_size[i])) + 1 -
-              cell_offset[i];
+    cpos[i] = static_cast<int>(std::floor(
+                  (pos[i] - m_local_box.my_left()[i]) * inv_cell_size[i])) +
+              1;
 
     /* particles outside our box. Still take them if
        nonperiodic boundary. We also accept the particle if we are at
@@ -237,22 +243,63 @@ void RegularDecomposition::resort(bool global,
       diff.emplace_back(ModifiedList{sort_cell->particles()});
     }
   }
+
+  if (m_space_filling_curve) {
+    sort_particles(diff);
+  }
+}
+
+void RegularDecomposition::sort_particles(
+    std::vector<ParticleChange> &modified_cells) {
+  auto constexpr n_bins = 1024.;
+  auto const scale = n_bins * inv_cell_size;
+  auto const &my_left = m_local_box.my_left();
+  auto const key = [&scale, &my_left](Particle const &p) {
+    Utils::Vector3i ind;
+    for (unsigned int i = 0; i < 3; ++i) {
+      ind[i] = std::max(0, static_cast<int>((p.pos()[i] - my_left[i]) *
+                                            scale[i]));
+    }
+    return Utils::morton_index(ind);
+  };
+  auto const compare = [&key](Particle const &a, Particle const &b) {
+    return key(a) < key(b);
+  };
+
+  for (auto &c : local_cells()) {
+    auto &particles = c->particles();
+    if (not std::is_sorted(particles.begin(), particles.end(), compare)) {
+      std::sort(particles.begin(), particles.end(), compare);
+      modified_cells.emplace_back(ModifiedList{particles});
+    }
+  }
 }
 
 void RegularDecomposition::mark_cells() {
   m_local_cells.clear();
   m_ghost_cells.clear();
 
+  std::vector<std::pair<std::uint64_t, Cell *>> local_cells;
   int cnt_c = 0;
   for (int o = 0; o < ghost_cell_grid[2]; o++)
     for (int n = 0; n < ghost_cell_grid[1]; n++)
       for (int m = 0; m < ghost_cell_grid[0]; m++) {
         if ((m > 0 && m < ghost_cell_grid[0] - 1 && n > 0 &&
-             n < ghost_cell_grid[1] - 1 && o > 0 && o < ghost_cell_grid[2] - 1))
-          m_local_cells.push_back(&cells.at(cnt_c++));
-        else
+             n < ghost_cell_grid[1] - 1 && o > 0 &&
+             o < ghost_cell_grid[2] - 1)) {
+          auto const key =
+              (m_space_filling_curve)
+                  ? Utils::morton_index({m - 1, n - 1, o - 1})
+                  : static_cast<std::uint64_t>(local_cells.size());
+          local_cells.emplace_back(key, &cells.at(cnt_c++));
+        } else
           m_ghost_cells.push_back(&cells.at(cnt_c++));
       }
+
+  std::sort(local_cells.begin(), local_cells.end());
+  for (auto const &kv : local_cells) {
+    m_local_cells.push_back(kv.second);
+  }
 }
 
 void RegularDecomposition::fill_comm_cell_lists(ParticleList **part_lists,
@@ -288,8 +335,6 @@ int RegularDecomposition::calc_processor_min_num_cells() const {
 }
 
 void RegularDecomposition::create_cell_grid(double range) {
-  auto const cart_info = Utils::Mpi::cart_get<3>(m_comm);
-
   int n_local_cells;
   auto cell_range = Utils::Vector3d::broadcast(range);
   auto const min_num_cells = calc_processor_min_num_cells();
@@ -300,6 +345,7 @@ void RegularDecomposition::create_cell_grid(double range) {
         static_cast<int>(std::ceil(std::cbrt(min_num_cells)));
 
     cell_grid = Utils::Vector3i::broadcast(cells_per_dir);
+    align_cell_grid();
     n_local_cells = Utils::product(cell_grid);
   } else {
     /* Calculate initial cell grid */
@@ -351,6 +397,9 @@ void RegularDecomposition::create_cell_grid(double range) {
       cell_range[min_ind] = m_local_box.length()[min_ind] / cell_grid[min_ind];
     }
 
+    align_cell_grid();
+    n_local_cells = Utils::product(cell_grid);
+
     /* sanity check */
     if (n_local_cells < min_num_cells) {
       runtimeErrorMsg() << "number of cells " << n_local_cells
@@ -366,8 +415,6 @@ void RegularDecomposition::create_cell_grid(double range) {
     runtimeErrorMsg() << "no suitable cell grid found";
   }
 
-  auto const node_pos = cart_info.coords;
-
   /* now set all dependent variables */
   int new_cells = 1;
   for (int i = 0; i < 3; i++) {
@@ -375,7 +422,6 @@ void RegularDecomposition::create_cell_grid(double range) {
     new_cells *= ghost_cell_grid[i];
     cell_size[i] = m_local_box.length()[i] / static_cast<double>(cell_grid[i]);
     inv_cell_size[i] = 1.0 / cell_size[i];
-    cell_offset[i] = node_pos[i] * cell_grid[i];
   }
 
   /* allocate cell array and cell pointer arrays */
@@ -385,6 +431,44 @@ void RegularDecomposition::create_cell_grid(double range) {
   m_ghost_cells.resize(new_cells - n_local_cells);
 }
 
+void RegularDecomposition::align_cell_grid() {
+  auto const cart_info = Utils::Mpi::cart_get<3>(m_comm);
+  auto const &node_pos = cart_info.coords;
+
+  if (m_local_box.uniform()) {
+    /* all nodes have the same cell grid */
+    cell_offset = hadamard_product(node_pos, cell_grid);
+    global_cell_grid = hadamard_product(cart_info.dims, cell_grid);
+    return;
+  }
+
+  std::vector<int> cell_grids;
+  boost::mpi::all_gather(m_comm, cell_grid.data(), 3, cell_grids);
+
+  /* smallest number of cells of the nodes in each slab */
+  std::array<std::vector<int>, 3> slab_cells;
+  for (std::size_t i = 0; i < 3; i++) {
+    slab_cells[i].assign(static_cast<std::size_t>(cart_info.dims[i]),
+                         std::numeric_limits<int>::max());
+  }
+  for (int rank = 0; rank < m_comm.size(); rank++) {
+    auto const pos = Utils::Mpi::cart_coords<3>(m_comm, rank);
+    for (std::size_t i = 0; i < 3; i++) {
+      auto &n_cells = slab_cells[i][static_cast<std::size_t>(pos[i])];
+      n_cells = std::min(n_cells, cell_grids[3 * rank + i]);
+    }
+  }
+
+  for (std::size_t i = 0; i < 3; i++) {
+    auto const &cells_in_slab = slab_cells[i];
+    auto const slab = cells_in_slab.begin() + node_pos[i];
+    cell_grid[i] = *slab;
+    cell_offset[i] = std::accumulate(cells_in_slab.begin(), slab, 0);
+    global_cell_grid[i] =
+        std::accumulate(cells_in_slab.begin(), cells_in_slab.end(), 0);
+  }
+}
+
 template <class K, class Comparator> auto make_flat_set(Comparator &&comp) {
   return boost::container::flat_set<K, std::remove_reference_t<Comparator>>(
       std::forward<Comparator>(comp));
@@ -393,10 +477,8 @@ template <class K, class Comparator> auto make_flat_set(Comparator &&comp) {
 void RegularDecomposition::init_cell_interactions() {
 
   auto const halo = Utils::Vector3i{1, 1, 1};
-  auto const cart_info = Utils::Mpi::cart_get<3>(m_comm);
-  auto const node_pos = cart_info.coords;
-  auto const global_halo_offset = hadamard_product(node_pos, cell_grid) - halo;
-  auto const global_size = hadamard_product(node_grid, cell_grid);
+  auto const global_halo_offset = cell_offset - halo;
+  auto const global_size = global_cell_grid;
 
   /* Translate a node local index (relative to the origin of the local grid)
    * to a global index. */
@@ -418,6 +500,28 @@ void RegularDecomposition::init_cell_interactions() {
     return (global_index - global_halo_offset);
   };
 
+  /* Whether a cell is inside the local cell grid. */
+  auto is_local = [&](Utils::Vector3i const &local_index) {
+    for (int i = 0; i < 3; i++) {
+      if (local_index[i] < 1 or local_index[i] > cell_grid[i])
+        return false;
+    }
+    return true;
+  };
+
+  /* Whether a ghost cell is imported by the half-shell communication:
+   * the last direction in which it leaves the local cell grid is an
+   * upper one. */
+  auto in_upper_half_shell = [&](Utils::Vector3i const &local_index) {
+    for (int i = 2; i >= 0; i--) {
+      if (local_index[i] > cell_grid[i])
+        return true;
+      if (local_index[i] < 1)
+        return false;
+    }
+    return false;
+  };
+
   /* We only consider local cells (e.g. not halo cells), which
    * span the range [(1,1,1), cell_grid) in local coordinates. */
   auto const start = global_index(Utils::Vector3i{1, 1, 1});
@@ -482,6 +586,14 @@ void RegularDecomposition::init_cell_interactions() {
 
           auto cell = &cells.at(
               get_linear_index(local_index(neighbor), ghost_cell_grid));
+          if (m_half_shell and not is_local(local_index(neighbor))) {
+            /* Pairs with ghosts of the lower half shell are
+             * computed on the node that owns the other cell. */
+            if (in_upper_half_shell(local_index(neighbor))) {
+              red_neighbors.push_back(cell);
+            }
+            continue;
+          }
           if (ind2 > ind1) {
             red_neighbors.push_back(cell);
           } else {
@@ -515,14 +627,26 @@ void revert_comm_order(GhostCommunicator &comm) {
   }
 }
 
+/** Whether two communications touch a common cell. */
+bool share_cells(GhostCommunication const &a, GhostCommunication const &b) {
+  std::unordered_set<ParticleList const *> const cells(a.part_lists.begin(),
+                                                       a.part_lists.end());
+  return std::any_of(
+      b.part_lists.begin(), b.part_lists.end(),
+      [&cells](ParticleList const *pl) { return cells.count(pl) != 0; });
+}
+
 /** Of every two communication rounds, set the first receivers to prefetch and
- *  poststore
+ *  poststore. The send buffer is then filled before the data is received,
+ *  which requires that the two rounds touch different cells.
  */
 void assign_prefetches(GhostCommunicator &comm) {
-  for (auto it = comm.communications.begin(); it != comm.communications.end();
-       it += 2) {
+  auto const n_comms = comm.communications.size();
+  for (std::size_t i = 0; i + 1 < n_comms; i += 2) {
+    auto it = std::next(comm.communications.begin(), i);
     auto next = std::next(it);
-    if (it->type == GHOST_RECV && next->type == GHOST_SEND) {
+    if (it->type == GHOST_RECV && next->type == GHOST_SEND &&
+        not share_cells(*it, *next)) {
       it->type |= GHOST_PREFETCH | GHOST_PSTSTORE;
       next->type |= GHOST_PREFETCH | GHOST_PSTSTORE;
     }
@@ -532,16 +656,23 @@ void assign_prefetches(GhostCommunicator &comm) {
 } // namespace
 
 GhostCommunicator RegularDecomposition::prepare_comm() {
-  int dir, lr, i, cnt, n_comm_cells[3];
-  Utils::Vector3i lc{}, hc{}, done{};
+  int dir, lr, i, cnt;
 
   auto const comm_info = Utils::Mpi::cart_get<3>(m_comm);
   auto const node_neighbors = Utils::Mpi::cart_neighbors<3>(m_comm);
 
+  /* In the half-shell import, nothing is received from below in the
+   * last direction. */
+  auto const skip = [this](int dir, int lr) {
+    return m_half_shell and dir == 2 and lr == 1;
+  };
+
   /* calculate number of communications */
   std::size_t num = 0;
   for (dir = 0; dir < 3; dir++) {
     for (lr = 0; lr < 2; lr++) {
+      if (skip(dir, lr))
+        continue;
       /* No communication for border of non periodic direction */
       if (comm_info.dims[dir] == 1)
         num++;
@@ -553,44 +684,61 @@ GhostCommunicator RegularDecomposition::prepare_comm() {
   /* prepare communicator */
   auto ghost_comm = GhostCommunicator{m_comm, num};
 
-  /* number of cells to communicate in a direction */
-  n_comm_cells[0] = cell_grid[1] * cell_grid[2];
-  n_comm_cells[1] = cell_grid[2] * ghost_cell_grid[0];
-  n_comm_cells[2] = ghost_cell_grid[0] * ghost_cell_grid[1];
+  /* Cells to communicate in a direction: the cell layer @p layer, extended
+   * by the ghost layers of the directions already communicated. With the
+   * half-shell import, the layers sent upwards (lr = 1) are only needed
+   * where they are forwarded downwards in a later direction, i.e. next to
+   * the lowest local layer of that direction. */
+  auto const comm_cells = [this](int dir, int lr, int layer) {
+    Utils::Vector3i lc{}, hc{};
+    for (int j = 0; j < 3; j++) {
+      lc[j] = (j < dir) ? 0 : 1;
+      hc[j] = (j < dir) ? cell_grid[j] + 1 : cell_grid[j];
+    }
+    lc[dir] = hc[dir] = layer;
+
+    std::vector<ParticleList *> part_lists;
+    auto const append = [&]() {
+      auto const offset = part_lists.size();
+      part_lists.resize(offset + static_cast<std::size_t>(Utils::product(
+                                     hc - lc + Utils::Vector3i{1, 1, 1})));
+      fill_comm_cell_lists(part_lists.data() + offset, lc, hc);
+    };
+
+    if (not m_half_shell or lr == 0) {
+      append();
+    } else {
+      for (int j = dir + 1; j < 3; j++) {
+        lc[j] = hc[j] = 1;
+        append();
+        lc[j] = 2;
+        hc[j] = cell_grid[j];
+      }
+    }
+    return part_lists;
+  };
 
   cnt = 0;
   /* direction loop: x, y, z */
   for (dir = 0; dir < 3; dir++) {
-    lc[(dir + 1) % 3] = 1 - done[(dir + 1) % 3];
-    lc[(dir + 2) % 3] = 1 - done[(dir + 2) % 3];
-    hc[(dir + 1) % 3] = cell_grid[(dir + 1) % 3] + done[(dir + 1) % 3];
-    hc[(dir + 2) % 3] = cell_grid[(dir + 2) % 3] + done[(dir + 2) % 3];
     /* lr loop: left right */
-    /* here we could in principle build in a one sided ghost
-       communication, simply by taking the lr loop only over one
-       value */
     for (lr = 0; lr < 2; lr++) {
+      if (skip(dir, lr))
+        continue;
+      auto const send_layer = 1 + lr * (cell_grid[dir] - 1);
+      auto const recv_layer = (1 - lr) * (cell_grid[dir] + 1);
       if (comm_info.dims[dir] == 1) {
         /* just copy cells on a single node */
         ghost_comm.communications[cnt].type = GHOST_LOCL;
         ghost_comm.communications[cnt].node = m_comm.rank();
 
-        /* Buffer has to contain Send and Recv cells -> factor 2 */
-        ghost_comm.communications[cnt].part_lists.resize(2 * n_comm_cells[dir]);
-
-        /* fill send ghost_comm cells */
-        lc[dir] = hc[dir] = 1 + lr * (cell_grid[dir] - 1);
-
-        fill_comm_cell_lists(ghost_comm.communications[cnt].part_lists.data(),
-                             lc, hc);
-
-        /* fill recv ghost_comm cells */
-        lc[dir] = hc[dir] = 0 + (1 - lr) * (cell_grid[dir] + 1);
-
-        /* place receive cells after send cells */
-        fill_comm_cell_lists(
-            &ghost_comm.communications[cnt].part_lists[n_comm_cells[dir]], lc,
-            hc);
+        /* Buffer has to contain Send and Recv cells: place receive cells
+         * after send cells */
+        auto &part_lists = ghost_comm.communications[cnt].part_lists;
+        part_lists = comm_cells(dir, lr, send_layer);
+        auto const recv_cells = comm_cells(dir, lr, recv_layer);
+        part_lists.insert(part_lists.end(), recv_cells.begin(),
+                          recv_cells.end());
 
         cnt++;
       } else {
@@ -599,30 +747,20 @@ GhostCommunicator RegularDecomposition::prepare_comm() {
           if ((comm_info.coords[dir] + i) % 2 == 0) {
             ghost_comm.communications[cnt].type = GHOST_SEND;
             ghost_comm.communications[cnt].node = node_neighbors[2 * dir + lr];
-            ghost_comm.communications[cnt].part_lists.resize(n_comm_cells[dir]);
-            /* prepare folding of ghost positions */
-
-            lc[dir] = hc[dir] = 1 + lr * (cell_grid[dir] - 1);
-
-            fill_comm_cell_lists(
-                ghost_comm.communications[cnt].part_lists.data(), lc, hc);
+            ghost_comm.communications[cnt].part_lists =
+                comm_cells(dir, lr, send_layer);
             cnt++;
           }
           if ((comm_info.coords[dir] + (1 - i)) % 2 == 0) {
             ghost_comm.communications[cnt].type = GHOST_RECV;
             ghost_comm.communications[cnt].node =
                 node_neighbors[2 * dir + (1 - lr)];
-            ghost_comm.communications[cnt].part_lists.resize(n_comm_cells[dir]);
-
-            lc[dir] = hc[dir] = (1 - lr) * (cell_grid[dir] + 1);
-
-            fill_comm_cell_lists(
-                ghost_comm.communications[cnt].part_lists.data(), lc, hc);
+            ghost_comm.communications[cnt].part_lists =
+                comm_cells(dir, lr, recv_layer);
             cnt++;
           }
         }
       }
-      done[dir] = 1;
     }
   }
 
@@ -632,11 +770,23 @@ GhostCommunicator RegularDecomposition::prepare_comm() {
 RegularDecomposition::RegularDecomposition(boost::mpi::communicator comm,
                                            double range,
                                            BoxGeometry const &box_geo,
-                                           LocalBox<double> const &local_geo)
-    : m_comm(std::move(comm)), m_box(box_geo), m_local_box(local_geo) {
+                                           LocalBox<double> const &local_geo,
+                                           bool space_filling_curve,
+                                           bool half_shell)
+    : m_comm(std::move(comm)), m_box(box_geo), m_local_box(local_geo),
+      m_space_filling_curve(space_filling_curve), m_half_shell(half_shell) {
   /* set up new regular decomposition cell structure */
   create_cell_grid(range);
 
+  /* The half shell needs distinct periodic images of the neighbor cells,
+   * otherwise a pair could be found in the upper half shell of both
+   * of its cells. */
+  for (unsigned int i = 0; i < 3; i++) {
+    if (m_box.periodic(i) and global_cell_grid[i] < 3) {
+      m_half_shell = false;
+    }
+  }
+
   /* setup cell neighbors */
   init_cell_interactions();
 
@@ -64,6 +64,18 @@
  * blue). Caution: This implementation needs double sided ghost
  * communication! For single sided ghost communication one would need
  * some ghost-ghost cell interaction as well, which we do not need!
+ *
+ * With the half-shell import, the pairs between local and ghost cells
+ * are instead chosen by their direction: a local cell interacts with a
+ * ghost cell only if the ghost lies in the upper half shell, i.e. if the
+ * last direction in which it leaves the local cell grid is an upper one.
+ * The node that owns the ghost finds the pair in the lower half shell
+ * and skips it. Only these ghost cells are communicated,
+ * together with the lower ghost cells that are forwarded to the corners
+ * of the half shell, which roughly halves the ghost volume. Pairs are
+ * not found between local particles and the ghosts of the lower half
+ * shell, hence bonds and neighbor searches across these boundaries are
+ * not supported.
  */
 struct RegularDecomposition : public ParticleDecomposition {
   /** Grid dimensions per node. */
@@ -72,6 +84,8 @@ struct RegularDecomposition : public ParticleDecomposition {
   Utils::Vector3d cell_size = {};
   /** Offset in global grid */
   Utils::Vector3i cell_offset = {};
+  /** Dimensions of the global grid */
+  Utils::Vector3i global_cell_grid = {};
   /** linked cell grid with ghost frame. */
   Utils::Vector3i ghost_cell_grid = {};
   /** inverse @ref RegularDecomposition::cell_size "cell_size". */
@@ -85,11 +99,23 @@ struct RegularDecomposition : public ParticleDecomposition {
   std::vector<Cell *> m_ghost_cells;
   GhostCommunicator m_exchange_ghosts_comm;
   GhostCommunicator m_collect_ghost_force_comm;
+  /** Order cells and particles along a space-filling curve. */
+  bool m_space_filling_curve;
+  /** Import the ghosts of the upper half shell only. */
+  bool m_half_shell;
 
 public:
   RegularDecomposition(boost::mpi::communicator comm, double range,
                        BoxGeometry const &box_geo,
-                       LocalBox<double> const &local_geo);
+                       LocalBox<double> const &local_geo,
+                       bool space_filling_curve = false,
+                       bool half_shell = false);
+
+  /** Whether the ghosts of the upper half shell only are imported.
+   *  This requires at least 3 cells in each periodic direction
+   *  of the global cell grid.
+   */
+  bool half_shell() const { return m_half_shell; }
 
   GhostCommunicator const &exchange_ghosts_comm() const override {
     return m_exchange_ghosts_comm;
@@ -125,10 +151,21 @@ public:
 
 private:
   /** Fill @c m_local_cells list and @c m_ghost_cells list for use with regular
-   *  decomposition.
+   *  decomposition. With @c m_space_filling_curve, the local cells are
+   *  ordered by their Morton index instead of their linear index.
    */
   void mark_cells();
 
+  /**
+   * @brief Order the particles of each local cell along the Z-order curve.
+   *
+   * Particles that are close in space are then also close in memory.
+   * The curve is sampled on a grid of 1024 points per cell and direction.
+   *
+   * @param[out] modified_cells Local cells that were reordered.
+   */
+  void sort_particles(std::vector<ParticleChange> &modified_cells);
+
   /** Fill a communication cell pointer list. Fill the cell pointers of
    *  all cells which are inside a rectangular subgrid of the 3D cell
    *  grid starting from the
@@ -202,6 +239,18 @@ private:
    */
   void create_cell_grid(double range);
 
+  /**
+   *  @brief Align the cell grids of the nodes.
+   *
+   *  Neighboring nodes exchange whole faces of their cell grids, hence all
+   *  nodes in a slab of the node grid need the same number of cells along
+   *  the slab normal. This only changes the cell grid when the local boxes
+   *  have different sizes, in which case each slab takes the smallest
+   *  number of cells of its nodes. Sets @c cell_grid, @c cell_offset and
+   *  @c global_cell_grid.
+   */
+  void align_cell_grid();
+
   /** Init cell interactions for cell system regular decomposition.
    *  Initializes the interacting neighbor cell list of a cell.
    *  This list of interacting neighbor cells is used by the Verlet
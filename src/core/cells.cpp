@@ -33,12 +33,17 @@
 #include "cell_system/HybridDecomposition.hpp"
 
 #include "Particle.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "collision.hpp"
 #include "communication.hpp"
+#include "config/config.hpp"
 #include "errorhandling.hpp"
 #include "event.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
 #include "particle_node.hpp"
+#include "virtual_sites.hpp"
+#include "virtual_sites/VirtualSitesOff.hpp"
 
 #include <utils/Vector.hpp>
 #include <utils/math/sqr.hpp>
@@ -49,6 +54,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <memory>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -109,6 +115,10 @@ static void search_distance_sanity_check_cell_structure(double const distance) {
     throw std::runtime_error("Cannot search for neighbors in the hybrid "
                              "decomposition cell system");
   }
+  if (cell_structure.has_half_shell_ghosts()) {
+    throw std::runtime_error("Cannot search for neighbors with the "
+                             "half-shell ghost import");
+  }
 }
 static void search_neighbors_sanity_checks(double const distance) {
   search_distance_sanity_check_max_range(distance);
@@ -229,6 +239,34 @@ void cells_re_init(CellStructureType new_cs) {
   on_cell_structure_change();
 }
 
+void cells_sanity_checks() {
+  if (cell_structure.use_compact_verlet_list and
+      not(cell_structure.use_hot_particle_data and
+          cell_structure.use_verlet_list)) {
+    runtimeErrorMsg() << "Compact Verlet lists require the hot particle "
+                         "data and Verlet lists";
+  }
+  if (not cell_structure.has_half_shell_ghosts()) {
+    return;
+  }
+  if (not bonded_ia_params.empty()) {
+    runtimeErrorMsg() << "Bonded interactions are not supported with the "
+                         "half-shell ghost import";
+  }
+#ifdef VIRTUAL_SITES
+  if (not std::dynamic_pointer_cast<VirtualSitesOff>(virtual_sites())) {
+    runtimeErrorMsg() << "Virtual sites are not supported with the "
+                         "half-shell ghost import";
+  }
+#endif
+#ifdef COLLISION_DETECTION
+  if (collision_params.mode != CollisionModeType::OFF) {
+    runtimeErrorMsg() << "Collision detection is not supported with the "
+                         "half-shell ghost import";
+  }
+#endif
+}
+
 void check_resort_particles() {
   auto const level = (cell_structure.check_resort_required(
                          cell_structure.local_particles(), skin))
@@ -238,7 +276,7 @@ void check_resort_particles() {
   cell_structure.set_resort_particles(level);
 }
 
-void cells_update_ghosts(unsigned data_parts) {
+void cells_update_ghosts(unsigned data_parts, bool overlap) {
   /* data parts that are only updated on resort */
   auto constexpr resort_only_parts =
       Cells::DATA_PART_PROPERTIES | Cells::DATA_PART_BONDS;
@@ -269,7 +307,11 @@ void cells_update_ghosts(unsigned data_parts) {
     cell_structure.clear_resort_particles();
   } else {
     /* Communication step: ghost information */
-    cell_structure.ghosts_update(data_parts & ~resort_only_parts);
+    if (overlap) {
+      cell_structure.ghosts_update_begin(data_parts & ~resort_only_parts);
+    } else {
+      cell_structure.ghosts_update(data_parts & ~resort_only_parts);
+    }
   }
 }
 
@@ -91,8 +91,11 @@ void cells_re_init(CellStructureType new_cs);
 
 /** Update ghost information. If needed,
  *  the particles are also resorted.
+ *  @param data_parts Particle parts to update.
+ *  @param overlap    If no resort is needed, only start the ghost update,
+ *                    see @ref CellStructure::ghosts_update_begin.
  */
-void cells_update_ghosts(unsigned data_parts);
+void cells_update_ghosts(unsigned data_parts, bool overlap = false);
 
 /**
  * @brief Get pairs closer than @p distance from the cells.
@@ -109,6 +112,13 @@ std::vector<std::pair<int, int>> get_pairs(double distance);
 std::vector<std::pair<int, int>>
 get_pairs_of_types(double distance, std::vector<int> const &types);
 
+/** Check that the settings of the cell system can be used, i.e. that
+ *  the compact Verlet lists come with the hot particle data, and that no
+ *  bonds, virtual sites or collision detection need the ghosts that the
+ *  half-shell ghost import leaves out.
+ */
+void cells_sanity_checks();
+
 /** Check if a particle resorting is required. */
 void check_resort_particles();
 
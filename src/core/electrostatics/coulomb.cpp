@@ -155,6 +155,9 @@ struct ShortRangeCutoff : public boost::static_visitor<double> {
   auto operator()(std::shared_ptr<CoulombMMM1D> const &actor) const {
     return std::numeric_limits<double>::infinity();
   }
+  auto operator()(std::shared_ptr<CoulombFMM> const &actor) const {
+    return actor->r_cut;
+  }
 #ifdef SCAFACOS
   auto operator()(std::shared_ptr<CoulombScafacos> const &actor) const {
     return actor->get_r_cut();
@@ -237,6 +240,9 @@ struct LongRangeForce : public boost::static_visitor<void> {
     actor->add_long_range_forces();
   }
 #endif
+  void operator()(std::shared_ptr<CoulombFMM> const &actor) const {
+    actor->add_long_range_forces(m_particles);
+  }
   /* Several algorithms only provide near-field kernels */
   void operator()(std::shared_ptr<CoulombMMM1D> const &) const {}
   void operator()(std::shared_ptr<DebyeHueckel> const &) const {}
@@ -271,6 +277,9 @@ struct LongRangeEnergy : public boost::static_visitor<double> {
     return actor->long_range_energy();
   }
 #endif
+  auto operator()(std::shared_ptr<CoulombFMM> const &actor) const {
+    return actor->long_range_energy(m_particles);
+  }
   /* Several algorithms only provide near-field kernels */
   auto operator()(std::shared_ptr<CoulombMMM1D> const &) const { return 0.; }
   auto operator()(std::shared_ptr<DebyeHueckel> const &) const { return 0.; }
@@ -27,6 +27,7 @@
 
 #include "electrostatics/debye_hueckel.hpp"
 #include "electrostatics/elc.hpp"
+#include "electrostatics/fmm.hpp"
 #include "electrostatics/icc.hpp"
 #include "electrostatics/mmm1d.hpp"
 #include "electrostatics/mmm1d_gpu.hpp"
@@ -57,6 +58,7 @@ using ElectrostaticsActor =
                    std::shared_ptr<ElectrostaticLayerCorrection>,
 #endif // P3M
                    std::shared_ptr<CoulombMMM1D>,
+                   std::shared_ptr<CoulombFMM>,
 #ifdef MMM1D_GPU
                    std::shared_ptr<CoulombMMM1DGpu>,
 #endif // MMM1D_GPU
@@ -111,6 +113,7 @@ template <> struct has_pressure<CoulombMMM1DGpu> : std::false_type {};
 template <> struct has_pressure<CoulombScafacos> : std::false_type {};
 #endif // SCAFACOS
 template <> struct has_pressure<CoulombMMM1D> : std::false_type {};
+template <> struct has_pressure<CoulombFMM> : std::false_type {};
 
 } // namespace traits
 
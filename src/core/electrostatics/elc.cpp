@@ -80,6 +80,8 @@ enum class ChargeProtocol : int { REAL, IMAGE, BOTH };
 static std::vector<double> partblk;
 /** collected data from the other cells */
 static double gblcblk[8];
+/** collected far-field data of all frequencies, see @ref FarFieldMode */
+static std::vector<double> far_gblcblk;
 
 /** structure for caching sin and cos values */
 struct SCCache {
@@ -95,6 +97,10 @@ static std::vector<SCCache> scycache;
 /**
  * @brief Calculate cached sin/cos values for one direction.
  *
+ * Only the fundamental frequency is evaluated with the trigonometric
+ * functions; the higher harmonics follow from the angle addition theorem
+ * in one contiguous sweep over all particles per frequency.
+ *
  * @tparam dir Index of the dimension to consider (e.g. 0 for x ...).
  *
  * @param particles Particle to calculate values for
@@ -108,14 +114,24 @@ static std::vector<SCCache> calc_sc_cache(ParticleRange const &particles,
   auto constexpr c_2pi = 2. * Utils::pi();
   auto const n_part = particles.size();
   std::vector<SCCache> ret(n_freq * n_part);
+  if (n_freq == 0) {
+    return ret;
+  }
 
-  for (std::size_t freq = 1; freq <= n_freq; freq++) {
-    auto const pref = c_2pi * u * static_cast<double>(freq);
+  auto const pref = c_2pi * u;
+  std::size_t o = 0;
+  for (auto const &p : particles) {
+    auto const arg = pref * p.pos()[dir];
+    ret[o++] = {sin(arg), cos(arg)};
+  }
 
-    std::size_t o = (freq - 1) * n_part;
-    for (auto const &p : particles) {
-      auto const arg = pref * p.pos()[dir];
-      ret[o++] = {sin(arg), cos(arg)};
+  auto const *const base = ret.data();
+  for (std::size_t freq = 2; freq <= n_freq; freq++) {
+    auto const *const prev = base + (freq - 2) * n_part;
+    auto *const next = ret.data() + (freq - 1) * n_part;
+    for (std::size_t ic = 0; ic < n_part; ic++) {
+      next[ic].s = prev[ic].s * base[ic].c + prev[ic].c * base[ic].s;
+      next[ic].c = prev[ic].c * base[ic].c - prev[ic].s * base[ic].s;
     }
   }
 
@@ -136,6 +152,65 @@ prepare_sc_cache(ParticleRange const &particles, double far_cut) {
   return {n_freq_x, n_freq_y};
 }
 
+/** @brief Frequency of the far-field sum. */
+struct FarFieldMode {
+  /** frequency index along x, 0 for the q-only modes */
+  std::size_t p;
+  /** frequency index along y, 0 for the p-only modes */
+  std::size_t q;
+  double omega;
+  /** position of the mode block in @ref far_gblcblk */
+  std::size_t offset;
+  /** number of block entries: 4 for the p- or q-only modes, 8 otherwise */
+  std::size_t size() const { return (p == 0 or q == 0) ? 4 : 8; }
+};
+
+/**
+ * @brief List all far-field frequencies within the cutoff.
+ * The p-only modes come first, then the q-only modes and finally
+ * the mixed modes.
+ */
+static std::vector<FarFieldMode> far_field_modes(double far_cut,
+                                                 double far_cut2,
+                                                 std::size_t n_scxcache,
+                                                 std::size_t n_scycache) {
+  auto constexpr c_2pi = 2. * Utils::pi();
+  auto const u_x = box_geo.length_inv()[0];
+  auto const u_y = box_geo.length_inv()[1];
+  std::vector<FarFieldMode> modes;
+  std::size_t offset = 0;
+  auto const add_mode = [&modes, &offset](std::size_t p, std::size_t q,
+                                          double omega) {
+    modes.push_back({p, q, omega, offset});
+    offset += modes.back().size();
+  };
+
+  /* the second condition is just for the case of numerical accident */
+  for (std::size_t p = 1;
+       u_x * static_cast<double>(p - 1) < far_cut && p <= n_scxcache; p++) {
+    add_mode(p, 0, c_2pi * u_x * static_cast<double>(p));
+  }
+  for (std::size_t q = 1;
+       u_y * static_cast<double>(q - 1) < far_cut && q <= n_scycache; q++) {
+    add_mode(0, q, c_2pi * u_y * static_cast<double>(q));
+  }
+  for (std::size_t p = 1;
+       u_x * static_cast<double>(p - 1) < far_cut && p <= n_scxcache; p++) {
+    for (std::size_t q = 1;
+         Utils::sqr(u_x * static_cast<double>(p - 1)) +
+                 Utils::sqr(u_y * static_cast<double>(q - 1)) <
+             far_cut2 &&
+         q <= n_scycache;
+         q++) {
+      add_mode(p, q,
+               c_2pi * sqrt(Utils::sqr(u_x * static_cast<double>(p)) +
+                            Utils::sqr(u_y * static_cast<double>(q))));
+    }
+  }
+
+  return modes;
+}
+
 /*****************************************************************/
 /* data distribution */
 /*****************************************************************/
@@ -179,6 +254,14 @@ static void distribute(std::size_t size) {
                          std::plus<>());
 }
 
+/** Reduce the blocks of all far-field frequencies in one collective. */
+static void distribute_far_field() {
+  auto const send_buf = far_gblcblk;
+  boost::mpi::all_reduce(comm_cart, send_buf.data(),
+                         static_cast<int>(send_buf.size()), far_gblcblk.data(),
+                         std::plus<>());
+}
+
 void ElectrostaticLayerCorrection::check_gap(Particle const &p) const {
   if (p.q() != 0.) {
     auto const z = p.pos()[2];
@@ -482,9 +565,31 @@ void ElectrostaticLayerCorrection::add_z_force(
 
 /** \name q=0 or p=0 per frequency code */
 /**@{*/
+template <PoQ axis>
+static void setup_PoQ_partblk(std::size_t index, double omega,
+                              ParticleRange const &particles) {
+  assert(index >= 1);
+  constexpr std::size_t size = 4;
+  auto const &sc_cache = (axis == PoQ::P) ? scxcache : scycache;
+
+  std::size_t ic = 0;
+  auto const o = (index - 1) * particles.size();
+  for (auto const &p : particles) {
+    auto const q = p.q();
+    auto const e = exp(omega * p.pos()[2]);
+
+    partblk[size * ic + POQESM] = q * sc_cache[o + ic].s / e;
+    partblk[size * ic + POQESP] = q * sc_cache[o + ic].s * e;
+    partblk[size * ic + POQECM] = q * sc_cache[o + ic].c / e;
+    partblk[size * ic + POQECP] = q * sc_cache[o + ic].c * e;
+
+    ++ic;
+  }
+}
+
 template <PoQ axis>
 void setup_PoQ(elc_data const &elc, double prefactor, std::size_t index,
-               double omega, ParticleRange const &particles) {
+               double omega, ParticleRange const &particles, double *blk) {
   assert(index >= 1);
   constexpr std::size_t size = 4;
   auto const xy_area_inv = box_geo.length_inv()[0] * box_geo.length_inv()[1];
@@ -501,25 +606,22 @@ void setup_PoQ(elc_data const &elc, double prefactor, std::size_t index,
     fac_delta = fac_delta_mid_bot * elc.delta_mid_top;
   }
 
+  setup_PoQ_partblk<axis>(index, omega, particles);
+
   clear_vec(lclimge, size);
-  clear_vec(gblcblk, size);
+  clear_vec(blk, size);
   auto const &sc_cache = (axis == PoQ::P) ? scxcache : scycache;
 
   std::size_t ic = 0;
   auto const o = (index - 1) * particles.size();
   for (auto const &p : particles) {
-    auto const z = p.pos()[2];
-    auto const q = p.q();
-    auto e = exp(omega * z);
-
-    partblk[size * ic + POQESM] = q * sc_cache[o + ic].s / e;
-    partblk[size * ic + POQESP] = q * sc_cache[o + ic].s * e;
-    partblk[size * ic + POQECM] = q * sc_cache[o + ic].c / e;
-    partblk[size * ic + POQECP] = q * sc_cache[o + ic].c * e;
-
-    add_vec(gblcblk, gblcblk, block(partblk.data(), ic, size), size);
+    add_vec(blk, blk, block(partblk.data(), ic, size), size);
 
     if (elc.dielectric_contrast_on) {
+      auto const z = p.pos()[2];
+      auto const q = p.q();
+      double e;
+
       if (z < elc.space_layer) { // handle the lower case first
         // negative sign is okay here as the image is located at -z
 
@@ -532,7 +634,7 @@ void setup_PoQ(elc_data const &elc, double prefactor, std::size_t index,
         lclimgebot[POQECM] = sc_cache[o + ic].c / e;
         lclimgebot[POQECP] = sc_cache[o + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgebot, gblcblk, size);
+        addscale_vec(blk, scale, lclimgebot, blk, size);
 
         e = (exp(omega * (-z - 2. * elc.box_h)) * elc.delta_mid_bot +
              exp(omega * (+z - 2. * elc.box_h))) *
@@ -556,7 +658,7 @@ void setup_PoQ(elc_data const &elc, double prefactor, std::size_t index,
         lclimgetop[POQECM] = sc_cache[o + ic].c / e;
         lclimgetop[POQECP] = sc_cache[o + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgetop, gblcblk, size);
+        addscale_vec(blk, scale, lclimgetop, blk, size);
 
         e = (exp(omega * (+z - 4. * elc.box_h)) * elc.delta_mid_top +
              exp(omega * (-z - 2. * elc.box_h))) *
@@ -574,42 +676,43 @@ void setup_PoQ(elc_data const &elc, double prefactor, std::size_t index,
     ++ic;
   }
 
-  scale_vec(pref, gblcblk, size);
+  scale_vec(pref, blk, size);
 
   if (elc.dielectric_contrast_on) {
     scale_vec(pref_di, lclimge, size);
-    add_vec(gblcblk, gblcblk, lclimge, size);
+    add_vec(blk, blk, lclimge, size);
   }
 }
 
-template <PoQ axis> void add_PoQ_force(ParticleRange const &particles) {
+template <PoQ axis>
+void add_PoQ_force(ParticleRange const &particles, double const *blk) {
   constexpr auto i = static_cast<int>(axis);
   constexpr std::size_t size = 4;
 
   std::size_t ic = 0;
   for (auto &p : particles) {
     auto &force = p.force();
-    force[i] += partblk[size * ic + POQESM] * gblcblk[POQECP] -
-                partblk[size * ic + POQECM] * gblcblk[POQESP] +
-                partblk[size * ic + POQESP] * gblcblk[POQECM] -
-                partblk[size * ic + POQECP] * gblcblk[POQESM];
-    force[2] += partblk[size * ic + POQECM] * gblcblk[POQECP] +
-                partblk[size * ic + POQESM] * gblcblk[POQESP] -
-                partblk[size * ic + POQECP] * gblcblk[POQECM] -
-                partblk[size * ic + POQESP] * gblcblk[POQESM];
+    force[i] += partblk[size * ic + POQESM] * blk[POQECP] -
+                partblk[size * ic + POQECM] * blk[POQESP] +
+                partblk[size * ic + POQESP] * blk[POQECM] -
+                partblk[size * ic + POQECP] * blk[POQESM];
+    force[2] += partblk[size * ic + POQECM] * blk[POQECP] +
+                partblk[size * ic + POQESM] * blk[POQESP] -
+                partblk[size * ic + POQECP] * blk[POQECM] -
+                partblk[size * ic + POQESP] * blk[POQESM];
     ++ic;
   }
 }
 
-static double PoQ_energy(double omega, std::size_t n_part) {
+static double PoQ_energy(double omega, std::size_t n_part, double const *blk) {
   constexpr std::size_t size = 4;
 
   auto energy = 0.;
   for (std::size_t ic = 0; ic < n_part; ic++) {
-    energy += partblk[size * ic + POQECM] * gblcblk[POQECP] +
-              partblk[size * ic + POQESM] * gblcblk[POQESP] +
-              partblk[size * ic + POQECP] * gblcblk[POQECM] +
-              partblk[size * ic + POQESP] * gblcblk[POQESM];
+    energy += partblk[size * ic + POQECM] * blk[POQECP] +
+              partblk[size * ic + POQESM] * blk[POQESP] +
+              partblk[size * ic + POQECP] * blk[POQECM] +
+              partblk[size * ic + POQESP] * blk[POQESM];
   }
 
   return energy / omega;
@@ -622,35 +725,18 @@ static double PoQ_energy(double omega, std::size_t n_part) {
 
 /** \name p,q <> 0 per frequency code */
 /**@{*/
-static void setup_PQ(elc_data const &elc, double prefactor, std::size_t index_p,
-                     std::size_t index_q, double omega,
-                     ParticleRange const &particles) {
+static void setup_PQ_partblk(std::size_t index_p, std::size_t index_q,
+                             double omega, ParticleRange const &particles) {
   assert(index_p >= 1);
   assert(index_q >= 1);
   constexpr std::size_t size = 8;
-  auto const xy_area_inv = box_geo.length_inv()[0] * box_geo.length_inv()[1];
-  auto const pref_di = prefactor * 8 * Utils::pi() * xy_area_inv;
-  auto const pref = -pref_di / expm1(omega * box_geo.length()[2]);
-  double lclimgebot[8], lclimgetop[8], lclimge[8];
-  double fac_delta_mid_bot = 1, fac_delta_mid_top = 1, fac_delta = 1;
-  if (elc.dielectric_contrast_on) {
-    auto const delta = elc.delta_mid_top * elc.delta_mid_bot;
-    auto const fac_elc = 1. / (1. - delta * exp(-omega * 2. * elc.box_h));
-    fac_delta_mid_bot = elc.delta_mid_bot * fac_elc;
-    fac_delta_mid_top = elc.delta_mid_top * fac_elc;
-    fac_delta = fac_delta_mid_bot * elc.delta_mid_top;
-  }
-
-  clear_vec(lclimge, size);
-  clear_vec(gblcblk, size);
 
   std::size_t ic = 0;
   auto const ox = (index_p - 1) * particles.size();
   auto const oy = (index_q - 1) * particles.size();
   for (auto const &p : particles) {
-    auto const z = p.pos()[2];
     auto const q = p.q();
-    auto e = exp(omega * z);
+    auto const e = exp(omega * p.pos()[2]);
 
     partblk[size * ic + PQESSM] =
         scxcache[ox + ic].s * scycache[oy + ic].s * q / e;
@@ -670,9 +756,43 @@ static void setup_PQ(elc_data const &elc, double prefactor, std::size_t index_p,
     partblk[size * ic + PQECCP] =
         scxcache[ox + ic].c * scycache[oy + ic].c * q * e;
 
-    add_vec(gblcblk, gblcblk, block(partblk.data(), ic, size), size);
+    ic++;
+  }
+}
+
+static void setup_PQ(elc_data const &elc, double prefactor, std::size_t index_p,
+                     std::size_t index_q, double omega,
+                     ParticleRange const &particles, double *blk) {
+  constexpr std::size_t size = 8;
+  auto const xy_area_inv = box_geo.length_inv()[0] * box_geo.length_inv()[1];
+  auto const pref_di = prefactor * 8 * Utils::pi() * xy_area_inv;
+  auto const pref = -pref_di / expm1(omega * box_geo.length()[2]);
+  double lclimgebot[8], lclimgetop[8], lclimge[8];
+  double fac_delta_mid_bot = 1, fac_delta_mid_top = 1, fac_delta = 1;
+  if (elc.dielectric_contrast_on) {
+    auto const delta = elc.delta_mid_top * elc.delta_mid_bot;
+    auto const fac_elc = 1. / (1. - delta * exp(-omega * 2. * elc.box_h));
+    fac_delta_mid_bot = elc.delta_mid_bot * fac_elc;
+    fac_delta_mid_top = elc.delta_mid_top * fac_elc;
+    fac_delta = fac_delta_mid_bot * elc.delta_mid_top;
+  }
+
+  setup_PQ_partblk(index_p, index_q, omega, particles);
+
+  clear_vec(lclimge, size);
+  clear_vec(blk, size);
+
+  std::size_t ic = 0;
+  auto const ox = (index_p - 1) * particles.size();
+  auto const oy = (index_q - 1) * particles.size();
+  for (auto const &p : particles) {
+    add_vec(blk, blk, block(partblk.data(), ic, size), size);
 
     if (elc.dielectric_contrast_on) {
+      auto const z = p.pos()[2];
+      auto const q = p.q();
+      double e;
+
       if (z < elc.space_layer) { // handle the lower case first
         // change e to take into account the z position of the images
 
@@ -689,7 +809,7 @@ static void setup_PQ(elc_data const &elc, double prefactor, std::size_t index_p,
         lclimgebot[PQECSP] = scxcache[ox + ic].c * scycache[oy + ic].s * e;
         lclimgebot[PQECCP] = scxcache[ox + ic].c * scycache[oy + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgebot, gblcblk, size);
+        addscale_vec(blk, scale, lclimgebot, blk, size);
 
         e = (exp(omega * (-z - 2. * elc.box_h)) * elc.delta_mid_bot +
              exp(omega * (+z - 2. * elc.box_h))) *
@@ -722,7 +842,7 @@ static void setup_PQ(elc_data const &elc, double prefactor, std::size_t index_p,
         lclimgetop[PQECSP] = scxcache[ox + ic].c * scycache[oy + ic].s * e;
         lclimgetop[PQECCP] = scxcache[ox + ic].c * scycache[oy + ic].c * e;
 
-        addscale_vec(gblcblk, scale, lclimgetop, gblcblk, size);
+        addscale_vec(blk, scale, lclimgetop, blk, size);
 
         e = (exp(omega * (+z - 4. * elc.box_h)) * elc.delta_mid_top +
              exp(omega * (-z - 2. * elc.box_h))) *
@@ -744,15 +864,15 @@ static void setup_PQ(elc_data const &elc, double prefactor, std::size_t index_p,
     ic++;
   }
 
-  scale_vec(pref, gblcblk, size);
+  scale_vec(pref, blk, size);
   if (elc.dielectric_contrast_on) {
     scale_vec(pref_di, lclimge, size);
-    add_vec(gblcblk, gblcblk, lclimge, size);
+    add_vec(blk, blk, lclimge, size);
   }
 }
 
 static void add_PQ_force(std::size_t index_p, std::size_t index_q, double omega,
-                         const ParticleRange &particles) {
+                         const ParticleRange &particles, double const *blk) {
   auto constexpr c_2pi = 2. * Utils::pi();
   auto const pref_x =
       c_2pi * box_geo.length_inv()[0] * static_cast<double>(index_p) / omega;
@@ -763,156 +883,126 @@ static void add_PQ_force(std::size_t index_p, std::size_t index_q, double omega,
   std::size_t ic = 0;
   for (auto &p : particles) {
     auto &force = p.force();
-    force[0] += pref_x * (partblk[size * ic + PQESCM] * gblcblk[PQECCP] +
-                          partblk[size * ic + PQESSM] * gblcblk[PQECSP] -
-                          partblk[size * ic + PQECCM] * gblcblk[PQESCP] -
-                          partblk[size * ic + PQECSM] * gblcblk[PQESSP] +
-                          partblk[size * ic + PQESCP] * gblcblk[PQECCM] +
-                          partblk[size * ic + PQESSP] * gblcblk[PQECSM] -
-                          partblk[size * ic + PQECCP] * gblcblk[PQESCM] -
-                          partblk[size * ic + PQECSP] * gblcblk[PQESSM]);
-    force[1] += pref_y * (partblk[size * ic + PQECSM] * gblcblk[PQECCP] +
-                          partblk[size * ic + PQESSM] * gblcblk[PQESCP] -
-                          partblk[size * ic + PQECCM] * gblcblk[PQECSP] -
-                          partblk[size * ic + PQESCM] * gblcblk[PQESSP] +
-                          partblk[size * ic + PQECSP] * gblcblk[PQECCM] +
-                          partblk[size * ic + PQESSP] * gblcblk[PQESCM] -
-                          partblk[size * ic + PQECCP] * gblcblk[PQECSM] -
-                          partblk[size * ic + PQESCP] * gblcblk[PQESSM]);
-    force[2] += (partblk[size * ic + PQECCM] * gblcblk[PQECCP] +
-                 partblk[size * ic + PQECSM] * gblcblk[PQECSP] +
-                 partblk[size * ic + PQESCM] * gblcblk[PQESCP] +
-                 partblk[size * ic + PQESSM] * gblcblk[PQESSP] -
-                 partblk[size * ic + PQECCP] * gblcblk[PQECCM] -
-                 partblk[size * ic + PQECSP] * gblcblk[PQECSM] -
-                 partblk[size * ic + PQESCP] * gblcblk[PQESCM] -
-                 partblk[size * ic + PQESSP] * gblcblk[PQESSM]);
+    force[0] += pref_x * (partblk[size * ic + PQESCM] * blk[PQECCP] +
+                          partblk[size * ic + PQESSM] * blk[PQECSP] -
+                          partblk[size * ic + PQECCM] * blk[PQESCP] -
+                          partblk[size * ic + PQECSM] * blk[PQESSP] +
+                          partblk[size * ic + PQESCP] * blk[PQECCM] +
+                          partblk[size * ic + PQESSP] * blk[PQECSM] -
+                          partblk[size * ic + PQECCP] * blk[PQESCM] -
+                          partblk[size * ic + PQECSP] * blk[PQESSM]);
+    force[1] += pref_y * (partblk[size * ic + PQECSM] * blk[PQECCP] +
+                          partblk[size * ic + PQESSM] * blk[PQESCP] -
+                          partblk[size * ic + PQECCM] * blk[PQECSP] -
+                          partblk[size * ic + PQESCM] * blk[PQESSP] +
+                          partblk[size * ic + PQECSP] * blk[PQECCM] +
+                          partblk[size * ic + PQESSP] * blk[PQESCM] -
+                          partblk[size * ic + PQECCP] * blk[PQECSM] -
+                          partblk[size * ic + PQESCP] * blk[PQESSM]);
+    force[2] += (partblk[size * ic + PQECCM] * blk[PQECCP] +
+                 partblk[size * ic + PQECSM] * blk[PQECSP] +
+                 partblk[size * ic + PQESCM] * blk[PQESCP] +
+                 partblk[size * ic + PQESSM] * blk[PQESSP] -
+                 partblk[size * ic + PQECCP] * blk[PQECCM] -
+                 partblk[size * ic + PQECSP] * blk[PQECSM] -
+                 partblk[size * ic + PQESCP] * blk[PQESCM] -
+                 partblk[size * ic + PQESSP] * blk[PQESSM]);
     ic++;
   }
 }
 
-static double PQ_energy(double omega, std::size_t n_part) {
+static double PQ_energy(double omega, std::size_t n_part, double const *blk) {
   constexpr std::size_t size = 8;
 
   auto energy = 0.;
   for (std::size_t ic = 0; ic < n_part; ic++) {
-    energy += partblk[size * ic + PQECCM] * gblcblk[PQECCP] +
-              partblk[size * ic + PQECSM] * gblcblk[PQECSP] +
-              partblk[size * ic + PQESCM] * gblcblk[PQESCP] +
-              partblk[size * ic + PQESSM] * gblcblk[PQESSP] +
-              partblk[size * ic + PQECCP] * gblcblk[PQECCM] +
-              partblk[size * ic + PQECSP] * gblcblk[PQECSM] +
-              partblk[size * ic + PQESCP] * gblcblk[PQESCM] +
-              partblk[size * ic + PQESSP] * gblcblk[PQESSM];
+    energy += partblk[size * ic + PQECCM] * blk[PQECCP] +
+              partblk[size * ic + PQECSM] * blk[PQECSP] +
+              partblk[size * ic + PQESCM] * blk[PQESCP] +
+              partblk[size * ic + PQESSM] * blk[PQESSP] +
+              partblk[size * ic + PQECCP] * blk[PQECCM] +
+              partblk[size * ic + PQECSP] * blk[PQECSM] +
+              partblk[size * ic + PQESCP] * blk[PQESCM] +
+              partblk[size * ic + PQESSP] * blk[PQESSM];
   }
   return energy / omega;
 }
 /**@}*/
 
-void ElectrostaticLayerCorrection::add_force(
-    ParticleRange const &particles) const {
-  auto constexpr c_2pi = 2. * Utils::pi();
+/**
+ * @brief Collect the far-field blocks of all frequencies.
+ *
+ * The local blocks of every frequency are accumulated into
+ * @ref far_gblcblk first and then summed over all MPI ranks in a single
+ * reduction, instead of one reduction per frequency. The particle blocks
+ * are not kept: the force and energy loops rebuild them per frequency,
+ * which only costs one exponential per particle and keeps the memory
+ * footprint independent of the number of frequencies.
+ */
+static std::vector<FarFieldMode>
+setup_far_field(elc_data const &elc, double prefactor,
+                ParticleRange const &particles) {
   auto const n_freqs = prepare_sc_cache(particles, elc.far_cut);
-  auto const n_scxcache = std::get<0>(n_freqs);
-  auto const n_scycache = std::get<1>(n_freqs);
+  auto const modes = far_field_modes(elc.far_cut, elc.far_cut2,
+                                     std::get<0>(n_freqs),
+                                     std::get<1>(n_freqs));
   partblk.resize(particles.size() * 8);
+  far_gblcblk.resize(modes.empty() ? 0 : modes.back().offset +
+                                             modes.back().size());
+
+  for (auto const &mode : modes) {
+    auto *const blk = far_gblcblk.data() + mode.offset;
+    if (mode.q == 0) {
+      setup_PoQ<PoQ::P>(elc, prefactor, mode.p, mode.omega, particles, blk);
+    } else if (mode.p == 0) {
+      setup_PoQ<PoQ::Q>(elc, prefactor, mode.q, mode.omega, particles, blk);
+    } else {
+      setup_PQ(elc, prefactor, mode.p, mode.q, mode.omega, particles, blk);
+    }
+  }
+  distribute_far_field();
 
+  return modes;
+}
+
+void ElectrostaticLayerCorrection::add_force(
+    ParticleRange const &particles) const {
   add_dipole_force(particles);
   add_z_force(particles);
 
-  /* the second condition is just for the case of numerical accident */
-  for (std::size_t p = 1;
-       box_geo.length_inv()[0] * static_cast<double>(p - 1) < elc.far_cut &&
-       p <= n_scxcache;
-       p++) {
-    auto const omega = c_2pi * box_geo.length_inv()[0] * static_cast<double>(p);
-    setup_PoQ<PoQ::P>(elc, prefactor, p, omega, particles);
-    distribute(4);
-    add_PoQ_force<PoQ::P>(particles);
-  }
-
-  for (std::size_t q = 1;
-       box_geo.length_inv()[1] * static_cast<double>(q - 1) < elc.far_cut &&
-       q <= n_scycache;
-       q++) {
-    auto const omega = c_2pi * box_geo.length_inv()[1] * static_cast<double>(q);
-    setup_PoQ<PoQ::Q>(elc, prefactor, q, omega, particles);
-    distribute(4);
-    add_PoQ_force<PoQ::Q>(particles);
-  }
-
-  for (std::size_t p = 1;
-       box_geo.length_inv()[0] * static_cast<double>(p - 1) < elc.far_cut &&
-       p <= n_scxcache;
-       p++) {
-    for (std::size_t q = 1;
-         Utils::sqr(box_geo.length_inv()[0] * static_cast<double>(p - 1)) +
-                 Utils::sqr(box_geo.length_inv()[1] *
-                            static_cast<double>(q - 1)) <
-             elc.far_cut2 &&
-         q <= n_scycache;
-         q++) {
-      auto const omega =
-          c_2pi *
-          sqrt(Utils::sqr(box_geo.length_inv()[0] * static_cast<double>(p)) +
-               Utils::sqr(box_geo.length_inv()[1] * static_cast<double>(q)));
-      setup_PQ(elc, prefactor, p, q, omega, particles);
-      distribute(8);
-      add_PQ_force(p, q, omega, particles);
+  auto const modes = setup_far_field(elc, prefactor, particles);
+  for (auto const &mode : modes) {
+    auto const *const blk = far_gblcblk.data() + mode.offset;
+    if (mode.q == 0) {
+      setup_PoQ_partblk<PoQ::P>(mode.p, mode.omega, particles);
+      add_PoQ_force<PoQ::P>(particles, blk);
+    } else if (mode.p == 0) {
+      setup_PoQ_partblk<PoQ::Q>(mode.q, mode.omega, particles);
+      add_PoQ_force<PoQ::Q>(particles, blk);
+    } else {
+      setup_PQ_partblk(mode.p, mode.q, mode.omega, particles);
+      add_PQ_force(mode.p, mode.q, mode.omega, particles, blk);
     }
   }
 }
 
 double ElectrostaticLayerCorrection::calc_energy(
     ParticleRange const &particles) const {
-  auto constexpr c_2pi = 2. * Utils::pi();
   auto energy = dipole_energy(particles) + z_energy(particles);
-  auto const n_freqs = prepare_sc_cache(particles, elc.far_cut);
-  auto const n_scxcache = std::get<0>(n_freqs);
-  auto const n_scycache = std::get<1>(n_freqs);
-
   auto const n_localpart = particles.size();
-  partblk.resize(n_localpart * 8);
-
-  /* the second condition is just for the case of numerical accident */
-  for (std::size_t p = 1;
-       box_geo.length_inv()[0] * static_cast<double>(p - 1) < elc.far_cut &&
-       p <= n_scxcache;
-       p++) {
-    auto const omega = c_2pi * box_geo.length_inv()[0] * static_cast<double>(p);
-    setup_PoQ<PoQ::P>(elc, prefactor, p, omega, particles);
-    distribute(4);
-    energy += PoQ_energy(omega, n_localpart);
-  }
 
-  for (std::size_t q = 1;
-       box_geo.length_inv()[1] * static_cast<double>(q - 1) < elc.far_cut &&
-       q <= n_scycache;
-       q++) {
-    auto const omega = c_2pi * box_geo.length_inv()[1] * static_cast<double>(q);
-    setup_PoQ<PoQ::Q>(elc, prefactor, q, omega, particles);
-    distribute(4);
-    energy += PoQ_energy(omega, n_localpart);
-  }
-
-  for (std::size_t p = 1;
-       box_geo.length_inv()[0] * static_cast<double>(p - 1) < elc.far_cut &&
-       p <= n_scxcache;
-       p++) {
-    for (std::size_t q = 1;
-         Utils::sqr(box_geo.length_inv()[0] * static_cast<double>(p - 1)) +
-                 Utils::sqr(box_geo.length_inv()[1] *
-                            static_cast<double>(q - 1)) <
-             elc.far_cut2 &&
-         q <= n_scycache;
-         q++) {
-      auto const omega =
-          c_2pi *
-          sqrt(Utils::sqr(box_geo.length_inv()[0] * static_cast<double>(p)) +
-               Utils::sqr(box_geo.length_inv()[1] * static_cast<double>(q)));
-      setup_PQ(elc, prefactor, p, q, omega, particles);
-      distribute(8);
-      energy += PQ_energy(omega, n_localpart);
+  auto const modes = setup_far_field(elc, prefactor, particles);
+  for (auto const &mode : modes) {
+    auto const *const blk = far_gblcblk.data() + mode.offset;
+    if (mode.q == 0) {
+      setup_PoQ_partblk<PoQ::P>(mode.p, mode.omega, particles);
+      energy += PoQ_energy(mode.omega, n_localpart, blk);
+    } else if (mode.p == 0) {
+      setup_PoQ_partblk<PoQ::Q>(mode.q, mode.omega, particles);
+      energy += PoQ_energy(mode.omega, n_localpart, blk);
+    } else {
+      setup_PQ_partblk(mode.p, mode.q, mode.omega, particles);
+      energy += PQ_energy(mode.omega, n_localpart, blk);
     }
   }
   /* we count both i<->j and j<->i, so return just half of it */
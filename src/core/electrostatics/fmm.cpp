@@ -0,0 +1,1150 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config/config.hpp"
+
+#ifdef ELECTROSTATICS
+
+#include "electrostatics/fmm.hpp"
+
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/cartesian_product.hpp>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/range/counting_range.hpp>
+#include <boost/serialization/complex.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+using Complex = std::complex<double>;
+/** Coefficients of a multipole or local expansion. */
+using Expansion = std::vector<Complex>;
+
+/** Largest expansion order. */
+auto constexpr max_order = 20;
+/** Deepest level of the octree. */
+auto constexpr max_depth = 7;
+/** Largest ratio of the cell diagonal and the distance in the far field. */
+auto constexpr max_ratio = 0.875;
+/** Number of levels of lattice super-cells in periodic directions. */
+auto constexpr n_lattice_levels = 40;
+/** Number of particles sampled during tuning. */
+auto constexpr n_error_samples = 100;
+
+/**
+ * @brief Position and charge of one particle.
+ */
+struct Charge {
+  Utils::Vector3d pos;
+  double q;
+
+  template <class Archive> void serialize(Archive &ar, long int) { ar &pos &q; }
+};
+
+/** @brief Potential and electric field at the position of a charge. */
+struct Field {
+  double potential;
+  Utils::Vector3d field;
+};
+
+/** @brief Index of the coefficient of degree @p n and order @p m. */
+int coeff(int n, int m) { return n * n + n + m; }
+
+std::size_t n_coeffs(int order) {
+  return static_cast<std::size_t>((order + 1) * (order + 1));
+}
+
+double sign(int n) { return (n % 2 == 0) ? 1. : -1.; }
+
+/**
+ * @brief Add a coefficient of non-negative order and its counterpart of
+ * negative order, which is fixed by the expansion of a real function.
+ */
+void add_coeff(Complex *out, int n, int m, Complex const &value) {
+  out[coeff(n, m)] += value;
+  if (m > 0) {
+    out[coeff(n, -m)] += sign(m) * std::conj(value);
+  }
+}
+
+/** @brief Regular solid harmonics @f$ r^n Y_n^m / (n + m)! @f$. */
+void regular_harmonics(Utils::Vector3d const &x, int order, Expansion &out) {
+  out.assign(n_coeffs(order), Complex{});
+  auto const xy = Complex{x[0], x[1]};
+  auto const r2 = x.norm2();
+  out[0] = 1.;
+  for (int m = 0; m <= order; ++m) {
+    if (m > 0) {
+      out[coeff(m, m)] = -xy / (2. * m) * out[coeff(m - 1, m - 1)];
+    }
+    if (m < order) {
+      out[coeff(m + 1, m)] = x[2] * out[coeff(m, m)];
+    }
+    for (int n = m + 2; n <= order; ++n) {
+      out[coeff(n, m)] = ((2. * n - 1.) * x[2] * out[coeff(n - 1, m)] -
+                          r2 * out[coeff(n - 2, m)]) /
+                         static_cast<double>((n + m) * (n - m));
+    }
+  }
+  for (int n = 1; n <= order; ++n) {
+    for (int m = 1; m <= n; ++m) {
+      out[coeff(n, -m)] = sign(m) * std::conj(out[coeff(n, m)]);
+    }
+  }
+}
+
+/** @brief Irregular solid harmonics @f$ (n - m)! Y_n^m / r^{n+1} @f$. */
+void irregular_harmonics(Utils::Vector3d const &x, int order, Expansion &out) {
+  out.assign(n_coeffs(order), Complex{});
+  auto const xy = Complex{x[0], x[1]};
+  auto const r2_inv = 1. / x.norm2();
+  out[0] = std::sqrt(r2_inv);
+  for (int m = 0; m <= order; ++m) {
+    if (m > 0) {
+      out[coeff(m, m)] =
+          -(2. * m - 1.) * xy * r2_inv * out[coeff(m - 1, m - 1)];
+    }
+    if (m < order) {
+      out[coeff(m + 1, m)] = (2. * m + 1.) * x[2] * r2_inv * out[coeff(m, m)];
+    }
+    for (int n = m + 2; n <= order; ++n) {
+      out[coeff(n, m)] =
+          ((2. * n - 1.) * x[2] * out[coeff(n - 1, m)] -
+           static_cast<double>((n - 1 + m) * (n - 1 - m)) *
+               out[coeff(n - 2, m)]) *
+          r2_inv;
+    }
+  }
+  for (int n = 1; n <= order; ++n) {
+    for (int m = 1; m <= n; ++m) {
+      out[coeff(n, -m)] = sign(m) * std::conj(out[coeff(n, m)]);
+    }
+  }
+}
+
+/**
+ * @brief Shift a multipole expansion to the center of its parent cell.
+ * @param child Multipole expansion to shift.
+ * @param R Regular harmonics of the child center relative to the parent.
+ * @param order Expansion order.
+ * @param parent Multipole expansion of the parent cell.
+ */
+void m2m(Complex const *child, Expansion const &R, int order,
+         Complex *parent) {
+  for (int n = 0; n <= order; ++n) {
+    for (int m = 0; m <= n; ++m) {
+      auto value = Complex{};
+      for (int k = 0; k <= n; ++k) {
+        for (int l = std::max(-k, m - n + k); l <= std::min(k, m + n - k);
+             ++l) {
+          value += child[coeff(k, l)] * R[coeff(n - k, m - l)];
+        }
+      }
+      add_coeff(parent, n, m, value);
+    }
+  }
+}
+
+/**
+ * @brief Convert a multipole expansion into a local expansion.
+ * @param multipole Multipole expansion of the source cell.
+ * @param I Irregular harmonics of twice the expansion order, of the target
+ *          center relative to the source center.
+ * @param order Expansion order.
+ * @param local Local expansion of the target cell.
+ */
+void m2l(Complex const *multipole, Expansion const &I, int order,
+         Complex *local) {
+  for (int k = 0; k <= order; ++k) {
+    for (int l = 0; l <= k; ++l) {
+      auto value = Complex{};
+      for (int n = 0; n <= order; ++n) {
+        for (int m = -n; m <= n; ++m) {
+          value += std::conj(multipole[coeff(n, m)]) * I[coeff(n + k, m + l)];
+        }
+      }
+      add_coeff(local, k, l, sign(k) * value);
+    }
+  }
+}
+
+/**
+ * @brief Shift a local expansion to the center of a child cell.
+ * @param parent Local expansion to shift.
+ * @param R Regular harmonics of the child center relative to the parent.
+ * @param order Expansion order.
+ * @param child Local expansion of the child cell.
+ */
+void l2l(Complex const *parent, Expansion const &R, int order,
+         Complex *child) {
+  for (int j = 0; j <= order; ++j) {
+    for (int s = 0; s <= j; ++s) {
+      auto value = Complex{};
+      for (int k = j; k <= order; ++k) {
+        for (int l = std::max(-k, s - k + j); l <= std::min(k, s + k - j);
+             ++l) {
+          value += parent[coeff(k, l)] * std::conj(R[coeff(k - j, l - s)]);
+        }
+      }
+      add_coeff(child, j, s, value);
+    }
+  }
+}
+
+/**
+ * @brief Evaluate a local expansion.
+ * @param local Local expansion.
+ * @param R Regular harmonics of the position relative to the cell center.
+ * @param order Expansion order.
+ * @return Potential and electric field.
+ */
+Field l2p(Complex const *local, Expansion const &R, int order) {
+  auto a00 = Complex{};
+  auto a10 = Complex{};
+  auto a11 = Complex{};
+  for (int k = 0; k <= order; ++k) {
+    for (int l = -k; l <= k; ++l) {
+      a00 += local[coeff(k, l)] * std::conj(R[coeff(k, l)]);
+      if (k > 0 and std::abs(l) < k) {
+        a10 += local[coeff(k, l)] * std::conj(R[coeff(k - 1, l)]);
+      }
+      if (k > 0 and std::abs(l - 1) < k) {
+        a11 += local[coeff(k, l)] * std::conj(R[coeff(k - 1, l - 1)]);
+      }
+    }
+  }
+  return {a00.real(), Utils::Vector3d{a11.real(), a11.imag(), -a10.real()}};
+}
+
+/**
+ * @brief Bounding box of the charges of one rank.
+ */
+struct Box {
+  Utils::Vector3d lower;
+  Utils::Vector3d upper;
+  bool empty;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &lower &upper &empty;
+  }
+};
+
+Box bounding_box(std::vector<Charge> const &charges) {
+  auto constexpr inf = std::numeric_limits<double>::infinity();
+  Box box{Utils::Vector3d::broadcast(inf), Utils::Vector3d::broadcast(-inf),
+          charges.empty()};
+  for (auto const &charge : charges) {
+    for (unsigned int d = 0; d < 3; ++d) {
+      box.lower[d] = std::min(box.lower[d], charge.pos[d]);
+      box.upper[d] = std::max(box.upper[d], charge.pos[d]);
+    }
+  }
+  return box;
+}
+
+/**
+ * @brief Multipole expansions of some of the requested cells.
+ */
+struct Multipoles {
+  /** Position of each expansion in the list of requested cells. */
+  std::vector<int> requests;
+  Expansion coefficients;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &requests &coefficients;
+  }
+};
+
+/**
+ * @brief Root box and depth of the octree over the charges of all ranks.
+ */
+struct Geometry {
+  Utils::Vector3d lower;
+  Utils::Vector3d size;
+  int n_levels;
+  /** Number of periodic images on each side handled by the tree. */
+  int n_images;
+
+  /** Needs to be called on all ranks. */
+  Geometry(std::vector<Charge> const &charges, int leaf_size)
+      : lower{}, size{}, n_levels{0}, n_images{0} {
+    auto const &comm = ::comm_cart;
+    auto const box_l = ::box_geo.length();
+    auto const local_box = bounding_box(charges);
+    auto const n_charges =
+        boost::mpi::all_reduce(comm, static_cast<int>(charges.size()),
+                               std::plus<>());
+    if (n_charges == 0) {
+      return;
+    }
+    Utils::Vector3d box_lower;
+    Utils::Vector3d box_upper;
+    boost::mpi::all_reduce(comm, local_box.lower.data(), 3, box_lower.data(),
+                           boost::mpi::minimum<double>());
+    boost::mpi::all_reduce(comm, local_box.upper.data(), 3, box_upper.data(),
+                           boost::mpi::maximum<double>());
+
+    auto extent = 0.;
+    auto box_l_min = std::numeric_limits<double>::infinity();
+    for (unsigned int d = 0; d < 3; ++d) {
+      if (::box_geo.periodic(d)) {
+        extent = std::max(extent, box_l[d]);
+        box_l_min = std::min(box_l_min, box_l[d]);
+      } else {
+        extent = std::max(extent, box_upper[d] - box_lower[d]);
+      }
+    }
+    if (extent == 0.) {
+      extent = 1.;
+    }
+    for (unsigned int d = 0; d < 3; ++d) {
+      if (::box_geo.periodic(d)) {
+        lower[d] = 0.;
+        size[d] = box_l[d];
+      } else {
+        lower[d] = 0.5 * (box_lower[d] + box_upper[d] - extent);
+        size[d] = extent;
+      }
+    }
+    if (std::isfinite(box_l_min)) {
+      auto const ratio = size.norm() / (max_ratio * box_l_min);
+      n_images = std::max(1, static_cast<int>(std::ceil(ratio)) - 1);
+    }
+
+    /* refine while the leaves keep at least half the target size */
+    n_levels = 1;
+    while (n_levels <= max_depth and
+           2. * n_charges >= leaf_size * std::pow(8., n_levels)) {
+      ++n_levels;
+    }
+  }
+
+  /** @brief Smallest edge of the leaf cells. */
+  double leaf_cell_size() const {
+    if (n_levels == 0) {
+      return 0.;
+    }
+    auto const h = size / static_cast<double>(1 << (n_levels - 1));
+    return *std::min_element(h.begin(), h.end());
+  }
+};
+
+/**
+ * @brief Octree over the charges of one rank.
+ *
+ * The cells of each level form a regular grid over the root box, which
+ * is the same on all ranks. Only non-empty cells are stored. Cells of
+ * other periodic images are addressed by unwrapped cell coordinates.
+ *
+ * Each rank sorts its own charges into the tree, together with the
+ * charges of other ranks in the near field of its leaves. The multipole
+ * expansions of its own charges are summed up over the ranks only for
+ * the cells that interact with the cells of its own charges.
+ */
+class Octree {
+  struct Level {
+    int n_side;
+    Utils::Vector3d cell_size;
+    /** Slot of each cell in row-major order, or -1 for empty cells. */
+    std::vector<int> slot;
+    /** Coordinates of the non-empty cells. */
+    std::vector<Utils::Vector3i> cells;
+  };
+
+  /** Charges sorted by leaf cell. */
+  std::vector<Charge> m_charges;
+  /** Original index of each sorted charge. */
+  std::vector<int> m_index;
+  /** Sorted position of each original charge. */
+  std::vector<int> m_position;
+  /** Leaf slot of each sorted charge. */
+  std::vector<int> m_leaf;
+  /** Range of sorted charges of each leaf slot. */
+  std::vector<int> m_bounds;
+  std::vector<Level> m_levels;
+  /** Bounding box of the charges of each rank. */
+  std::vector<Box> m_boxes;
+  Utils::Vector3d m_lower;
+  Utils::Vector3d m_size;
+  Utils::Vector3d m_box_l;
+  std::array<bool, 3> m_periodic;
+  int m_n_images;
+  double m_r_cut;
+  /** Number of charges of this rank, which come first in original order. */
+  int m_n_local;
+
+  int depth() const { return static_cast<int>(m_levels.size()) - 1; }
+
+  Utils::Vector3d center(int level, Utils::Vector3i const &cell) const {
+    auto const &h = m_levels[level].cell_size;
+    Utils::Vector3d pos;
+    for (unsigned int d = 0; d < 3; ++d) {
+      pos[d] = m_lower[d] + (cell[d] + 0.5) * h[d];
+    }
+    return pos;
+  }
+
+  /**
+   * @brief Index of a cell given by its unwrapped coordinates.
+   * @return The row-major index of the cell, or -1 if it is outside of
+   * the root box, and the offset of its periodic image.
+   */
+  std::pair<int, Utils::Vector3d> wrap(int level, Utils::Vector3i cell) const {
+    auto const &grid = m_levels[level];
+    Utils::Vector3d offset{};
+    for (unsigned int d = 0; d < 3; ++d) {
+      if (m_periodic[d]) {
+        auto const shift = static_cast<int>(
+            std::floor(static_cast<double>(cell[d]) / grid.n_side));
+        cell[d] -= shift * grid.n_side;
+        offset[d] = shift * m_box_l[d];
+      } else if (cell[d] < 0 or cell[d] >= grid.n_side) {
+        return {-1, offset};
+      }
+    }
+    auto const index = (cell[0] * grid.n_side + cell[1]) * grid.n_side +
+                       cell[2];
+    return {index, offset};
+  }
+
+  /**
+   * @brief Find a cell by its unwrapped coordinates.
+   * @return The slot of the cell, or -1 if it is empty or outside of the
+   * root box, and the offset of its periodic image.
+   */
+  std::pair<int, Utils::Vector3d> find(int level,
+                                       Utils::Vector3i const &cell) const {
+    auto const [index, offset] = wrap(level, cell);
+    return {(index == -1) ? -1 : m_levels[level].slot[index], offset};
+  }
+
+  /**
+   * @brief Whether two cells of a level interact via their expansions.
+   * The expansions have to converge, and no pair of charges of the two
+   * cells may be closer than the short-range cutoff.
+   */
+  bool separated(int level, Utils::Vector3i const &a,
+                 Utils::Vector3i const &b) const {
+    auto const &h = m_levels[level].cell_size;
+    Utils::Vector3d d;
+    for (unsigned int i = 0; i < 3; ++i) {
+      d[i] = (a[i] - b[i]) * h[i];
+    }
+    auto const dist = d.norm();
+    auto const diagonal = h.norm();
+    return diagonal <= max_ratio * dist and dist - diagonal >= m_r_cut;
+  }
+
+  /**
+   * @brief Call a function for the other ranks whose charges may lie
+   * in a cell, given by its row-major index.
+   */
+  template <class F> void for_each_owner(int level, int index, F f) const {
+    auto const &grid = m_levels[level];
+    auto const n = grid.n_side;
+    auto const cell =
+        Utils::Vector3i{index / (n * n), index / n % n, index % n};
+    for (int rank = 0; rank < static_cast<int>(m_boxes.size()); ++rank) {
+      auto const &box = m_boxes[rank];
+      if (rank == ::comm_cart.rank() or box.empty) {
+        continue;
+      }
+      auto overlap = true;
+      for (unsigned int d = 0; d < 3; ++d) {
+        /* cover the rounding of the cell coordinates of the charges */
+        auto const margin = 1e-6 * grid.cell_size[d];
+        auto const lower = m_lower[d] + cell[d] * grid.cell_size[d] - margin;
+        auto const upper = lower + grid.cell_size[d] + 2. * margin;
+        overlap &= box.upper[d] >= lower and box.lower[d] <= upper;
+      }
+      if (overlap) {
+        f(rank);
+      }
+    }
+  }
+
+  /** @brief Sort charges into the leaf cells, replacing the tree. */
+  void sort(std::vector<Charge> const &charges) {
+    auto const n_charges = static_cast<int>(charges.size());
+    for (auto &grid : m_levels) {
+      grid.slot.assign(grid.slot.size(), -1);
+      grid.cells.clear();
+    }
+    m_charges.clear();
+    m_index.clear();
+    m_bounds.clear();
+    m_position.resize(charges.size());
+    m_leaf.resize(charges.size());
+
+    auto const &leaves = m_levels.back();
+    std::vector<std::pair<int, int>> keys(charges.size());
+    std::vector<Utils::Vector3i> leaf_cells(charges.size());
+    for (int i = 0; i < n_charges; ++i) {
+      auto &cell = leaf_cells[i];
+      for (unsigned int d = 0; d < 3; ++d) {
+        auto const x = (charges[i].pos[d] - m_lower[d]) / leaves.cell_size[d];
+        cell[d] = std::min(std::max(static_cast<int>(x), 0), leaves.n_side - 1);
+      }
+      auto const index =
+          (cell[0] * leaves.n_side + cell[1]) * leaves.n_side + cell[2];
+      keys[i] = {index, i};
+    }
+    std::sort(keys.begin(), keys.end());
+
+    m_charges.reserve(charges.size());
+    m_index.reserve(charges.size());
+    for (auto const &key : keys) {
+      auto const i = key.second;
+      auto const &cell = leaf_cells[i];
+      for (int level = depth(); level >= 0; --level) {
+        auto &grid = m_levels[level];
+        auto const c = cell / (1 << (depth() - level));
+        auto const index = (c[0] * grid.n_side + c[1]) * grid.n_side + c[2];
+        if (grid.slot[index] == -1) {
+          grid.slot[index] = static_cast<int>(grid.cells.size());
+          grid.cells.emplace_back(c);
+          if (level == depth()) {
+            m_bounds.emplace_back(static_cast<int>(m_charges.size()));
+          }
+        }
+      }
+      m_position[i] = static_cast<int>(m_charges.size());
+      m_leaf[m_charges.size()] = m_levels.back().slot[key.first];
+      m_index.emplace_back(i);
+      m_charges.emplace_back(charges[i]);
+    }
+    m_bounds.emplace_back(static_cast<int>(m_charges.size()));
+  }
+
+  /** @brief Cells containing a target, on each level. */
+  std::vector<std::vector<char>>
+  needed_cells(std::vector<int> const &targets) const {
+    std::vector<std::vector<char>> needed(m_levels.size());
+    for (int level = 0; level <= depth(); ++level) {
+      needed[level].assign(m_levels[level].cells.size(), 0);
+    }
+    for (auto const target : targets) {
+      auto const &cell = m_levels.back().cells[m_leaf[m_position[target]]];
+      for (int level = 0; level <= depth(); ++level) {
+        auto const c = cell / (1 << (depth() - level));
+        needed[level][find(level, c).first] = 1;
+      }
+    }
+    return needed;
+  }
+
+  /**
+   * @brief Walk the interaction lists of the cells containing a target.
+   *
+   * The near field of a cell is made of the children of the near field
+   * of its parent. The children that are well separated from the cell
+   * interact with it via their expansions, the other children form its
+   * near field. Cells without charges of this rank are kept in the near
+   * field, since they may contain charges of other ranks.
+   *
+   * @param needed Cells containing a target, on each level.
+   * @param down Called with the level and the slots of each target cell
+   *        and of its parent.
+   * @param far Called with the level, the slot of the target cell and
+   *        the unwrapped coordinates of each well separated cell.
+   * @return Near field of the leaf cells containing a target.
+   */
+  template <class Down, class Far>
+  std::vector<std::vector<Utils::Vector3i>>
+  interaction_lists(std::vector<std::vector<char>> const &needed, Down down,
+                    Far far) const {
+    std::vector<std::vector<Utils::Vector3i>> near(1);
+    Utils::cartesian_product(
+        [&near](int nx, int ny, int nz) {
+          near[0].emplace_back(Utils::Vector3i{nx, ny, nz});
+        },
+        boost::counting_range(-m_periodic[0] * m_n_images,
+                              m_periodic[0] * m_n_images + 1),
+        boost::counting_range(-m_periodic[1] * m_n_images,
+                              m_periodic[1] * m_n_images + 1),
+        boost::counting_range(-m_periodic[2] * m_n_images,
+                              m_periodic[2] * m_n_images + 1));
+
+    for (int level = 1; level <= depth(); ++level) {
+      auto const &grid = m_levels[level];
+      std::vector<std::vector<Utils::Vector3i>> child_near(grid.cells.size());
+      for (std::size_t t = 0; t < grid.cells.size(); ++t) {
+        if (not needed[level][t]) {
+          continue;
+        }
+        auto const &cell = grid.cells[t];
+        auto const p = find(level - 1, cell / 2).first;
+        down(level, t, p);
+        for (auto const &neighbor : near[p]) {
+          Utils::cartesian_product(
+              [&](int cx, int cy, int cz) {
+                auto const source = 2 * neighbor + Utils::Vector3i{cx, cy, cz};
+                if (wrap(level, source).first == -1) {
+                  return;
+                }
+                if (separated(level, cell, source)) {
+                  far(level, t, source);
+                } else {
+                  child_near[t].emplace_back(source);
+                }
+              },
+              boost::counting_range(0, 2), boost::counting_range(0, 2),
+              boost::counting_range(0, 2));
+        }
+      }
+      std::swap(near, child_near);
+    }
+    return near;
+  }
+
+  /**
+   * @brief Sum up the multipole expansions of the cells of some requests
+   * over all ranks. Needs to be called on all ranks.
+   * @param multipoles Multipole expansions of the local charges.
+   * @param keys Level and row-major index of the requested cells.
+   * @param order Expansion order.
+   * @return Slot of each requested non-empty cell on each level, and the
+   * multipole expansions of these cells.
+   */
+  auto gather_multipoles(std::vector<Expansion> const &multipoles,
+                         std::vector<std::pair<int, int>> const &keys,
+                         int order) const {
+    auto const &comm = ::comm_cart;
+    auto const n = n_coeffs(order);
+    std::vector<std::unordered_map<int, int>> slots(m_levels.size());
+    std::vector<Expansion> result(m_levels.size());
+    auto const slot = [&](int level, int index) {
+      auto const it = slots[level].find(index);
+      if (it != slots[level].end()) {
+        return it->second;
+      }
+      auto const s = static_cast<int>(slots[level].size());
+      slots[level][index] = s;
+      result[level].resize((s + 1) * n);
+      return s;
+    };
+
+    std::vector<std::vector<int>> requests(comm.size());
+    for (auto const &key : keys) {
+      auto const level = key.first;
+      auto const index = key.second;
+      auto const local = m_levels[level].slot[index];
+      if (local != -1) {
+        auto const s = slot(level, index);
+        std::copy_n(multipoles[level].begin() + local * n, n,
+                    result[level].begin() + s * n);
+      }
+      for_each_owner(level, index, [&](int rank) {
+        requests[rank].emplace_back(level);
+        requests[rank].emplace_back(index);
+      });
+    }
+    std::vector<std::vector<int>> received;
+    boost::mpi::all_to_all(comm, requests, received);
+
+    std::vector<Multipoles> replies(comm.size());
+    for (int rank = 0; rank < comm.size(); ++rank) {
+      auto const &cells = received[rank];
+      auto &reply = replies[rank];
+      for (std::size_t i = 0; i < cells.size(); i += 2) {
+        auto const local = m_levels[cells[i]].slot[cells[i + 1]];
+        if (local != -1) {
+          auto const first = multipoles[cells[i]].begin() + local * n;
+          reply.requests.emplace_back(static_cast<int>(i / 2));
+          reply.coefficients.insert(reply.coefficients.end(), first,
+                                    first + n);
+        }
+      }
+    }
+    std::vector<Multipoles> answers;
+    boost::mpi::all_to_all(comm, replies, answers);
+
+    for (int rank = 0; rank < comm.size(); ++rank) {
+      auto const &answer = answers[rank];
+      for (std::size_t i = 0; i < answer.requests.size(); ++i) {
+        auto const r = 2 * answer.requests[i];
+        auto const level = requests[rank][r];
+        auto const s = slot(level, requests[rank][r + 1]);
+        auto const first = answer.coefficients.begin() + i * n;
+        auto const out = result[level].begin() + s * n;
+        std::transform(first, first + n, out, out, std::plus<>());
+      }
+    }
+    return std::make_pair(std::move(slots), std::move(result));
+  }
+
+  /**
+   * @brief Local expansion at the root of all images beyond the tree.
+   *
+   * Starting from the root multipole without its monopole, super-cells
+   * of @f$ b = 2 n + 1 @f$ images per periodic direction are formed
+   * recursively, where @f$ n @f$ is the number of images handled by the
+   * tree. The surrounding shell of each super-cell level contributes
+   * to the local expansion. The expansions of level @f$ j @f$ are scaled
+   * by @f$ b^{-j} @f$ per degree, such that all levels share the same
+   * translation operators.
+   */
+  void add_lattice(Complex const *root, int order, Complex *local) const {
+    auto const b = 2 * m_n_images + 1;
+    auto const n_outer = (b * b - 1) / 2;
+    Utils::Vector3i range{};
+    for (unsigned int d = 0; d < 3; ++d) {
+      range[d] = m_periodic[d] ? n_outer : 0;
+    }
+
+    Expansion inner(n_coeffs(order));
+    Expansion outer(n_coeffs(2 * order));
+    Expansion harmonics;
+    Utils::cartesian_product(
+        [&](int nx, int ny, int nz) {
+          auto const shift = Utils::Vector3d{
+              nx * m_box_l[0], ny * m_box_l[1], nz * m_box_l[2]};
+          if (std::abs(nx) <= m_n_images and std::abs(ny) <= m_n_images and
+              std::abs(nz) <= m_n_images) {
+            regular_harmonics(shift, order, harmonics);
+            std::transform(inner.begin(), inner.end(), harmonics.begin(),
+                           inner.begin(), std::plus<>());
+          } else {
+            irregular_harmonics(-shift, 2 * order, harmonics);
+            std::transform(outer.begin(), outer.end(), harmonics.begin(),
+                           outer.begin(), std::plus<>());
+          }
+        },
+        boost::counting_range(-range[0], range[0] + 1),
+        boost::counting_range(-range[1], range[1] + 1),
+        boost::counting_range(-range[2], range[2] + 1));
+
+    auto multipole = Expansion(root, root + n_coeffs(order));
+    multipole[0] = 0.;
+    Expansion buffer;
+    for (int j = 0; j < n_lattice_levels; ++j) {
+      buffer.assign(n_coeffs(order), Complex{});
+      m2l(multipole.data(), outer, order, buffer.data());
+      for (int k = 0; k <= order; ++k) {
+        auto const scale = std::pow(static_cast<double>(b), -j * (k + 1));
+        for (int l = -k; l <= k; ++l) {
+          local[coeff(k, l)] += scale * buffer[coeff(k, l)];
+        }
+      }
+      buffer.assign(n_coeffs(order), Complex{});
+      m2m(multipole.data(), inner, order, buffer.data());
+      for (int n = 0; n <= order; ++n) {
+        auto const scale = std::pow(static_cast<double>(b), -n);
+        for (int m = -n; m <= n; ++m) {
+          multipole[coeff(n, m)] = scale * buffer[coeff(n, m)];
+        }
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Sort the charges of this rank and the charges of other ranks
+   * in the near field of their leaves into the tree.
+   * Needs to be called on all ranks.
+   */
+  Octree(Geometry const &geometry, std::vector<Charge> charges, double r_cut)
+      : m_lower(geometry.lower), m_size(geometry.size),
+        m_box_l(::box_geo.length()), m_n_images(geometry.n_images),
+        m_r_cut(r_cut), m_n_local(static_cast<int>(charges.size())) {
+    for (unsigned int d = 0; d < 3; ++d) {
+      m_periodic[d] = ::box_geo.periodic(d);
+    }
+    for (int level = 0; level < geometry.n_levels; ++level) {
+      auto const n_side = 1 << level;
+      m_levels.push_back({n_side, m_size / static_cast<double>(n_side),
+                          std::vector<int>(n_side * n_side * n_side, -1),
+                          {}});
+    }
+    if (m_levels.empty()) {
+      return;
+    }
+    auto const &comm = ::comm_cart;
+    boost::mpi::all_gather(comm, bounding_box(charges), m_boxes);
+    sort(charges);
+
+    /* leaves in the near field of the local charges */
+    std::vector<int> targets(charges.size());
+    std::iota(targets.begin(), targets.end(), 0);
+    auto const near = interaction_lists(
+        needed_cells(targets), [](int, std::size_t, int) {},
+        [](int, std::size_t, Utils::Vector3i const &) {});
+    std::vector<int> leaves;
+    for (auto const &sources : near) {
+      for (auto const &source : sources) {
+        leaves.emplace_back(wrap(depth(), source).first);
+      }
+    }
+    std::sort(leaves.begin(), leaves.end());
+    leaves.erase(std::unique(leaves.begin(), leaves.end()), leaves.end());
+
+    /* exchange the charges of these leaves */
+    std::vector<std::vector<int>> requests(comm.size());
+    for (auto const index : leaves) {
+      for_each_owner(depth(), index,
+                     [&](int rank) { requests[rank].emplace_back(index); });
+    }
+    std::vector<std::vector<int>> received;
+    boost::mpi::all_to_all(comm, requests, received);
+    std::vector<std::vector<Charge>> replies(comm.size());
+    for (int rank = 0; rank < comm.size(); ++rank) {
+      for (auto const index : received[rank]) {
+        auto const s = m_levels.back().slot[index];
+        if (s != -1) {
+          replies[rank].insert(replies[rank].end(),
+                               m_charges.begin() + m_bounds[s],
+                               m_charges.begin() + m_bounds[s + 1]);
+        }
+      }
+    }
+    std::vector<std::vector<Charge>> answers;
+    boost::mpi::all_to_all(comm, replies, answers);
+    for (auto const &answer : answers) {
+      charges.insert(charges.end(), answer.begin(), answer.end());
+    }
+    sort(charges);
+  }
+
+  /**
+   * @brief Potential and field at the position of some local charges.
+   *
+   * The multipole expansions of the local charges are calculated for all
+   * cells. The expansions of the cells that interact with the cells of
+   * the targets are then summed up over all ranks, and local expansions
+   * are only calculated for the cells containing a target.
+   * Needs to be called on all ranks.
+   *
+   * @param order Expansion order.
+   * @param targets Original indices of the target charges.
+   * @param with_short_range Whether to include pairs closer than the
+   *        short-range cutoff.
+   */
+  std::vector<Field> evaluate(int order, std::vector<int> const &targets,
+                              bool with_short_range) const {
+    std::vector<Field> result(targets.size(), Field{0., {}});
+    if (m_levels.empty()) {
+      return result;
+    }
+    auto const n = n_coeffs(order);
+    Expansion harmonics;
+
+    /* upward pass, without the charges of other ranks */
+    std::vector<Expansion> multipoles(m_levels.size());
+    {
+      auto const &grid = m_levels.back();
+      auto &multipole = multipoles.back();
+      multipole.assign(grid.cells.size() * n, Complex{});
+      for (std::size_t s = 0; s < grid.cells.size(); ++s) {
+        auto const c = center(depth(), grid.cells[s]);
+        for (int i = m_bounds[s]; i < m_bounds[s + 1]; ++i) {
+          if (m_index[i] >= m_n_local) {
+            continue;
+          }
+          regular_harmonics(m_charges[i].pos - c, order, harmonics);
+          for (std::size_t k = 0; k < n; ++k) {
+            multipole[s * n + k] += m_charges[i].q * harmonics[k];
+          }
+        }
+      }
+    }
+    for (int level = depth() - 1; level >= 0; --level) {
+      auto const &children = m_levels[level + 1];
+      multipoles[level].assign(m_levels[level].cells.size() * n, Complex{});
+      for (std::size_t s = 0; s < children.cells.size(); ++s) {
+        auto const &cell = children.cells[s];
+        auto const parent = cell / 2;
+        auto const p = find(level, parent).first;
+        regular_harmonics(center(level + 1, cell) - center(level, parent),
+                          order, harmonics);
+        m2m(&multipoles[level + 1][s * n], harmonics, order,
+            &multipoles[level][p * n]);
+      }
+    }
+
+    /* well separated cells of the cells containing a target */
+    auto const needed = needed_cells(targets);
+    std::vector<std::pair<int, int>> keys;
+    interaction_lists(
+        needed, [](int, std::size_t, int) {},
+        [&](int level, std::size_t, Utils::Vector3i const &source) {
+          keys.emplace_back(level, wrap(level, source).first);
+        });
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    auto const far_field = gather_multipoles(multipoles, keys, order);
+    auto const &slots = far_field.first;
+    auto const &sources = far_field.second;
+
+    /* downward pass */
+    std::vector<Expansion> locals(m_levels.size());
+    for (int level = 0; level <= depth(); ++level) {
+      locals[level].assign(m_levels[level].cells.size() * n, Complex{});
+    }
+    if (m_n_images > 0) {
+      auto root = Expansion(n, Complex{});
+      if (not m_levels[0].cells.empty()) {
+        std::copy_n(multipoles[0].begin(), n, root.begin());
+      }
+      boost::mpi::all_reduce(::comm_cart,
+                             boost::mpi::inplace(
+                                 reinterpret_cast<double *>(root.data())),
+                             static_cast<int>(2 * n), std::plus<>());
+      if (not m_levels[0].cells.empty()) {
+        add_lattice(root.data(), order, locals[0].data());
+      }
+    }
+    auto const near = interaction_lists(
+        needed,
+        [&](int level, std::size_t t, int p) {
+          auto const &cell = m_levels[level].cells[t];
+          regular_harmonics(center(level, cell) - center(level - 1, cell / 2),
+                            order, harmonics);
+          l2l(&locals[level - 1][p * n], harmonics, order,
+              &locals[level][t * n]);
+        },
+        [&](int level, std::size_t t, Utils::Vector3i const &source) {
+          auto const it = slots[level].find(wrap(level, source).first);
+          if (it == slots[level].end()) {
+            return;
+          }
+          auto const &cell = m_levels[level].cells[t];
+          irregular_harmonics(center(level, cell) - center(level, source),
+                              2 * order, harmonics);
+          m2l(&sources[level][it->second * n], harmonics, order,
+              &locals[level][t * n]);
+        });
+
+    /* evaluation */
+    auto const r_cut2 = with_short_range ? 0. : m_r_cut * m_r_cut;
+    for (std::size_t j = 0; j < targets.size(); ++j) {
+      auto const i = m_position[targets[j]];
+      auto const leaf = m_leaf[i];
+      auto const &pos = m_charges[i].pos;
+      regular_harmonics(pos - center(depth(), m_levels.back().cells[leaf]),
+                        order, harmonics);
+      auto &res = result[j];
+      res = l2p(&locals[depth()][leaf * n], harmonics, order);
+      for (auto const &neighbor : near[leaf]) {
+        auto const [s, offset] = find(depth(), neighbor);
+        if (s == -1) {
+          continue;
+        }
+        for (int k = m_bounds[s]; k < m_bounds[s + 1]; ++k) {
+          auto const d = pos - (m_charges[k].pos + offset);
+          auto const r2 = d.norm2();
+          if (r2 < r_cut2 or (k == i and offset == Utils::Vector3d{})) {
+            continue;
+          }
+          auto const r_inv = 1. / std::sqrt(r2);
+          res.potential += m_charges[k].q * r_inv;
+          res.field += (m_charges[k].q * r_inv * r_inv * r_inv) * d;
+        }
+      }
+    }
+    return result;
+  }
+};
+
+/**
+ * @brief Charges of the local particles.
+ * @return The local charged particles and their charges.
+ */
+auto local_particle_data(ParticleRange const &particles) {
+  std::vector<Particle *> local_particles;
+  std::vector<Charge> local_charges;
+
+  local_particles.reserve(particles.size());
+  local_charges.reserve(particles.size());
+
+  for (auto &p : particles) {
+    if (p.q() != 0.0) {
+      local_particles.emplace_back(&p);
+      local_charges.emplace_back(
+          Charge{folded_position(p.pos(), ::box_geo), p.q()});
+    }
+  }
+
+  return std::make_pair(std::move(local_particles), std::move(local_charges));
+}
+
+auto local_targets(std::size_t n_local) {
+  std::vector<int> targets(n_local);
+  std::iota(targets.begin(), targets.end(), 0);
+  return targets;
+}
+} // namespace
+
+void CoulombFMM::add_long_range_forces(ParticleRange const &particles) const {
+  auto [local_particles, local_charges] = local_particle_data(particles);
+  auto const geometry = Geometry(local_charges, leaf_size);
+  auto const tree = Octree(geometry, std::move(local_charges), r_cut);
+  auto const fields =
+      tree.evaluate(order, local_targets(local_particles.size()), false);
+
+  for (std::size_t i = 0; i < local_particles.size(); ++i) {
+    auto &p = *local_particles[i];
+    p.force() += (prefactor * p.q()) * fields[i].field;
+  }
+}
+
+double CoulombFMM::long_range_energy(ParticleRange const &particles) const {
+  auto [local_particles, local_charges] = local_particle_data(particles);
+  auto const geometry = Geometry(local_charges, leaf_size);
+  auto const tree = Octree(geometry, std::move(local_charges), r_cut);
+  auto const fields =
+      tree.evaluate(order, local_targets(local_particles.size()), false);
+
+  auto u = 0.;
+  for (std::size_t i = 0; i < local_particles.size(); ++i) {
+    u += local_particles[i]->q() * fields[i].potential;
+  }
+
+  /* every pair is visited from both sides */
+  return 0.5 * prefactor * u;
+}
+
+void CoulombFMM::tune() {
+  if (m_is_tuned) {
+    return;
+  }
+  auto [local_particles, local_charges] =
+      local_particle_data(::cell_structure.local_particles());
+  auto const n_local = static_cast<int>(local_particles.size());
+  auto const geometry = Geometry(local_charges, leaf_size);
+
+  if (r_cut == -1.) {
+    r_cut = 0.5 * geometry.leaf_cell_size();
+    for (unsigned int d = 0; d < 3; ++d) {
+      if (::box_geo.periodic(d)) {
+        r_cut = std::min(r_cut, 0.25 * ::box_geo.length()[d]);
+      }
+    }
+  }
+
+  if (order == -1) {
+    auto const tree = Octree(geometry, std::move(local_charges), r_cut);
+    std::vector<int> all_sizes;
+    boost::mpi::all_gather(::comm_cart, n_local, all_sizes);
+    auto const offset = std::accumulate(
+        all_sizes.begin(), all_sizes.begin() + ::comm_cart.rank(), 0);
+    auto const n_total = std::accumulate(all_sizes.begin(), all_sizes.end(), 0);
+    auto const stride = std::max(1, n_total / n_error_samples);
+    std::vector<int> samples;
+    for (int i = (stride - offset % stride) % stride; i < n_local;
+         i += stride) {
+      samples.emplace_back(i);
+    }
+    std::map<int, std::vector<Field>> fields;
+    auto const sample_fields = [&](int p) -> std::vector<Field> const & {
+      if (fields.count(p) == 0) {
+        fields[p] = tree.evaluate(p, samples, true);
+      }
+      return fields[p];
+    };
+
+    for (int p = 2; p + 2 <= max_order; ++p) {
+      auto const &res = sample_fields(p);
+      auto const &ref = sample_fields(p + 2);
+      std::array<double, 2> sums{};
+      for (std::size_t i = 0; i < samples.size(); ++i) {
+        sums[0] += (res[i].field - ref[i].field).norm2();
+        sums[1] += ref[i].field.norm2();
+      }
+      boost::mpi::all_reduce(::comm_cart, boost::mpi::inplace(sums.data()), 2,
+                             std::plus<>());
+      auto const error = (sums[1] > 0.) ? std::sqrt(sums[0] / sums[1]) : 0.;
+      if (tune_verbose and this_node == 0) {
+        std::printf("order= %d error= %e\n", p, error);
+      }
+      if (error <= accuracy) {
+        order = p;
+        break;
+      }
+      fields.erase(p);
+    }
+    if (order == -1) {
+      throw std::runtime_error("FMM could not reach the requested accuracy");
+    }
+  }
+  if (tune_verbose and this_node == 0) {
+    std::printf("FMM tuned: order= %d r_cut= %f\n", order, r_cut);
+  }
+
+  m_is_tuned = true;
+}
+
+void CoulombFMM::sanity_checks_periodicity() const {
+  if (box_geo.periodic(0) and box_geo.periodic(1) and box_geo.periodic(2)) {
+    throw std::runtime_error(
+        "FMM requires at least one non-periodic direction");
+  }
+}
+
+void CoulombFMM::sanity_checks_cutoff() const {
+  for (unsigned int d = 0; d < 3; ++d) {
+    if (box_geo.periodic(d) and 2. * r_cut >= box_geo.length()[d]) {
+      throw std::runtime_error(
+          "FMM requires r_cut to be smaller than half the box length in "
+          "periodic directions");
+    }
+  }
+}
+
+CoulombFMM::CoulombFMM(double prefactor, double accuracy, int order,
+                       double r_cut, int leaf_size, bool tune_verbose)
+    : accuracy{accuracy}, order{order}, r_cut{r_cut}, leaf_size{leaf_size},
+      tune_verbose{tune_verbose}, m_is_tuned{order != -1 and r_cut != -1.} {
+  set_prefactor(prefactor);
+  if (accuracy <= 0.) {
+    throw std::domain_error("Parameter 'accuracy' must be > 0");
+  }
+  if (order != -1 and (order < 1 or order > max_order)) {
+    throw std::domain_error("Parameter 'order' must be between 1 and " +
+                            std::to_string(max_order));
+  }
+  if (r_cut < 0. and r_cut != -1.) {
+    throw std::domain_error("Parameter 'r_cut' must be >= 0");
+  }
+  if (leaf_size <= 0) {
+    throw std::domain_error("Parameter 'leaf_size' must be > 0");
+  }
+}
+
+#endif // ELECTROSTATICS
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file
+ * Fast multipole method for long-range %Coulomb interactions on the CPU.
+ * The method handles open boundaries and one or two periodic directions.
+ * Pairs closer than the short-range cutoff are calculated by the pair
+ * kernel in the short-range loop, all other pairs by an octree of
+ * spherical harmonics expansions. Periodic images beyond the tree are
+ * summed up by a hierarchy of lattice super-cells. Each MPI rank only
+ * calculates the expansions of its own charges and receives the charges
+ * and expansions of other ranks that interact with them.
+ */
+
+#ifndef ESPRESSO_SRC_CORE_ELECTROSTATICS_FMM_HPP
+#define ESPRESSO_SRC_CORE_ELECTROSTATICS_FMM_HPP
+
+#include "config/config.hpp"
+
+#ifdef ELECTROSTATICS
+
+#include "electrostatics/actor.hpp"
+
+#include "ParticleRange.hpp"
+
+#include <utils/Vector.hpp>
+
+/** @brief Parameters for the FMM electrostatic interaction */
+struct CoulombFMM : public Coulomb::Actor<CoulombFMM> {
+  /** @brief Target relative RMS force error of the tuning. */
+  double accuracy;
+  /** @brief Order of the multipole expansions, or -1 to tune it. */
+  int order;
+  /** @brief Short-range cutoff, or -1 to choose it from the leaf size. */
+  double r_cut;
+  /** @brief Average number of charges in a leaf cell of the octree. */
+  int leaf_size;
+  bool tune_verbose;
+
+  CoulombFMM(double prefactor, double accuracy, int order, double r_cut,
+             int leaf_size, bool tune_verbose);
+
+  /** Compute the pair force.
+   *  @param[in]  q1q2      Product of the charges on p1 and p2.
+   *  @param[in]  d         Vector pointing from p1 to p2.
+   *  @param[in]  dist      Distance between p1 and p2.
+   */
+  Utils::Vector3d pair_force(double q1q2, Utils::Vector3d const &d,
+                             double dist) const {
+    if (dist >= r_cut) {
+      return {};
+    }
+    return (prefactor * q1q2 / (dist * dist * dist)) * d;
+  }
+
+  /** Compute the pair energy.
+   *  @param[in] q1q2      Product of the charges on p1 and p2.
+   *  @param[in] dist      Distance between p1 and p2.
+   */
+  double pair_energy(double q1q2, double dist) const {
+    if (dist >= r_cut) {
+      return 0.;
+    }
+    return prefactor * q1q2 / dist;
+  }
+
+  /**
+   * @brief Tune the short-range cutoff and the expansion order.
+   * The order is increased until the difference to the forces of a
+   * higher order drops below @ref accuracy.
+   */
+  void tune();
+  bool is_tuned() const { return m_is_tuned; }
+
+  void on_activation() {
+    sanity_checks();
+    tune();
+  }
+  void on_boxl_change() const { sanity_checks_cutoff(); }
+  void on_node_grid_change() const {}
+  void on_periodicity_change() const {
+    sanity_checks_periodicity();
+    sanity_checks_cutoff();
+  }
+  void on_cell_structure_change() const {}
+  void init() const {}
+
+  void sanity_checks() const {
+    sanity_checks_periodicity();
+    sanity_checks_cutoff();
+    sanity_checks_charge_neutrality();
+  }
+
+  double long_range_energy(ParticleRange const &particles) const;
+  void add_long_range_forces(ParticleRange const &particles) const;
+
+private:
+  bool m_is_tuned;
+
+  void sanity_checks_periodicity() const;
+  void sanity_checks_cutoff() const;
+};
+
+#endif // ELECTROSTATICS
+#endif
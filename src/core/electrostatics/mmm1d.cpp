@@ -42,9 +42,12 @@
 #include <utils/math/sqr.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstdio>
 #include <limits>
+#include <stdexcept>
+#include <utility>
 #include <vector>
 
 /* if you define this feature, the Bessel functions are calculated up
@@ -116,11 +119,260 @@ void CoulombMMM1D::prepare_polygamma_series() {
   } while (err > 0.1 * maxPWerror);
 }
 
+/** Minimal and maximal number of table intervals per direction. */
+static constexpr int table_min_intervals = 16;
+static constexpr int table_max_intervals = 512;
+/** Maximal number of intervals of the one-dimensional Bessel table. */
+static constexpr int bessel_table_max_intervals = 8192;
+/** Maximal number of table cells probed per direction during tuning. */
+static constexpr int table_error_samples = 64;
+
+/** @brief Polygamma sums of the near formula (potential, radial force,
+ *  axial force) at <tt>rxy2_d = (rxy / box_l[2])^2</tt>.
+ */
+static Utils::Vector3d near_sums(double rxy2_d, double z_d) {
+  auto const n_modPsi = static_cast<int>(modPsi.size()) >> 1;
+  auto se = mod_psi_even(0, z_d);
+  auto sr = 0.;
+  auto sz = mod_psi_odd(0, z_d);
+  auto r2nm1 = 1.;
+  for (int n = 1; n < n_modPsi; n++) {
+    auto const mpe = mod_psi_even(n, z_d);
+    auto const r2n = r2nm1 * rxy2_d;
+    se += r2n * mpe;
+    sr += static_cast<double>(2 * n) * r2nm1 * mpe;
+    sz += r2n * mod_psi_odd(n, z_d);
+    r2nm1 = r2n;
+  }
+  return {se, sr, sz};
+}
+
+/** @brief Exponentially scaled Bessel functions <tt>K0(y) exp(y)</tt>
+ *  and <tt>K1(y) exp(y)</tt>, which vary slowly enough to be
+ *  interpolated.
+ */
+static std::pair<double, double> scaled_bessel(double y) {
+  if (y > 700.) {
+    // leading order of the asymptotic expansion, the scaling would overflow
+    auto const k = std::sqrt(Utils::pi() / (2. * y));
+    return {k, k};
+  }
+#ifdef MMM1D_MACHINE_PREC
+  auto const k0 = K0(y);
+  auto const k1 = K1(y);
+#else
+  auto const [k0, k1] = LPK01(y);
+#endif
+  auto const scale = std::exp(y);
+  return {k0 * scale, k1 * scale};
+}
+
+/** @brief Weights of the cubic Lagrange polynomial through the nodes
+ *  0, 1, 2, 3 at position @p t.
+ */
+static std::array<double, 4> lagrange_weights(double t) {
+  auto const t1 = t - 1., t2 = t - 2., t3 = t - 3.;
+  return {{-t1 * t2 * t3 / 6., t * t2 * t3 / 2., -t * t1 * t3 / 2.,
+           t * t1 * t2 / 6.}};
+}
+
+template <class F>
+void CoulombMMM1D::PolygammaTable::fill(double x_lo, double x_hi, int n,
+                                        F &&f) {
+  x_min = x_lo;
+  x_max = x_hi;
+  n_x = n;
+  n_z = n;
+  values.resize(3ul * static_cast<std::size_t>((n_x + 1) * (n_z + 1)));
+  auto const h_x = (x_max - x_min) / static_cast<double>(n_x);
+  auto const h_z = 0.5 / static_cast<double>(n_z);
+  auto it = values.begin();
+  for (int i = 0; i <= n_x; ++i) {
+    for (int j = 0; j <= n_z; ++j) {
+      auto const sums = f(x_min + i * h_x, j * h_z);
+      it = std::copy(sums.begin(), sums.end(), it);
+    }
+  }
+}
+
+Utils::Vector3d CoulombMMM1D::PolygammaTable::operator()(double x,
+                                                         double z) const {
+  auto const u = (x - x_min) / (x_max - x_min) * static_cast<double>(n_x);
+  auto const v = 2. * z * static_cast<double>(n_z);
+  auto const i = std::clamp(static_cast<int>(u) - 1, 0, n_x - 3);
+  auto const j = std::clamp(static_cast<int>(v) - 1, 0, n_z - 3);
+  auto const w_x = lagrange_weights(u - i);
+  auto const w_z = lagrange_weights(v - j);
+  Utils::Vector3d result{};
+  for (int a = 0; a < 4; ++a) {
+    auto const *node = values.data() + 3 * ((i + a) * (n_z + 1) + j);
+    Utils::Vector3d row{};
+    for (int b = 0; b < 4; ++b, node += 3) {
+      row += w_z[b] * Utils::Vector3d{node[0], node[1], node[2]};
+    }
+    result += w_x[a] * row;
+  }
+  return result;
+}
+
+void CoulombMMM1D::BesselTable::fill(double x_lo, double x_hi, int n,
+                                     int n_terms) {
+  auto constexpr c_2pi = 2. * Utils::pi();
+  x_min = x_lo;
+  x_max = x_hi;
+  n_x = n;
+  n_bessel = n_terms;
+  values.resize(2ul * static_cast<std::size_t>((n_x + 1) * n_bessel));
+  auto const h_x = (x_max - x_min) / static_cast<double>(n_x);
+  auto it = values.begin();
+  for (int i = 0; i <= n_x; ++i) {
+    for (int bp = 1; bp <= n_bessel; ++bp) {
+      auto const [k0, k1] = scaled_bessel(c_2pi * bp * (x_min + i * h_x));
+      *it++ = k0;
+      *it++ = k1;
+    }
+  }
+}
+
+std::pair<std::array<double, 4>, double const *>
+CoulombMMM1D::BesselTable::stencil(double x) const {
+  auto const u = (x - x_min) / (x_max - x_min) * static_cast<double>(n_x);
+  auto const i = std::clamp(static_cast<int>(u) - 1, 0, n_x - 3);
+  return {lagrange_weights(u - i), values.data() + 2 * n_bessel * i};
+}
+
+/** @brief Interpolate along four nodes separated by @p stride. */
+static double interpolate(std::array<double, 4> const &w, double const *node,
+                          int stride) {
+  return w[0] * node[0] + w[1] * node[stride] + w[2] * node[2 * stride] +
+         w[3] * node[3 * stride];
+}
+
+Utils::Vector3d CoulombMMM1D::BesselTable::operator()(double x, double z,
+                                                      int n_terms) const {
+  auto constexpr c_2pi = 2. * Utils::pi();
+  auto const stride = 2 * n_bessel;
+  auto [w, node] = stencil(x);
+  /* exp(-fq x) cos(fq z) and exp(-fq x) sin(fq z) for all terms follow
+   * from the first one by complex multiplication */
+  auto const damping = std::exp(-c_2pi * x);
+  auto const c_1 = damping * cos(c_2pi * z);
+  auto const s_1 = damping * sin(c_2pi * z);
+  auto c_n = c_1, s_n = s_1;
+  auto se = 0., sr = 0., sz = 0.;
+  for (int bp = 1; bp <= n_terms; ++bp, node += 2) {
+    auto const k0 = interpolate(w, node, stride);
+    auto const k1 = interpolate(w, node + 1, stride);
+    se += k0 * c_n;
+    sr += bp * k1 * c_n;
+    sz += bp * k0 * s_n;
+    auto const c_next = c_n * c_1 - s_n * s_1;
+    s_n = s_n * c_1 + c_n * s_1;
+    c_n = c_next;
+  }
+  return {se, sr, sz};
+}
+
+int CoulombMMM1D::n_bessel_terms(double rxy) const {
+  int n = 0;
+  while (n + 1 < MAXIMAL_B_CUT and bessel_radii[n] >= rxy) {
+    ++n;
+  }
+  return n;
+}
+
+bool CoulombMMM1D::prepare_tables() {
+  if (m_is_tabulated and m_table_box_l == box_geo.length() and
+      m_table_switch_radius_sq == far_switch_radius_sq) {
+    return true;
+  }
+  m_is_tabulated = false;
+  auto constexpr c_2pi = 2. * Utils::pi();
+  auto const uz = box_geo.length_inv()[2];
+  auto const tolerance = 0.5 * maxPWerror;
+
+  /* near formula: refine until the error of the potential and of both
+   * force components, probed at cell midpoints, is within tolerance */
+  auto const x_near = far_switch_radius_sq * uz2;
+  auto converged = false;
+  for (int n = table_min_intervals; n <= table_max_intervals and !converged;
+       n *= 2) {
+    m_near_table.fill(0., x_near, n, near_sums);
+    auto const n_samples = std::min(n - 1, table_error_samples);
+    auto const h_x = x_near / static_cast<double>(n);
+    auto const h_z = 0.5 / static_cast<double>(n);
+    auto error = 0.;
+    for (int k = 0; k <= n_samples and error <= tolerance; ++k) {
+      auto const x = (k * (n - 1) / n_samples + 0.5) * h_x;
+      auto const scale = Utils::Vector3d{uz, uz2 * std::sqrt(x), uz2};
+      for (int l = 0; l <= n_samples; ++l) {
+        auto const z = (l * (n - 1) / n_samples + 0.5) * h_z;
+        auto const diff = m_near_table(x, z) - near_sums(x, z);
+        for (int c = 0; c < 3; ++c) {
+          error = std::max(error, scale[c] * std::fabs(diff[c]));
+        }
+      }
+    }
+    converged = error <= tolerance;
+  }
+  if (not converged) {
+    return false;
+  }
+
+  /* far formula: only the terms whose Bessel radius exceeds the switch
+   * radius can contribute; the error bound holds for any z */
+  auto const switch_radius = std::sqrt(far_switch_radius_sq);
+  auto const n_bessel = n_bessel_terms(switch_radius);
+  auto const x_far = switch_radius * uz;
+  if (n_bessel == 0) {
+    m_far_table = BesselTable{};
+  } else {
+    converged = false;
+    for (int n = table_min_intervals;
+         n <= bessel_table_max_intervals and !converged; n *= 2) {
+      m_far_table.fill(x_far, bessel_radii[0] * uz, n, n_bessel);
+      auto const h_x = (m_far_table.x_max - x_far) / static_cast<double>(n);
+      auto error = 0.;
+      for (int k = 0; k < n and error <= tolerance; ++k) {
+        auto const x = x_far + (k + 0.5) * h_x;
+        auto const damping = std::exp(-c_2pi * x);
+        auto [w, node] = m_far_table.stencil(x);
+        auto damping_n = damping;
+        Utils::Vector3d sums{};
+        for (int bp = 1; bp <= n_bessel; ++bp, node += 2) {
+          auto const [k0, k1] = scaled_bessel(c_2pi * bp * x);
+          auto const k0_error =
+              std::fabs(interpolate(w, node, 2 * n_bessel) - k0);
+          auto const k1_error =
+              std::fabs(interpolate(w, node + 1, 2 * n_bessel) - k1);
+          sums[0] += damping_n * k0_error;
+          sums[1] += bp * damping_n * k1_error;
+          sums[2] += bp * damping_n * k0_error;
+          damping_n *= damping;
+        }
+        error = std::max({error, 4. * uz * sums[0],
+                          4. * c_2pi * uz2 * std::max(sums[1], sums[2])});
+      }
+      converged = error <= tolerance;
+    }
+    if (not converged) {
+      return false;
+    }
+  }
+
+  m_table_box_l = box_geo.length();
+  m_table_switch_radius_sq = far_switch_radius_sq;
+  m_is_tabulated = true;
+  return true;
+}
+
 CoulombMMM1D::CoulombMMM1D(double prefactor, double maxPWerror,
                            double switch_rad, int tune_timings,
-                           bool tune_verbose)
+                           bool tune_verbose, bool tabulate)
     : maxPWerror{maxPWerror}, far_switch_radius{switch_rad},
-      tune_timings{tune_timings}, tune_verbose{tune_verbose}, m_is_tuned{false},
+      tune_timings{tune_timings}, tune_verbose{tune_verbose},
+      tabulate{tabulate}, m_is_tuned{false}, m_is_tabulated{false},
+      m_table_box_l{}, m_table_switch_radius_sq{-1.},
       far_switch_radius_sq{-1.}, uz2{0.}, prefuz2{0.}, prefL3_i{0.} {
   set_prefactor(prefactor);
   if (maxPWerror <= 0.) {
@@ -160,6 +412,14 @@ void CoulombMMM1D::recalc_boxl_parameters() {
 
   determine_bessel_radii();
   prepare_polygamma_series();
+
+  if (not tabulate or far_switch_radius_sq <= 0.) {
+    m_is_tabulated = false;
+  } else if (not prepare_tables() and m_is_tuned) {
+    runtimeErrorMsg() << "MMM1D could not tabulate the pair interactions "
+                      << "to the requested accuracy, falling back to "
+                      << "direct evaluation";
+  }
 }
 
 Utils::Vector3d CoulombMMM1D::pair_force(double q1q2, Utils::Vector3d const &d,
@@ -172,23 +432,30 @@ Utils::Vector3d CoulombMMM1D::pair_force(double q1q2, Utils::Vector3d const &d,
   Utils::Vector3d force;
 
   if (rxy2 <= far_switch_radius_sq) {
-    /* polygamma summation */
     auto sr = 0.;
-    auto sz = mod_psi_odd(0, z_d);
-    auto r2nm1 = 1.;
-    for (int n = 1; n < n_modPsi; n++) {
-      auto const deriv = static_cast<double>(2 * n);
-      auto const mpe = mod_psi_even(n, z_d);
-      auto const mpo = mod_psi_odd(n, z_d);
-      auto const r2n = r2nm1 * rxy2_d;
-
-      sz += r2n * mpo;
-      sr += deriv * r2nm1 * mpe;
-
-      if (fabs(deriv * r2nm1 * mpe) < maxPWerror)
-        break;
+    auto sz = 0.;
+    if (m_is_tabulated) {
+      auto const sums = m_near_table(rxy2_d, std::fabs(z_d));
+      sr = sums[1];
+      sz = (z_d < 0.) ? -sums[2] : sums[2];
+    } else {
+      /* polygamma summation */
+      sz = mod_psi_odd(0, z_d);
+      auto r2nm1 = 1.;
+      for (int n = 1; n < n_modPsi; n++) {
+        auto const deriv = static_cast<double>(2 * n);
+        auto const mpe = mod_psi_even(n, z_d);
+        auto const mpo = mod_psi_odd(n, z_d);
+        auto const r2n = r2nm1 * rxy2_d;
+
+        sz += r2n * mpo;
+        sr += deriv * r2nm1 * mpe;
+
+        if (fabs(deriv * r2nm1 * mpe) < maxPWerror)
+          break;
 
-      r2nm1 = r2n;
+        r2nm1 = r2n;
+      }
     }
 
     double Fx = prefL3_i * sr * d[0];
@@ -227,19 +494,25 @@ Utils::Vector3d CoulombMMM1D::pair_force(double q1q2, Utils::Vector3d const &d,
     auto const rxy_d = rxy * box_geo.length_inv()[2];
     auto sr = 0., sz = 0.;
 
-    for (int bp = 1; bp < MAXIMAL_B_CUT; bp++) {
-      if (bessel_radii[bp - 1] < rxy)
-        break;
+    if (m_is_tabulated) {
+      auto const sums = m_far_table(rxy_d, z_d, n_bessel_terms(rxy));
+      sr = sums[1];
+      sz = sums[2];
+    } else {
+      for (int bp = 1; bp < MAXIMAL_B_CUT; bp++) {
+        if (bessel_radii[bp - 1] < rxy)
+          break;
 
-      auto const fq = c_2pi * bp;
+        auto const fq = c_2pi * bp;
 #ifdef MMM1D_MACHINE_PREC
-      auto const k0 = K0(fq * rxy_d);
-      auto const k1 = K1(fq * rxy_d);
+        auto const k0 = K0(fq * rxy_d);
+        auto const k1 = K1(fq * rxy_d);
 #else
-      auto const [k0, k1] = LPK01(fq * rxy_d);
+        auto const [k0, k1] = LPK01(fq * rxy_d);
 #endif
-      sr += bp * k1 * cos(fq * z_d);
-      sz += bp * k0 * sin(fq * z_d);
+        sr += bp * k1 * cos(fq * z_d);
+        sz += bp * k0 * sin(fq * z_d);
+      }
     }
     sr *= uz2 * 4. * c_2pi;
     sz *= uz2 * 4. * c_2pi;
@@ -268,16 +541,20 @@ double CoulombMMM1D::pair_energy(double const q1q2, Utils::Vector3d const &d,
     /* near range formula */
     energy = -2. * Utils::gamma();
 
-    /* polygamma summation */
-    double r2n = 1.0;
-    for (int n = 0; n < n_modPsi; n++) {
-      auto const add = mod_psi_even(n, z_d) * r2n;
-      energy -= add;
+    if (m_is_tabulated) {
+      energy -= m_near_table(rxy2_d, std::fabs(z_d))[0];
+    } else {
+      /* polygamma summation */
+      double r2n = 1.0;
+      for (int n = 0; n < n_modPsi; n++) {
+        auto const add = mod_psi_even(n, z_d) * r2n;
+        energy -= add;
 
-      if (fabs(add) < maxPWerror)
-        break;
+        if (fabs(add) < maxPWerror)
+          break;
 
-      r2n *= rxy2_d;
+        r2n *= rxy2_d;
+      }
     }
     energy *= box_geo.length_inv()[2];
 
@@ -301,12 +578,16 @@ double CoulombMMM1D::pair_energy(double const q1q2, Utils::Vector3d const &d,
     /* The first Bessel term will compensate a little bit the
        log term, so add them close together */
     energy = -0.25 * log(rxy2_d) + 0.5 * (Utils::ln_2() - Utils::gamma());
-    for (int bp = 1; bp < MAXIMAL_B_CUT; bp++) {
-      if (bessel_radii[bp - 1] < rxy)
-        break;
+    if (m_is_tabulated) {
+      energy += m_far_table(rxy_d, z_d, n_bessel_terms(rxy))[0];
+    } else {
+      for (int bp = 1; bp < MAXIMAL_B_CUT; bp++) {
+        if (bessel_radii[bp - 1] < rxy)
+          break;
 
-      auto const fq = c_2pi * bp;
-      energy += K0(fq * rxy_d) * cos(fq * z_d);
+        auto const fq = c_2pi * bp;
+        energy += K0(fq * rxy_d) * cos(fq * z_d);
+      }
     }
     energy *= 4. * box_geo.length_inv()[2];
   }
@@ -356,6 +637,12 @@ void CoulombMMM1D::tune() {
     throw std::runtime_error("MMM1D could not find a reasonable Bessel cutoff");
   }
 
+  recalc_boxl_parameters();
+  if (tabulate and not m_is_tabulated) {
+    throw std::runtime_error("MMM1D could not tabulate the pair interactions "
+                             "to the requested accuracy");
+  }
+
   m_is_tuned = true;
   on_coulomb_change();
 }
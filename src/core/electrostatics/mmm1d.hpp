@@ -42,6 +42,8 @@
 #include <utils/Vector.hpp>
 
 #include <array>
+#include <utility>
+#include <vector>
 
 /** @brief Parameters for the MMM1D electrostatic interaction */
 struct CoulombMMM1D : public Coulomb::Actor<CoulombMMM1D> {
@@ -57,9 +59,14 @@ struct CoulombMMM1D : public Coulomb::Actor<CoulombMMM1D> {
   double far_switch_radius;
   int tune_timings;
   bool tune_verbose;
+  /**
+   * @brief Interpolate the polygamma and Bessel sums from tables
+   * instead of evaluating them for every pair.
+   */
+  bool tabulate;
 
   CoulombMMM1D(double prefactor, double maxPWerror, double switch_rad,
-               int tune_timings, bool tune_verbose);
+               int tune_timings, bool tune_verbose, bool tabulate);
 
   /** Compute the pair force.
    *  @param[in]  q1q2      Product of the charges on p1 and p2.
@@ -78,6 +85,8 @@ struct CoulombMMM1D : public Coulomb::Actor<CoulombMMM1D> {
 
   void tune();
   bool is_tuned() const { return m_is_tuned; }
+  /** @brief Whether the pair interactions are currently interpolated. */
+  bool is_tabulated() const { return m_is_tabulated; }
 
   void on_activation() {
     sanity_checks();
@@ -98,7 +107,60 @@ struct CoulombMMM1D : public Coulomb::Actor<CoulombMMM1D> {
   }
 
 private:
+  /**
+   * @brief Table of the three polygamma sums of the near formula on a
+   * uniform grid of <tt>x = rxy^2 / box_l[2]^2</tt> and of the reduced
+   * axial distance <tt>|z| / box_l[2]</tt> in [0, 0.5]. The sums are
+   * stored in the order potential, radial force, axial force and are
+   * interpolated with cubic Lagrange polynomials in both directions.
+   */
+  struct PolygammaTable {
+    double x_min = 0.;
+    double x_max = 0.;
+    /** @brief Number of intervals along the radial coordinate. */
+    int n_x = 0;
+    /** @brief Number of intervals along the axial distance. */
+    int n_z = 0;
+    std::vector<double> values;
+
+    template <class F> void fill(double x_min, double x_max, int n, F &&f);
+    Utils::Vector3d operator()(double x, double z) const;
+  };
+
+  /**
+   * @brief Cache of the modified Bessel functions of the far formula on a
+   * uniform grid of <tt>x = rxy / box_l[2]</tt>. For every term @c p,
+   * <tt>K0(2 pi p x)</tt> and <tt>K1(2 pi p x)</tt> are stored scaled by
+   * <tt>exp(2 pi p x)</tt> and interpolated with cubic Lagrange
+   * polynomials; the axial dependence is evaluated exactly.
+   */
+  struct BesselTable {
+    double x_min = 0.;
+    double x_max = 0.;
+    /** @brief Number of intervals along the radial coordinate. */
+    int n_x = 0;
+    /** @brief Number of Bessel terms per node. */
+    int n_bessel = 0;
+    std::vector<double> values;
+
+    void fill(double x_min, double x_max, int n, int n_bessel);
+    std::pair<std::array<double, 4>, double const *> stencil(double x) const;
+    /** @brief Potential, radial and axial force sums over the first
+     *  @p n_terms terms at reduced axial distance @p z.
+     */
+    Utils::Vector3d operator()(double x, double z, int n_terms) const;
+  };
+
   bool m_is_tuned;
+  bool m_is_tabulated;
+  /** @brief Polygamma sums of the near formula. */
+  PolygammaTable m_near_table;
+  /** @brief Bessel functions of the far formula. */
+  BesselTable m_far_table;
+  /** @brief Box length the tables were built for. */
+  Utils::Vector3d m_table_box_l;
+  /** @brief Square of the far switch radius the tables were built for. */
+  double m_table_switch_radius_sq;
   /** @brief Square of the far switch radius. */
   double far_switch_radius_sq;
   /** @brief Squared inverse box length in z-direction. */
@@ -117,6 +179,9 @@ private:
 
   void determine_bessel_radii();
   void prepare_polygamma_series();
+  /** @brief Number of Bessel terms needed at radial distance @p rxy. */
+  int n_bessel_terms(double rxy) const;
+  bool prepare_tables();
   void recalc_boxl_parameters();
   void sanity_checks_periodicity() const;
   void sanity_checks_cell_structure() const;
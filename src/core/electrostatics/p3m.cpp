@@ -68,11 +68,14 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <complex>
 #include <cstddef>
 #include <functional>
 #include <sstream>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 void CoulombP3M::count_charged_particles() {
   auto local_n = 0;
@@ -107,8 +110,14 @@ void CoulombP3M::calc_influence_function_force() {
   auto const start = Utils::Vector3i{p3m.fft.plan[3].start};
   auto const size = Utils::Vector3i{p3m.fft.plan[3].new_mesh};
 
-  p3m.g_force = grid_influence_function<1>(p3m.params, start, start + size,
-                                           box_geo.length());
+  if (p3m.differentiation == P3MDifferentiation::ad) {
+    /* the aliasing terms do not cancel for analytical differentiation */
+    p3m.g_force = grid_influence_function_ad<1>(p3m.params, start,
+                                                start + size, box_geo.length());
+  } else {
+    p3m.g_force = grid_influence_function<1>(p3m.params, start, start + size,
+                                             box_geo.length());
+  }
 }
 
 /** Calculate the influence function optimized for the energy and the
@@ -122,6 +131,75 @@ void CoulombP3M::calc_influence_function_energy() {
                                             box_geo.length());
 }
 
+/** Calculate the self force of a charge with analytical differentiation.
+ *  Unlike with ik-differentiation, the force of a charge on itself does not
+ *  vanish, it is periodic in the position with the mesh spacing
+ *  @cite ballenegger12a. The coefficients of the first two harmonics along
+ *  each direction are calculated from the Fourier series of the self energy
+ *  on the mesh, such that the self force can be subtracted.
+ */
+void CoulombP3M::calc_self_force_corr() {
+  using namespace detail::FFT_indexing;
+  using Utils::sinc;
+
+  p3m.self_force_corr = {};
+  if (p3m.differentiation != P3MDifferentiation::ad or p3m.params.tuning) {
+    return;
+  }
+
+  auto const cao = p3m.params.cao;
+  auto const &mesh = p3m.params.mesh;
+  auto const shifts = detail::calc_meshift(mesh);
+  auto const start = Utils::Vector3i{p3m.fft.plan[3].start};
+  auto const size = Utils::Vector3i{p3m.fft.plan[3].new_mesh};
+
+  /* sums of U_m^2 and of U_m U_{m+1}, U_m U_{m+2} along one direction */
+  auto const alias_sums = [cao](double x) {
+    auto constexpr m_max = 2;
+    Utils::Vector3d sums{};
+    for (int m = -m_max; m <= m_max; m++) {
+      auto const u = std::pow(sinc(x + m), cao);
+      sums[0] += u * u;
+      sums[1] += u * std::pow(sinc(x + m + 1), cao);
+      sums[2] += u * std::pow(sinc(x + m + 2), cao);
+    }
+    return sums;
+  };
+
+  std::array<Utils::Vector3d, 2> local_corr{};
+  Utils::Vector3i n{};
+  int ind = 0;
+  for (n[0] = start[0]; n[0] < start[0] + size[0]; n[0]++) {
+    for (n[1] = start[1]; n[1] < start[1] + size[1]; n[1]++) {
+      for (n[2] = start[2]; n[2] < start[2] + size[2]; n[2]++) {
+        auto const g = p3m.fft.mode_multiplicity(n) * p3m.g_force[ind++];
+        if (g == 0.) {
+          continue;
+        }
+        auto const k_ind = Utils::Vector3i{n[KX], n[KY], n[KZ]};
+        std::array<Utils::Vector3d, 3> sums;
+        for (int d = 0; d < 3; d++) {
+          sums[d] = alias_sums(static_cast<double>(shifts[d][k_ind[d]]) /
+                               static_cast<double>(mesh[d]));
+        }
+        for (int d = 0; d < 3; d++) {
+          auto const transverse = sums[(d + 1) % 3][0] * sums[(d + 2) % 3][0];
+          for (int h = 1; h <= 2; h++) {
+            local_corr[h - 1][d] += g * sums[d][h] * transverse;
+          }
+        }
+      }
+    }
+  }
+
+  for (int h = 1; h <= 2; h++) {
+    auto const corr = boost::mpi::all_reduce(comm_cart, local_corr[h - 1],
+                                             std::plus<>());
+    p3m.self_force_corr[h - 1] =
+        2. * Utils::pi() * h * Utils::hadamard_product(corr, p3m.params.ai);
+  }
+}
+
 /** Aliasing sum used by @ref p3m_k_space_error. */
 static void p3m_tune_aliasing_sums(int nx, int ny, int nz,
                                    Utils::Vector3i const &mesh,
@@ -156,6 +234,39 @@ static void p3m_tune_aliasing_sums(int nx, int ny, int nz,
   }
 }
 
+/** Aliasing sums used by @ref p3m_k_space_error_ad. */
+static void p3m_tune_aliasing_sums_ad(int nx, int ny, int nz,
+                                      Utils::Vector3i const &mesh,
+                                      Utils::Vector3d const &mesh_i, int cao,
+                                      double alpha_L_i, double *alias1,
+                                      double *alias3) {
+  using Utils::sinc;
+
+  auto const factor1 = Utils::sqr(Utils::pi() * alpha_L_i);
+
+  *alias1 = *alias3 = 0.0;
+  for (int mx = -P3M_BRILLOUIN; mx <= P3M_BRILLOUIN; mx++) {
+    auto const nmx = nx + mx * mesh[0];
+    auto const fnmx = mesh_i[0] * nmx;
+    for (int my = -P3M_BRILLOUIN; my <= P3M_BRILLOUIN; my++) {
+      auto const nmy = ny + my * mesh[1];
+      auto const fnmy = mesh_i[1] * nmy;
+      for (int mz = -P3M_BRILLOUIN; mz <= P3M_BRILLOUIN; mz++) {
+        auto const nmz = nz + mz * mesh[2];
+        auto const fnmz = mesh_i[2] * nmz;
+
+        auto const nm2 = Utils::sqr(nmx) + Utils::sqr(nmy) + Utils::sqr(nmz);
+        auto const ex = exp(-factor1 * nm2);
+
+        auto const U2 = pow(sinc(fnmx) * sinc(fnmy) * sinc(fnmz), 2.0 * cao);
+
+        *alias1 += Utils::sqr(ex) / nm2;
+        *alias3 += U2 * ex;
+      }
+    }
+  }
+}
+
 /** Calculate the real space contribution to the rms error in the force (as
  *  described by Kolafa and Perram).
  *  \param pref       Prefactor of Coulomb interaction.
@@ -219,6 +330,63 @@ static double p3m_k_space_error(double pref, Utils::Vector3i const &mesh,
          (box_geo.length()[1] * box_geo.length()[2]);
 }
 
+/** Calculate the k-space contribution to the rms error in the force
+ *  for analytical differentiation with the optimal influence function,
+ *  as described in @cite ballenegger12a. The sum of
+ *  \f$ U_m^2 \vec{n}_m^2 \f$ over all aliases is evaluated analytically.
+ *  \param pref     Prefactor of Coulomb interaction.
+ *  \param mesh     number of mesh points in one direction.
+ *  \param cao      charge assignment order, at least 2.
+ *  \param n_c_part number of charged particles in the system.
+ *  \param sum_q2   sum of square of charges in the system
+ *  \param alpha_L  rescaled Ewald splitting parameter.
+ *  \return reciprocal (k) space error
+ */
+static double p3m_k_space_error_ad(double pref, Utils::Vector3i const &mesh,
+                                   int cao, int n_c_part, double sum_q2,
+                                   double alpha_L) {
+  assert(cao >= 2);
+  auto const mesh_i =
+      Utils::hadamard_division(Utils::Vector3d::broadcast(1.), mesh);
+  auto const alpha_L_i = 1. / alpha_L;
+  /* sums of U^2 and of U^2 n^2 over the aliases along one direction */
+  auto const alias_sums = [&](int n, int d) {
+    auto const sum_U2 = p3m_analytic_cotangent_sum(n, mesh_i[d], cao);
+    auto const sin_n = std::sin(Utils::pi() * mesh_i[d] * n) / Utils::pi();
+    auto const sum_U2_n2 = Utils::sqr(mesh[d] * sin_n) *
+                           p3m_analytic_cotangent_sum(n, mesh_i[d], cao - 1);
+    return std::make_pair(sum_U2, sum_U2_n2);
+  };
+  auto he_q = 0.;
+
+  for (int nx = -mesh[0] / 2; nx < mesh[0] / 2; nx++) {
+    auto const sx = alias_sums(nx, 0);
+    for (int ny = -mesh[1] / 2; ny < mesh[1] / 2; ny++) {
+      auto const sy = alias_sums(ny, 1);
+      for (int nz = -mesh[2] / 2; nz < mesh[2] / 2; nz++) {
+        if ((nx != 0) || (ny != 0) || (nz != 0)) {
+          auto const sz = alias_sums(nz, 2);
+          auto const cs = sx.first * sy.first * sz.first;
+          auto const alias4 = sx.second * sy.first * sz.first +
+                              sx.first * sy.second * sz.first +
+                              sx.first * sy.first * sz.second;
+          double alias1, alias3;
+          p3m_tune_aliasing_sums_ad(nx, ny, nz, mesh, mesh_i, cao, alpha_L_i,
+                                    &alias1, &alias3);
+
+          auto const d = alias1 - Utils::sqr(alias3) / (cs * alias4);
+          /* at high precision, d can become negative due to extinction;
+             also, don't take values that have no significant digits left*/
+          if (d > 0 && (fabs(d / alias1) > ROUND_ERROR_PREC))
+            he_q += d;
+        }
+      }
+    }
+  }
+  return 2. * pref * sum_q2 * sqrt(he_q / static_cast<double>(n_c_part)) /
+         (box_geo.length()[1] * box_geo.length()[2]);
+}
+
 #ifdef CUDA
 static double p3mgpu_k_space_error(double prefactor,
                                    Utils::Vector3i const &mesh, int cao,
@@ -271,20 +439,40 @@ void CoulombP3M::init() {
 
 CoulombP3M::CoulombP3M(P3MParameters &&parameters, double prefactor,
                        int tune_timings, bool tune_verbose,
-                       bool check_complex_residuals)
+                       bool check_complex_residuals,
+                       P3MDifferentiation differentiation,
+                       bool tune_differentiation, std::string tuning_cache)
     : p3m{std::move(parameters)}, tune_timings{tune_timings},
-      tune_verbose{tune_verbose}, check_complex_residuals{
-                                      check_complex_residuals} {
+      tune_verbose{tune_verbose},
+      check_complex_residuals{check_complex_residuals},
+      tune_differentiation{tune_differentiation},
+      tuning_cache{std::move(tuning_cache)} {
 
   if (tune_timings <= 0) {
     throw std::domain_error("Parameter 'timings' must be > 0");
   }
+  if (differentiation == P3MDifferentiation::ad and p3m.params.cao == 1) {
+    throw std::domain_error(
+        "Parameter 'cao' must be > 1 for analytical differentiation");
+  }
+  p3m.differentiation = differentiation;
   m_is_tuned = !p3m.params.tuning;
   p3m.params.tuning = false;
   set_prefactor(prefactor);
 }
 
 namespace {
+/** @brief Charged particles of a range, in the order of the range. */
+auto charged_particles(ParticleRange const &particles) {
+  std::vector<Particle *> charged;
+  for (auto &p : particles) {
+    if (p.q() != 0.0) {
+      charged.push_back(&p);
+    }
+  }
+  return charged;
+}
+
 template <std::size_t cao> struct AssignCharge {
   void operator()(p3m_data_struct &p3m, double q,
                   Utils::Vector3d const &real_pos,
@@ -308,12 +496,28 @@ template <std::size_t cao> struct AssignCharge {
         [q, &p3m](int ind, double w) { p3m.rs_mesh[ind] += w * q; });
   }
 
-  void operator()(p3m_data_struct &p3m, ParticleRange const &particles) {
-    for (auto &p : particles) {
-      if (p.q() != 0.0) {
-        this->operator()(p3m, p.q(), p.pos(), p3m.inter_weights);
-      }
+  void operator()(p3m_data_struct &p3m, ParticleRange const &particles,
+                  [[maybe_unused]] int n_threads) {
+    auto const charged = charged_particles(particles);
+    auto const n_charged = static_cast<int>(charged.size());
+
+    /* the weights of different particles are independent */
+    p3m.inter_weights.resize(charged.size());
+#ifdef OPENMP
+#pragma omp parallel for num_threads(n_threads)
+#endif
+    for (int i = 0; i < n_charged; ++i) {
+      auto const index = static_cast<std::size_t>(i);
+      p3m.inter_weights.store(
+          index, p3m_calculate_interpolation_weights<cao>(
+                     charged[index]->pos(), p3m.params.ai, p3m.local_mesh));
     }
+
+    p3m_parallel_assign<cao>(
+        p3m.local_mesh, p3m.inter_weights, n_threads,
+        [&p3m, &charged](std::size_t i, int ind, double w) {
+          p3m.rs_mesh[ind] += w * charged[i]->q();
+        });
   }
 };
 } // namespace
@@ -325,7 +529,8 @@ void CoulombP3M::charge_assign(ParticleRange const &particles) {
   for (int i = 0; i < p3m.local_mesh.size; i++)
     p3m.rs_mesh[i] = 0.0;
 
-  Utils::integral_parameter<AssignCharge, 1, 7>(p3m.params.cao, p3m, particles);
+  Utils::integral_parameter<AssignCharge, 1, 7>(
+      p3m.params.cao, p3m, particles, cell_structure.get_n_threads());
 }
 
 void CoulombP3M::assign_charge(double q, Utils::Vector3d const &real_pos,
@@ -342,29 +547,71 @@ void CoulombP3M::assign_charge(double q, Utils::Vector3d const &real_pos) {
 namespace {
 template <std::size_t cao> struct AssignForces {
   void operator()(p3m_data_struct &p3m, double force_prefac,
-                  ParticleRange const &particles) const {
-    using Utils::make_const_span;
-    using Utils::Span;
-    using Utils::Vector;
-
+                  ParticleRange const &particles,
+                  [[maybe_unused]] int n_threads) const {
     assert(cao == p3m.inter_weights.cao());
 
-    /* charged particle counter */
-    auto p_index = std::size_t{0ul};
+    /* the weights are cached in the order of the charged particles */
+    auto const charged = charged_particles(particles);
+    auto const n_charged = static_cast<int>(charged.size());
+    assert(charged.size() == p3m.inter_weights.size());
 
-    for (auto &p : particles) {
-      if (p.q() != 0.0) {
-        auto const pref = p.q() * force_prefac;
-        auto const w = p3m.inter_weights.load<cao>(p_index);
-
-        Utils::Vector3d force{};
-        p3m_interpolate(p3m.local_mesh, w, [&force, &p3m](int ind, double w) {
-          force += w * Utils::Vector3d{p3m.E_mesh[0][ind], p3m.E_mesh[1][ind],
-                                       p3m.E_mesh[2][ind]};
-        });
+    /* each particle only reads from the mesh */
+#ifdef OPENMP
+#pragma omp parallel for num_threads(n_threads)
+#endif
+    for (int i = 0; i < n_charged; ++i) {
+      auto &p = *charged[static_cast<std::size_t>(i)];
+      auto const pref = p.q() * force_prefac;
+      auto const w =
+          p3m.inter_weights.load<cao>(static_cast<std::size_t>(i));
+
+      Utils::Vector3d force{};
+      p3m_interpolate(p3m.local_mesh, w, [&force, &p3m](int ind, double w) {
+        force += w * Utils::Vector3d{p3m.E_mesh[0][ind], p3m.E_mesh[1][ind],
+                                     p3m.E_mesh[2][ind]};
+      });
 
-        p.force() -= pref * force;
-        ++p_index;
+      p.force() -= pref * force;
+    }
+  }
+};
+
+template <std::size_t cao> struct AssignForcesAD {
+  void operator()(p3m_data_struct &p3m, double force_prefac,
+                  ParticleRange const &particles,
+                  [[maybe_unused]] int n_threads) const {
+    auto const charged = charged_particles(particles);
+    auto const n_charged = static_cast<int>(charged.size());
+
+    /* each particle only reads from the potential mesh */
+#ifdef OPENMP
+#pragma omp parallel for num_threads(n_threads)
+#endif
+    for (int i = 0; i < n_charged; ++i) {
+      auto &p = *charged[static_cast<std::size_t>(i)];
+      auto const pref = p.q() * force_prefac;
+      auto const w = p3m_calculate_interpolation_gradient_weights<cao>(
+          p.pos(), p3m.params.ai, p3m.local_mesh);
+
+      Utils::Vector3d grad{};
+      p3m_interpolate_gradient(
+          p3m.local_mesh, w,
+          [&grad, &p3m](int ind, Utils::Vector3d const &dw) {
+            grad += dw * p3m.E_mesh[0][ind];
+          });
+
+      /* the derivatives of the weights are in mesh units */
+      p.force() -= pref * Utils::hadamard_product(p3m.params.ai, grad);
+
+      /* subtract the self force */
+      for (int d = 0; d < 3; d++) {
+        auto const s = 2. * Utils::pi() *
+                       (p.pos()[d] - p3m.local_mesh.ld_pos[d]) *
+                       p3m.params.ai[d];
+        p.force()[d] -= pref * p.q() *
+                        (p3m.self_force_corr[0][d] * std::sin(s) +
+                         p3m.self_force_corr[1][d] * std::sin(2. * s));
       }
     }
   }
@@ -404,6 +651,7 @@ Utils::Vector9d CoulombP3M::p3m_calc_kspace_pressure_tensor() {
     int ind = 0;
     int j[3];
     auto const half_alpha_inv_sq = Utils::sqr(1. / 2. / p3m.params.alpha);
+    auto const start = Utils::Vector3i{p3m.fft.plan[3].start};
     for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[RX]; j[0]++) {
       for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[RY]; j[1]++) {
         for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[RZ]; j[2]++) {
@@ -419,9 +667,11 @@ Utils::Vector9d CoulombP3M::p3m_calc_kspace_pressure_tensor() {
           auto const sqk = Utils::sqr(kx) + Utils::sqr(ky) + Utils::sqr(kz);
 
           if (sqk != 0.) {
+            auto const n = Utils::Vector3i{j} + start;
             auto const node_k_space_energy =
-                p3m.g_energy[ind] * (Utils::sqr(p3m.rs_mesh[2 * ind]) +
-                                     Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
+                p3m.fft.mode_multiplicity(n) * p3m.g_energy[ind] *
+                (Utils::sqr(p3m.rs_mesh[2 * ind]) +
+                 Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
             auto const vterm = -2. * (1. / sqk + half_alpha_inv_sq);
             auto const pref = node_k_space_energy * vterm;
             node_k_space_pressure_tensor[0] += pref * kx * kx; /* sigma_xx */
@@ -465,7 +715,25 @@ double CoulombP3M::long_range_kernel(bool force_flag, bool energy_flag,
   auto const pref = 4. * Utils::pi() / volume / (2. * p3m.params.epsilon + 1.);
 
   /* === k-space force calculation  === */
-  if (force_flag) {
+  if (force_flag and p3m.differentiation == P3MDifferentiation::ad) {
+    /* potential mesh, the charge mesh is kept for the energy */
+    auto &phi_mesh = p3m.E_mesh[0];
+    for (std::size_t i = 0; i < p3m.g_force.size(); i++) {
+      phi_mesh[2 * i + 0] = p3m.g_force[i] * p3m.rs_mesh[2 * i + 0];
+      phi_mesh[2 * i + 1] = p3m.g_force[i] * p3m.rs_mesh[2 * i + 1];
+    }
+
+    /* Back FFT and redistribute potential mesh */
+    auto const check_complex = !p3m.params.tuning and check_complex_residuals;
+    fft_perform_back(phi_mesh.data(), check_complex, p3m.fft, comm_cart);
+    p3m.sm.spread_grid(phi_mesh.data(), comm_cart, p3m.local_mesh.dim);
+
+    /* analytical differentiation of the charge assignment function */
+    auto const force_prefac = prefactor / volume;
+    Utils::integral_parameter<AssignForcesAD, 2, 7>(
+        p3m.params.cao, p3m, force_prefac, particles,
+        cell_structure.get_n_threads());
+  } else if (force_flag) {
     /* sqrt(-1)*k differentiation */
     int j[3];
     int ind = 0;
@@ -507,25 +775,38 @@ double CoulombP3M::long_range_kernel(bool force_flag, bool energy_flag,
                        p3m.local_mesh.dim);
 
     auto const force_prefac = prefactor / volume;
-    Utils::integral_parameter<AssignForces, 1, 7>(p3m.params.cao, p3m,
-                                                  force_prefac, particles);
-
-    // add dipole forces
-    if (p3m.params.epsilon != P3M_EPSILON_METALLIC) {
-      auto const dm = prefactor * pref * box_dipole.value();
-      for (auto &p : particles) {
-        p.force() -= p.q() * dm;
-      }
+    Utils::integral_parameter<AssignForces, 1, 7>(
+        p3m.params.cao, p3m, force_prefac, particles,
+        cell_structure.get_n_threads());
+  }
+
+  // add dipole forces
+  if (force_flag and p3m.params.epsilon != P3M_EPSILON_METALLIC) {
+    auto const dm = prefactor * pref * box_dipole.value();
+    for (auto &p : particles) {
+      p.force() -= p.q() * dm;
     }
   }
 
   /* === k-space energy calculation  === */
   if (energy_flag) {
     auto node_energy = 0.;
-    for (int i = 0; i < p3m.fft.plan[3].new_size; i++) {
-      // Use the energy optimized influence function for energy!
-      node_energy += p3m.g_energy[i] * (Utils::sqr(p3m.rs_mesh[2 * i]) +
-                                        Utils::sqr(p3m.rs_mesh[2 * i + 1]));
+    auto const start = Utils::Vector3i{p3m.fft.plan[3].start};
+    Utils::Vector3i j{};
+    int ind = 0;
+    for (j[0] = 0; j[0] < p3m.fft.plan[3].new_mesh[0]; j[0]++) {
+      for (j[1] = 0; j[1] < p3m.fft.plan[3].new_mesh[1]; j[1]++) {
+        for (j[2] = 0; j[2] < p3m.fft.plan[3].new_mesh[2]; j[2]++) {
+          // Use the energy optimized influence function for energy!
+          // Modes not stored in the half spectrum contribute the same
+          // energy as their complex conjugates.
+          node_energy += p3m.fft.mode_multiplicity(j + start) *
+                         p3m.g_energy[ind] *
+                         (Utils::sqr(p3m.rs_mesh[2 * ind]) +
+                          Utils::sqr(p3m.rs_mesh[2 * ind + 1]));
+          ind++;
+        }
+      }
     }
     node_energy /= 2. * volume;
 
@@ -553,16 +834,44 @@ class CoulombTuningAlgorithm : public TuningAlgorithm {
   double m_mesh_density_min = -1., m_mesh_density_max = -1.;
   // indicates if mesh should be tuned
   bool m_tune_mesh = false;
+  // indicates if both differentiation schemes should be compared
+  bool m_tune_differentiation;
 
 public:
   CoulombTuningAlgorithm(p3m_data_struct &input_p3m, double prefactor,
-                         int timings)
-      : TuningAlgorithm{prefactor, timings}, p3m{input_p3m} {}
+                         int timings, bool tune_differentiation)
+      : TuningAlgorithm{prefactor, timings}, p3m{input_p3m},
+        m_tune_differentiation{tune_differentiation} {}
 
   P3MParameters &get_params() override { return p3m.params; }
 
   void on_solver_change() const override { on_coulomb_change(); }
 
+  std::vector<double> particle_signature() const override {
+    return {static_cast<double>(p3m.sum_qpart), p3m.sum_q2};
+  }
+
+  std::vector<double> solver_signature() const override {
+    auto const differentiation = (m_tune_differentiation)
+                                     ? -1.
+                                     : static_cast<double>(p3m.differentiation);
+    auto gap_size = -1.;
+    if (auto elc_actor = get_actor_by_type<ElectrostaticLayerCorrection>(
+            electrostatics_actor)) {
+      gap_size = elc_actor->elc.gap_size;
+    }
+    return {differentiation, gap_size};
+  }
+
+  std::vector<double> get_tuned_state() const override {
+    return {static_cast<double>(p3m.differentiation)};
+  }
+
+  void set_tuned_state(std::vector<double> const &state) override {
+    p3m.differentiation =
+        static_cast<P3MDifferentiation>(static_cast<int>(state[0]));
+  }
+
   void setup_logger(bool verbose) override {
 #ifdef CUDA
     auto const on_gpu = has_actor_of_type<CoulombP3MGPU>(electrostatics_actor);
@@ -616,8 +925,11 @@ public:
                                     p3m.sum_q2, alpha_L);
     } else
 #endif
-      ks_err = p3m_k_space_error(m_prefactor, mesh, cao, p3m.sum_qpart,
-                                 p3m.sum_q2, alpha_L);
+      ks_err = (p3m.differentiation == P3MDifferentiation::ad)
+                   ? p3m_k_space_error_ad(m_prefactor, mesh, cao,
+                                          p3m.sum_qpart, p3m.sum_q2, alpha_L)
+                   : p3m_k_space_error(m_prefactor, mesh, cao, p3m.sum_qpart,
+                                       p3m.sum_q2, alpha_L);
 
     return {Utils::Vector2d{rs_err, ks_err}.norm(), rs_err, ks_err, alpha_L};
   }
@@ -655,6 +967,42 @@ public:
   }
 
   TuningAlgorithm::Parameters get_time() override {
+    if (not m_tune_differentiation) {
+      return get_mesh_time();
+    }
+    /* tune both differentiation schemes from the same initial guesses */
+    auto const cao_min_initial = cao_min;
+    auto const cao_best_initial = cao_best;
+    auto const r_cut_iL_max_initial = m_r_cut_iL_max;
+    auto tuned_params = TuningAlgorithm::Parameters{};
+    auto tuned_differentiation = P3MDifferentiation::ik;
+    for (auto const differentiation :
+         {P3MDifferentiation::ik, P3MDifferentiation::ad}) {
+      auto const is_ad = differentiation == P3MDifferentiation::ad;
+      /* analytical differentiation needs a differentiable assignment */
+      cao_min = (is_ad) ? std::max(cao_min_initial, 2) : cao_min_initial;
+      if (cao_min > cao_max) {
+        continue;
+      }
+      cao_best = std::max(cao_best_initial, cao_min);
+      m_r_cut_iL_max = r_cut_iL_max_initial;
+      reset_n_trials();
+      p3m.differentiation = differentiation;
+      m_logger->report_differentiation((is_ad) ? "ad" : "ik");
+      auto const trial_params = get_mesh_time();
+      if (trial_params.time < tuned_params.time) {
+        tuned_params = trial_params;
+        tuned_differentiation = differentiation;
+      }
+    }
+    cao_min = cao_min_initial;
+    p3m.differentiation = tuned_differentiation;
+    return tuned_params;
+  }
+
+private:
+  /** @brief Find the fastest mesh for the current differentiation scheme. */
+  TuningAlgorithm::Parameters get_mesh_time() {
     auto tuned_params = TuningAlgorithm::Parameters{};
     auto time_best = time_sentinel;
     auto mesh_density = m_mesh_density_min;
@@ -714,7 +1062,9 @@ void CoulombP3M::tune() {
           "CoulombP3M: no charged particles in the system");
     }
     try {
-      CoulombTuningAlgorithm parameters(p3m, prefactor, tune_timings);
+      CoulombTuningAlgorithm parameters(p3m, prefactor, tune_timings,
+                                        tune_differentiation);
+      parameters.set_cache_path(tuning_cache);
       parameters.setup_logger(tune_verbose);
       // parameter ranges
       parameters.determine_mesh_limits();
@@ -788,6 +1138,29 @@ void CoulombP3M::sanity_checks_node_grid() const {
     throw std::runtime_error(
         "CoulombP3M: node grid must be sorted, largest first");
   }
+  if (not has_uniform_node_domains()) {
+    throw std::runtime_error("CoulombP3M: requires local boxes of equal size");
+  }
+}
+
+/**
+ * @brief Scaling factor of an isotropic box change.
+ * @return The ratio of the box lengths, or nothing if the box
+ * was rescaled anisotropically or if there is no old box.
+ */
+static boost::optional<double>
+isotropic_scaling_factor(Utils::Vector3d const &old_box_l,
+                         Utils::Vector3d const &new_box_l) {
+  if (old_box_l == Utils::Vector3d{}) {
+    return {};
+  }
+  auto const factor = new_box_l[0] / old_box_l[0];
+  for (int i : {1, 2}) {
+    if (std::abs(new_box_l[i] / old_box_l[i] - factor) > 1e-12 * factor) {
+      return {};
+    }
+  }
+  return factor;
 }
 
 void CoulombP3M::scaleby_box_l() {
@@ -796,8 +1169,34 @@ void CoulombP3M::scaleby_box_l() {
   p3m.params.recalc_a_ai_cao_cut(box_geo.length());
   p3m.local_mesh.recalc_ld_pos(p3m.params);
   sanity_checks_boxl();
-  calc_influence_function_force();
-  calc_influence_function_energy();
+  auto const g_params = p3m_data_struct::InfluenceFunctionParameters{
+      p3m.params.mesh,
+      p3m.params.cao,
+      p3m.params.alpha_L,
+      static_cast<int>(p3m.differentiation),
+      Utils::Vector3i{p3m.fft.plan[3].start},
+      Utils::Vector3i{p3m.fft.plan[3].new_mesh}};
+  auto const factor =
+      (g_params == p3m.g_params)
+          ? isotropic_scaling_factor(p3m.g_box_l, box_geo.length())
+          : boost::none;
+  if (factor) {
+    /* With fixed alpha_L, mesh and cao, all k vectors scale with the
+     * inverse box length while the products k*h and k/alpha are
+     * invariant. Both influence functions thus scale with the square
+     * of the box length, and the self force with the box length. */
+    p3m.scale_influence_functions(Utils::sqr(*factor));
+    for (auto &corr : p3m.self_force_corr) {
+      corr *= *factor;
+    }
+  } else {
+    calc_influence_function_force();
+    calc_influence_function_energy();
+    calc_self_force_corr();
+  }
+  p3m.g_params = g_params;
+  /* influence functions of the tuning mode are placeholders */
+  p3m.g_box_l = (p3m.params.tuning) ? Utils::Vector3d{} : box_geo.length();
 }
 
 #endif // P3M
@@ -55,6 +55,18 @@
 
 #include <array>
 #include <cmath>
+#include <string>
+
+/** @brief Differentiation scheme of the mesh potential. */
+enum class P3MDifferentiation : int {
+  /** @brief Differentiation in k-space, with three back FFTs. */
+  ik,
+  /**
+   * @brief Analytical differentiation of the charge assignment function,
+   * with one back FFT.
+   */
+  ad
+};
 
 struct p3m_data_struct : public p3m_data_struct_base {
   explicit p3m_data_struct(P3MParameters &&parameters)
@@ -64,8 +76,14 @@ struct p3m_data_struct : public p3m_data_struct_base {
   P3MLocalMesh local_mesh;
   /** real space mesh (local) for CA/FFT. */
   fft_vector<double> rs_mesh;
-  /** mesh (local) for the electric field. */
+  /** mesh (local) for the electric field, or for the potential in the
+   *  first component with analytical differentiation. */
   std::array<fft_vector<double>, 3> E_mesh;
+  /** differentiation scheme of the mesh potential. */
+  P3MDifferentiation differentiation = P3MDifferentiation::ik;
+  /** coefficients of the first two harmonics of the self force with
+   *  analytical differentiation, for each direction. */
+  std::array<Utils::Vector3d, 2> self_force_corr;
 
   /** number of charged particles (only on head node). */
   int sum_qpart = 0;
@@ -90,13 +108,19 @@ struct CoulombP3M : public Coulomb::Actor<CoulombP3M> {
   int tune_timings;
   bool tune_verbose;
   bool check_complex_residuals;
+  /** Let the tuning choose the faster differentiation scheme. */
+  bool tune_differentiation;
+  /** File to store and look up tuned parameters, empty to disable. */
+  std::string tuning_cache;
 
 private:
   bool m_is_tuned;
 
 public:
   CoulombP3M(P3MParameters &&parameters, double prefactor, int tune_timings,
-             bool tune_verbose, bool check_complex_residuals);
+             bool tune_verbose, bool check_complex_residuals,
+             P3MDifferentiation differentiation, bool tune_differentiation,
+             std::string tuning_cache);
 
   bool is_tuned() const { return m_is_tuned; }
 
@@ -158,7 +182,11 @@ public:
    *
    * After checking if the total error lies below the target accuracy,
    * the time needed for one force calculation is measured. Parameters
-   * that minimize the runtime are kept.
+   * that minimize the runtime are kept. With @ref tune_differentiation,
+   * this is done for both differentiation schemes and the faster one is
+   * kept, using the error estimate of @cite ballenegger12a for analytical
+   * differentiation. With a @ref tuning_cache, the parameters of a
+   * previous tuning of the same system are re-used.
    *
    * The function is based on routines of the program HE_Q.cpp written by M.
    * Deserno.
@@ -237,6 +265,7 @@ public:
 private:
   void calc_influence_function_force();
   void calc_influence_function_energy();
+  void calc_self_force_corr();
 
   /** Checks for correctness of the k-space cutoff. */
   void sanity_checks_boxl() const;
@@ -42,6 +42,7 @@
 #include <utils/Span.hpp>
 
 #include <memory>
+#include <stdexcept>
 
 std::shared_ptr<Observable_stat> calculate_energy() {
 
@@ -130,6 +131,10 @@ double mpi_observable_compute_energy() {
 }
 
 double particle_short_range_energy_contribution(int pid) {
+  if (cell_structure.has_half_shell_ghosts()) {
+    throw std::runtime_error("Cannot compute the energy of a particle with "
+                             "the half-shell ghost import");
+  }
   double ret = 0.0;
 
   if (cell_structure.get_resort_particles()) {
@@ -47,6 +47,7 @@ double mpi_observable_compute_energy();
  *
  * @param pid    Particle id
  * @return Non-bonded energy of the particle.
+ * @throws std::runtime_error with the half-shell ghost import.
  */
 double particle_short_range_energy_contribution(int pid);
 
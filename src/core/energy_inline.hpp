@@ -62,22 +62,15 @@
 #include <boost/range/algorithm/find_if.hpp>
 #include <boost/variant.hpp>
 
-/** Calculate non-bonded energies between a pair of particles.
- *  @param p1         particle 1.
- *  @param p2         particle 2.
+/** Calculate the central non-bonded energies between a pair of particles.
+ *  These energies only depend on the particle types and on the distance.
  *  @param ia_params  the interaction parameters between the two particles
- *  @param d          vector between p1 and p2.
- *  @param dist       distance between p1 and p2.
- *  @param coulomb_kernel   %Coulomb energy kernel.
- *  @return the short-range interaction energy between the two particles
+ *  @param dist       distance between the two particles.
  */
-inline double calc_non_bonded_pair_energy(
-    Particle const &p1, Particle const &p2, IA_parameters const &ia_params,
-    Utils::Vector3d const &d, double const dist,
-    Coulomb::ShortRangeEnergyKernel::kernel_type const *coulomb_kernel) {
+inline double calc_central_radial_energy(IA_parameters const &ia_params,
+                                         double const dist) {
 
   double ret = 0;
-
 #ifdef LENNARD_JONES
   /* Lennard-Jones */
   ret += lj_pair_energy(ia_params, dist);
@@ -137,11 +130,6 @@ inline double calc_non_bonded_pair_energy(
   ret += ljcos2_pair_energy(ia_params, dist);
 #endif
 
-#ifdef THOLE
-  /* Thole damping */
-  ret += thole_pair_energy(p1, p2, ia_params, d, dist, coulomb_kernel);
-#endif
-
 #ifdef TABULATED
   /* tabulated */
   ret += tabulated_pair_energy(ia_params, dist);
@@ -152,6 +140,33 @@ inline double calc_non_bonded_pair_energy(
   ret += ljcos_pair_energy(ia_params, dist);
 #endif
 
+  return ret;
+}
+
+/** Calculate non-bonded energies between a pair of particles.
+ *  @param p1         particle 1.
+ *  @param p2         particle 2.
+ *  @param ia_params  the interaction parameters between the two particles
+ *  @param d          vector between p1 and p2.
+ *  @param dist       distance between p1 and p2.
+ *  @param coulomb_kernel   %Coulomb energy kernel.
+ *  @return the short-range interaction energy between the two particles
+ */
+inline double calc_non_bonded_pair_energy(
+    Particle const &p1, Particle const &p2, IA_parameters const &ia_params,
+    Utils::Vector3d const &d, double const dist,
+    Coulomb::ShortRangeEnergyKernel::kernel_type const *coulomb_kernel) {
+
+  auto const &spline = ia_params.spline_tabulation;
+  double ret = (spline.is_tabulated() and dist >= spline.min)
+                   ? spline.energy(dist)
+                   : calc_central_radial_energy(ia_params, dist);
+
+#ifdef THOLE
+  /* Thole damping */
+  ret += thole_pair_energy(p1, p2, ia_params, d, dist, coulomb_kernel);
+#endif
+
 #ifdef GAY_BERNE
   /* Gay-Berne */
   ret += gb_pair_energy(p1.quat(), p2.quat(), ia_params, d, dist);
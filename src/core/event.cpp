@@ -46,6 +46,7 @@
 #include "interactions.hpp"
 #include "magnetostatics/dipoles.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "nonbonded_interactions/spline_tabulation.hpp"
 #include "npt.hpp"
 #include "partCfg_global.hpp"
 #include "particle_node.hpp"
@@ -97,6 +98,7 @@ void on_integration_start(double time_step) {
   integrator_npt_sanity_checks();
 #endif
   long_range_interactions_sanity_checks();
+  cells_sanity_checks();
   lb_lbfluid_sanity_checks(time_step);
 
   /********************************************/
@@ -237,6 +239,7 @@ void on_dipoles_change() {
 }
 
 void on_non_bonded_ia_change() {
+  update_spline_tabulations();
   maximal_cutoff_nonbonded();
   on_short_range_ia_change();
 }
@@ -340,6 +343,19 @@ void on_node_grid_change() {
   cells_re_init(cell_structure.decomposition_type());
 }
 
+void on_node_domain_change() {
+  /* the Cartesian communicator is unchanged, only the local boxes and
+   * their cell grids are rebuilt */
+  grid_changed_box_l(box_geo);
+#ifdef ELECTROSTATICS
+  Coulomb::on_node_grid_change();
+#endif
+#ifdef DIPOLES
+  Dipoles::on_node_grid_change();
+#endif
+  cells_re_init(cell_structure.decomposition_type());
+}
+
 /**
  * @brief Returns the ghost flags required for running pair
  *        kernels for the global state, e.g. the force calculation.
@@ -128,6 +128,10 @@ void on_forcecap_change();
  */
 void on_node_grid_change();
 
+/** @brief Called when the boundaries between the local boxes changed.
+ */
+void on_node_domain_change();
+
 unsigned global_ghost_flags();
 
 /** called every time the walls for the lb fluid are changed */
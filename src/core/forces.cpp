@@ -43,8 +43,10 @@
 #include "immersed_boundaries.hpp"
 #include "integrate.hpp"
 #include "interactions.hpp"
+#include "load_balancing.hpp"
 #include "magnetostatics/dipoles.hpp"
 #include "nonbonded_interactions/VerletCriterion.hpp"
+#include "nonbonded_interactions/cluster_pair_kernel.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
 #include "rotation.hpp"
@@ -52,13 +54,19 @@
 #include "thermostat.hpp"
 #include "thermostats/langevin_inline.hpp"
 #include "virtual_sites.hpp"
+#include "virtual_sites/VirtualSitesOff.hpp"
 
 #include <boost/variant.hpp>
 
 #include <profiler/profiler.hpp>
 
 #include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <limits>
 #include <memory>
+#include <utility>
+#include <vector>
 
 std::shared_ptr<ComFixed> comfixed = std::make_shared<ComFixed>();
 
@@ -144,7 +152,36 @@ void init_forces_ghosts(const ParticleRange &particles) {
   }
 }
 
-void force_calc(CellStructure &cell_structure, double time_step, double kT) {
+/** Add the long range forces multiplied by @p weight. */
+static void add_long_range_forces(ParticleRange const &particles,
+                                  double weight) {
+  if (weight == 0.) {
+    return;
+  }
+  if (weight == 1.) {
+    calc_long_range_forces(particles);
+    return;
+  }
+  std::vector<ParticleForce> forces;
+  forces.reserve(particles.size());
+  for (auto &p : particles) {
+    forces.emplace_back(p.force_and_torque());
+    p.force_and_torque() = {};
+  }
+  calc_long_range_forces(particles);
+  auto it = forces.begin();
+  for (auto &p : particles) {
+    auto &f = p.force_and_torque();
+    f.f *= weight;
+#ifdef ROTATION
+    f.torque *= weight;
+#endif
+    f += *it++;
+  }
+}
+
+void force_calc(CellStructure &cell_structure, double time_step, double kT,
+                double long_range_weight) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   auto &espresso_system = EspressoSystemInterface::Instance();
@@ -160,13 +197,27 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   if (electrostatics_extension) {
     if (auto icc = boost::get<std::shared_ptr<ICCStar>>(
             electrostatics_extension.get_ptr())) {
+      cell_structure.ghosts_wait();
       (**icc).iteration(cell_structure, particles, ghost_particles);
     }
   }
 #endif
   init_forces(particles, ghost_particles, time_step, kT);
 
-  calc_long_range_forces(particles);
+  /* The long-range forces and the constraints only act on the real
+   * particles, hence they can be computed while the ghost forces are
+   * reduced, unless virtual sites or GPU methods need them earlier */
+  auto overlap_force_reduction =
+      cell_structure.use_ghost_overlap and espresso_system.npart_gpu() == 0;
+#ifdef VIRTUAL_SITES
+  overlap_force_reduction &=
+      static_cast<bool>(std::dynamic_pointer_cast<VirtualSitesOff>(
+          virtual_sites()));
+#endif
+
+  if (not overlap_force_reduction) {
+    add_long_range_forces(particles, long_range_weight);
+  }
 
   auto const elc_kernel = Coulomb::pair_force_elc_kernel();
   auto const coulomb_kernel = Coulomb::pair_force_kernel();
@@ -184,28 +235,137 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
   auto const dipole_cutoff = INACTIVE_CUTOFF;
 #endif
 
-  short_range_loop(
+  /* Bonds created during the integration step are not tracked
+   * by the bond tables */
+  auto use_bond_tables = cell_structure.use_bond_tables;
+#ifdef COLLISION_DETECTION
+  use_bond_tables &= (collision_params.mode == CollisionModeType::OFF);
+#endif
+
+  auto const bond_kernel = TabulatedBondKernel{
       [coulomb_kernel_ptr = coulomb_kernel.get_ptr()](
           Particle &p1, int bond_id, Utils::Span<Particle *> partners) {
         return add_bonded_force(p1, bond_id, partners, coulomb_kernel_ptr);
       },
-      [coulomb_kernel_ptr = coulomb_kernel.get_ptr(),
-       dipoles_kernel_ptr = dipoles_kernel.get_ptr(),
-       elc_kernel_ptr = elc_kernel.get_ptr()](Particle &p1, Particle &p2,
-                                              Distance const &d) {
-        add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
-                                  coulomb_kernel_ptr, dipoles_kernel_ptr,
-                                  elc_kernel_ptr);
+      [](BondTable const &table) { add_bond_table_forces(table); },
+      has_bond_table_kernel, use_bond_tables};
+  auto const verlet_criterion =
+      VerletCriterion<>{skin, interaction_range(), coulomb_cutoff,
+                        dipole_cutoff, collision_detection_cutoff()};
+
+  /* The pair kernel can only run on several threads when it doesn't
+   * accumulate into global state */
+  auto thread_safe_pair_kernel = true;
+#ifdef NPT
+  thread_safe_pair_kernel &= (integ_switch != INTEG_METHOD_NPT_ISO);
+#endif
 #ifdef COLLISION_DETECTION
-        if (collision_params.mode != CollisionModeType::OFF)
-          detect_collision(p1, p2, d.dist2);
+  thread_safe_pair_kernel &= (collision_params.mode == CollisionModeType::OFF);
+#endif
+
+  /* Central forces and short-range electrostatics only need positions,
+   * types and charges, which are read from the hot particle data */
+  auto use_hot_particle_data = cell_structure.use_hot_particle_data and
+                               thread_safe_pair_kernel and
+                               not dipoles_kernel and not elc_kernel;
+#ifdef DPD
+  use_hot_particle_data &= not(thermo_switch & THERMO_DPD);
 #endif
-      },
-      maximal_cutoff(n_nodes), maximal_cutoff_bonded(),
-      VerletCriterion<>{skin, interaction_range(), coulomb_cutoff,
-                        dipole_cutoff, collision_detection_cutoff()});
 
-  Constraints::constraints.add_forces(particles, get_sim_time());
+  /* Compact Verlet lists are only kept by the loop over the hot Verlet
+   * lists, which then replaces the cluster pair lists and the tiles */
+  auto const use_compact_verlet_lists = use_hot_particle_data and
+                                        cell_structure.use_verlet_list and
+                                        cell_structure.use_compact_verlet_list;
+
+  /* Without electrostatics, the cluster pair lists replace the Verlet
+   * lists, such that the common potentials can be vectorized */
+  auto const &decomposition = std::as_const(cell_structure).decomposition();
+  auto const use_cluster_pairs =
+      use_hot_particle_data and not use_compact_verlet_lists and
+      not coulomb_kernel and cell_structure.use_verlet_list and
+      decomposition.minimum_image_distance() and
+      decomposition.box().type() == BoxType::CUBOID;
+  /* The atom decomposition visits all pairs of particles, which is done
+   * in cache-sized tiles of clusters without any pair lists */
+  auto const use_tiles =
+      use_hot_particle_data and not use_compact_verlet_lists and
+      not coulomb_kernel and
+      cell_structure.decomposition_type() ==
+          CellStructureType::CELL_STRUCTURE_NSQUARE and
+      decomposition.minimum_image_distance() and
+      decomposition.box().type() == BoxType::CUBOID;
+  /* Electrostatics without a cutoff, such as MMM1D, act on all pairs of
+   * the atom decomposition, which are visited in tiles without pair lists
+   * and distributed over the threads of the cell system */
+  auto const use_pair_tiles =
+      use_hot_particle_data and not use_compact_verlet_lists and
+      coulomb_kernel and
+      coulomb_cutoff == std::numeric_limits<double>::infinity() and
+      cell_structure.decomposition_type() ==
+          CellStructureType::CELL_STRUCTURE_NSQUARE;
+
+  auto const hot_pair_kernel = [coulomb_kernel_ptr = coulomb_kernel.get_ptr()](
+                                   HotParticleData &data, std::size_t i,
+                                   std::size_t j, Utils::Vector3d const &d,
+                                   double dist2) {
+    add_non_bonded_pair_force(data, i, j, d, sqrt(dist2), dist2,
+                              coulomb_kernel_ptr);
+  };
+
+  auto const short_range_start = std::chrono::steady_clock::now();
+  if (use_tiles or use_cluster_pairs) {
+    auto const cluster_loop = [&](auto const &cluster_kernel) {
+      if (use_tiles) {
+        tiled_short_range_loop(bond_kernel, cluster_kernel,
+                               maximal_cutoff(n_nodes),
+                               maximal_cutoff_bonded());
+      } else {
+        cluster_short_range_loop(bond_kernel, cluster_kernel,
+                                 maximal_cutoff(n_nodes),
+                                 maximal_cutoff_bonded(), interaction_range());
+      }
+    };
+    if (cell_structure.use_mixed_precision) {
+      cluster_loop(ClusterPairKernel<decltype(hot_pair_kernel), float>{
+          hot_pair_kernel, decomposition.box()});
+    } else {
+      cluster_loop(ClusterPairKernel<decltype(hot_pair_kernel)>{
+          hot_pair_kernel, decomposition.box()});
+    }
+  } else if (use_pair_tiles) {
+    hot_tiled_short_range_loop(bond_kernel, hot_pair_kernel,
+                               maximal_cutoff(n_nodes),
+                               maximal_cutoff_bonded());
+  } else if (use_hot_particle_data) {
+    hot_short_range_loop(bond_kernel, hot_pair_kernel, maximal_cutoff(n_nodes),
+                         maximal_cutoff_bonded(), verlet_criterion);
+  } else {
+    short_range_loop(
+        bond_kernel,
+        [coulomb_kernel_ptr = coulomb_kernel.get_ptr(),
+         dipoles_kernel_ptr = dipoles_kernel.get_ptr(),
+         elc_kernel_ptr = elc_kernel.get_ptr()](Particle &p1, Particle &p2,
+                                                Distance const &d) {
+          add_non_bonded_pair_force(p1, p2, d.vec21, sqrt(d.dist2), d.dist2,
+                                    coulomb_kernel_ptr, dipoles_kernel_ptr,
+                                    elc_kernel_ptr);
+#ifdef COLLISION_DETECTION
+          if (collision_params.mode != CollisionModeType::OFF)
+            detect_collision(p1, p2, d.dist2);
+#endif
+        },
+        maximal_cutoff(n_nodes), maximal_cutoff_bonded(), verlet_criterion,
+        thread_safe_pair_kernel);
+  }
+  LoadBalancing::add_short_range_time(std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - short_range_start).count());
+
+  cell_structure.ghosts_wait();
+
+  if (not overlap_force_reduction) {
+    Constraints::constraints.add_forces(particles, get_sim_time());
+  }
 
   if (max_oif_objects) {
     // There are two global quantities that need to be evaluated:
@@ -238,7 +398,14 @@ void force_calc(CellStructure &cell_structure, double time_step, double kT) {
 #endif
 
   // Communication Step: ghost forces
-  cell_structure.ghosts_reduce_forces();
+  if (overlap_force_reduction) {
+    cell_structure.ghosts_reduce_forces_begin();
+    add_long_range_forces(particles, long_range_weight);
+    Constraints::constraints.add_forces(particles, get_sim_time());
+    cell_structure.ghosts_wait();
+  } else {
+    cell_structure.ghosts_reduce_forces();
+  }
 
   // should be pretty late, since it needs to zero out the total force
   comfixed->apply(comm_cart, particles);
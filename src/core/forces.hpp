@@ -56,8 +56,16 @@ void init_forces_ghosts(const ParticleRange &particles);
  *  <li> Calculate non-bonded short range interaction forces
  *  <li> Calculate long range interaction forces
  *  </ol>
+ *
+ *  @param cell_structure     Cell structure
+ *  @param time_step          Time step
+ *  @param kT                 Thermal energy
+ *  @param long_range_weight  Factor applied to the long range forces,
+ *                            which are skipped when it is zero
+ *                            (multiple time step integration)
  */
-void force_calc(CellStructure &cell_structure, double time_step, double kT);
+void force_calc(CellStructure &cell_structure, double time_step, double kT,
+                double long_range_weight = 1.);
 
 /** Calculate long range forces (P3M, ...). */
 void calc_long_range_forces(const ParticleRange &particles);
@@ -62,6 +62,8 @@
 
 #include "Particle.hpp"
 #include "bond_error.hpp"
+#include "cell_system/BondTables.hpp"
+#include "cell_system/HotParticleData.hpp"
 #include "errorhandling.hpp"
 #include "exclusions.hpp"
 #include "thermostat.hpp"
@@ -69,17 +71,21 @@
 #include <utils/Span.hpp>
 #include <utils/Vector.hpp>
 
+#include <boost/container/static_vector.hpp>
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
 
+#include <array>
+#include <cstddef>
 #include <tuple>
+#include <utility>
 
-inline ParticleForce calc_non_bonded_pair_force(
-    Particle const &p1, Particle const &p2, IA_parameters const &ia_params,
-    Utils::Vector3d const &d, double const dist,
-    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel) {
-
-  ParticleForce pf{};
+/** Calculate the magnitude of the central non-bonded forces, divided by
+ *  the distance. These forces only depend on the particle types and on
+ *  the distance.
+ */
+inline double calc_central_radial_force_factor(IA_parameters const &ia_params,
+                                               double const dist) {
   double force_factor = 0;
 /* Lennard-Jones */
 #ifdef LENNARD_JONES
@@ -133,13 +139,153 @@ inline ParticleForce calc_non_bonded_pair_force(
 #ifdef LJCOS2
   force_factor += ljcos2_pair_force_factor(ia_params, dist);
 #endif
-/* Thole damping */
-#ifdef THOLE
-  pf.f += thole_pair_force(p1, p2, ia_params, d, dist, coulomb_kernel);
-#endif
 /* tabulated */
 #ifdef TABULATED
   force_factor += tabulated_pair_force_factor(ia_params, dist);
+#endif
+  return force_factor;
+}
+
+/** Central force kernel with only the potentials of @p Kernel.
+ *  @tparam Kernel one of @ref CentralForceKernel::Kernel.
+ */
+template <int Kernel>
+double central_radial_force_factor(IA_parameters const &ia_params,
+                                   double const dist) {
+  using namespace CentralForceKernel;
+  if constexpr (Kernel == KERNEL_GENERIC) {
+    return calc_central_radial_force_factor(ia_params, dist);
+  }
+#ifdef LENNARD_JONES
+  if constexpr (Kernel == KERNEL_LJ) {
+    return lj_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef WCA
+  if constexpr (Kernel == KERNEL_WCA) {
+    return wca_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  if constexpr (Kernel == KERNEL_LJGEN) {
+    return ljgen_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef SMOOTH_STEP
+  if constexpr (Kernel == KERNEL_SMOOTH_STEP) {
+    return SmSt_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef HERTZIAN
+  if constexpr (Kernel == KERNEL_HERTZIAN) {
+    return hertzian_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef GAUSSIAN
+  if constexpr (Kernel == KERNEL_GAUSSIAN) {
+    return gaussian_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef BMHTF_NACL
+  if constexpr (Kernel == KERNEL_BMHTF) {
+    return BMHTF_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef BUCKINGHAM
+  if constexpr (Kernel == KERNEL_BUCKINGHAM) {
+    return buck_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef MORSE
+  if constexpr (Kernel == KERNEL_MORSE) {
+    return morse_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef SOFT_SPHERE
+  if constexpr (Kernel == KERNEL_SOFT_SPHERE) {
+    return soft_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef HAT
+  if constexpr (Kernel == KERNEL_HAT) {
+    return hat_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef LJCOS
+  if constexpr (Kernel == KERNEL_LJCOS) {
+    return ljcos_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef LJCOS2
+  if constexpr (Kernel == KERNEL_LJCOS2) {
+    return ljcos2_pair_force_factor(ia_params, dist);
+  }
+#endif
+#ifdef TABULATED
+  if constexpr (Kernel == KERNEL_TABULATED) {
+    return tabulated_pair_force_factor(ia_params, dist);
+  }
+#endif
+  if constexpr (Kernel == KERNEL_SPLINE) {
+    auto const &spline = ia_params.spline_tabulation;
+    if (dist < spline.min) {
+      return calc_central_radial_force_factor(ia_params, dist);
+    }
+    return spline.force_factor(dist);
+  }
+  /* no potential or a potential that is not compiled in */
+  return 0.;
+}
+
+namespace detail {
+template <std::size_t... Kernels>
+constexpr auto make_central_force_kernels(std::index_sequence<Kernels...>) {
+  using kernel_type = double (*)(IA_parameters const &, double);
+  return std::array<kernel_type, sizeof...(Kernels)>{
+      {&central_radial_force_factor<static_cast<int>(Kernels)>...}};
+}
+} // namespace detail
+
+/** Dispatch table of the central force kernels. */
+inline constexpr auto central_force_kernels =
+    detail::make_central_force_kernels(
+        std::make_index_sequence<CentralForceKernel::N_KERNELS>{});
+
+/** Calculate the magnitude of the central non-bonded forces, divided by
+ *  the distance, with the kernel selected for the pair of particle types.
+ *  Same result as @ref calc_central_radial_force_factor.
+ */
+inline double dispatch_central_radial_force_factor(
+    IA_parameters const &ia_params, double const dist) {
+  return central_force_kernels[ia_params.central_force_kernel](ia_params,
+                                                              dist);
+}
+
+/** Check whether the non-bonded forces between two particle types depend
+ *  on more than the particle positions and charges.
+ */
+inline bool pair_force_needs_full_particle(IA_parameters const &ia_params) {
+  auto needs_full_particle = false;
+#ifdef THOLE
+  needs_full_particle |= (ia_params.thole.scaling_coeff != 0.);
+#endif
+#ifdef GAY_BERNE
+  needs_full_particle |= (ia_params.gay_berne.cut > 0.);
+#endif
+  return needs_full_particle;
+}
+
+inline ParticleForce calc_non_bonded_pair_force(
+    Particle const &p1, Particle const &p2, IA_parameters const &ia_params,
+    Utils::Vector3d const &d, double const dist,
+    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel) {
+
+  ParticleForce pf{};
+  auto const force_factor =
+      dispatch_central_radial_force_factor(ia_params, dist);
+/* Thole damping */
+#ifdef THOLE
+  pf.f += thole_pair_force(p1, p2, ia_params, d, dist, coulomb_kernel);
 #endif
 /* Gay-Berne */
 #ifdef GAY_BERNE
@@ -251,6 +397,57 @@ inline void add_non_bonded_pair_force(
   p2.force_and_torque() += calc_opposing_force(pf, d);
 }
 
+/** Calculate non-bonded forces between a pair of particles in the hot
+ *  particle data and update their forces.
+ *
+ *  Only central forces and short-range electrostatics are evaluated
+ *  on the hot particle data. Pairs with non-bonded exclusions or with
+ *  interactions that depend on other particle properties are passed on
+ *  to the full particles. Magnetostatics, the ELC force correction, the
+ *  DPD thermostat and the NpT virial are not handled, in which case the
+ *  pair loop has to run on the full particles instead.
+ *
+ *  @param[in,out] data    hot particle data.
+ *  @param[in] i           index of particle 1.
+ *  @param[in] j           index of particle 2.
+ *  @param[in] d           vector between particle 1 and particle 2.
+ *  @param[in] dist        distance between particle 1 and particle 2.
+ *  @param[in] dist2       distance squared between particle 1 and particle 2.
+ *  @param[in] coulomb_kernel  %Coulomb force kernel.
+ */
+inline void add_non_bonded_pair_force(
+    HotParticleData &data, std::size_t i, std::size_t j,
+    Utils::Vector3d const &d, double dist, double dist2,
+    Coulomb::ShortRangeForceKernel::kernel_type const *coulomb_kernel) {
+  auto const &ia_params = get_ia_param(data.type[i], data.type[j]);
+
+  auto needs_full_particle = pair_force_needs_full_particle(ia_params);
+#ifdef EXCLUSIONS
+  needs_full_particle |= (data.has_exclusions[i] or data.has_exclusions[j]);
+#endif
+  if (needs_full_particle) {
+    add_non_bonded_pair_force(*data.particles[i], *data.particles[j], d, dist,
+                              dist2, coulomb_kernel, nullptr, nullptr);
+    return;
+  }
+
+  Utils::Vector3d force{};
+
+  if (dist < ia_params.max_cut) {
+    force += dispatch_central_radial_force_factor(ia_params, dist) * d;
+  }
+
+#ifdef ELECTROSTATICS
+  auto const q1q2 = data.q[i] * data.q[j];
+  if (q1q2 != 0. and coulomb_kernel != nullptr) {
+    force += (*coulomb_kernel)(q1q2, d, dist);
+  }
+#endif // ELECTROSTATICS
+
+  data.add_force(i, force);
+  data.add_force(j, -force);
+}
+
 /** Compute the bonded interaction force between particle pairs.
  *
  *  @param[in] p1          First particle.
@@ -440,4 +637,121 @@ add_bonded_force(Particle &p1, int bond_id, Utils::Span<Particle *> partners,
   }
 }
 
+/** @brief Whether the bonds with id @p bond_id can be evaluated by
+ *  @ref add_bond_table_forces.
+ */
+inline bool has_bond_table_kernel(int bond_id) {
+  if (not bonded_ia_params.contains(bond_id)) {
+    return false;
+  }
+  auto const &iaparams = *bonded_ia_params.at(bond_id);
+  return boost::get<HarmonicBond>(&iaparams) or
+         boost::get<FeneBond>(&iaparams) or
+         boost::get<AngleHarmonicBond>(&iaparams) or
+         boost::get<AngleCosineBond>(&iaparams) or
+         boost::get<AngleCossquareBond>(&iaparams) or
+         boost::get<DihedralBond>(&iaparams);
+}
+
+namespace detail {
+inline void bond_table_broken_error(Utils::Span<Particle *const> particles) {
+  boost::container::static_vector<int, 3> partner_ids;
+  for (std::size_t i = 1; i < particles.size(); ++i) {
+    partner_ids.push_back(particles[i]->id());
+  }
+  bond_broken_error(particles[0]->id(),
+                    {partner_ids.data(), partner_ids.size()});
+}
+
+template <class Bond>
+void add_pair_bond_table_forces(BondTable const &table, Bond const &bond) {
+  auto const can_break = BondBreakage::has_spec(table.bond_id);
+  auto const n_bonds = table.size();
+  for (std::size_t i = 0; i < n_bonds; ++i) {
+    auto const particles = table[i];
+    auto &p1 = *particles[0];
+    auto &p2 = *particles[1];
+    auto const dx = box_geo.get_mi_vector(p1.pos(), p2.pos());
+    if (can_break and
+        BondBreakage::check_and_handle_breakage(p1.id(), p2.id(),
+                                                table.bond_id, dx.norm())) {
+      continue;
+    }
+    auto const result = bond.force(dx);
+    if (not result) {
+      bond_table_broken_error(particles);
+      continue;
+    }
+    p1.force() += *result;
+    p2.force() -= *result;
+#ifdef NPT
+    npt_add_virial_force_contribution(*result, dx);
+#endif
+  }
+}
+
+template <class Bond>
+void add_angle_bond_table_forces(BondTable const &table, Bond const &bond) {
+  auto const n_bonds = table.size();
+  for (std::size_t i = 0; i < n_bonds; ++i) {
+    auto const particles = table[i];
+    auto &p1 = *particles[0];
+    auto &p2 = *particles[1];
+    auto &p3 = *particles[2];
+    auto const forces = bond.forces(p1.pos(), p2.pos(), p3.pos());
+    p1.force() += std::get<0>(forces);
+    p2.force() += std::get<1>(forces);
+    p3.force() += std::get<2>(forces);
+  }
+}
+
+inline void add_dihedral_bond_table_forces(BondTable const &table,
+                                           DihedralBond const &bond) {
+  auto const n_bonds = table.size();
+  for (std::size_t i = 0; i < n_bonds; ++i) {
+    auto const particles = table[i];
+    auto &p1 = *particles[0];
+    auto &p2 = *particles[1];
+    auto &p3 = *particles[2];
+    auto &p4 = *particles[3];
+    auto const result = bond.forces(p2.pos(), p1.pos(), p3.pos(), p4.pos());
+    if (not result) {
+      bond_table_broken_error(particles);
+      continue;
+    }
+    auto const &forces = *result;
+    p1.force() += std::get<0>(forces);
+    p2.force() += std::get<1>(forces);
+    p3.force() += std::get<2>(forces);
+    p4.force() += std::get<3>(forces);
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Add the forces of all bonds of a @ref BondTable.
+ *
+ * The bond type is only resolved once per table, the bonds are then
+ * evaluated in a loop over the table with the kernel of that type.
+ * Forces are added in the same way as in @ref add_bonded_force.
+ */
+inline void add_bond_table_forces(BondTable const &table) {
+  auto const &iaparams = *bonded_ia_params.at(table.bond_id);
+  if (auto const *iap = boost::get<HarmonicBond>(&iaparams)) {
+    detail::add_pair_bond_table_forces(table, *iap);
+  } else if (auto const *iap = boost::get<FeneBond>(&iaparams)) {
+    detail::add_pair_bond_table_forces(table, *iap);
+  } else if (auto const *iap = boost::get<AngleHarmonicBond>(&iaparams)) {
+    detail::add_angle_bond_table_forces(table, *iap);
+  } else if (auto const *iap = boost::get<AngleCosineBond>(&iaparams)) {
+    detail::add_angle_bond_table_forces(table, *iap);
+  } else if (auto const *iap = boost::get<AngleCossquareBond>(&iaparams)) {
+    detail::add_angle_bond_table_forces(table, *iap);
+  } else if (auto const *iap = boost::get<DihedralBond>(&iaparams)) {
+    detail::add_dihedral_bond_table_forces(table, *iap);
+  } else {
+    throw BondUnknownTypeError();
+  }
+}
+
 #endif // CORE_FORCES_INLINE_HPP
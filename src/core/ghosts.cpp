@@ -42,14 +42,21 @@
 #include <boost/iostreams/device/back_inserter.hpp>
 #include <boost/iostreams/stream.hpp>
 #include <boost/mpi/collectives.hpp>
+#include <boost/mpi/nonblocking.hpp>
+#include <boost/mpi/request.hpp>
 #include <boost/range/numeric.hpp>
 #include <boost/serialization/vector.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <cstring>
+#include <deque>
 #include <functional>
 #include <iterator>
+#include <memory>
+#include <type_traits>
+#include <unordered_set>
 #include <vector>
 
 /** Tag for ghosts communications. */
@@ -225,7 +232,106 @@ serialize_and_reduce(Archive &ar, Particle &p, unsigned int data_parts,
 #endif
 }
 
+/**
+ * @brief Whether the particle data is transferred as an array of
+ * fixed-size records, without the serialization archives.
+ *
+ * Position and force updates are the most frequent ghost communications.
+ * Their records are the plain structs @ref ParticlePosition and
+ * @ref ParticleForce, which are copied with @c memcpy.
+ */
+static bool is_flat_update(unsigned int data_parts) {
+  return data_parts == GHOSTTRANS_POSITION or data_parts == GHOSTTRANS_FORCE;
+}
+
+static_assert(std::is_trivially_copyable<ParticlePosition>::value, "");
+static_assert(std::is_trivially_copyable<ParticleForce>::value, "");
+
+/** @brief Position record of a ghost, with the ghost shift applied. */
+static ParticlePosition ghost_position(Particle const &p,
+                                       Utils::Vector3d const &ghost_shift) {
+  ParticlePosition r;
+  r.p = p.pos() + ghost_shift;
+  r.i = p.image_box();
+  fold_position(r.p, r.i, ::box_geo);
+#ifdef ROTATION
+  r.quat = p.quat();
+#endif
+#ifdef BOND_CONSTRAINT
+  r.p_last_timestep = p.pos_last_time_step();
+#endif
+  return r;
+}
+
+static void set_position(Particle &p, ParticlePosition const &r) {
+  p.pos() = r.p;
+  p.image_box() = r.i;
+#ifdef ROTATION
+  p.quat() = r.quat;
+#endif
+#ifdef BOND_CONSTRAINT
+  p.pos_last_time_step() = r.p_last_timestep;
+#endif
+}
+
+/**
+ * @brief Call a kernel with every particle of a communication and the
+ * address of its record in a buffer of flat records.
+ */
+template <class Record, class Kernel>
+static void for_each_record(CommBuf &buffer,
+                            const GhostCommunication &ghost_comm,
+                            Kernel &&kernel) {
+  auto record = buffer.data();
+  for (auto part_list : ghost_comm.part_lists) {
+    for (auto &p : *part_list) {
+      kernel(p, record);
+      record += sizeof(Record);
+    }
+  }
+  assert(record == buffer.data() + buffer.size());
+}
+
+static void pack_flat_records(CommBuf &send_buffer,
+                              const GhostCommunication &ghost_comm,
+                              unsigned int data_parts) {
+  if (data_parts == GHOSTTRANS_POSITION) {
+    for_each_record<ParticlePosition>(
+        send_buffer, ghost_comm, [&ghost_comm](Particle &p, char *record) {
+          auto const r = ghost_position(p, ghost_comm.shift);
+          std::memcpy(record, &r, sizeof(r));
+        });
+  } else {
+    for_each_record<ParticleForce>(
+        send_buffer, ghost_comm, [](Particle &p, char *record) {
+          std::memcpy(record, &p.force_and_torque(), sizeof(ParticleForce));
+        });
+  }
+}
+
+static void unpack_flat_records(CommBuf &recv_buffer,
+                                const GhostCommunication &ghost_comm,
+                                unsigned int data_parts) {
+  if (data_parts == GHOSTTRANS_POSITION) {
+    for_each_record<ParticlePosition>(
+        recv_buffer, ghost_comm, [](Particle &p, char *record) {
+          ParticlePosition r;
+          std::memcpy(&r, record, sizeof(r));
+          set_position(p, r);
+        });
+  } else {
+    for_each_record<ParticleForce>(
+        recv_buffer, ghost_comm, [](Particle &p, char *record) {
+          std::memcpy(&p.force_and_torque(), record, sizeof(ParticleForce));
+        });
+  }
+}
+
 static std::size_t calc_transmit_size(unsigned data_parts) {
+  if (is_flat_update(data_parts)) {
+    return (data_parts == GHOSTTRANS_POSITION) ? sizeof(ParticlePosition)
+                                               : sizeof(ParticleForce);
+  }
   SerializationSizeCalculator sizeof_archive;
   Particle p{};
   serialize_and_reduce(sizeof_archive, p, data_parts, ReductionPolicy::MOVE,
@@ -252,6 +358,11 @@ static void prepare_send_buffer(CommBuf &send_buffer,
   send_buffer.resize(calc_transmit_size(ghost_comm, data_parts));
   send_buffer.bonds().clear();
 
+  if (is_flat_update(data_parts)) {
+    pack_flat_records(send_buffer, ghost_comm, data_parts);
+    return;
+  }
+
   auto archiver = Utils::MemcpyOArchive{Utils::make_span(send_buffer)};
 
   /* Construct archive that pushes back to the bond buffer */
@@ -301,6 +412,11 @@ static void prepare_recv_buffer(CommBuf &recv_buffer,
 static void put_recv_buffer(CommBuf &recv_buffer,
                             const GhostCommunication &ghost_comm,
                             unsigned int data_parts) {
+  if (is_flat_update(data_parts)) {
+    unpack_flat_records(recv_buffer, ghost_comm, data_parts);
+    return;
+  }
+
   /* put back data */
   auto archiver = Utils::MemcpyIArchive{Utils::make_span(recv_buffer)};
 
@@ -355,24 +471,58 @@ add_rattle_correction_from_recv_buffer(CommBuf &recv_buffer,
 static void add_forces_from_recv_buffer(CommBuf &recv_buffer,
                                         const GhostCommunication &ghost_comm) {
   /* put back data */
-  auto archiver = Utils::MemcpyIArchive{Utils::make_span(recv_buffer)};
-  for (auto &part_list : ghost_comm.part_lists) {
-    for (Particle &part : *part_list) {
-      ParticleForce pf;
-      archiver >> pf;
-      part.force_and_torque() += pf;
-    }
-  }
+  for_each_record<ParticleForce>(
+      recv_buffer, ghost_comm, [](Particle &p, char *record) {
+        ParticleForce pf;
+        std::memcpy(&pf, record, sizeof(pf));
+        p.force_and_torque() += pf;
+      });
+}
+
+/** Write back received data: forces and rattle corrections are added,
+ *  everything else is overwritten.
+ */
+static void write_recv_buffer(CommBuf &recv_buffer,
+                              const GhostCommunication &ghost_comm,
+                              unsigned int data_parts) {
+  if (data_parts == GHOSTTRANS_FORCE)
+    add_forces_from_recv_buffer(recv_buffer, ghost_comm);
+#ifdef BOND_CONSTRAINT
+  else if (data_parts == GHOSTTRANS_RATTLE)
+    add_rattle_correction_from_recv_buffer(recv_buffer, ghost_comm);
+#endif
+  else
+    put_recv_buffer(recv_buffer, ghost_comm, data_parts);
 }
 
 static void cell_cell_transfer(const GhostCommunication &ghost_comm,
                                unsigned int data_parts) {
+  auto const offset = ghost_comm.part_lists.size() / 2;
+
+  if (is_flat_update(data_parts)) {
+    for (std::size_t pl = 0; pl < offset; pl++) {
+      auto const &src_part = *ghost_comm.part_lists[pl];
+      auto &dst_part = *ghost_comm.part_lists[pl + offset];
+      assert(src_part.size() == dst_part.size());
+
+      for (std::size_t i = 0; i < src_part.size(); i++) {
+        auto const &p1 = src_part.begin()[i];
+        auto &p2 = dst_part.begin()[i];
+        if (data_parts == GHOSTTRANS_POSITION) {
+          set_position(p2, ghost_position(p1, ghost_comm.shift));
+        } else {
+          p2.force_and_torque() += p1.force_and_torque();
+        }
+      }
+    }
+    return;
+  }
+
   CommBuf buffer;
   if (!(data_parts & GHOSTTRANS_PARTNUM)) {
     buffer.resize(calc_transmit_size(data_parts));
   }
   /* transfer data */
-  auto const offset = ghost_comm.part_lists.size() / 2;
   for (std::size_t pl = 0; pl < offset; pl++) {
     auto *src_list = ghost_comm.part_lists[pl];
     auto *dst_list = ghost_comm.part_lists[pl + offset];
@@ -520,12 +670,8 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
       if (!poststore) {
         /* forces have to be added, the rest overwritten. Exception is RDCE,
          * where the addition is integrated into the communication. */
-        if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-          add_forces_from_recv_buffer(recv_buffer, ghost_comm);
-#ifdef BOND_CONSTRAINT
-        else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
-          add_rattle_correction_from_recv_buffer(recv_buffer, ghost_comm);
-#endif
+        if (comm_type != GHOST_RDCE)
+          write_recv_buffer(recv_buffer, ghost_comm, data_parts);
         else
           put_recv_buffer(recv_buffer, ghost_comm, data_parts);
       }
@@ -543,16 +689,147 @@ void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts) {
         assert(recv_buffer.size() ==
                calc_transmit_size(*poststore_ghost_comm, data_parts));
         /* as above */
-        if (data_parts == GHOSTTRANS_FORCE && comm_type != GHOST_RDCE)
-          add_forces_from_recv_buffer(recv_buffer, *poststore_ghost_comm);
-#ifdef BOND_CONSTRAINT
-        else if (data_parts == GHOSTTRANS_RATTLE && comm_type != GHOST_RDCE)
-          add_rattle_correction_from_recv_buffer(recv_buffer,
-                                                 *poststore_ghost_comm);
-#endif
+        if (comm_type != GHOST_RDCE)
+          write_recv_buffer(recv_buffer, *poststore_ghost_comm, data_parts);
         else
           put_recv_buffer(recv_buffer, *poststore_ghost_comm, data_parts);
       }
     }
   }
 }
+
+struct PendingGhostCommunication::State {
+  GhostCommunicator const *gcr = nullptr;
+  unsigned int data_parts = GHOSTTRANS_NONE;
+  /** Index of the next communication to post */
+  std::size_t next = 0;
+  /** Buffers of the posted operations, kept to reuse their memory.
+   *  Growing a deque doesn't move the buffers in flight. */
+  std::deque<CommBuf> send_buffers;
+  std::deque<CommBuf> recv_buffers;
+  /** Receive operations in flight, in the order of the communicator */
+  std::vector<GhostCommunication const *> recvs;
+  /** Cells written by the receive operations in flight */
+  std::unordered_set<ParticleList const *> recv_lists;
+  std::vector<boost::mpi::request> requests;
+
+  /** Whether an operation reads a cell that is still being received. */
+  bool depends_on_recvs(GhostCommunication const &ghost_comm) const {
+    return std::any_of(ghost_comm.part_lists.begin(),
+                       ghost_comm.part_lists.end(),
+                       [this](ParticleList const *part_list) {
+                         return recv_lists.count(part_list) != 0;
+                       });
+  }
+
+  /** Post the operations up to the next dependency on a receive. */
+  void post() {
+    auto const &comm = gcr->mpi_comm;
+    auto const &communications = gcr->communications;
+    std::size_t n_sends = 0;
+
+    for (; next < communications.size(); ++next) {
+      auto const &ghost_comm = communications[next];
+      auto const comm_type = ghost_comm.type & GHOST_JOBMASK;
+
+      if (comm_type == GHOST_LOCL) {
+        if (not requests.empty())
+          break;
+        cell_cell_transfer(ghost_comm, data_parts);
+      } else if (comm_type == GHOST_SEND) {
+        if (depends_on_recvs(ghost_comm))
+          break;
+        if (send_buffers.size() == n_sends)
+          send_buffers.emplace_back();
+        auto &send_buffer = send_buffers[n_sends++];
+        prepare_send_buffer(send_buffer, ghost_comm, data_parts);
+        requests.emplace_back(
+            comm.isend(ghost_comm.node, REQ_GHOST_SEND, send_buffer.data(),
+                       static_cast<int>(send_buffer.size())));
+      } else {
+        assert(comm_type == GHOST_RECV);
+        if (recv_buffers.size() == recvs.size())
+          recv_buffers.emplace_back();
+        auto &recv_buffer = recv_buffers[recvs.size()];
+        prepare_recv_buffer(recv_buffer, ghost_comm, data_parts);
+        requests.emplace_back(
+            comm.irecv(ghost_comm.node, REQ_GHOST_SEND, recv_buffer.data(),
+                       static_cast<int>(recv_buffer.size())));
+        recvs.emplace_back(&ghost_comm);
+        recv_lists.insert(ghost_comm.part_lists.begin(),
+                          ghost_comm.part_lists.end());
+      }
+    }
+
+    if (requests.empty()) {
+      finish();
+    }
+  }
+
+  /** Write back the completed receive operations and post the next ones. */
+  void advance() {
+    for (std::size_t i = 0; i < recvs.size(); ++i) {
+      write_recv_buffer(recv_buffers[i], *recvs[i], data_parts);
+    }
+    requests.clear();
+    recvs.clear();
+    recv_lists.clear();
+    post();
+  }
+
+  void finish() {
+    gcr = nullptr;
+    data_parts = GHOSTTRANS_NONE;
+    next = 0;
+  }
+};
+
+PendingGhostCommunication::PendingGhostCommunication()
+    : m_state(std::make_unique<State>()) {}
+
+PendingGhostCommunication::~PendingGhostCommunication() = default;
+
+void PendingGhostCommunication::start(GhostCommunicator const &gcr,
+                                      unsigned int data_parts) {
+  assert(not active());
+  if (GHOSTTRANS_NONE == data_parts)
+    return;
+
+  auto const is_point_to_point = [](GhostCommunication const &ghost_comm) {
+    auto const comm_type = ghost_comm.type & GHOST_JOBMASK;
+    return comm_type == GHOST_SEND or comm_type == GHOST_RECV or
+           comm_type == GHOST_LOCL;
+  };
+
+  /* bonds are sent in a second message of variable size, and the
+   * cell sizes have to be known before any data can be received */
+  if ((data_parts & (GHOSTTRANS_PARTNUM | GHOSTTRANS_BONDS)) or
+      not std::all_of(gcr.communications.begin(), gcr.communications.end(),
+                      is_point_to_point)) {
+    ghost_communicator(gcr, data_parts);
+    return;
+  }
+
+  m_state->gcr = &gcr;
+  m_state->data_parts = data_parts;
+  m_state->post();
+}
+
+bool PendingGhostCommunication::test() {
+  while (active() and boost::mpi::test_all(m_state->requests.begin(),
+                                           m_state->requests.end())) {
+    m_state->advance();
+  }
+  return not active();
+}
+
+void PendingGhostCommunication::wait() {
+  while (active()) {
+    boost::mpi::wait_all(m_state->requests.begin(), m_state->requests.end());
+    m_state->advance();
+  }
+}
+
+bool PendingGhostCommunication::active() const {
+  return m_state->gcr != nullptr;
+}
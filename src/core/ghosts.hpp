@@ -48,6 +48,10 @@
  *  - @ref GHOSTTRANS_RATTLE transfers the @ref ParticleRattle
  *  - @ref GHOSTTRANS_PARTNUM transfers the cell sizes
  *
+ *  Updates of only the positions or only the forces are packed as arrays
+ *  of @ref ParticlePosition resp. @ref ParticleForce records, all other
+ *  combinations are serialized particle by particle.
+ *
  *  Each ghost communication describes a single communication of the local with
  *  another node (or all other nodes). The data transferred can be any number
  *  of cells, there are five communication types:
@@ -90,6 +94,7 @@
 #include <boost/mpi/communicator.hpp>
 
 #include <cstddef>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -168,4 +173,46 @@ struct GhostCommunicator {
  */
 void ghost_communicator(const GhostCommunicator &gcr, unsigned int data_parts);
 
+/**
+ * @brief Ghost communication that progresses while the caller
+ * does other work.
+ *
+ * The communications of the ghost communicator are posted as
+ * non-blocking point-to-point messages. Consecutive send and receive
+ * operations are in flight together, until a send operation needs
+ * data of a cell that is still being received (e.g. ghosts of ghosts
+ * in the corners of the regular decomposition). Received data is
+ * written back in the order of the communicator, and local transfers
+ * are executed as soon as no message is pending. The particle data in
+ * the cells touched by the communicator must not be accessed between
+ * @ref start and the completion of the communication.
+ *
+ * Communicators with collective operations and transfers of the cell
+ * sizes or bonds are run synchronously by @ref start.
+ */
+class PendingGhostCommunication {
+  struct State;
+  std::unique_ptr<State> m_state;
+
+public:
+  PendingGhostCommunication();
+  ~PendingGhostCommunication();
+
+  /**
+   * @brief Post the communication.
+   *
+   * The ghost communicator has to outlive the communication.
+   */
+  void start(GhostCommunicator const &gcr, unsigned int data_parts);
+  /**
+   * @brief Progress the communication without blocking.
+   * @return Whether the communication is complete.
+   */
+  bool test();
+  /** @brief Block until the communication is complete. */
+  void wait();
+  /** @brief Whether the communication is still in flight. */
+  bool active() const;
+};
+
 #endif
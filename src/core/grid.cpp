@@ -35,14 +35,22 @@
 #include <mpi.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
 
 BoxGeometry box_geo;
 LocalBox<double> local_geo;
 
 Utils::Vector3i node_grid{};
 
+/** Boundaries of the local boxes, empty for an equal division of the box */
+static std::array<std::vector<double>, 3> node_domain_boundaries;
+
 void init_node_grid() { grid_changed_n_nodes(); }
 
 int map_position_node_array(const Utils::Vector3d &pos) {
@@ -50,7 +58,15 @@ int map_position_node_array(const Utils::Vector3d &pos) {
 
   Utils::Vector3i im;
   for (int i = 0; i < 3; i++) {
-    im[i] = static_cast<int>(std::floor(f_pos[i] / local_geo.length()[i]));
+    if (has_uniform_node_domains()) {
+      im[i] = static_cast<int>(std::floor(f_pos[i] / local_geo.length()[i]));
+    } else {
+      auto const &b = node_domain_boundaries[i];
+      auto const x = f_pos[i] * box_geo.length_inv()[i];
+      im[i] = static_cast<int>(
+          std::distance(b.begin(), std::upper_bound(b.begin(), b.end(), x)) -
+          1);
+    }
     im[i] = std::clamp(im[i], 0, node_grid[i] - 1);
   }
 
@@ -89,11 +105,96 @@ LocalBox<double> regular_decomposition(const BoxGeometry &box,
           CellStructureType::CELL_STRUCTURE_REGULAR};
 }
 
+LocalBox<double>
+regular_decomposition(const BoxGeometry &box, Utils::Vector3i const &node_pos,
+                      Utils::Vector3i const &node_grid_par,
+                      std::array<std::vector<double>, 3> const &boundaries) {
+  Utils::Vector3d local_length;
+  Utils::Vector3d my_left;
+
+  for (std::size_t i = 0; i < 3; i++) {
+    auto const lower = boundaries[i][static_cast<std::size_t>(node_pos[i])];
+    auto const upper = boundaries[i][static_cast<std::size_t>(node_pos[i]) + 1];
+    local_length[i] = (upper - lower) * box.length()[i];
+    my_left[i] = lower * box.length()[i];
+  }
+
+  Utils::Array<int, 6> boundary;
+  for (std::size_t dir = 0; dir < 3; dir++) {
+    /* left boundary ? */
+    boundary[2 * dir] = (node_pos[dir] == 0);
+    /* right boundary ? */
+    boundary[2 * dir + 1] = -(node_pos[dir] == node_grid_par[dir] - 1);
+  }
+
+  return {my_left, local_length, boundary,
+          CellStructureType::CELL_STRUCTURE_REGULAR, false};
+}
+
+std::array<std::vector<double>, 3> get_node_domain_boundaries() {
+  if (not has_uniform_node_domains()) {
+    return node_domain_boundaries;
+  }
+  std::array<std::vector<double>, 3> boundaries;
+  for (std::size_t i = 0; i < 3; i++) {
+    for (int k = 0; k <= node_grid[i]; k++) {
+      boundaries[i].push_back(static_cast<double>(k) /
+                              static_cast<double>(node_grid[i]));
+    }
+  }
+  return boundaries;
+}
+
+bool has_uniform_node_domains() { return node_domain_boundaries[0].empty(); }
+
+void set_node_domain_boundaries(
+    std::array<std::vector<double>, 3> const &boundaries) {
+  auto uniform = true;
+  for (std::size_t i = 0; i < 3; i++) {
+    auto const &b = boundaries[i];
+    if (b.size() != static_cast<std::size_t>(node_grid[i]) + 1u or
+        b.front() != 0. or b.back() != 1.) {
+      throw std::invalid_argument(
+          "Node domain boundaries must go from 0 to 1 in node_grid + 1 steps");
+    }
+    if (std::adjacent_find(b.begin(), b.end(), std::greater_equal<>()) !=
+        b.end()) {
+      throw std::invalid_argument(
+          "Node domain boundaries must be strictly increasing");
+    }
+    for (std::size_t k = 0; k < b.size(); k++) {
+      auto const equal_part =
+          static_cast<double>(k) / static_cast<double>(node_grid[i]);
+      uniform &= std::abs(b[k] - equal_part) < 1e-12;
+    }
+  }
+
+  if (uniform) {
+    node_domain_boundaries = {};
+  } else {
+    node_domain_boundaries = boundaries;
+  }
+  on_node_domain_change();
+}
+
 void grid_changed_box_l(const BoxGeometry &box) {
-  local_geo = regular_decomposition(box, calc_node_pos(comm_cart), node_grid);
+  if (has_uniform_node_domains()) {
+    local_geo = regular_decomposition(box, calc_node_pos(comm_cart), node_grid);
+  } else {
+    local_geo = regular_decomposition(box, calc_node_pos(comm_cart), node_grid,
+                                      node_domain_boundaries);
+  }
 }
 
 void grid_changed_n_nodes() {
+  for (std::size_t i = 0; i < 3; i++) {
+    if (not has_uniform_node_domains() and
+        node_domain_boundaries[i].size() !=
+            static_cast<std::size_t>(node_grid[i]) + 1u) {
+      node_domain_boundaries = {};
+    }
+  }
+
   comm_cart =
       Utils::Mpi::cart_create(comm_cart, node_grid, /* reorder */ false);
 
@@ -106,6 +207,7 @@ void grid_changed_n_nodes() {
 
 void set_node_grid(Utils::Vector3i const &value) {
   ::node_grid = value;
+  node_domain_boundaries = {};
   on_node_grid_change();
 }
 
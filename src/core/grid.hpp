@@ -38,6 +38,9 @@
 
 #include <boost/mpi/communicator.hpp>
 
+#include <array>
+#include <vector>
+
 extern BoxGeometry box_geo;
 extern LocalBox<double> local_geo;
 
@@ -106,6 +109,48 @@ LocalBox<double> regular_decomposition(const BoxGeometry &box,
                                        Utils::Vector3i const &node_pos,
                                        Utils::Vector3i const &node_grid);
 
+/**
+ * @brief Composition of the simulation box into parts of different sizes.
+ *
+ * The boundaries between the local boxes are given along each axis as
+ * fractions of the box length, with @c node_grid[i] + 1 entries for axis
+ * @c i. The local box of a node spans the interval between the entries
+ * @c node_pos[i] and @c node_pos[i] + 1 along axis @c i.
+ *
+ * @param box Geometry of the simulation box
+ * @param node_pos Position of node in the node grid
+ * @param node_grid Nodes in each direction
+ * @param boundaries Boundaries of the local boxes along each axis
+ * @return Geometry for the node
+ */
+LocalBox<double>
+regular_decomposition(const BoxGeometry &box, Utils::Vector3i const &node_pos,
+                      Utils::Vector3i const &node_grid,
+                      std::array<std::vector<double>, 3> const &boundaries);
+
+/**
+ * @brief Boundaries between the local boxes along each axis, as fractions
+ * of the box length (see @ref regular_decomposition).
+ */
+std::array<std::vector<double>, 3> get_node_domain_boundaries();
+
+/** @brief Whether all local boxes have the same size. */
+bool has_uniform_node_domains();
+
+/**
+ * @brief Move the boundaries between the local boxes.
+ *
+ * The boundaries are reset to an equal division of the box whenever
+ * the node grid changes.
+ *
+ * @param boundaries Boundaries along each axis, as fractions of the box
+ *        length, starting at 0 and ending at 1 in increasing order.
+ * @throws std::invalid_argument if the boundaries don't match the node
+ *         grid or are not in increasing order.
+ */
+void set_node_domain_boundaries(
+    std::array<std::vector<double>, 3> const &boundaries);
+
 void set_node_grid(Utils::Vector3i const &value);
 void set_box_length(Utils::Vector3d const &value);
 
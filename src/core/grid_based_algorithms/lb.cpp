@@ -616,6 +616,9 @@ void lb_sanity_checks(const LB_Parameters &lb_parameters) {
   if (lb_parameters.viscosity <= 0.0) {
     runtimeErrorMsg() << "Lattice Boltzmann fluid viscosity not set";
   }
+  if (not has_uniform_node_domains()) {
+    runtimeErrorMsg() << "Lattice Boltzmann requires local boxes of equal size";
+  }
 }
 
 uint64_t lb_fluid_get_rng_state() {
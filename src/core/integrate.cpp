@@ -32,9 +32,11 @@
 #include "integrators/stokesian_dynamics_inline.hpp"
 #include "integrators/velocity_verlet_inline.hpp"
 #include "integrators/velocity_verlet_npt.hpp"
+#include "integrators/velocity_verlet_respa.hpp"
 
 #include "ParticleRange.hpp"
 #include "accumulators.hpp"
+#include "adaptive_skin.hpp"
 #include "bond_breakage/bond_breakage.hpp"
 #include "bonded_interactions/rigid_bond.hpp"
 #include "cells.hpp"
@@ -48,6 +50,7 @@
 #include "grid_based_algorithms/lb_particle_coupling.hpp"
 #include "interactions.hpp"
 #include "lees_edwards/lees_edwards.hpp"
+#include "load_balancing.hpp"
 #include "nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "npt.hpp"
 #include "rattle.hpp"
@@ -155,6 +158,7 @@ void integrator_sanity_checks() {
           << "The steepest descent integrator is incompatible with thermostats";
     break;
   case INTEG_METHOD_NVT:
+  case INTEG_METHOD_NVT_RESPA:
     if (thermo_switch & (THERMO_NPT_ISO | THERMO_BROWNIAN | THERMO_SD))
       runtimeErrorMsg() << "The VV integrator is incompatible with the "
                            "currently active combination of thermostats";
@@ -200,6 +204,7 @@ static bool integrator_step_1(ParticleRange const &particles) {
     early_exit = steepest_descent_step(particles);
     break;
   case INTEG_METHOD_NVT:
+  case INTEG_METHOD_NVT_RESPA:
     velocity_verlet_step_1(particles, time_step);
     break;
 #ifdef NPT
@@ -229,6 +234,7 @@ static void integrator_step_2(ParticleRange const &particles, double kT) {
     // Nothing
     break;
   case INTEG_METHOD_NVT:
+  case INTEG_METHOD_NVT_RESPA:
     velocity_verlet_step_2(particles, time_step);
     break;
 #ifdef NPT
@@ -251,6 +257,17 @@ static void integrator_step_2(ParticleRange const &particles, double kT) {
   }
 }
 
+/** Weight of the long-range forces in the next force calculation
+ *  @param restart  Whether the force calculation starts a new outer time
+ *                  step of the multiple time step integrator
+ */
+static double long_range_force_weight(bool restart) {
+  if (integ_switch == INTEG_METHOD_NVT_RESPA) {
+    return velocity_verlet_respa_long_range_weight(restart);
+  }
+  return 1.;
+}
+
 int integrate(int n_steps, int reuse_forces) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
@@ -273,7 +290,8 @@ int integrate(int n_steps, int reuse_forces) {
     // Communication step: distribute ghost positions
     cells_update_ghosts(global_ghost_flags());
 
-    force_calc(cell_structure, time_step, temperature);
+    force_calc(cell_structure, time_step, temperature,
+               long_range_force_weight(true));
 
     if (integ_switch != INTEG_METHOD_STEEPEST_DESCENT) {
 #ifdef ROTATION
@@ -292,6 +310,8 @@ int integrate(int n_steps, int reuse_forces) {
   // Keep track of the number of Verlet updates (i.e. particle resorts)
   int n_verlet_updates = 0;
 
+  AdaptiveSkin::on_integration_start();
+
 #ifdef VALGRIND_MARKERS
   CALLGRIND_START_INSTRUMENTATION;
 #endif
@@ -336,15 +356,19 @@ int integrate(int n_steps, int reuse_forces) {
     virtual_sites()->update();
 #endif
 
-    if (cell_structure.get_resort_particles() >= Cells::RESORT_LOCAL)
+    auto const verlet_update =
+        cell_structure.get_resort_particles() >= Cells::RESORT_LOCAL;
+    if (verlet_update)
       n_verlet_updates++;
 
-    // Communication step: distribute ghost positions
-    cells_update_ghosts(global_ghost_flags());
+    // Communication step: distribute ghost positions, possibly
+    // overlapped with the force calculation
+    cells_update_ghosts(global_ghost_flags(), cell_structure.use_ghost_overlap);
 
     particles = cell_structure.local_particles();
 
-    force_calc(cell_structure, time_step, temperature);
+    force_calc(cell_structure, time_step, temperature,
+               long_range_force_weight(false));
 
 #ifdef VIRTUAL_SITES
     virtual_sites()->after_force_calc();
@@ -384,6 +408,13 @@ int integrate(int n_steps, int reuse_forces) {
 
     integrated_steps++;
 
+    try {
+      LoadBalancing::on_integration_step();
+      AdaptiveSkin::on_integration_step(verlet_update);
+    } catch (std::exception const &err) {
+      runtimeErrorMsg() << err.what();
+    }
+
     if (check_runtime_errors(comm_cart))
       break;
 
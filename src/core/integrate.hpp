@@ -34,6 +34,7 @@
 #define INTEG_METHOD_STEEPEST_DESCENT 2
 #define INTEG_METHOD_BD 3
 #define INTEG_METHOD_SD 7
+#define INTEG_METHOD_NVT_RESPA 8
 /**@}*/
 
 /** Switch determining which integrator to use. */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "integrators/velocity_verlet_respa.hpp"
+
+#include <stdexcept>
+
+/** Currently active multiple time step instance */
+static VelocityVerletRespaParameters params{1};
+
+/** Number of force calculations since the start of the outer time step */
+static int inner_step = 0;
+
+void register_integrator(VelocityVerletRespaParameters const &obj) {
+  ::params = obj;
+  ::inner_step = 0;
+}
+
+double velocity_verlet_respa_long_range_weight(bool restart) {
+  auto const n = params.long_range_interval;
+  inner_step = (restart) ? 0 : (inner_step + 1) % n;
+  return (inner_step == 0) ? static_cast<double>(n) : 0.;
+}
+
+VelocityVerletRespaParameters::VelocityVerletRespaParameters(
+    int long_range_interval)
+    : long_range_interval{long_range_interval} {
+  if (long_range_interval < 1) {
+    throw std::domain_error("Parameter 'long_range_interval' must be >= 1");
+  }
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CORE_INTEGRATORS_VELOCITY_VERLET_RESPA_HPP
+#define CORE_INTEGRATORS_VELOCITY_VERLET_RESPA_HPP
+
+/** \file
+ *  Multiple time step velocity Verlet integrator (r-RESPA).
+ *
+ *  The bonded and short-range forces are evaluated every time step,
+ *  the long-range forces only every
+ *  @ref VelocityVerletRespaParameters::long_range_interval "n"-th step.
+ *  The long-range forces are applied as impulses at the boundaries of
+ *  the outer time step @f$ n \cdot dt @f$, see @cite tuckerman92a.
+ *  Since the velocity Verlet kernels apply a force for half a time step
+ *  after the force calculation and again before the next position update,
+ *  this amounts to adding the long-range forces multiplied by @f$ n @f$
+ *  in the force calculation that ends an outer time step, and omitting
+ *  them in all other force calculations.
+ */
+
+/** Parameters of the multiple time step velocity Verlet integrator */
+struct VelocityVerletRespaParameters {
+  /** Number of time steps per evaluation of the long-range forces */
+  int long_range_interval;
+
+  explicit VelocityVerletRespaParameters(int long_range_interval);
+};
+
+void register_integrator(VelocityVerletRespaParameters const &obj);
+
+/**
+ * @brief Weight of the long-range forces in the next force calculation.
+ *
+ * @param restart  Whether the force calculation starts a new outer
+ *                 time step, e.g. when the forces are recalculated
+ *                 before the first integration step.
+ * @return @ref VelocityVerletRespaParameters::long_range_interval
+ *         "long_range_interval" at the boundaries of the outer time
+ *         steps, zero otherwise.
+ */
+double velocity_verlet_respa_long_range_weight(bool restart);
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "load_balancing.hpp"
+
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+#include "grid_based_algorithms/lb_interface.hpp"
+#include "integrate.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/mpi/cart_comm.hpp>
+
+#include <boost/mpi/collectives/all_gather.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+namespace LoadBalancing {
+
+static Parameters parameters{};
+/** Time spent in the short-range loop since the last balancing */
+static double short_range_time = 0.;
+/** Integration steps since the last balancing */
+static int steps_since_balancing = 0;
+
+Parameters const &get_parameters() { return parameters; }
+
+void set_parameters(Parameters const &params) {
+  if (params.interval < 0) {
+    throw std::domain_error("Parameter 'interval' must be >= 0");
+  }
+  if (params.tolerance < 0.) {
+    throw std::domain_error("Parameter 'tolerance' must be >= 0");
+  }
+  parameters = params;
+  steps_since_balancing = 0;
+  short_range_time = 0.;
+}
+
+double imbalance(std::vector<double> const &loads) {
+  if (loads.empty()) {
+    return 0.;
+  }
+  auto const total = std::accumulate(loads.begin(), loads.end(), 0.);
+  if (total <= 0.) {
+    return 0.;
+  }
+  auto const mean = total / static_cast<double>(loads.size());
+  return *std::max_element(loads.begin(), loads.end()) / mean - 1.;
+}
+
+std::vector<double> balance_slabs(std::vector<double> const &boundaries,
+                                  std::vector<double> const &loads,
+                                  double min_width) {
+  assert(boundaries.size() == loads.size() + 1u);
+  auto const n_slabs = loads.size();
+  auto const total = std::accumulate(loads.begin(), loads.end(), 0.);
+  auto const length = boundaries.back() - boundaries.front();
+
+  if (n_slabs < 2 or total <= 0. or
+      static_cast<double>(n_slabs) * min_width > length) {
+    return boundaries;
+  }
+
+  /* Invert the cumulative load, which is linear within each slab */
+  auto result = boundaries;
+  std::size_t slab = 0;
+  auto cumulative_load = 0.;
+  for (std::size_t k = 1; k < n_slabs; ++k) {
+    auto const target =
+        total * static_cast<double>(k) / static_cast<double>(n_slabs);
+    while (slab + 1 < n_slabs and cumulative_load + loads[slab] < target) {
+      cumulative_load += loads[slab];
+      ++slab;
+    }
+    auto const fraction =
+        (loads[slab] > 0.)
+            ? std::clamp((target - cumulative_load) / loads[slab], 0., 1.)
+            : 0.;
+    result[k] = boundaries[slab] +
+                fraction * (boundaries[slab + 1] - boundaries[slab]);
+  }
+
+  /* Enforce the minimal slab width from both ends */
+  for (std::size_t k = 1; k < n_slabs; ++k) {
+    result[k] = std::max(result[k], result[k - 1] + min_width);
+  }
+  for (std::size_t k = n_slabs - 1; k > 0; --k) {
+    result[k] = std::min(result[k], result[k + 1] - min_width);
+  }
+
+  return result;
+}
+
+void add_short_range_time(double seconds) { short_range_time += seconds; }
+
+static double local_load() {
+  switch (parameters.metric) {
+  case Metric::NPART:
+    return static_cast<double>(cell_structure.local_particles().size());
+  case Metric::SHORT_RANGE_TIME:
+    return short_range_time;
+  }
+  return 0.;
+}
+
+double rebalance() {
+  if (cell_structure.decomposition_type() !=
+      CellStructureType::CELL_STRUCTURE_REGULAR) {
+    throw std::runtime_error(
+        "Load balancing requires the regular decomposition cell system");
+  }
+  if (lb_lbfluid_get_lattice_switch() != ActiveLB::NONE) {
+    throw std::runtime_error(
+        "Load balancing is not compatible with lattice-Boltzmann");
+  }
+
+  std::vector<double> loads;
+  boost::mpi::all_gather(comm_cart, local_load(), loads);
+  short_range_time = 0.;
+  steps_since_balancing = 0;
+
+  auto const load_imbalance = imbalance(loads);
+  if (load_imbalance <= parameters.tolerance) {
+    return load_imbalance;
+  }
+
+  /* Load of the slabs of ranks perpendicular to each axis */
+  std::array<std::vector<double>, 3> slab_loads;
+  for (std::size_t i = 0; i < 3; ++i) {
+    slab_loads[i].resize(static_cast<std::size_t>(node_grid[i]), 0.);
+  }
+  for (int rank = 0; rank < comm_cart.size(); ++rank) {
+    auto const node_pos = Utils::Mpi::cart_coords<3>(comm_cart, rank);
+    for (std::size_t i = 0; i < 3; ++i) {
+      slab_loads[i][static_cast<std::size_t>(node_pos[i])] += loads[rank];
+    }
+  }
+
+  /* Slabs have to hold at least one cell, with a margin for rounding,
+   * and are kept wider than a tenth of an equal division of the box in
+   * the non-interacting case */
+  auto const old_boundaries = get_node_domain_boundaries();
+  auto boundaries = old_boundaries;
+  for (std::size_t i = 0; i < 3; ++i) {
+    auto const min_width =
+        std::max((1. + 1e-10) * interaction_range() * box_geo.length_inv()[i],
+                 0.1 / static_cast<double>(node_grid[i]));
+    boundaries[i] = balance_slabs(old_boundaries[i], slab_loads[i], min_width);
+  }
+  if (boundaries == old_boundaries) {
+    return load_imbalance;
+  }
+
+  try {
+    set_node_domain_boundaries(boundaries);
+  } catch (...) {
+    set_node_domain_boundaries(old_boundaries);
+    throw;
+  }
+
+  return load_imbalance;
+}
+
+void on_integration_step() {
+  if (parameters.interval == 0) {
+    return;
+  }
+  if (++steps_since_balancing >= parameters.interval) {
+    rebalance();
+  }
+}
+
+} // namespace LoadBalancing
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ESPRESSO_SRC_CORE_LOAD_BALANCING_HPP
+#define ESPRESSO_SRC_CORE_LOAD_BALANCING_HPP
+
+/** @file
+ *  Dynamic load balancing of the regular decomposition.
+ *
+ *  The boundaries between the local boxes are shifted along each axis
+ *  of the node grid, such that every slab of MPI ranks perpendicular
+ *  to that axis carries the same share of the measured load. The local
+ *  boxes therefore remain a rectilinear grid, which keeps the ghost
+ *  communication of the regular decomposition unchanged.
+ *
+ *  Implementation in load_balancing.cpp.
+ */
+
+#include <vector>
+
+namespace LoadBalancing {
+
+/** @brief Estimate of the work done by an MPI rank. */
+enum class Metric : int {
+  /** Number of local particles */
+  NPART = 0,
+  /** Time spent in the short-range force loop since the last balancing */
+  SHORT_RANGE_TIME = 1,
+};
+
+/** @brief Parameters of the periodic load balancing. */
+struct Parameters {
+  /** Number of integration steps between two balancing attempts,
+   *  0 disables the periodic load balancing.
+   */
+  int interval = 0;
+  /** Load estimate */
+  Metric metric = Metric::NPART;
+  /** Relative load imbalance below which the local boxes are kept */
+  double tolerance = 0.1;
+};
+
+Parameters const &get_parameters();
+
+/**
+ * @brief Set the parameters of the periodic load balancing.
+ *
+ * @throws std::domain_error if the interval or the tolerance is negative.
+ */
+void set_parameters(Parameters const &params);
+
+/**
+ * @brief Relative load imbalance, i.e. the ratio of the largest
+ * to the mean load minus one.
+ */
+double imbalance(std::vector<double> const &loads);
+
+/**
+ * @brief Shift the boundaries of the slabs along one axis to equalize
+ * their load.
+ *
+ * The load of each slab is assumed to be spread evenly over the slab.
+ * The new boundaries split the cumulative load in equal parts, and are
+ * then moved apart where necessary to keep every slab at least
+ * @p min_width wide. The outer boundaries are never moved.
+ *
+ * @param boundaries Slab boundaries in increasing order, one more than
+ *                   the number of slabs.
+ * @param loads      Load of each slab.
+ * @param min_width  Minimal width of a slab.
+ * @return New slab boundaries. The old boundaries are returned if the
+ *         total load vanishes or the slabs cannot be wide enough.
+ */
+std::vector<double> balance_slabs(std::vector<double> const &boundaries,
+                                  std::vector<double> const &loads,
+                                  double min_width);
+
+/** @brief Account for time spent in the short-range force loop. */
+void add_short_range_time(double seconds);
+
+/**
+ * @brief Move the boundaries of the local boxes according to the load
+ * measured since the last balancing. Has to be called on all ranks.
+ *
+ * The boundaries are only moved if the load imbalance is larger than
+ * @ref Parameters::tolerance.
+ *
+ * @throws std::runtime_error if the regular decomposition is not active
+ *         or an active algorithm requires local boxes of equal size.
+ * @return The load imbalance before balancing.
+ */
+double rebalance();
+
+/**
+ * @brief Rebalance every @ref Parameters::interval integration steps.
+ * Has to be called on all ranks after each integration step.
+ */
+void on_integration_step();
+
+} // namespace LoadBalancing
+
+#endif
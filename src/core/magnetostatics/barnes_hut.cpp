@@ -0,0 +1,732 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config/config.hpp"
+
+#ifdef DIPOLES
+
+#include "magnetostatics/barnes_hut.hpp"
+#include "magnetostatics/dipolar_pair_kernels.hpp"
+
+#include "cells.hpp"
+#include "communication.hpp"
+#include "grid.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/cartesian_product.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <boost/mpi/collectives.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/range/counting_range.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+/** Maximal number of dipoles in a leaf octant. */
+auto constexpr leaf_size = 8;
+/** Number of particles sampled by the error estimate. */
+auto constexpr n_error_samples = 100;
+/**
+ * Relative margin of the acceptance test of octants sent to other ranks,
+ * which covers the rounding of the distances on the receiving rank.
+ */
+auto constexpr acceptance_margin = 1e-10;
+
+/**
+ * @brief Position and dipole moment of one particle.
+ */
+struct PosMom {
+  Utils::Vector3d pos;
+  Utils::Vector3d m;
+
+  template <class Archive> void serialize(Archive &ar, long int) { ar &pos &m; }
+};
+
+/**
+ * @brief Octant of an octree.
+ * The children of an octant are contiguous, the octant owns a contiguous
+ * range of the reordered dipoles.
+ */
+struct Octant {
+  int begin;
+  int end;
+  int first_child;
+  int n_children;
+  /** Tight bounding box of the dipoles. */
+  Utils::Vector3d lower;
+  Utils::Vector3d upper;
+  /** Center of the dipoles weighted by their magnitude. */
+  Utils::Vector3d center;
+  /** Total dipole moment. */
+  Utils::Vector3d moment;
+  /** Longest edge of the bounding box. */
+  double size;
+  /** Distance of @ref center from the bounding box center. */
+  double offset;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &begin &end &first_child &n_children &lower &upper &center &moment
+        &size &offset;
+  }
+};
+
+/**
+ * @brief Part of the octree of another rank needed by the local dipoles.
+ * Octants accepted as a single dipole by all local dipoles come without
+ * their children and dipoles.
+ */
+struct EssentialTree {
+  std::vector<Octant> nodes;
+  std::vector<PosMom> sources;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &nodes &sources;
+  }
+};
+
+/**
+ * @brief Bounding box of the dipoles of one rank.
+ */
+struct Box {
+  Utils::Vector3d lower;
+  Utils::Vector3d upper;
+  bool empty;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &lower &upper &empty;
+  }
+};
+
+/**
+ * @brief Periodic image of the octree.
+ */
+struct Image {
+  /** Shift added to the distance vectors. */
+  Utils::Vector3d offset;
+  /** Box shifts, used to select the minimum image. */
+  Utils::Vector3i shift;
+  /** Whether this is the primary box, without self-interaction. */
+  bool primary;
+};
+
+/**
+ * @brief Octree over the dipoles of one rank.
+ *
+ * The octants are stored in breadth-first order. The octree either holds
+ * the local dipoles, or the essential tree received from another rank.
+ */
+class Octree {
+  std::vector<PosMom> m_sources;
+  /** Original index of each reordered dipole. */
+  std::vector<int> m_index;
+  /** Reordered slot of each original dipole. */
+  std::vector<int> m_slot;
+  std::vector<Octant> m_nodes;
+  std::vector<Image> m_images;
+  /** Directions in which only the minimum image interacts. */
+  std::array<bool, 3> m_window;
+  Utils::Vector3d m_box_l;
+  Utils::Vector3d m_box_l_half;
+
+  Octant make_node(int begin, int end) const {
+    Octant node{begin, end, 0, 0, m_sources[begin].pos, m_sources[begin].pos,
+                {},    {},  0., 0.};
+    auto weight = 0.;
+    for (int i = begin; i < end; ++i) {
+      auto const &source = m_sources[i];
+      auto const m = source.m.norm();
+      for (unsigned int d = 0; d < 3; ++d) {
+        node.lower[d] = std::min(node.lower[d], source.pos[d]);
+        node.upper[d] = std::max(node.upper[d], source.pos[d]);
+      }
+      node.center += m * source.pos;
+      node.moment += source.m;
+      weight += m;
+    }
+    node.center /= weight;
+    auto const edges = node.upper - node.lower;
+    node.size = *std::max_element(edges.begin(), edges.end());
+    node.offset = (node.center - 0.5 * (node.lower + node.upper)).norm();
+    return node;
+  }
+
+  /** @brief Sort the dipoles of an octant into its eight children. */
+  void split(std::size_t k) {
+    auto const begin = m_nodes[k].begin;
+    auto const end = m_nodes[k].end;
+    if (end - begin <= leaf_size or m_nodes[k].size == 0.) {
+      return;
+    }
+    auto const mid = 0.5 * (m_nodes[k].lower + m_nodes[k].upper);
+    auto const octant = [&mid](Utils::Vector3d const &pos) {
+      return static_cast<int>(pos[0] >= mid[0]) +
+             2 * static_cast<int>(pos[1] >= mid[1]) +
+             4 * static_cast<int>(pos[2] >= mid[2]);
+    };
+
+    std::array<int, 9> bounds{};
+    for (int i = begin; i < end; ++i) {
+      ++bounds[octant(m_sources[i].pos) + 1];
+    }
+    auto const n_children = static_cast<int>(std::count_if(
+        bounds.begin() + 1, bounds.end(), [](int n) { return n > 0; }));
+    if (n_children < 2) {
+      return;
+    }
+    std::partial_sum(bounds.begin(), bounds.end(), bounds.begin());
+
+    /* stable counting sort of the range by octant */
+    auto const sources = std::vector<PosMom>(m_sources.begin() + begin,
+                                             m_sources.begin() + end);
+    auto const index =
+        std::vector<int>(m_index.begin() + begin, m_index.begin() + end);
+    auto fill = bounds;
+    for (std::size_t i = 0; i < sources.size(); ++i) {
+      auto const slot = begin + fill[octant(sources[i].pos)]++;
+      m_sources[slot] = sources[i];
+      m_index[slot] = index[i];
+    }
+
+    m_nodes[k].first_child = static_cast<int>(m_nodes.size());
+    m_nodes[k].n_children = n_children;
+    for (std::size_t i = 0; i < 8; ++i) {
+      if (bounds[i + 1] > bounds[i]) {
+        m_nodes.emplace_back(
+            make_node(begin + bounds[i], begin + bounds[i + 1]));
+      }
+    }
+  }
+
+  /** @brief Periodic images for the minimum image or replica summation. */
+  void make_images(int n_replicas) {
+    auto const periodic =
+        Utils::Vector3i{static_cast<int>(::box_geo.periodic(0)),
+                        static_cast<int>(::box_geo.periodic(1)),
+                        static_cast<int>(::box_geo.periodic(2))};
+    auto const ncut = n_replicas * periodic;
+    auto const with_replicas = (ncut.norm2() > 0);
+    auto const range = with_replicas ? ncut : periodic;
+
+    Utils::cartesian_product(
+        [&](int nx, int ny, int nz) {
+          auto const shift = Utils::Vector3i{nx, ny, nz};
+          if (with_replicas and shift.norm2() > ncut.norm2()) {
+            return;
+          }
+          auto const offset = Utils::Vector3d{
+              nx * m_box_l[0], ny * m_box_l[1], nz * m_box_l[2]};
+          if (with_replicas) {
+            m_images.push_back({offset, shift, shift == Utils::Vector3i{}});
+          } else {
+            m_images.push_back({-offset, shift, shift == Utils::Vector3i{}});
+          }
+        },
+        boost::counting_range(-range[0], range[0] + 1),
+        boost::counting_range(-range[1], range[1] + 1),
+        boost::counting_range(-range[2], range[2] + 1));
+
+    for (unsigned int d = 0; d < 3; ++d) {
+      m_window[d] = not with_replicas and ::box_geo.periodic(d);
+    }
+  }
+
+  /** @brief Whether a dipole is the minimum image in a shifted box. */
+  bool is_minimum_image(Utils::Vector3d const &dx, Image const &image) const {
+    for (unsigned int d = 0; d < 3; ++d) {
+      if (m_window[d]) {
+        auto const n = (std::abs(dx[d]) > m_box_l_half[d])
+                           ? static_cast<int>(std::round(dx[d] / m_box_l[d]))
+                           : 0;
+        if (n != image.shift[d]) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  /**
+   * @brief How the dipoles in a box see an octant, in all images.
+   *
+   * Uses the same tests as @ref image_sum, evaluated for the corners
+   * of the box that are least favorable.
+   *
+   * @return Whether all dipoles ignore the octant, and whether all
+   * dipoles either ignore it or accept it as a single dipole.
+   */
+  std::pair<bool, bool> visibility(Octant const &node, Box const &box,
+                                   double theta) const {
+    auto hidden = true;
+    for (auto const &image : m_images) {
+      auto inside = true;
+      auto outside = false;
+      for (unsigned int d = 0; d < 3; ++d) {
+        if (m_window[d]) {
+          auto const lower = box.lower[d] - node.upper[d] + image.offset[d];
+          auto const upper = box.upper[d] - node.lower[d] + image.offset[d];
+          outside |= upper < -m_box_l_half[d] or lower > m_box_l_half[d];
+          inside &= lower > -m_box_l_half[d] and upper < m_box_l_half[d];
+        }
+      }
+      if (outside) {
+        continue;
+      }
+      hidden = false;
+      if (not inside) {
+        return {false, false};
+      }
+      /* smallest distance between the dipoles and the octant center */
+      auto dist2 = 0.;
+      auto scale = 0.;
+      for (unsigned int d = 0; d < 3; ++d) {
+        auto const center = node.center[d] - image.offset[d];
+        auto const gap = std::max(
+            {box.lower[d] - center, center - box.upper[d], 0.});
+        dist2 += gap * gap;
+        scale = std::max({scale, std::abs(box.lower[d]),
+                          std::abs(box.upper[d]), std::abs(center)});
+      }
+      auto const dist = std::sqrt(dist2) - acceptance_margin * scale;
+      if (not(theta * dist > node.size + theta * node.offset)) {
+        return {false, false};
+      }
+    }
+    return {hidden, true};
+  }
+
+public:
+  Octree(std::vector<PosMom> sources, int n_replicas)
+      : m_sources(std::move(sources)), m_index(m_sources.size()),
+        m_slot(m_sources.size()), m_box_l(::box_geo.length()),
+        m_box_l_half(0.5 * ::box_geo.length()) {
+    make_images(n_replicas);
+    if (m_sources.empty()) {
+      return;
+    }
+    std::iota(m_index.begin(), m_index.end(), 0);
+    m_nodes.emplace_back(make_node(0, static_cast<int>(m_sources.size())));
+    for (std::size_t k = 0; k < m_nodes.size(); ++k) {
+      split(k);
+    }
+    for (std::size_t i = 0; i < m_index.size(); ++i) {
+      m_slot[m_index[i]] = static_cast<int>(i);
+    }
+  }
+
+  Octree(EssentialTree tree, int n_replicas)
+      : m_sources(std::move(tree.sources)), m_nodes(std::move(tree.nodes)),
+        m_box_l(::box_geo.length()), m_box_l_half(0.5 * ::box_geo.length()) {
+    make_images(n_replicas);
+  }
+
+  /**
+   * @brief Sum over all interaction partners of a position.
+   *
+   * Octants are accepted as a single dipole when their distance is
+   * larger than their size divided by the opening angle, plus the
+   * offset of their center. An opening angle of zero gives the exact
+   * pair sum.
+   *
+   * @param pos Position of the target.
+   * @param target Original index of the target in this octree, or -1.
+   * @param theta Opening angle.
+   * @param init Initial value of the sum.
+   * @param f Binary operation mapping distance and moment of the
+   *          interaction partner to the value to be summed up.
+   * @param stack Buffer for the traversal.
+   */
+  template <typename T, class F>
+  T image_sum(Utils::Vector3d const &pos, int target, double theta, T init,
+              F f, std::vector<int> &stack) const {
+    if (m_nodes.empty()) {
+      return init;
+    }
+    auto const slot = (target == -1) ? -1 : m_slot[target];
+    for (auto const &image : m_images) {
+      stack.assign(1, 0);
+      while (not stack.empty()) {
+        auto const &node = m_nodes[stack.back()];
+        stack.pop_back();
+
+        /* position of the octant relative to the minimum image window */
+        auto inside = true;
+        auto outside = false;
+        for (unsigned int d = 0; d < 3; ++d) {
+          if (m_window[d]) {
+            auto const lower = pos[d] - node.upper[d] + image.offset[d];
+            auto const upper = pos[d] - node.lower[d] + image.offset[d];
+            outside |= upper < -m_box_l_half[d] or lower > m_box_l_half[d];
+            inside &= lower > -m_box_l_half[d] and upper < m_box_l_half[d];
+          }
+        }
+        if (outside) {
+          continue;
+        }
+
+        auto const has_target =
+            image.primary and slot >= node.begin and slot < node.end;
+        if (inside and not has_target) {
+          auto const d = pos - node.center + image.offset;
+          if (theta * d.norm() > node.size + theta * node.offset) {
+            init += f(d, node.moment);
+            continue;
+          }
+        }
+
+        if (node.n_children > 0) {
+          for (int i = 0; i < node.n_children; ++i) {
+            stack.push_back(node.first_child + i);
+          }
+          continue;
+        }
+        for (int i = node.begin; i < node.end; ++i) {
+          if (image.primary and i == slot) {
+            continue;
+          }
+          auto const dx = pos - m_sources[i].pos;
+          if (is_minimum_image(dx, image)) {
+            init += f(dx + image.offset, m_sources[i].m);
+          }
+        }
+      }
+    }
+    return init;
+  }
+
+  /**
+   * @brief Octants and dipoles needed by the dipoles in a box.
+   *
+   * Octants that all dipoles in the box accept as a single dipole are
+   * copied without their children, octants that they all ignore are
+   * left out. The traversal of the essential tree by @ref image_sum
+   * thus gives the same result as the traversal of the full octree.
+   */
+  EssentialTree essential_tree(Box const &box, double theta) const {
+    EssentialTree tree;
+    if (box.empty or m_nodes.empty() or
+        visibility(m_nodes[0], box, theta).first) {
+      return tree;
+    }
+    std::vector<int> origin(1, 0);
+    tree.nodes.emplace_back(m_nodes[0]);
+    for (std::size_t k = 0; k < tree.nodes.size(); ++k) {
+      auto const &node = m_nodes[origin[k]];
+      auto const begin = static_cast<int>(tree.sources.size());
+      tree.nodes[k].begin = begin;
+      tree.nodes[k].end = begin;
+      tree.nodes[k].first_child = 0;
+      tree.nodes[k].n_children = 0;
+      if (visibility(node, box, theta).second) {
+        continue;
+      }
+      if (node.n_children > 0) {
+        tree.nodes[k].first_child = static_cast<int>(tree.nodes.size());
+        for (int i = 0; i < node.n_children; ++i) {
+          auto const child = node.first_child + i;
+          if (not visibility(m_nodes[child], box, theta).first) {
+            origin.emplace_back(child);
+            tree.nodes.emplace_back(m_nodes[child]);
+            ++tree.nodes[k].n_children;
+          }
+        }
+      } else {
+        tree.sources.insert(tree.sources.end(),
+                            m_sources.begin() + node.begin,
+                            m_sources.begin() + node.end);
+        tree.nodes[k].end = static_cast<int>(tree.sources.size());
+      }
+    }
+    return tree;
+  }
+
+  /** @brief Bounding box of the dipoles. */
+  Box box() const {
+    if (m_nodes.empty()) {
+      return {{}, {}, true};
+    }
+    return {m_nodes[0].lower, m_nodes[0].upper, false};
+  }
+
+  auto const &dipole(int target) const { return m_sources[m_slot[target]]; }
+  auto size() const { return static_cast<int>(m_slot.size()); }
+};
+
+/**
+ * @brief Local octree and the essential trees of all other ranks.
+ */
+class Forest {
+  std::vector<Octree> m_trees;
+
+public:
+  /**
+   * @brief Build the local octree and exchange the essential trees.
+   * Needs to be called on all ranks.
+   */
+  Forest(std::vector<PosMom> local_posmom, int n_replicas, double theta) {
+    auto const &comm = ::comm_cart;
+    m_trees.emplace_back(std::move(local_posmom), n_replicas);
+    auto const &local = m_trees.front();
+    if (comm.size() == 1) {
+      return;
+    }
+
+    std::vector<Box> boxes;
+    boost::mpi::all_gather(comm, local.box(), boxes);
+    std::vector<EssentialTree> send_buf(comm.size());
+    for (int rank = 0; rank < comm.size(); ++rank) {
+      if (rank != comm.rank()) {
+        send_buf[rank] = local.essential_tree(boxes[rank], theta);
+      }
+    }
+    std::vector<EssentialTree> recv_buf;
+    boost::mpi::all_to_all(comm, send_buf, recv_buf);
+    for (int rank = 0; rank < comm.size(); ++rank) {
+      if (rank != comm.rank() and not recv_buf[rank].nodes.empty()) {
+        m_trees.emplace_back(std::move(recv_buf[rank]), n_replicas);
+      }
+    }
+  }
+
+  /** @brief Sum over all interaction partners of a local dipole. */
+  template <typename T, class F>
+  T image_sum(int target, double theta, T init, F f,
+              std::vector<int> &stack) const {
+    auto const &pos = m_trees.front().dipole(target).pos;
+    init = m_trees.front().image_sum(pos, target, theta, init, f, stack);
+    for (auto it = std::next(m_trees.begin()); it != m_trees.end(); ++it) {
+      init = it->image_sum(pos, -1, theta, init, f, stack);
+    }
+    return init;
+  }
+
+  auto const &dipole(int target) const {
+    return m_trees.front().dipole(target);
+  }
+};
+
+/**
+ * @brief Dipoles of the local particles.
+ * @return The local dipolar particles and their dipoles.
+ */
+auto local_particle_data(ParticleRange const &particles) {
+  std::vector<Particle *> local_particles;
+  std::vector<PosMom> local_posmom;
+
+  local_particles.reserve(particles.size());
+  local_posmom.reserve(particles.size());
+
+  for (auto &p : particles) {
+    if (p.dipm() != 0.0) {
+      local_particles.emplace_back(&p);
+      local_posmom.emplace_back(
+          PosMom{folded_position(p.pos(), ::box_geo), p.calc_dip()});
+    }
+  }
+
+  return std::make_pair(std::move(local_particles), std::move(local_posmom));
+}
+
+/**
+ * @brief Dipole of the error estimate sample.
+ */
+struct Sample {
+  PosMom dipole;
+  int rank;
+  /** Original index in the octree of @ref rank. */
+  int index;
+
+  template <class Archive> void serialize(Archive &ar, long int) {
+    ar &dipole &rank &index;
+  }
+};
+
+/**
+ * @brief Deterministic sample of the dipoles of all ranks.
+ * Needs to be called on all ranks.
+ */
+std::vector<Sample> gather_samples(Octree const &tree) {
+  auto const &comm = ::comm_cart;
+  std::vector<int> all_sizes;
+  boost::mpi::all_gather(comm, tree.size(), all_sizes);
+  auto const offset =
+      std::accumulate(all_sizes.begin(), all_sizes.begin() + comm.rank(), 0);
+  auto const total_size =
+      std::accumulate(all_sizes.begin() + comm.rank(), all_sizes.end(), offset);
+
+  auto const stride = std::max(1, total_size / n_error_samples);
+  auto const first = (stride - offset % stride) % stride;
+  std::vector<Sample> local_samples;
+  for (int i = first; i < tree.size(); i += stride) {
+    local_samples.push_back({tree.dipole(i), comm.rank(), i});
+  }
+
+  std::vector<std::vector<Sample>> all_samples;
+  boost::mpi::all_gather(comm, local_samples, all_samples);
+  std::vector<Sample> samples;
+  for (auto const &rank_samples : all_samples) {
+    samples.insert(samples.end(), rank_samples.begin(), rank_samples.end());
+  }
+  return samples;
+}
+
+/**
+ * @brief Forces on the sample dipoles.
+ * Each rank sums up the forces of its own octree. Needs to be called on
+ * all ranks.
+ */
+std::vector<double> sample_forces(Octree const &tree,
+                                  std::vector<Sample> const &samples,
+                                  double theta) {
+  std::vector<double> forces(3 * samples.size());
+  std::vector<int> stack;
+  for (std::size_t i = 0; i < samples.size(); ++i) {
+    auto const &sample = samples[i];
+    auto const &m = sample.dipole.m;
+    auto const target = (sample.rank == ::comm_cart.rank()) ? sample.index : -1;
+    auto const fi = tree.image_sum(
+        sample.dipole.pos, target, theta, ParticleForce{},
+        [&m](Utils::Vector3d const &d, Utils::Vector3d const &mj) {
+          return Dipoles::pair_force(d, m, mj);
+        },
+        stack);
+    std::copy(fi.f.begin(), fi.f.end(), forces.begin() + 3 * i);
+  }
+  boost::mpi::all_reduce(::comm_cart, boost::mpi::inplace(forces.data()),
+                         static_cast<int>(forces.size()), std::plus<>());
+  return forces;
+}
+
+/** @brief Relative RMS difference of sample forces. */
+double force_error(std::vector<double> const &ref,
+                   std::vector<double> const &res) {
+  std::array<double, 2> sums{};
+  for (std::size_t i = 0; i < ref.size(); ++i) {
+    sums[0] += Utils::sqr(res[i] - ref[i]);
+    sums[1] += Utils::sqr(ref[i]);
+  }
+  return (sums[1] > 0.) ? std::sqrt(sums[0] / sums[1]) : 0.;
+}
+} // namespace
+
+void DipolarBarnesHut::add_long_range_forces(
+    ParticleRange const &particles) const {
+  auto [local_particles, local_posmom] = local_particle_data(particles);
+  auto const forest =
+      Forest(std::move(local_posmom), n_replicas, opening_angle);
+
+  std::vector<int> stack;
+  for (std::size_t i = 0; i < local_particles.size(); ++i) {
+    auto const &m = forest.dipole(static_cast<int>(i)).m;
+    auto const fi = forest.image_sum(
+        static_cast<int>(i), opening_angle, ParticleForce{},
+        [&m](Utils::Vector3d const &d, Utils::Vector3d const &mj) {
+          return Dipoles::pair_force(d, m, mj);
+        },
+        stack);
+    local_particles[i]->force() += prefactor * fi.f;
+    local_particles[i]->torque() += prefactor * fi.torque;
+  }
+}
+
+double
+DipolarBarnesHut::long_range_energy(ParticleRange const &particles) const {
+  auto [local_particles, local_posmom] = local_particle_data(particles);
+  auto const forest =
+      Forest(std::move(local_posmom), n_replicas, opening_angle);
+
+  auto u = 0.;
+  std::vector<int> stack;
+  for (int i = 0; i < static_cast<int>(local_particles.size()); ++i) {
+    auto const &m = forest.dipole(i).m;
+    u = forest.image_sum(
+        i, opening_angle, u,
+        [&m](Utils::Vector3d const &d, Utils::Vector3d const &mj) {
+          return Dipoles::pair_potential(d, m, mj);
+        },
+        stack);
+  }
+
+  /* every pair is visited from both sides */
+  return 0.5 * prefactor * u;
+}
+
+double DipolarBarnesHut::estimate_error() const {
+  auto const tree = Octree(
+      local_particle_data(::cell_structure.local_particles()).second,
+      n_replicas);
+  auto const samples = gather_samples(tree);
+  return force_error(sample_forces(tree, samples, 0.),
+                     sample_forces(tree, samples, opening_angle));
+}
+
+void DipolarBarnesHut::tune() {
+  if (accuracy <= 0.) {
+    return;
+  }
+  auto constexpr theta_max = 1.;
+  auto constexpr theta_min = 0.01;
+  auto constexpr theta_step = 0.8;
+
+  auto const tree = Octree(
+      local_particle_data(::cell_structure.local_particles()).second,
+      n_replicas);
+  auto const samples = gather_samples(tree);
+  auto const ref = sample_forces(tree, samples, 0.);
+
+  auto theta = theta_max;
+  while (force_error(ref, sample_forces(tree, samples, theta)) > accuracy) {
+    theta *= theta_step;
+    if (theta < theta_min) {
+      throw std::runtime_error(
+          "DipolarBarnesHut: failed to reach the requested accuracy");
+    }
+  }
+  opening_angle = theta;
+}
+
+DipolarBarnesHut::DipolarBarnesHut(double prefactor, double opening_angle,
+                                   int n_replicas, double accuracy)
+    : prefactor{prefactor}, opening_angle{opening_angle},
+      n_replicas{n_replicas}, accuracy{accuracy} {
+  if (prefactor <= 0.) {
+    throw std::domain_error("Parameter 'prefactor' must be > 0");
+  }
+  if (opening_angle <= 0.) {
+    throw std::domain_error("Parameter 'opening_angle' must be > 0");
+  }
+  if (n_replicas < 0) {
+    throw std::domain_error("Parameter 'n_replicas' must be >= 0");
+  }
+  if (accuracy <= 0. and accuracy != -1.) {
+    throw std::domain_error("Parameter 'accuracy' must be > 0 or -1");
+  }
+}
+
+#endif // DIPOLES
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPRESSO_SRC_CORE_MAGNETOSTATICS_BARNES_HUT_HPP
+#define ESPRESSO_SRC_CORE_MAGNETOSTATICS_BARNES_HUT_HPP
+
+#include "config/config.hpp"
+
+#ifdef DIPOLES
+
+#include "ParticleRange.hpp"
+
+/**
+ * @brief Dipolar Barnes-Hut octree sum on the CPU.
+ *
+ * Each rank sorts its dipoles into an octree. Every octant carries the
+ * sum of its dipole moments, located at the center of its dipoles
+ * weighted by their magnitude. Octants that are far enough from a
+ * particle, as controlled by the opening angle, interact with it as
+ * a single dipole; the remaining pairs are summed up exactly. The ranks
+ * exchange locally essential trees: the octants that the dipoles of the
+ * receiving rank need, without the children of octants that all of
+ * these dipoles accept as a single dipole. Each rank evaluates the
+ * forces, torques and energies of its local particles.
+ *
+ * Periodic boundaries are handled like in @ref DipolarDirectSum: with
+ * the minimum image convention when no replicas are used, otherwise by
+ * summing over @ref n_replicas periodic copies with a spherical cutoff.
+ */
+struct DipolarBarnesHut {
+  double prefactor;
+  /** @brief Opening angle of the octants. */
+  double opening_angle;
+  int n_replicas;
+  /** @brief Target relative force error, or -1 to skip tuning. */
+  double accuracy;
+
+  DipolarBarnesHut(double prefactor, double opening_angle, int n_replicas,
+                   double accuracy);
+
+  void on_activation() {
+    sanity_checks();
+    tune();
+  }
+  void on_boxl_change() const {}
+  void on_node_grid_change() const {}
+  void on_periodicity_change() const {}
+  void on_cell_structure_change() const {}
+  void init() const {}
+  void sanity_checks() const {}
+
+  /**
+   * @brief Tune the opening angle to the target accuracy.
+   * The opening angle is decreased until the error estimate drops
+   * below @ref accuracy. Nothing is done when @ref accuracy is negative.
+   */
+  void tune();
+
+  /**
+   * @brief Estimate the relative RMS force error of the tree summation.
+   * Tree and exact forces are compared on a deterministic sample of
+   * the particles. Needs to be called on all ranks.
+   */
+  double estimate_error() const;
+
+  double long_range_energy(ParticleRange const &particles) const;
+  void add_long_range_forces(ParticleRange const &particles) const;
+};
+
+#endif // DIPOLES
+#endif
@@ -24,6 +24,7 @@
 #ifdef DIPOLES
 
 #include "magnetostatics/dipolar_direct_sum.hpp"
+#include "magnetostatics/dipolar_pair_kernels.hpp"
 
 #include "cells.hpp"
 #include "communication.hpp"
@@ -51,59 +52,6 @@
 #include <vector>
 
 namespace {
-/**
- * @brief Pair force of two interacting dipoles.
- *
- * @param d Distance vector.
- * @param m1 Dipole moment of one particle.
- * @param m2 Dipole moment of the other particle.
- *
- * @return Resulting force.
- */
-auto pair_force(Utils::Vector3d const &d, Utils::Vector3d const &m1,
-                Utils::Vector3d const &m2) {
-  auto const pe2 = m1 * d;
-  auto const pe3 = m2 * d;
-
-  auto const r2 = d.norm2();
-  auto const r = std::sqrt(r2);
-  auto const r5 = r2 * r2 * r;
-  auto const r7 = r5 * r2;
-
-  auto const a = 3.0 * (m1 * m2) / r5;
-  auto const b = -15.0 * pe2 * pe3 / r7;
-
-  auto const f = (a + b) * d + 3.0 * (pe3 * m1 + pe2 * m2) / r5;
-  auto const r3 = r2 * r;
-  auto const t =
-      -vector_product(m1, m2) / r3 + 3.0 * pe3 * vector_product(m1, d) / r5;
-
-  return ParticleForce{f, t};
-}
-
-/**
- * @brief Pair potential for two interacting dipoles.
- *
- * @param d Distance vector.
- * @param m1 Dipole moment of one particle.
- * @param m2 Dipole moment of the other particle.
- *
- * @return Interaction energy.
- */
-auto pair_potential(Utils::Vector3d const &d, Utils::Vector3d const &m1,
-                    Utils::Vector3d const &m2) {
-  auto const r2 = d * d;
-  auto const r = sqrt(r2);
-  auto const r3 = r2 * r;
-  auto const r5 = r3 * r2;
-
-  auto const pe1 = m1 * m2;
-  auto const pe2 = m1 * d;
-  auto const pe3 = m2 * d;
-
-  return pe1 / r3 - 3.0 * pe2 * pe3 / r5;
-}
-
 /**
  * @brief Call kernel for every 3d index in a sphere around the origin.
  *
@@ -290,7 +238,7 @@ void DipolarDirectSum::add_long_range_forces(
     auto fi = image_sum(
         it, std::next(it), it, with_replicas, ncut, box_l, ParticleForce{},
         [it](Utils::Vector3d const &rn, Utils::Vector3d const &mj) {
-          return pair_force(rn, it->m, mj);
+          return Dipoles::pair_force(rn, it->m, mj);
         });
 
     /* IA with other local particles */
@@ -305,7 +253,7 @@ void DipolarDirectSum::add_long_range_forces(
       for_each_image(ncut, [&](int nx, int ny, int nz) {
         auto const rn =
             d + Utils::Vector3d{nx * box_l[0], ny * box_l[1], nz * box_l[2]};
-        auto const pf = pair_force(rn, it->m, jt->m);
+        auto const pf = Dipoles::pair_force(rn, it->m, jt->m);
         fij += pf;
         fji.f -= pf.f;
         /* Conservation of angular momentum mandates that
@@ -335,14 +283,14 @@ void DipolarDirectSum::add_long_range_forces(
         image_sum(all_posmom.begin(), local_posmom_begin, it, with_replicas,
                   ncut, box_l, ParticleForce{},
                   [it](Utils::Vector3d const &rn, Utils::Vector3d const &mj) {
-                    return pair_force(rn, it->m, mj);
+                    return Dipoles::pair_force(rn, it->m, mj);
                   });
 
     // black particles
     fi += image_sum(local_posmom_end, all_posmom.end(), it, with_replicas, ncut,
                     box_l, ParticleForce{},
                     [it](Utils::Vector3d const &rn, Utils::Vector3d const &mj) {
-                      return pair_force(rn, it->m, mj);
+                      return Dipoles::pair_force(rn, it->m, mj);
                     });
 
     (*p)->force() += prefactor * fi.f;
@@ -377,7 +325,7 @@ DipolarDirectSum::long_range_energy(ParticleRange const &particles) const {
   for (auto it = local_posmom_begin; it != local_posmom_end; ++it) {
     u = image_sum(it, all_posmom.end(), it, with_replicas, ncut, box_l, u,
                   [it](Utils::Vector3d const &rn, Utils::Vector3d const &mj) {
-                    return pair_potential(rn, it->m, mj);
+                    return Dipoles::pair_potential(rn, it->m, mj);
                   });
   }
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2010-2022 The ESPResSo project
+ * Copyright (C) 2002,2003,2004,2005,2006,2007,2008,2009,2010
+ *   Max-Planck-Institute for Polymer Research, Theory Group
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPRESSO_SRC_CORE_MAGNETOSTATICS_DIPOLAR_PAIR_KERNELS_HPP
+#define ESPRESSO_SRC_CORE_MAGNETOSTATICS_DIPOLAR_PAIR_KERNELS_HPP
+
+#include "config/config.hpp"
+
+#ifdef DIPOLES
+
+#include "Particle.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cmath>
+
+namespace Dipoles {
+
+/**
+ * @brief Pair force of two interacting dipoles.
+ *
+ * @param d Distance vector.
+ * @param m1 Dipole moment of one particle.
+ * @param m2 Dipole moment of the other particle.
+ *
+ * @return Resulting force and torque on the first particle.
+ */
+inline ParticleForce pair_force(Utils::Vector3d const &d,
+                                Utils::Vector3d const &m1,
+                                Utils::Vector3d const &m2) {
+  auto const pe2 = m1 * d;
+  auto const pe3 = m2 * d;
+
+  auto const r2 = d.norm2();
+  auto const r = std::sqrt(r2);
+  auto const r5 = r2 * r2 * r;
+  auto const r7 = r5 * r2;
+
+  auto const a = 3.0 * (m1 * m2) / r5;
+  auto const b = -15.0 * pe2 * pe3 / r7;
+
+  auto const f = (a + b) * d + 3.0 * (pe3 * m1 + pe2 * m2) / r5;
+  auto const r3 = r2 * r;
+  auto const t =
+      -vector_product(m1, m2) / r3 + 3.0 * pe3 * vector_product(m1, d) / r5;
+
+  return ParticleForce{f, t};
+}
+
+/**
+ * @brief Pair potential for two interacting dipoles.
+ *
+ * @param d Distance vector.
+ * @param m1 Dipole moment of one particle.
+ * @param m2 Dipole moment of the other particle.
+ *
+ * @return Interaction energy.
+ */
+inline double pair_potential(Utils::Vector3d const &d,
+                             Utils::Vector3d const &m1,
+                             Utils::Vector3d const &m2) {
+  auto const r2 = d * d;
+  auto const r = std::sqrt(r2);
+  auto const r3 = r2 * r;
+  auto const r5 = r3 * r2;
+
+  auto const pe1 = m1 * m2;
+  auto const pe2 = m1 * d;
+  auto const pe3 = m2 * d;
+
+  return pe1 / r3 - 3.0 * pe2 * pe3 / r5;
+}
+
+} // namespace Dipoles
+
+#endif // DIPOLES
+#endif
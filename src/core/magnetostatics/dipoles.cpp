@@ -131,6 +131,9 @@ struct LongRangeForce : public boost::static_visitor<void> {
   void operator()(std::shared_ptr<DipolarDirectSum> const &actor) const {
     actor->add_long_range_forces(m_particles);
   }
+  void operator()(std::shared_ptr<DipolarBarnesHut> const &actor) const {
+    actor->add_long_range_forces(m_particles);
+  }
 #ifdef DIPOLAR_DIRECT_SUM
   void operator()(std::shared_ptr<DipolarDirectSumGpu> const &actor) const {
     actor->add_long_range_forces();
@@ -167,6 +170,9 @@ struct LongRangeEnergy : public boost::static_visitor<double> {
   double operator()(std::shared_ptr<DipolarDirectSum> const &actor) const {
     return actor->long_range_energy(m_particles);
   }
+  double operator()(std::shared_ptr<DipolarBarnesHut> const &actor) const {
+    return actor->long_range_energy(m_particles);
+  }
 #ifdef DIPOLAR_DIRECT_SUM
   double operator()(std::shared_ptr<DipolarDirectSumGpu> const &actor) const {
     actor->long_range_energy();
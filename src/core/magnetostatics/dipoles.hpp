@@ -26,6 +26,7 @@
 
 #include "actor/traits.hpp"
 
+#include "magnetostatics/barnes_hut.hpp"
 #include "magnetostatics/barnes_hut_gpu.hpp"
 #include "magnetostatics/dipolar_direct_sum.hpp"
 #include "magnetostatics/dipolar_direct_sum_gpu.hpp"
@@ -49,6 +50,7 @@
 
 using MagnetostaticsActor =
     boost::variant<std::shared_ptr<DipolarDirectSum>,
+                   std::shared_ptr<DipolarBarnesHut>,
 #ifdef DIPOLAR_DIRECT_SUM
                    std::shared_ptr<DipolarDirectSumGpu>,
 #endif
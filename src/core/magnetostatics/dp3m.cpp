@@ -106,7 +106,10 @@ double DipolarP3M::calc_average_self_energy_k_space() const {
   auto const size = Utils::Vector3i{dp3m.fft.plan[3].new_mesh};
 
   auto const node_phi = grid_influence_function_self_energy(
-      dp3m.params, start, start + size, dp3m.g_energy);
+      dp3m.params, start, start + size, dp3m.g_energy,
+      [this](Utils::Vector3i const &n) {
+        return dp3m.fft.mode_multiplicity(n);
+      });
 
   double phi = 0.;
   boost::mpi::reduce(comm_cart, node_phi, phi, std::plus<>(), 0);
@@ -285,10 +288,12 @@ double DipolarP3M::kernel(bool force_flag, bool energy_flag,
       ind = 0;
       i = 0;
       double node_k_space_energy_dip = 0.0;
+      auto const start = Utils::Vector3i{dp3m.fft.plan[3].start};
       for (j[0] = 0; j[0] < dp3m.fft.plan[3].new_mesh[0]; j[0]++) {
         for (j[1] = 0; j[1] < dp3m.fft.plan[3].new_mesh[1]; j[1]++) {
           for (j[2] = 0; j[2] < dp3m.fft.plan[3].new_mesh[2]; j[2]++) {
             node_k_space_energy_dip +=
+                dp3m.fft.mode_multiplicity(Utils::Vector3i{j} + start) *
                 dp3m.g_energy[i] *
                 (Utils::sqr(
                      dp3m.rs_mesh_dip[0][ind] *
@@ -596,6 +601,10 @@ public:
 
   void on_solver_change() const override { on_dipoles_change(); }
 
+  std::vector<double> particle_signature() const override {
+    return {static_cast<double>(dp3m.sum_dip_part), dp3m.sum_mu2};
+  }
+
   boost::optional<std::string>
   layer_correction_veto_r_cut(double) const override {
     return {};
@@ -908,6 +917,9 @@ void DipolarP3M::sanity_checks_node_grid() const {
     throw std::runtime_error(
         "DipolarP3M: node grid must be sorted, largest first");
   }
+  if (not has_uniform_node_domains()) {
+    throw std::runtime_error("DipolarP3M: requires local boxes of equal size");
+  }
 }
 
 void DipolarP3M::scaleby_box_l() {
@@ -916,8 +928,25 @@ void DipolarP3M::scaleby_box_l() {
   dp3m.params.recalc_a_ai_cao_cut(box_geo.length());
   dp3m.local_mesh.recalc_ld_pos(dp3m.params);
   sanity_checks_boxl();
-  calc_influence_function_force();
-  calc_influence_function_energy();
+  auto const g_params = dp3m_data_struct::InfluenceFunctionParameters{
+      dp3m.params.mesh,
+      dp3m.params.cao,
+      dp3m.params.alpha_L,
+      0,
+      Utils::Vector3i{dp3m.fft.plan[3].start},
+      Utils::Vector3i{dp3m.fft.plan[3].new_mesh}};
+  if (g_params == dp3m.g_params and dp3m.g_box_l != Utils::Vector3d{}) {
+    /* the influence functions only depend on the box length through
+     * a prefactor of the inverse square of the box length */
+    dp3m.scale_influence_functions(
+        Utils::sqr(dp3m.g_box_l[0] * box_geo.length_inv()[0]));
+  } else {
+    calc_influence_function_force();
+    calc_influence_function_energy();
+  }
+  dp3m.g_params = g_params;
+  /* influence functions of the tuning mode are placeholders */
+  dp3m.g_box_l = (dp3m.params.tuning) ? Utils::Vector3d{} : box_geo.length();
   dp3m.energy_correction = 0.0;
 }
 
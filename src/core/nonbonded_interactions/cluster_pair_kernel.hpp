@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NB_IA_CLUSTER_PAIR_KERNEL_HPP
+#define CORE_NB_IA_CLUSTER_PAIR_KERNEL_HPP
+
+/** \file
+ *  Non-bonded force kernel for pairs of particle clusters.
+ *
+ *  The interactions between the particles of two clusters are evaluated
+ *  row by row, each row being a loop of fixed length without branches
+ *  that the compiler can vectorize. Only the Lennard-Jones, WCA,
+ *  soft-sphere and Lennard-Jones cosine potentials are implemented this
+ *  way. Cluster pairs involving other interactions, tabulated potentials
+ *  or exclusions are handed to a scalar pair kernel.
+ */
+
+#include "config/config.hpp"
+
+#include "BoxGeometry.hpp"
+#include "cell_system/HotParticleData.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/math/int_pow.hpp>
+#include <utils/math/sqr.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ClusterKernel {
+
+/** Potentials evaluated by the cluster pair kernel. */
+enum Potential : std::uint8_t {
+  HAS_LJ = 1u << 0,
+  HAS_WCA = 1u << 1,
+  HAS_SOFT_SPHERE = 1u << 2,
+  HAS_LJCOS = 1u << 3,
+  /** Interactions that need the scalar pair kernel */
+  HAS_UNSUPPORTED = 1u << 7
+};
+
+/**
+ * @brief Potentials that are active between two particle types,
+ * as a combination of @ref Potential flags.
+ */
+inline std::uint8_t active_potentials(IA_parameters const &ia_params) {
+  std::uint8_t flags = 0u;
+  auto const is_active = [](double cutoff) { return cutoff > 0.; };
+#ifdef LENNARD_JONES
+  if (is_active(ia_params.lj.max_cutoff()))
+    flags |= HAS_LJ;
+#endif
+#ifdef WCA
+  if (is_active(ia_params.wca.max_cutoff()))
+    flags |= HAS_WCA;
+#endif
+#ifdef SOFT_SPHERE
+  if (is_active(ia_params.soft_sphere.max_cutoff()))
+    flags |= HAS_SOFT_SPHERE;
+#endif
+#ifdef LJCOS
+  if (is_active(ia_params.ljcos.max_cutoff()))
+    flags |= HAS_LJCOS;
+#endif
+  auto unsupported = false;
+#ifdef LENNARD_JONES_GENERIC
+  unsupported |= is_active(ia_params.ljgen.max_cutoff());
+#endif
+#ifdef SMOOTH_STEP
+  unsupported |= is_active(ia_params.smooth_step.max_cutoff());
+#endif
+#ifdef HERTZIAN
+  unsupported |= is_active(ia_params.hertzian.max_cutoff());
+#endif
+#ifdef GAUSSIAN
+  unsupported |= is_active(ia_params.gaussian.max_cutoff());
+#endif
+#ifdef BMHTF_NACL
+  unsupported |= is_active(ia_params.bmhtf.max_cutoff());
+#endif
+#ifdef MORSE
+  unsupported |= is_active(ia_params.morse.max_cutoff());
+#endif
+#ifdef BUCKINGHAM
+  unsupported |= is_active(ia_params.buckingham.max_cutoff());
+#endif
+#ifdef HAT
+  unsupported |= is_active(ia_params.hat.max_cutoff());
+#endif
+#ifdef LJCOS2
+  unsupported |= is_active(ia_params.ljcos2.max_cutoff());
+#endif
+#ifdef GAY_BERNE
+  unsupported |= is_active(ia_params.gay_berne.max_cutoff());
+#endif
+#ifdef TABULATED
+  unsupported |= is_active(ia_params.tab.cutoff());
+#endif
+#ifdef THOLE
+  unsupported |= (ia_params.thole.scaling_coeff != 0.);
+#endif
+  unsupported |= ia_params.spline_tabulation.is_tabulated();
+  if (unsupported)
+    flags |= HAS_UNSUPPORTED;
+  return flags;
+}
+
+/* The force factors below evaluate both branches of the potentials and
+ * select the result, so that they can be vectorized. Results outside of
+ * the interaction range are discarded, even if they are not finite. They
+ * are evaluated in the floating-point type of the distance, which is
+ * @c float in the mixed-precision mode. */
+
+#ifdef LENNARD_JONES
+template <class Real>
+Real lj_force_factor(IA_parameters const &ia_params, Real dist) {
+  auto const &lj = ia_params.lj;
+  auto const r_off = dist - static_cast<Real>(lj.offset);
+  auto const frac6 = Utils::int_pow<6>(static_cast<Real>(lj.sig) / r_off);
+  auto const fac = Real(48) * static_cast<Real>(lj.eps) * frac6 *
+                   (frac6 - Real(0.5)) / (r_off * dist);
+  return (dist < static_cast<Real>(lj.max_cutoff()) and
+          dist > static_cast<Real>(lj.min_cutoff()))
+             ? fac
+             : Real(0);
+}
+#endif
+
+#ifdef WCA
+template <class Real>
+Real wca_force_factor(IA_parameters const &ia_params, Real dist) {
+  auto const &wca = ia_params.wca;
+  auto const frac6 = Utils::int_pow<6>(static_cast<Real>(wca.sig) / dist);
+  auto const fac = Real(48) * static_cast<Real>(wca.eps) * frac6 *
+                   (frac6 - Real(0.5)) / (dist * dist);
+  return (dist < static_cast<Real>(wca.cut)) ? fac : Real(0);
+}
+#endif
+
+#ifdef SOFT_SPHERE
+template <class Real>
+Real soft_force_factor(IA_parameters const &ia_params, Real dist) {
+  auto const &soft = ia_params.soft_sphere;
+  auto const r_off = dist - static_cast<Real>(soft.offset);
+  auto const fac = static_cast<Real>(soft.a * soft.n) /
+                   std::pow(r_off, static_cast<Real>(soft.n + 1.)) / dist;
+  return (dist < static_cast<Real>(soft.max_cutoff()) and r_off > Real(0))
+             ? fac
+             : Real(0);
+}
+#endif
+
+#ifdef LJCOS
+template <class Real>
+Real ljcos_force_factor(IA_parameters const &ia_params, Real dist) {
+  auto const &ljcos = ia_params.ljcos;
+  auto const r_off = dist - static_cast<Real>(ljcos.offset);
+  auto const fac_cos =
+      (r_off / dist) * static_cast<Real>(ljcos.alfa) *
+      static_cast<Real>(ljcos.eps) *
+      std::sin(static_cast<Real>(ljcos.alfa) * Utils::sqr(r_off) +
+               static_cast<Real>(ljcos.beta));
+  auto const frac6 = Utils::int_pow<6>(static_cast<Real>(ljcos.sig) / r_off);
+  auto const fac_lj = Real(48) * static_cast<Real>(ljcos.eps) * frac6 *
+                      (frac6 - Real(0.5)) / (r_off * dist);
+  auto const fac = (dist > static_cast<Real>(ljcos.rmin + ljcos.offset))
+                       ? fac_cos
+                       : ((dist > Real(0)) ? fac_lj : Real(0));
+  return (dist < static_cast<Real>(ljcos.max_cutoff())) ? fac : Real(0);
+}
+#endif
+
+} // namespace ClusterKernel
+
+/**
+ * @brief Non-bonded force kernel for pairs of particle clusters.
+ *
+ * The table of active potentials per type pair is set up on
+ * construction, so a kernel should only be used for one force
+ * calculation.
+ *
+ * With @p Real = @c float, the distances and the force factors are
+ * computed in single precision, which doubles the width of the vector
+ * instructions. The positions are taken relative to the first particle
+ * of the first cluster to keep their magnitude small, and the forces are
+ * accumulated in double precision. Unsupported cluster pairs are always
+ * evaluated in double precision by the scalar kernel.
+ *
+ * The distances follow the minimum image convention of a cuboid box.
+ *
+ * @tparam PairKernel Scalar kernel for the unsupported cluster pairs,
+ *         needs to be callable with (HotParticleData, index, index,
+ *         Utils::Vector3d, double) like the kernel of
+ *         @ref CellStructure::hot_non_bonded_loop.
+ * @tparam Real Floating-point type of the distances and force factors.
+ */
+template <class PairKernel, class Real = double> class ClusterPairKernel {
+  static constexpr std::uint32_t cluster_size = ClusterPair::size;
+
+  PairKernel m_pair_kernel;
+  BoxGeometry m_box;
+  /** Box length and its inverse, the inverse is zero in the
+   *  non-periodic directions such that they are never folded */
+  Real m_length[3];
+  Real m_length_inv[3];
+  int m_n_types;
+  std::vector<IA_parameters const *> m_ia_params;
+  std::vector<std::uint8_t> m_potentials;
+
+public:
+  ClusterPairKernel(PairKernel pair_kernel, BoxGeometry const &box)
+      : m_pair_kernel(std::move(pair_kernel)), m_box(box),
+        m_n_types(::max_seen_particle_type) {
+    assert(box.type() == BoxType::CUBOID);
+    for (unsigned k = 0; k < 3; ++k) {
+      m_length[k] = static_cast<Real>(box.length()[k]);
+      m_length_inv[k] =
+          box.periodic(k) ? static_cast<Real>(box.length_inv()[k]) : Real(0);
+    }
+    auto const n_pairs = static_cast<std::size_t>(m_n_types * m_n_types);
+    m_ia_params.resize(n_pairs);
+    m_potentials.resize(n_pairs);
+    for (int i = 0; i < m_n_types; ++i) {
+      for (int j = 0; j < m_n_types; ++j) {
+        auto const &ia_params = get_ia_param(i, j);
+        m_ia_params[i * m_n_types + j] = &ia_params;
+        m_potentials[i * m_n_types + j] =
+            ClusterKernel::active_potentials(ia_params);
+      }
+    }
+  }
+
+  void operator()(HotParticleData &data, ClusterPair const &pair) const {
+    auto const is_self_pair = pair.is_self_pair();
+
+    /* interaction parameters of the cluster pair, the second cluster
+     * is padded with its last particle */
+    IA_parameters const *ia_params[cluster_size][cluster_size];
+    std::uint8_t potentials = 0u;
+    for (std::uint32_t a = 0; a < pair.n_i; ++a) {
+      auto const row = data.type[pair.i + a] * m_n_types;
+      for (std::uint32_t b = 0; b < cluster_size; ++b) {
+        auto const col = data.type[pair.j + std::min(b, pair.n_j - 1u)];
+        ia_params[a][b] = m_ia_params[row + col];
+        potentials |= m_potentials[row + col];
+      }
+    }
+
+    auto needs_pair_kernel = static_cast<bool>(
+        potentials & ClusterKernel::Potential::HAS_UNSUPPORTED);
+#ifdef EXCLUSIONS
+    for (std::uint32_t a = 0; a < pair.n_i; ++a) {
+      needs_pair_kernel |= static_cast<bool>(data.has_exclusions[pair.i + a]);
+    }
+    for (std::uint32_t b = 0; b < pair.n_j; ++b) {
+      needs_pair_kernel |= static_cast<bool>(data.has_exclusions[pair.j + b]);
+    }
+#endif
+    if (needs_pair_kernel) {
+      for (std::uint32_t a = 0; a < pair.n_i; ++a) {
+        auto const i = pair.i + a;
+        for (std::uint32_t b = is_self_pair ? a + 1u : 0u; b < pair.n_j;
+             ++b) {
+          auto const j = pair.j + b;
+          auto const d = m_box.get_mi_vector(data.position(i),
+                                             data.position(j));
+          m_pair_kernel(data, i, j, d, d.norm2());
+        }
+      }
+      return;
+    }
+
+    /* in single precision, the positions are taken relative to the first
+     * particle of the first cluster, at their closest periodic image; in
+     * double precision they are used as is to get the same distances as
+     * the scalar kernel */
+    auto const position = [this, &data, origin = data.position(pair.i)](
+                              std::size_t i, unsigned k) {
+      if (std::is_same<Real, double>::value) {
+        return static_cast<Real>(data.pos[k][i]);
+      }
+      return static_cast<Real>(
+          m_box.get_mi_coord(data.pos[k][i], origin[k], k));
+    };
+    Real x_j[3][cluster_size];
+    for (std::uint32_t b = 0; b < cluster_size; ++b) {
+      auto const j = pair.j + std::min(b, pair.n_j - 1u);
+      for (unsigned k = 0; k < 3; ++k) {
+        x_j[k][b] = position(j, k);
+      }
+    }
+
+    double f_j[3][cluster_size] = {};
+    for (std::uint32_t a = 0; a < pair.n_i; ++a) {
+      auto const i = pair.i + a;
+      Real d[3][cluster_size];
+      Real dist[cluster_size];
+      Real fac[cluster_size] = {};
+      bool valid[cluster_size];
+
+      Real x_i[3];
+      for (unsigned k = 0; k < 3; ++k) {
+        x_i[k] = position(i, k);
+      }
+      for (std::uint32_t b = 0; b < cluster_size; ++b) {
+        auto dist2 = Real(0);
+        for (std::size_t k = 0; k < 3; ++k) {
+          auto const dx = x_i[k] - x_j[k][b];
+          d[k][b] = dx - std::round(dx * m_length_inv[k]) * m_length[k];
+          dist2 += d[k][b] * d[k][b];
+        }
+        dist[b] = std::sqrt(dist2);
+        valid[b] = (b < pair.n_j) and (not is_self_pair or b > a);
+      }
+
+#ifdef LENNARD_JONES
+      if (potentials & ClusterKernel::Potential::HAS_LJ) {
+        for (std::uint32_t b = 0; b < cluster_size; ++b) {
+          fac[b] += ClusterKernel::lj_force_factor(*ia_params[a][b], dist[b]);
+        }
+      }
+#endif
+#ifdef WCA
+      if (potentials & ClusterKernel::Potential::HAS_WCA) {
+        for (std::uint32_t b = 0; b < cluster_size; ++b) {
+          fac[b] += ClusterKernel::wca_force_factor(*ia_params[a][b], dist[b]);
+        }
+      }
+#endif
+#ifdef SOFT_SPHERE
+      if (potentials & ClusterKernel::Potential::HAS_SOFT_SPHERE) {
+        for (std::uint32_t b = 0; b < cluster_size; ++b) {
+          fac[b] +=
+              ClusterKernel::soft_force_factor(*ia_params[a][b], dist[b]);
+        }
+      }
+#endif
+#ifdef LJCOS
+      if (potentials & ClusterKernel::Potential::HAS_LJCOS) {
+        for (std::uint32_t b = 0; b < cluster_size; ++b) {
+          fac[b] +=
+              ClusterKernel::ljcos_force_factor(*ia_params[a][b], dist[b]);
+        }
+      }
+#endif
+
+      for (std::size_t k = 0; k < 3; ++k) {
+        auto f_i = 0.;
+        for (std::uint32_t b = 0; b < cluster_size; ++b) {
+          auto const f =
+              valid[b] ? static_cast<double>(fac[b] * d[k][b]) : 0.;
+          f_i += f;
+          f_j[k][b] -= f;
+        }
+        data.force[k][i] += f_i;
+      }
+    }
+
+    for (std::uint32_t b = 0; b < pair.n_j; ++b) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        data.force[k][pair.j + b] += f_j[k][b];
+      }
+    }
+  }
+};
+
+#endif
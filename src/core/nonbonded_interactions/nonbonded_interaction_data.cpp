@@ -151,11 +151,75 @@ static double recalc_maximal_cutoff(const IA_parameters &data) {
   return max_cut_current;
 }
 
+/** Select the kernel of the central forces: pairs of particle types with
+ *  a single active potential get a kernel without the branches of the
+ *  other potentials, tabulated pairs get the spline kernel.
+ */
+static CentralForceKernel::Kernel
+select_central_force_kernel(IA_parameters const &data) {
+  using namespace CentralForceKernel;
+  auto kernel = KERNEL_NONE;
+  auto n_active = 0;
+  auto const check = [&kernel, &n_active](double cutoff, Kernel candidate) {
+    if (cutoff > 0.) {
+      kernel = candidate;
+      ++n_active;
+    }
+  };
+#ifdef LENNARD_JONES
+  check(data.lj.max_cutoff(), KERNEL_LJ);
+#endif
+#ifdef WCA
+  check(data.wca.max_cutoff(), KERNEL_WCA);
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  check(data.ljgen.max_cutoff(), KERNEL_LJGEN);
+#endif
+#ifdef SMOOTH_STEP
+  check(data.smooth_step.max_cutoff(), KERNEL_SMOOTH_STEP);
+#endif
+#ifdef HERTZIAN
+  check(data.hertzian.max_cutoff(), KERNEL_HERTZIAN);
+#endif
+#ifdef GAUSSIAN
+  check(data.gaussian.max_cutoff(), KERNEL_GAUSSIAN);
+#endif
+#ifdef BMHTF_NACL
+  check(data.bmhtf.max_cutoff(), KERNEL_BMHTF);
+#endif
+#ifdef BUCKINGHAM
+  check(data.buckingham.max_cutoff(), KERNEL_BUCKINGHAM);
+#endif
+#ifdef MORSE
+  check(data.morse.max_cutoff(), KERNEL_MORSE);
+#endif
+#ifdef SOFT_SPHERE
+  check(data.soft_sphere.max_cutoff(), KERNEL_SOFT_SPHERE);
+#endif
+#ifdef HAT
+  check(data.hat.max_cutoff(), KERNEL_HAT);
+#endif
+#ifdef LJCOS
+  check(data.ljcos.max_cutoff(), KERNEL_LJCOS);
+#endif
+#ifdef LJCOS2
+  check(data.ljcos2.max_cutoff(), KERNEL_LJCOS2);
+#endif
+#ifdef TABULATED
+  check(data.tab.cutoff(), KERNEL_TABULATED);
+#endif
+  if (data.spline_tabulation.is_tabulated()) {
+    return KERNEL_SPLINE;
+  }
+  return (n_active > 1) ? KERNEL_GENERIC : kernel;
+}
+
 double maximal_cutoff_nonbonded() {
   auto max_cut_nonbonded = INACTIVE_CUTOFF;
 
   for (auto &data : nonbonded_ia_params) {
     data->max_cut = recalc_maximal_cutoff(*data);
+    data->central_force_kernel = select_central_force_kernel(*data);
     max_cut_nonbonded = std::max(max_cut_nonbonded, data->max_cut);
   }
 
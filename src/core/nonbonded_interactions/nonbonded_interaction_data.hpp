@@ -33,6 +33,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -274,6 +275,84 @@ struct DPD_Parameters {
   double max_cutoff() const { return std::max(radial.cutoff, trans.cutoff); }
 };
 
+/** Cubic spline tabulation of the central potentials.
+ *
+ *  The sum of the central forces and energies of a pair of particle types
+ *  is interpolated between @ref min and the largest cutoff of the central
+ *  potentials, with an absolute error below @ref accuracy. Distances below
+ *  @ref min are evaluated analytically.
+ */
+struct SplineTabulation_Parameters {
+  /** Smallest tabulated distance. */
+  double min = INACTIVE_CUTOFF;
+  /** Maximal absolute error of the interpolated forces and energies. */
+  double accuracy = 0.0;
+  /** Largest tabulated distance. */
+  double max = INACTIVE_CUTOFF;
+  /** Inverse of the distance between the spline nodes. */
+  double invstepsize = 0.0;
+  /** Coefficients of the force factor polynomials, 4 per interval. */
+  std::vector<double> force_coeffs;
+  /** Coefficients of the energy polynomials, 4 per interval. */
+  std::vector<double> energy_coeffs;
+  SplineTabulation_Parameters() = default;
+  SplineTabulation_Parameters(double min, double accuracy);
+  bool is_tabulated() const { return not force_coeffs.empty(); }
+
+  /** Interpolate the force, divided by the distance, for
+   *  @p dist >= @ref min.
+   */
+  double force_factor(double dist) const {
+    return interpolate(force_coeffs, dist);
+  }
+
+  /** Interpolate the energy for @p dist >= @ref min. */
+  double energy(double dist) const { return interpolate(energy_coeffs, dist); }
+
+private:
+  double interpolate(std::vector<double> const &coeffs, double dist) const {
+    if (dist >= max) {
+      return 0.;
+    }
+    auto const x = (dist - min) * invstepsize;
+    auto const n_intervals = coeffs.size() / 4u;
+    auto const i = std::min(static_cast<std::size_t>(x), n_intervals - 1u);
+    auto const t = x - static_cast<double>(i);
+    auto const *c = coeffs.data() + 4u * i;
+    return c[0] + t * (c[1] + t * (c[2] + t * c[3]));
+  }
+};
+
+/** Central force kernels, specialized for the potentials that are active
+ *  between two particle types.
+ */
+namespace CentralForceKernel {
+enum Kernel : int {
+  /** No central potential */
+  KERNEL_NONE = 0,
+  /* kernels for a single potential */
+  KERNEL_LJ,
+  KERNEL_WCA,
+  KERNEL_LJGEN,
+  KERNEL_SMOOTH_STEP,
+  KERNEL_HERTZIAN,
+  KERNEL_GAUSSIAN,
+  KERNEL_BMHTF,
+  KERNEL_BUCKINGHAM,
+  KERNEL_MORSE,
+  KERNEL_SOFT_SPHERE,
+  KERNEL_HAT,
+  KERNEL_LJCOS,
+  KERNEL_LJCOS2,
+  KERNEL_TABULATED,
+  /** Interpolation of the sum of all potentials */
+  KERNEL_SPLINE,
+  /** Sum of all potentials */
+  KERNEL_GENERIC,
+  N_KERNELS
+};
+} // namespace CentralForceKernel
+
 /** Data structure containing the interaction parameters for non-bonded
  *  interactions.
  *  Access via <tt>get_ia_param(i, j)</tt> with
@@ -286,6 +365,12 @@ struct IA_parameters {
    */
   double max_cut = INACTIVE_CUTOFF;
 
+  /** kernel of the central forces for this pair of particle types,
+   *  selected by @ref maximal_cutoff_nonbonded.
+   */
+  CentralForceKernel::Kernel central_force_kernel =
+      CentralForceKernel::KERNEL_GENERIC;
+
 #ifdef LENNARD_JONES
   LJ_Parameters lj;
 #endif
@@ -353,6 +438,8 @@ struct IA_parameters {
 #ifdef THOLE
   Thole_Parameters thole;
 #endif
+
+  SplineTabulation_Parameters spline_tabulation;
 };
 
 extern std::vector<std::shared_ptr<IA_parameters>> nonbonded_ia_params;
@@ -361,7 +448,8 @@ extern std::vector<std::shared_ptr<IA_parameters>> nonbonded_ia_params;
 extern int max_seen_particle_type;
 
 /** Maximal interaction cutoff (real space/short range non-bonded
- *  interactions).
+ *  interactions). Also selects the central force kernels of all pairs
+ *  of particle types.
  */
 double maximal_cutoff_nonbonded();
 
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+/** \file
+ *
+ *  Implementation of \ref spline_tabulation.hpp
+ */
+#include "spline_tabulation.hpp"
+
+#include "energy_inline.hpp"
+#include "errorhandling.hpp"
+#include "forces_inline.hpp"
+#include "nonbonded_interaction_data.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+SplineTabulation_Parameters::SplineTabulation_Parameters(double min,
+                                                         double accuracy)
+    : min{min}, accuracy{accuracy} {
+  if (min < 0.) {
+    throw std::domain_error("SplineTabulation parameter 'min' has to be >= 0");
+  }
+  if (accuracy <= 0.) {
+    throw std::domain_error(
+        "SplineTabulation parameter 'accuracy' has to be > 0");
+  }
+}
+
+namespace {
+/** Number of intervals of the first trial table */
+constexpr std::size_t min_intervals = 64u;
+/** Largest number of intervals */
+constexpr std::size_t max_intervals = std::size_t{1u} << 16;
+
+/** Largest cutoff of the central potentials. */
+double central_cutoff(IA_parameters const &data) {
+  auto cutoff = INACTIVE_CUTOFF;
+#ifdef LENNARD_JONES
+  cutoff = std::max(cutoff, data.lj.max_cutoff());
+#endif
+#ifdef WCA
+  cutoff = std::max(cutoff, data.wca.max_cutoff());
+#endif
+#ifdef LENNARD_JONES_GENERIC
+  cutoff = std::max(cutoff, data.ljgen.max_cutoff());
+#endif
+#ifdef SMOOTH_STEP
+  cutoff = std::max(cutoff, data.smooth_step.max_cutoff());
+#endif
+#ifdef HERTZIAN
+  cutoff = std::max(cutoff, data.hertzian.max_cutoff());
+#endif
+#ifdef GAUSSIAN
+  cutoff = std::max(cutoff, data.gaussian.max_cutoff());
+#endif
+#ifdef BMHTF_NACL
+  cutoff = std::max(cutoff, data.bmhtf.max_cutoff());
+#endif
+#ifdef BUCKINGHAM
+  cutoff = std::max(cutoff, data.buckingham.max_cutoff());
+#endif
+#ifdef MORSE
+  cutoff = std::max(cutoff, data.morse.max_cutoff());
+#endif
+#ifdef SOFT_SPHERE
+  cutoff = std::max(cutoff, data.soft_sphere.max_cutoff());
+#endif
+#ifdef HAT
+  cutoff = std::max(cutoff, data.hat.max_cutoff());
+#endif
+#ifdef LJCOS
+  cutoff = std::max(cutoff, data.ljcos.max_cutoff());
+#endif
+#ifdef LJCOS2
+  cutoff = std::max(cutoff, data.ljcos2.max_cutoff());
+#endif
+#ifdef TABULATED
+  cutoff = std::max(cutoff, data.tab.cutoff());
+#endif
+  return cutoff;
+}
+
+/**
+ * @brief Polynomial coefficients of a cubic spline through uniformly
+ * sampled values, 4 per interval in units of the interval length.
+ *
+ * The second derivative is extrapolated linearly to the end points,
+ * which avoids the error of the natural spline close to steep walls.
+ */
+std::vector<double> spline_coefficients(std::vector<double> const &y) {
+  auto const n = y.size() - 1u;
+  auto const rhs = [&y](std::size_t i) {
+    return 6. * (y[i + 1u] - 2. * y[i] + y[i - 1u]);
+  };
+
+  /* second derivatives, the equations of the first and last inner nodes
+   * decouple with the extrapolation m[0] = 2 m[1] - m[2] */
+  std::vector<double> m(n + 1u, 0.);
+  m[1u] = rhs(1u) / 6.;
+  m[n - 1u] = rhs(n - 1u) / 6.;
+
+  /* tridiagonal system m[i - 1] + 4 m[i] + m[i + 1] = rhs(i) */
+  std::vector<double> c_prime(n, 0.);
+  std::vector<double> d_prime(n, 0.);
+  for (std::size_t i = 2u; i <= n - 2u; ++i) {
+    auto d = rhs(i);
+    if (i == 2u) {
+      d -= m[1u];
+    }
+    if (i == n - 2u) {
+      d -= m[n - 1u];
+    }
+    auto const denom = 4. - ((i == 2u) ? 0. : c_prime[i - 1u]);
+    c_prime[i] = 1. / denom;
+    d_prime[i] = (d - ((i == 2u) ? 0. : d_prime[i - 1u])) / denom;
+  }
+  for (std::size_t i = n - 2u; i >= 2u; --i) {
+    m[i] = d_prime[i] - ((i == n - 2u) ? 0. : c_prime[i] * m[i + 1u]);
+  }
+  m[0u] = 2. * m[1u] - m[2u];
+  m[n] = 2. * m[n - 1u] - m[n - 2u];
+
+  std::vector<double> coeffs(4u * n);
+  for (std::size_t i = 0u; i < n; ++i) {
+    coeffs[4u * i + 0u] = y[i];
+    coeffs[4u * i + 1u] = y[i + 1u] - y[i] - (2. * m[i] + m[i + 1u]) / 6.;
+    coeffs[4u * i + 2u] = m[i] / 2.;
+    coeffs[4u * i + 3u] = (m[i + 1u] - m[i]) / 6.;
+  }
+  return coeffs;
+}
+
+/** Largest interpolation error of the forces and energies between the
+ *  nodes of a table.
+ */
+double interpolation_error(IA_parameters const &ia_params) {
+  auto const &spline = ia_params.spline_tabulation;
+  auto const n_intervals = spline.force_coeffs.size() / 4u;
+  auto const step = 1. / spline.invstepsize;
+  auto error = 0.;
+  for (std::size_t i = 0u; i < n_intervals; ++i) {
+    for (auto const t : {0.25, 0.5, 0.75}) {
+      auto const dist = spline.min + (static_cast<double>(i) + t) * step;
+      auto const force = calc_central_radial_force_factor(ia_params, dist);
+      auto const energy = calc_central_radial_energy(ia_params, dist);
+      error = std::max(
+          {error, std::abs(spline.force_factor(dist) - force) * dist,
+           std::abs(spline.energy(dist) - energy)});
+    }
+  }
+  return error;
+}
+
+void clear_table(SplineTabulation_Parameters &spline) {
+  spline.max = INACTIVE_CUTOFF;
+  spline.invstepsize = 0.;
+  spline.force_coeffs.clear();
+  spline.energy_coeffs.clear();
+}
+} // namespace
+
+void tabulate_central_potentials(IA_parameters &ia_params) {
+  auto &spline = ia_params.spline_tabulation;
+  clear_table(spline);
+
+  auto const cutoff = central_cutoff(ia_params);
+  if (spline.min == INACTIVE_CUTOFF or cutoff <= spline.min) {
+    return;
+  }
+
+  auto const length = cutoff - spline.min;
+  for (auto n = min_intervals; n <= max_intervals; n *= 2u) {
+    auto const step = length / static_cast<double>(n);
+    std::vector<double> force(n + 1u);
+    std::vector<double> energy(n + 1u);
+    for (std::size_t k = 0u; k <= n; ++k) {
+      /* the potentials vanish at their cutoff, the last node is sampled
+       * just below it to interpolate up to the cutoff */
+      auto const dist = (k == n) ? std::nextafter(cutoff, spline.min)
+                                 : spline.min + static_cast<double>(k) * step;
+      force[k] = calc_central_radial_force_factor(ia_params, dist);
+      energy[k] = calc_central_radial_energy(ia_params, dist);
+    }
+    spline.max = cutoff;
+    spline.invstepsize = static_cast<double>(n) / length;
+    spline.force_coeffs = spline_coefficients(force);
+    spline.energy_coeffs = spline_coefficients(energy);
+    if (interpolation_error(ia_params) <= spline.accuracy) {
+      return;
+    }
+  }
+
+  clear_table(spline);
+  throw std::runtime_error(
+      "Spline tabulation cannot reach an accuracy of " +
+      std::to_string(spline.accuracy) + " with " +
+      std::to_string(max_intervals) + " intervals, increase 'min' or " +
+      "'accuracy'");
+}
+
+void update_spline_tabulations() {
+  for (auto &ia_params : ::nonbonded_ia_params) {
+    try {
+      tabulate_central_potentials(*ia_params);
+    } catch (std::runtime_error const &err) {
+      runtimeErrorMsg() << err.what();
+    }
+  }
+}
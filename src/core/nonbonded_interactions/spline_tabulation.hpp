@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_NB_IA_SPLINE_TABULATION_HPP
+#define CORE_NB_IA_SPLINE_TABULATION_HPP
+
+/** \file
+ *  Cubic spline tabulation of the central non-bonded potentials.
+ *
+ *  The force factors and energies of all central potentials of a pair of
+ *  particle types are sampled on a uniform grid. The number of intervals
+ *  is doubled until the interpolation error of the forces and energies,
+ *  measured between the nodes, is below the requested accuracy.
+ *
+ *  Implementation in \ref spline_tabulation.cpp.
+ */
+
+#include "nonbonded_interaction_data.hpp"
+
+/** @brief Tabulate the central potentials of a pair of particle types.
+ *
+ *  The table is cleared when the tabulation is disabled or when no central
+ *  potential is active beyond @ref SplineTabulation_Parameters::min.
+ *
+ *  @throws std::runtime_error if the accuracy cannot be reached, in which
+ *  case the table is cleared.
+ */
+void tabulate_central_potentials(IA_parameters &ia_params);
+
+/** @brief Tabulate the central potentials of all pairs of particle types.
+ *
+ *  Pairs whose tabulation fails fall back to the analytic potentials and
+ *  a runtime error is reported.
+ */
+void update_spline_tabulations();
+
+#endif
@@ -24,22 +24,34 @@
 #if defined(P3M) || defined(DP3M)
 
 #include "p3m/TuningAlgorithm.hpp"
+#include "p3m/TuningCache.hpp"
 #include "p3m/common.hpp"
 
 #include "tuning.hpp"
 
+#include "cells.hpp"
 #include "communication.hpp"
+#include "errorhandling.hpp"
 #include "grid.hpp"
 #include "integrate.hpp"
 
+#include <boost/mpi/collectives/broadcast.hpp>
+#include <boost/optional.hpp>
 #include <boost/range/algorithm/min_element.hpp>
+#include <boost/serialization/optional.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <utility>
+#include <vector>
 
 /** @name Error codes for tuning. */
 /**@{*/
@@ -93,6 +105,124 @@ void TuningAlgorithm::commit(Utils::Vector3i const &mesh, int cao,
   p3m_params.mesh = mesh;
 }
 
+/** @brief Number of tuned parameters common to all solvers in the cache. */
+static auto constexpr n_cached_parameters = std::size_t{8};
+
+void TuningAlgorithm::tune() {
+  auto const use_cache = not m_cache_path.empty();
+  TuningCache::Entry signature;
+  boost::optional<TuningCache::Entry> cached;
+  if (use_cache) {
+    signature = get_cache_signature();
+    cached = find_in_cache(signature);
+  }
+  auto const is_exact = cached and cached->particles == signature.particles;
+
+  Parameters tuned_params;
+  if (is_exact) {
+    auto const &values = cached->parameters;
+    tuned_params.mesh = {static_cast<int>(values[0]),
+                         static_cast<int>(values[1]),
+                         static_cast<int>(values[2])};
+    tuned_params.cao = static_cast<int>(values[3]);
+    tuned_params.r_cut_iL = values[4];
+    tuned_params.alpha_L = values[5];
+    tuned_params.accuracy = values[6];
+    tuned_params.time = values[7];
+    set_tuned_state({values.begin() + n_cached_parameters, values.end()});
+    m_logger->report_cache(m_cache_path, true);
+  } else {
+    if (cached and cao_min != cao_max) {
+      // the charge assignment order of a similar system is a good guess
+      auto const cao = static_cast<int>(cached->parameters[3]);
+      cao_best = std::min(std::max(cao, cao_min), cao_max);
+      m_logger->report_cache(m_cache_path, false);
+    }
+    // activate tuning mode
+    get_params().tuning = true;
+
+    tuned_params = get_time();
+
+    // deactivate tuning mode
+    get_params().tuning = false;
+  }
+
+  if (tuned_params.time == time_sentinel) {
+    throw std::runtime_error(m_logger->get_name() +
+                             ": failed to reach requested accuracy");
+  }
+  // set tuned parameters
+  get_params().accuracy = tuned_params.accuracy;
+  commit(tuned_params.mesh, tuned_params.cao, tuned_params.r_cut_iL,
+         tuned_params.alpha_L);
+
+  m_logger->tuning_results(tuned_params.mesh, tuned_params.cao,
+                           tuned_params.r_cut_iL, tuned_params.alpha_L,
+                           tuned_params.accuracy, tuned_params.time);
+
+  if (use_cache and not is_exact) {
+    store_in_cache(std::move(signature), tuned_params);
+  }
+}
+
+TuningCache::Entry TuningAlgorithm::get_cache_signature() {
+  auto const &params = get_params();
+  TuningCache::Entry signature;
+  signature.name = m_logger->get_name();
+  auto &system = signature.system;
+  system.insert(system.end(), box_geo.length().begin(),
+                box_geo.length().end());
+  system.insert(system.end(), ::node_grid.begin(), ::node_grid.end());
+  system.push_back(static_cast<double>(cell_structure.decomposition_type()));
+  system.push_back(static_cast<double>(cell_structure.get_n_threads()));
+  system.push_back(skin);
+  system.push_back(m_prefactor);
+  system.push_back(params.accuracy);
+  // parameters that are not tuned
+  system.insert(system.end(), params.mesh.begin(), params.mesh.end());
+  system.push_back(static_cast<double>(params.cao));
+  system.push_back(params.r_cut_iL);
+  auto const solver = solver_signature();
+  system.insert(system.end(), solver.begin(), solver.end());
+  signature.particles = particle_signature();
+  return signature;
+}
+
+boost::optional<TuningCache::Entry>
+TuningAlgorithm::find_in_cache(TuningCache::Entry const &signature) const {
+  boost::optional<TuningCache::Entry> cached;
+  if (this_node == 0) {
+    cached = TuningCache(m_cache_path).find(signature);
+    auto const n_parameters = n_cached_parameters + get_tuned_state().size();
+    if (cached and cached->parameters.size() != n_parameters) {
+      cached = boost::none;
+    }
+  }
+  boost::mpi::broadcast(comm_cart, cached, 0);
+  return cached;
+}
+
+void TuningAlgorithm::store_in_cache(TuningCache::Entry entry,
+                                     Parameters const &tuned_params) const {
+  if (this_node != 0) {
+    return;
+  }
+  auto &values = entry.parameters;
+  values.assign(tuned_params.mesh.begin(), tuned_params.mesh.end());
+  values.push_back(static_cast<double>(tuned_params.cao));
+  values.push_back(tuned_params.r_cut_iL);
+  values.push_back(tuned_params.alpha_L);
+  values.push_back(tuned_params.accuracy);
+  values.push_back(tuned_params.time);
+  auto const state = get_tuned_state();
+  values.insert(values.end(), state.begin(), state.end());
+  try {
+    TuningCache(m_cache_path).store(entry);
+  } catch (std::exception const &err) {
+    runtimeWarningMsg() << err.what();
+  }
+}
+
 /**
  * @brief Get the optimal alpha and the corresponding computation time
  * for a fixed @p mesh and @p cao.
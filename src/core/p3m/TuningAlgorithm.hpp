@@ -26,6 +26,7 @@
 
 #if defined(P3M) || defined(DP3M)
 
+#include "p3m/TuningCache.hpp"
 #include "p3m/TuningLogger.hpp"
 #include "p3m/common.hpp"
 
@@ -38,6 +39,8 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 /**
  * @brief Tuning algorithm for P3M.
@@ -62,6 +65,7 @@
 class TuningAlgorithm {
   int m_timings;
   std::size_t m_n_trials;
+  std::string m_cache_path;
 
 protected:
   double m_prefactor;
@@ -143,28 +147,36 @@ public:
   void commit(Utils::Vector3i const &mesh, int cao, double r_cut_iL,
               double alpha_L);
 
-  void tune() {
-    // activate tuning mode
-    get_params().tuning = true;
+  /**
+   * @brief Tuning entry point.
+   *
+   * With a tuning cache, the tuned parameters of a system with the same
+   * signature are re-used without any time measurement. If only the
+   * particle signature differs, the cached charge assignment order is
+   * the initial guess of the tuning, whose result is added to the cache.
+   */
+  void tune();
 
-    auto const tuned_params = get_time();
+  /** @brief Store and look up tuning results in a file. */
+  void set_cache_path(std::string path) { m_cache_path = std::move(path); }
 
-    // deactivate tuning mode
-    get_params().tuning = false;
+  /**
+   * @brief Particle properties that enter the error estimates.
+   * Part of the tuning cache signature.
+   */
+  virtual std::vector<double> particle_signature() const = 0;
 
-    if (tuned_params.time == time_sentinel) {
-      throw std::runtime_error(m_logger->get_name() +
-                               ": failed to reach requested accuracy");
-    }
-    // set tuned parameters
-    get_params().accuracy = tuned_params.accuracy;
-    commit(tuned_params.mesh, tuned_params.cao, tuned_params.r_cut_iL,
-           tuned_params.alpha_L);
+  /**
+   * @brief Solver-specific settings that enter the tuning.
+   * Part of the tuning cache signature.
+   */
+  virtual std::vector<double> solver_signature() const { return {}; }
 
-    m_logger->tuning_results(tuned_params.mesh, tuned_params.cao,
-                             tuned_params.r_cut_iL, tuned_params.alpha_L,
-                             tuned_params.accuracy, tuned_params.time);
-  }
+  /** @brief Tuned solver-specific settings to store in the tuning cache. */
+  virtual std::vector<double> get_tuned_state() const { return {}; }
+
+  /** @brief Restore solver-specific settings from the tuning cache. */
+  virtual void set_tuned_state(std::vector<double> const &) {}
 
 protected:
   auto get_n_trials() { return m_n_trials; }
@@ -176,6 +188,16 @@ protected:
   double get_mc_time(Utils::Vector3i const &mesh, int cao,
                      double &tuned_r_cut_iL, double &tuned_alpha_L,
                      double &tuned_accuracy);
+
+private:
+  /** @brief Signature of the system for the tuning cache. */
+  TuningCache::Entry get_cache_signature();
+  /** @brief Look up the tuning cache on the head node. */
+  boost::optional<TuningCache::Entry>
+  find_in_cache(TuningCache::Entry const &signature) const;
+  /** @brief Add tuned parameters to the tuning cache on the head node. */
+  void store_in_cache(TuningCache::Entry entry,
+                      Parameters const &tuned_params) const;
 };
 
 #endif // P3M or DP3M
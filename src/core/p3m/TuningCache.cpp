@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config/config.hpp"
+
+#if defined(P3M) || defined(DP3M)
+
+#include "p3m/TuningCache.hpp"
+
+#include <boost/optional.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+auto constexpr separator = '|';
+
+void write_field(std::ostream &os, std::vector<double> const &values) {
+  os << ' ' << separator;
+  for (auto const value : values) {
+    os << ' ' << value;
+  }
+}
+
+bool read_field(std::string const &field, std::vector<double> &values) {
+  std::istringstream is(field);
+  double value;
+  while (is >> value) {
+    values.push_back(value);
+  }
+  return is.eof();
+}
+
+bool parse_entry(std::string const &line, TuningCache::Entry &entry) {
+  std::istringstream is(line);
+  std::vector<std::string> fields;
+  std::string field;
+  while (std::getline(is, field, separator)) {
+    fields.push_back(field);
+  }
+  if (fields.size() != 4ul) {
+    return false;
+  }
+  std::istringstream name(fields[0]);
+  return (name >> entry.name) and read_field(fields[1], entry.system) and
+         read_field(fields[2], entry.particles) and
+         read_field(fields[3], entry.parameters) and
+         not entry.parameters.empty();
+}
+} // namespace
+
+std::vector<TuningCache::Entry> TuningCache::load() const {
+  std::vector<Entry> entries;
+  std::ifstream file(m_path);
+  std::string line;
+  while (std::getline(file, line)) {
+    Entry entry;
+    if (parse_entry(line, entry)) {
+      entries.emplace_back(std::move(entry));
+    }
+  }
+  return entries;
+}
+
+boost::optional<TuningCache::Entry>
+TuningCache::find(Entry const &signature) const {
+  boost::optional<Entry> candidate;
+  for (auto &entry : load()) {
+    if (entry.name != signature.name or entry.system != signature.system) {
+      continue;
+    }
+    if (entry.particles == signature.particles) {
+      candidate = std::move(entry);
+    } else if (not candidate or candidate->particles != signature.particles) {
+      candidate = std::move(entry);
+    }
+  }
+  return candidate;
+}
+
+void TuningCache::store(Entry const &entry) const {
+  std::ostringstream line;
+  line << std::setprecision(std::numeric_limits<double>::max_digits10)
+       << entry.name;
+  write_field(line, entry.system);
+  write_field(line, entry.particles);
+  write_field(line, entry.parameters);
+  line << '\n';
+  // write the whole line at once to not interleave with concurrent writers
+  std::ofstream file(m_path, std::ios::app);
+  file << line.str() << std::flush;
+  if (not file) {
+    throw std::runtime_error("Cannot write P3M tuning cache '" + m_path + "'");
+  }
+}
+
+#endif // P3M or DP3M
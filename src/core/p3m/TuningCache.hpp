@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPRESSO_SRC_CORE_P3M_TUNING_CACHE_HPP
+#define ESPRESSO_SRC_CORE_P3M_TUNING_CACHE_HPP
+
+#include "config/config.hpp"
+
+#if defined(P3M) || defined(DP3M)
+
+#include <boost/optional.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief On-disk storage of P3M tuning results.
+ *
+ * Each line of the cache file holds one tuning result as four fields
+ * separated by <tt>|</tt>: the solver name, the system signature, the
+ * particle signature and the tuned parameters. Each field is a list of
+ * numbers written with enough digits to be read back exactly. Lines that
+ * cannot be parsed are ignored, new results are appended to the file.
+ */
+class TuningCache {
+public:
+  struct Entry {
+    /** Name of the solver. */
+    std::string name;
+    /** Box, parallelization, target accuracy and fixed parameters. */
+    std::vector<double> system;
+    /** Particle properties that enter the error estimates. */
+    std::vector<double> particles;
+    /** Tuned parameters. */
+    std::vector<double> parameters;
+
+    template <class Archive>
+    void serialize(Archive &ar, long int /* version */) {
+      ar &name &system &particles &parameters;
+    }
+  };
+
+  explicit TuningCache(std::string path) : m_path{std::move(path)} {}
+
+  /** @brief Read all entries, a missing file is an empty cache. */
+  std::vector<Entry> load() const;
+
+  /**
+   * @brief Find the entry that best matches a signature.
+   *
+   * Only entries with the same solver name and system signature are
+   * considered. The most recent entry that also has the same particle
+   * signature is preferred, otherwise the most recent candidate is
+   * returned, which can serve as a starting point for the tuning.
+   */
+  boost::optional<Entry> find(Entry const &signature) const;
+
+  /**
+   * @brief Append an entry to the cache file.
+   * @throws std::runtime_error if the file cannot be written.
+   */
+  void store(Entry const &entry) const;
+
+private:
+  std::string m_path;
+};
+
+#endif // P3M or DP3M
+
+#endif
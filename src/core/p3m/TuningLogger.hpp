@@ -117,6 +117,19 @@ public:
     }
   }
 
+  void report_differentiation(std::string const &scheme) const {
+    if (m_verbose) {
+      std::printf("differentiation %s\n", scheme.c_str());
+    }
+  }
+
+  void report_cache(std::string const &path, bool exact_match) const {
+    if (m_verbose) {
+      std::printf("%s from tuning cache %s\n",
+                  (exact_match) ? "parameters" : "initial cao", path.c_str());
+    }
+  }
+
   auto get_name() const { return m_name; }
 
 private:
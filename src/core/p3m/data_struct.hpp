@@ -27,6 +27,8 @@
 
 #include "common.hpp"
 
+#include <utils/Vector.hpp>
+
 #include <array>
 #include <vector>
 
@@ -44,6 +46,29 @@ struct p3m_data_struct_base {
   /** Energy optimised influence function (k-space) */
   std::vector<double> g_energy;
 
+  /** @brief Parameters the influence functions depend on, except the box. */
+  struct InfluenceFunctionParameters {
+    Utils::Vector3i mesh = {};
+    int cao = 0;
+    double alpha_L = 0.;
+    /** Solver-specific variant, e.g. the differentiation scheme. */
+    int variant = 0;
+    /** Local domain in k-space. */
+    Utils::Vector3i ks_start = {};
+    Utils::Vector3i ks_size = {};
+
+    bool operator==(InfluenceFunctionParameters const &other) const {
+      return mesh == other.mesh and cao == other.cao and
+             alpha_L == other.alpha_L and variant == other.variant and
+             ks_start == other.ks_start and ks_size == other.ks_size;
+    }
+  };
+  /** Parameters for which the influence functions were calculated. */
+  InfluenceFunctionParameters g_params;
+  /** Box length for which the influence functions were calculated,
+   *  zero if they have to be calculated from scratch. */
+  Utils::Vector3d g_box_l = {};
+
   /** number of permutations in k_space */
   int ks_pnum;
 
@@ -54,6 +79,15 @@ struct p3m_data_struct_base {
   void calc_differential_operator() {
     d_op = detail::calc_meshift(params.mesh, true);
   }
+
+  /** Multiply the influence functions by a constant factor. */
+  void scale_influence_functions(double factor) {
+    for (auto *g : {&g_force, &g_energy}) {
+      for (auto &value : *g) {
+        value *= factor;
+      }
+    }
+  }
 };
 
 #endif
@@ -42,9 +42,11 @@
 #include <fftw3.h>
 #include <mpi.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdio>
 #include <cstring>
+#include <iterator>
 #include <stdexcept>
 #include <utility>
 #include <vector>
@@ -534,6 +536,15 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
   for (int i = 0; i < 3; i++)
     fft.plan[0].new_mesh[i] = ca_mesh_dim[i];
 
+  /* real space direction of the rows of the first FFT */
+  int r_dir[3] = {0, 1, 2};
+  permute_ifield(r_dir, 3, -(fft.plan[1].n_permute));
+  auto const r2c_dir = r_dir[2];
+  /* the real-to-complex FFT only stores the non-negative half of the
+     spectrum in that direction, the other grids redistribute this half */
+  auto half_mesh_dim = global_mesh_dim;
+  half_mesh_dim[r2c_dir] = global_mesh_dim[r2c_dir] / 2 + 1;
+
   for (int i = 1; i < 4; i++) {
     using Utils::make_span;
     auto group = find_comm_groups(
@@ -556,6 +567,7 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
     }
 
     fft.plan[i].group = *group;
+    auto const &mesh_dim = (i == 1) ? global_mesh_dim : half_mesh_dim;
 
     fft.plan[i].send_block.resize(6 * fft.plan[i].group.size());
     fft.plan[i].send_size.resize(fft.plan[i].group.size());
@@ -563,7 +575,7 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
     fft.plan[i].recv_size.resize(fft.plan[i].group.size());
 
     fft.plan[i].new_size = calc_local_mesh(
-        my_pos[i], n_grid[i], global_mesh_dim.data(), global_mesh_off.data(),
+        my_pos[i], n_grid[i], mesh_dim.data(), global_mesh_off.data(),
         fft.plan[i].new_mesh, fft.plan[i].start);
     permute_ifield(fft.plan[i].new_mesh, 3, -(fft.plan[i].n_permute));
     permute_ifield(fft.plan[i].start, 3, -(fft.plan[i].n_permute));
@@ -575,7 +587,7 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
       int node = fft.plan[i].group[j];
       fft.plan[i].send_size[j] = calc_send_block(
           my_pos[i - 1], n_grid[i - 1], &(n_pos[i][3 * node]), n_grid[i],
-          global_mesh_dim.data(), global_mesh_off.data(),
+          mesh_dim.data(), global_mesh_off.data(),
           &(fft.plan[i].send_block[6 * j]));
       permute_ifield(&(fft.plan[i].send_block[6 * j]), 3,
                      -(fft.plan[i - 1].n_permute));
@@ -593,7 +605,7 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
       /* recv block: comm.rank() from comm-group-node i (identity: node) */
       fft.plan[i].recv_size[j] = calc_send_block(
           my_pos[i], n_grid[i], &(n_pos[i - 1][3 * node]), n_grid[i - 1],
-          global_mesh_dim.data(), global_mesh_off.data(),
+          mesh_dim.data(), global_mesh_off.data(),
           &(fft.plan[i].recv_block[6 * j]));
       permute_ifield(&(fft.plan[i].recv_block[6 * j]), 3,
                      -(fft.plan[i].n_permute));
@@ -605,6 +617,10 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
 
     for (int j = 0; j < 3; j++)
       fft.plan[i].old_mesh[j] = fft.plan[i - 1].new_mesh[j];
+    if (i == 2) {
+      /* the first FFT leaves half-length complex rows behind */
+      fft.plan[i].old_mesh[2] = fft.plan[1].new_mesh[2] / 2 + 1;
+    }
     if (i == 1) {
       fft.plan[i].element = 1;
     } else {
@@ -623,6 +639,13 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
     if (2 * fft.plan[i].new_size > fft.max_mesh_size)
       fft.max_mesh_size = 2 * fft.plan[i].new_size;
 
+  /* k-space direction of the half spectrum */
+  int k_dir[3] = {0, 1, 2};
+  permute_ifield(k_dir, 3, -(fft.plan[3].n_permute));
+  auto const half_dir = std::find(std::begin(k_dir), std::end(k_dir), r2c_dir);
+  fft.half_dir = static_cast<int>(std::distance(std::begin(k_dir), half_dir));
+  fft.half_dir_mesh = global_mesh_dim[r2c_dir];
+
   /* === pack function === */
   for (int i = 1; i < 4; i++) {
     fft.plan[i].pack_function = pack_block_permute2;
@@ -640,6 +663,12 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
   fft.recv_buf.resize(fft.max_comm_size);
   fft.data_buf.resize(fft.max_mesh_size);
   auto *c_data = (fftw_complex *)(fft.data_buf.data());
+  /* the real-to-complex FFTs are out-of-place, they are planned on a
+     scratch buffer and executed on the mesh */
+  fft_vector<double> plan_buf(fft.max_mesh_size);
+  auto *c_plan_buf = (fftw_complex *)(plan_buf.data());
+  auto const n_r2c = fft.plan[1].new_mesh[2];
+  auto const n_r2c_half = n_r2c / 2 + 1;
 
   /* === FFT Routines (Using FFTW / RFFTW package)=== */
   for (int i = 1; i < 4; i++) {
@@ -648,10 +677,16 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
 
     if (fft.init_tag)
       fftw_destroy_plan(fft.plan[i].our_fftw_plan);
-    fft.plan[i].our_fftw_plan = fftw_plan_many_dft(
-        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
-        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
-        fft.plan[i].dir, FFTW_PATIENT);
+    if (i == 1) {
+      fft.plan[i].our_fftw_plan = fftw_plan_many_dft_r2c(
+          1, &n_r2c, fft.plan[i].n_ffts, fft.data_buf.data(), nullptr, 1,
+          n_r2c, c_plan_buf, nullptr, 1, n_r2c_half, FFTW_PATIENT);
+    } else {
+      fft.plan[i].our_fftw_plan = fftw_plan_many_dft(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
+          fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
+          fft.plan[i].dir, FFTW_PATIENT);
+    }
   }
 
   /* === The BACK Direction === */
@@ -661,10 +696,16 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
 
     if (fft.init_tag)
       fftw_destroy_plan(fft.back[i].our_fftw_plan);
-    fft.back[i].our_fftw_plan = fftw_plan_many_dft(
-        1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
-        fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
-        fft.back[i].dir, FFTW_PATIENT);
+    if (i == 1) {
+      fft.back[i].our_fftw_plan = fftw_plan_many_dft_c2r(
+          1, &n_r2c, fft.plan[i].n_ffts, c_plan_buf, nullptr, 1, n_r2c_half,
+          fft.data_buf.data(), nullptr, 1, n_r2c, FFTW_PATIENT);
+    } else {
+      fft.back[i].our_fftw_plan = fftw_plan_many_dft(
+          1, &fft.plan[i].new_mesh[2], fft.plan[i].n_ffts, c_data, nullptr, 1,
+          fft.plan[i].new_mesh[2], c_data, nullptr, 1, fft.plan[i].new_mesh[2],
+          fft.back[i].dir, FFTW_PATIENT);
+    }
 
     fft.back[i].pack_function = pack_block_permute1;
   }
@@ -689,13 +730,9 @@ void fft_perform_forw(double *data, fft_data_struct &fft,
   /* communication to current dir row format (in is data) */
   forw_grid_comm(fft.plan[1], data, fft.data_buf.data(), fft, comm);
 
-  /* complexify the real data array (in is fft.data_buf) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    data[2 * i + 0] = fft.data_buf[i]; /* real value */
-    data[2 * i + 1] = 0;               /* complex value */
-  }
-  /* perform FFT (in/out is data)*/
-  fftw_execute_dft(fft.plan[1].our_fftw_plan, c_data, c_data);
+  /* perform real-to-complex FFT (in is fft.data_buf, out is data) */
+  fftw_execute_dft_r2c(fft.plan[1].our_fftw_plan, fft.data_buf.data(),
+                       c_data);
   /* ===== second direction ===== */
   /* communication to current dir row format (in is data) */
   forw_grid_comm(fft.plan[2], data, fft.data_buf.data(), fft, comm);
@@ -732,19 +769,27 @@ void fft_perform_back(double *data, bool check_complex, fft_data_struct &fft,
                  comm);
 
   /* ===== first direction  ===== */
-  /* perform FFT (in is data) */
-  fftw_execute_dft(fft.back[1].our_fftw_plan, c_data, c_data);
-  /* throw away the (hopefully) empty complex component (in is data) */
-  for (int i = 0; i < fft.plan[1].new_size; i++) {
-    fft.data_buf[i] = data[2 * i]; /* real value */
-    // Vincent:
-    if (check_complex and std::abs(data[2 * i + 1]) > 1e-5) {
-      printf("Complex value is not zero (i=%d,data=%g)!!!\n", i,
-             data[2 * i + 1]);
-      if (i > 100)
+  /* the self-conjugate modes of the half spectrum have to be real,
+     otherwise the complex-to-real FFT silently drops a component */
+  if (check_complex) {
+    auto const n_row = fft.plan[1].new_mesh[2];
+    auto const n_half = n_row / 2 + 1;
+    auto const check_mode = [data](int i) {
+      if (std::abs(data[2 * i + 1]) > 1e-5) {
+        printf("Complex value is not zero (i=%d,data=%g)!!!\n", i,
+               data[2 * i + 1]);
         throw std::runtime_error("Complex value is not zero");
+      }
+    };
+    for (int row = 0; row < fft.plan[1].n_ffts; row++) {
+      check_mode(row * n_half);
+      if (n_row % 2 == 0)
+        check_mode(row * n_half + n_row / 2);
     }
   }
+  /* perform complex-to-real FFT (in is data, out is fft.data_buf) */
+  fftw_execute_dft_c2r(fft.back[1].our_fftw_plan, c_data,
+                       fft.data_buf.data());
   /* communicate (in is fft.data_buf) */
   back_grid_comm(fft.plan[1], fft.back[1], fft.data_buf.data(), data, fft,
                  comm);
@@ -31,9 +31,13 @@
  *  1D-FFT. After performing the FFT on that direction the data is
  *  redistributed.
  *
- *  For simplicity at the moment I have implemented a full complex to
- *  complex FFT (even though a real to complex FFT would be
- *  sufficient)
+ *  The first 1D-FFT is a real-to-complex transform, which only keeps the
+ *  non-negative half of the spectrum along its row direction. The two
+ *  following complex-to-complex FFTs and the k-space mesh therefore
+ *  have about half the size of the full spectrum. The missing modes are
+ *  the complex conjugates of the stored ones; sums over the whole spectrum
+ *  have to weight the mesh points with @ref
+ *  fft_data_struct::mode_multiplicity.
  *
  *  \todo Combine the forward and backward structures.
  *  \todo The packing routines could be moved to utils.hpp when they are needed
@@ -170,6 +174,20 @@ struct fft_data_struct { // NOLINT(bugprone-reserved-identifier)
   std::vector<double> recv_buf;
   /** Buffer for receive data. */
   fft_vector<double> data_buf;
+
+  /** k-space direction in which only half of the spectrum is stored. */
+  int half_dir = 0;
+  /** Global mesh size in the direction of the half spectrum. */
+  int half_dir_mesh = 0;
+
+  /** Number of modes of the full spectrum represented by a k-space mesh
+   *  point, i.e. 2 if the complex conjugate mode is not stored, 1 otherwise.
+   *  @param n  Global index of the mesh point in the k-space mesh.
+   */
+  double mode_multiplicity(Utils::Vector3i const &n) const {
+    auto const k = n[half_dir];
+    return (k == 0 or 2 * k == half_dir_mesh) ? 1. : 2.;
+  }
 };
 
 /** Initialize everything connected to the 3D-FFT.
@@ -191,6 +209,7 @@ int fft_init(Utils::Vector3i const &ca_mesh_dim, int const *ca_mesh_margin,
              boost::mpi::communicator const &comm);
 
 /** Perform an in-place forward 3D FFT.
+ *  The real input mesh is replaced by the half spectrum.
  *  \warning The content of \a data is overwritten.
  *  \param[in,out] data  Mesh.
  *  \param[in,out] fft   FFT plan.
@@ -200,10 +219,11 @@ void fft_perform_forw(double *data, fft_data_struct &fft,
                       const boost::mpi::communicator &comm);
 
 /** Perform an in-place backward 3D FFT.
+ *  The half spectrum is replaced by the real output mesh.
  *  \warning The content of \a data is overwritten.
  *  \param[in,out] data           Mesh.
- *  \param[in]     check_complex  Throw an error if the complex component is
- *                                non-zero.
+ *  \param[in]     check_complex  Throw an error if the complex component of
+ *                                a self-conjugate mode is non-zero.
  *  \param[in,out] fft            FFT plan.
  *  \param[in]     comm           MPI communicator.
  */
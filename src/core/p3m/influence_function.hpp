@@ -95,26 +95,93 @@ double G_opt(int cao, double alpha, Utils::Vector3d const &k,
 }
 
 /**
- * @brief Map influence function over a grid.
+ * @brief Optimal influence function for analytical differentiation.
  *
- * This evaluates the optimal influence function @ref G_opt
- * over a regular grid of k vectors, and returns the values as a vector.
+ * This implements the optimal influence function of @cite ballenegger12a
+ * for the potential mesh of ad-P3M, where the force is obtained from the
+ * gradient of the charge assignment function:
+ * @f[
+ *   G(\vec{k}) = \frac{\sum_m U_m^2 \vec{k}_m^2 \hat{\phi}(\vec{k}_m)}
+ *                      {\left(\sum_m U_m^2\right)
+ *                       \left(\sum_m U_m^2 \vec{k}_m^2\right)}
+ * @f]
+ * with the Fourier transformed reference potential @f$ \hat{\phi} @f$,
+ * normalized like @ref G_opt for <tt>S = 1</tt>, to which it reduces
+ * for <tt>m = 0</tt>.
  *
- * @tparam S Order of the differential operator, e.g. 0 for potential,
- *          1 for electric field...
  * @tparam m Number of aliasing terms to take into account.
  *
+ * @param cao Charge assignment order.
+ * @param alpha Ewald splitting parameter.
+ * @param k k Vector to evaluate the function for.
+ * @param h Grid spacing.
+ */
+template <std::size_t m>
+double G_opt_ad(int cao, double alpha, Utils::Vector3d const &k,
+                Utils::Vector3d const &h) {
+  using namespace detail::FFT_indexing;
+  using Utils::sinc;
+
+  auto constexpr two_pi = 2. * Utils::pi();
+  auto constexpr two_pi_i = 1. / two_pi;
+  auto constexpr limit = 30.;
+
+  auto const k2 = k.norm2();
+  if (k2 == 0.0) {
+    return 0.0;
+  }
+
+  auto constexpr m_max = static_cast<int>(m);
+
+  double numerator = 0.0;
+  double sum_U2 = 0.0;
+  double sum_U2_km2 = 0.0;
+
+  for (int mx = -m_max; mx <= m_max; mx++) {
+    for (int my = -m_max; my <= m_max; my++) {
+      for (int mz = -m_max; mz <= m_max; mz++) {
+        auto const km =
+            k + two_pi * Utils::Vector3d{mx / h[RX], my / h[RY], mz / h[RZ]};
+        auto const U2 = std::pow(sinc(km[RX] * h[RX] * two_pi_i) *
+                                     sinc(km[RY] * h[RY] * two_pi_i) *
+                                     sinc(km[RZ] * h[RZ] * two_pi_i),
+                                 2 * cao);
+
+        auto const km2 = km.norm2();
+        auto const exponent = Utils::sqr(1. / (2. * alpha)) * km2;
+        if (exponent < limit) {
+          numerator += U2 * std::exp(-exponent) * 4. * Utils::pi();
+        }
+        sum_U2 += U2;
+        sum_U2_km2 += U2 * km2;
+      }
+    }
+  }
+
+  return numerator / (sum_U2 * sum_U2_km2);
+}
+
+namespace detail {
+/**
+ * @brief Map influence function over a grid.
+ *
+ * The function is evaluated for the k vectors of the grid points, except
+ * for the k vectors with only zero and Nyquist components, where it is 0.
+ *
  * @param params P3M parameters
  * @param n_start Lower left corner of the grid
  * @param n_end Upper right corner of the grid.
  * @param box_l Box size
- * @return Values of G_opt at regular grid points.
+ * @param G Influence function, called with the charge assignment order,
+ *          the Ewald splitting parameter, the k vector and the grid spacing.
+ * @return Values of @p G at regular grid points.
  */
-template <std::size_t S, std::size_t m = 0>
-std::vector<double> grid_influence_function(const P3MParameters &params,
-                                            const Utils::Vector3i &n_start,
-                                            const Utils::Vector3i &n_end,
-                                            const Utils::Vector3d &box_l) {
+template <class F>
+std::vector<double> map_influence_function(const P3MParameters &params,
+                                           const Utils::Vector3i &n_start,
+                                           const Utils::Vector3i &n_end,
+                                           const Utils::Vector3d &box_l,
+                                           F const &G) {
   using namespace detail::FFT_indexing;
 
   auto const shifts = detail::calc_meshift(params.mesh);
@@ -149,7 +216,7 @@ std::vector<double> grid_influence_function(const P3MParameters &params,
                                          shifts[RY][n[KY]] / box_l[RY],
                                          shifts[RZ][n[KZ]] / box_l[RZ]};
 
-          g[ind] = G_opt<S, m>(params.cao, params.alpha, k, h);
+          g[ind] = G(params.cao, params.alpha, k, h);
         }
       }
     }
@@ -157,5 +224,54 @@ std::vector<double> grid_influence_function(const P3MParameters &params,
 
   return g;
 }
+} // namespace detail
+
+/**
+ * @brief Map influence function over a grid.
+ *
+ * This evaluates the optimal influence function @ref G_opt
+ * over a regular grid of k vectors, and returns the values as a vector.
+ *
+ * @tparam S Order of the differential operator, e.g. 0 for potential,
+ *          1 for electric field...
+ * @tparam m Number of aliasing terms to take into account.
+ *
+ * @param params P3M parameters
+ * @param n_start Lower left corner of the grid
+ * @param n_end Upper right corner of the grid.
+ * @param box_l Box size
+ * @return Values of G_opt at regular grid points.
+ */
+template <std::size_t S, std::size_t m = 0>
+std::vector<double> grid_influence_function(const P3MParameters &params,
+                                            const Utils::Vector3i &n_start,
+                                            const Utils::Vector3i &n_end,
+                                            const Utils::Vector3d &box_l) {
+  return detail::map_influence_function(params, n_start, n_end, box_l,
+                                        G_opt<S, m>);
+}
+
+/**
+ * @brief Map influence function for analytical differentiation over a grid.
+ *
+ * This evaluates the optimal influence function @ref G_opt_ad
+ * over a regular grid of k vectors, and returns the values as a vector.
+ *
+ * @tparam m Number of aliasing terms to take into account.
+ *
+ * @param params P3M parameters
+ * @param n_start Lower left corner of the grid
+ * @param n_end Upper right corner of the grid.
+ * @param box_l Box size
+ * @return Values of G_opt_ad at regular grid points.
+ */
+template <std::size_t m>
+std::vector<double> grid_influence_function_ad(const P3MParameters &params,
+                                               const Utils::Vector3i &n_start,
+                                               const Utils::Vector3i &n_end,
+                                               const Utils::Vector3d &box_l) {
+  return detail::map_influence_function(params, n_start, n_end, box_l,
+                                        G_opt_ad<m>);
+}
 
 #endif
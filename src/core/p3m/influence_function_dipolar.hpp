@@ -188,11 +188,15 @@ inline double G_opt_dipolar_self_energy(P3MParameters const &params,
  * @param n_start Lower left corner of the grid
  * @param n_end Upper right corner of the grid.
  * @param g Energies on the grid.
+ * @param multiplicity Number of modes represented by a grid point.
  * @return Total self-energy.
  */
-inline double grid_influence_function_self_energy(
-    P3MParameters const &params, Utils::Vector3i const &n_start,
-    Utils::Vector3i const &n_end, std::vector<double> const &g) {
+template <typename F>
+double grid_influence_function_self_energy(P3MParameters const &params,
+                                           Utils::Vector3i const &n_start,
+                                           Utils::Vector3i const &n_end,
+                                           std::vector<double> const &g,
+                                           F const &multiplicity) {
   auto const size = n_end - n_start;
 
   auto const shifts = detail::calc_meshift(params.mesh, false);
@@ -215,7 +219,7 @@ inline double grid_influence_function_self_energy(
           auto const d_op =
               Utils::Vector3i{d_ops[0][n[0]], d_ops[0][n[1]], d_ops[0][n[2]]};
           auto const U2 = G_opt_dipolar_self_energy(params, shift);
-          energy += g[ind] * U2 * d_op.norm2();
+          energy += multiplicity(n) * g[ind] * U2 * d_op.norm2();
         }
       }
     }
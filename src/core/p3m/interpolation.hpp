@@ -21,15 +21,21 @@
 #ifndef ESPRESSO_CORE_P3M_INTERPOLATION_HPP
 #define ESPRESSO_CORE_P3M_INTERPOLATION_HPP
 
+#include "config/config.hpp"
+
 #include <utils/Span.hpp>
+#include <utils/Vector.hpp>
 #include <utils/index.hpp>
 #include <utils/math/bspline.hpp>
 
 #include <boost/range/algorithm/copy.hpp>
 
 #include <cassert>
+#include <cmath>
 #include <cstddef>
+#include <numeric>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 /**
@@ -89,6 +95,39 @@ public:
     boost::copy(w.w_z, it);
   }
 
+  /**
+   * @brief Store weights for one point at a given index.
+   *
+   * The cache has to be resized to hold the point, see
+   * @ref p3m_interpolation_cache::resize. Points at different
+   * indices can be stored concurrently.
+   *
+   * @tparam cao Interpolation order has to match the order
+   *         set at last call to @ref p3m_interpolation_cache::reset.
+   * @param i Index of the point.
+   * @param w Interpolation weights to store.
+   */
+  template <int cao>
+  void store(std::size_t i, const InterpolationWeights<cao> &w) {
+    assert(cao == m_cao);
+    assert(i < size());
+
+    ca_fmp[i] = w.ind;
+    auto const offset = ca_frac.begin() + 3 * i * m_cao;
+    boost::copy(w.w_x, offset + 0 * m_cao);
+    boost::copy(w.w_y, offset + 1 * m_cao);
+    boost::copy(w.w_z, offset + 2 * m_cao);
+  }
+
+  /**
+   * @brief Linear index of the corner of the interpolation cube of a point.
+   * @param i Index of the point.
+   */
+  int corner(std::size_t i) const {
+    assert(i < size());
+    return ca_fmp[i];
+  }
+
   /**
    * @brief Load entry from the cache.
    *
@@ -127,19 +166,30 @@ public:
     ca_frac.clear();
     ca_fmp.clear();
   }
+
+  /**
+   * @brief Resize the cache to hold a number of points.
+   *
+   * @param n Number of points.
+   */
+  void resize(std::size_t n) {
+    ca_fmp.resize(n);
+    ca_frac.resize(3 * n * m_cao);
+  }
 };
 
+namespace detail {
 /**
- * @brief Calculate the P-th order interpolation weights.
+ * @brief Corner of the interpolation cube of a point.
  *
- * As described in from @cite hockney88a 5-189 (or 8-61).
- * The weights are also tabulated in @cite deserno98a @cite deserno98b.
+ * @return Linear index of the corner and distance of the point
+ *         to the nearest mesh point, in mesh units.
  */
 template <int cao>
-InterpolationWeights<cao>
-p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
-                                    const Utils::Vector3d &ai,
-                                    P3MLocalMesh const &local_mesh) {
+std::pair<int, Utils::Vector3d>
+p3m_interpolation_corner(const Utils::Vector3d &position,
+                         const Utils::Vector3d &ai,
+                         P3MLocalMesh const &local_mesh) {
   /** position shift for calc. of first assignment mesh point. */
   static auto const pos_shift = std::floor((cao - 1) / 2.0) - (cao % 2) / 2.0;
 
@@ -159,19 +209,81 @@ p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
     dist[d] = (pos - nmp[d]) - 0.5;
   }
 
-  InterpolationWeights<cao> ret;
+  assert((nmp + Utils::Vector3i::broadcast(cao)) <= local_mesh.dim);
 
   /* 3d-array index of nearest mesh point */
-  ret.ind = Utils::get_linear_index(nmp, local_mesh.dim,
-                                    Utils::MemoryOrder::ROW_MAJOR);
+  return {Utils::get_linear_index(nmp, local_mesh.dim,
+                                  Utils::MemoryOrder::ROW_MAJOR),
+          dist};
+}
+} // namespace detail
+
+/**
+ * @brief Calculate the P-th order interpolation weights.
+ *
+ * As described in from @cite hockney88a 5-189 (or 8-61).
+ * The weights are also tabulated in @cite deserno98a @cite deserno98b.
+ */
+template <int cao>
+InterpolationWeights<cao>
+p3m_calculate_interpolation_weights(const Utils::Vector3d &position,
+                                    const Utils::Vector3d &ai,
+                                    P3MLocalMesh const &local_mesh) {
+  InterpolationWeights<cao> ret;
+  Utils::Vector3d dist;
+  std::tie(ret.ind, dist) =
+      detail::p3m_interpolation_corner<cao>(position, ai, local_mesh);
+
+  for (int i = 0; i < cao; i++) {
+    using Utils::bspline;
+
+    ret.w_x[i] = bspline<cao>(i, dist[0]);
+    ret.w_y[i] = bspline<cao>(i, dist[1]);
+    ret.w_z[i] = bspline<cao>(i, dist[2]);
+  }
+
+  return ret;
+}
+
+/**
+ * @brief Interpolation weights and their derivatives for one point.
+ *
+ * @tparam cao Interpolation order.
+ */
+template <int cao>
+struct InterpolationGradientWeights : public InterpolationWeights<cao> {
+  /** Derivatives of the weights for the directions, in mesh units */
+  Utils::Array<double, cao> dw_x, dw_y, dw_z;
+};
+
+/**
+ * @brief Calculate the P-th order interpolation weights and their
+ * derivatives.
+ *
+ * The derivatives are taken with respect to the position of the point
+ * in mesh units, they are the weights of the gradient of the charge
+ * assignment function needed for analytical differentiation.
+ */
+template <int cao>
+InterpolationGradientWeights<cao>
+p3m_calculate_interpolation_gradient_weights(const Utils::Vector3d &position,
+                                             const Utils::Vector3d &ai,
+                                             P3MLocalMesh const &local_mesh) {
+  InterpolationGradientWeights<cao> ret;
+  Utils::Vector3d dist;
+  std::tie(ret.ind, dist) =
+      detail::p3m_interpolation_corner<cao>(position, ai, local_mesh);
 
-  assert((nmp + Utils::Vector3i::broadcast(cao)) <= local_mesh.dim);
   for (int i = 0; i < cao; i++) {
     using Utils::bspline;
+    using Utils::bspline_d;
 
     ret.w_x[i] = bspline<cao>(i, dist[0]);
     ret.w_y[i] = bspline<cao>(i, dist[1]);
     ret.w_z[i] = bspline<cao>(i, dist[2]);
+    ret.dw_x[i] = bspline_d<cao>(i, dist[0]);
+    ret.dw_y[i] = bspline_d<cao>(i, dist[1]);
+    ret.dw_z[i] = bspline_d<cao>(i, dist[2]);
   }
 
   return ret;
@@ -207,4 +319,93 @@ void p3m_interpolate(P3MLocalMesh const &local_mesh,
   }
 }
 
+/**
+ * @brief P3M grid interpolation of a gradient.
+ *
+ * This runs an kernel for every interpolation point
+ * in a set of interpolation weights with the linear
+ * grid index and the gradient of the weight of the point,
+ * in mesh units, as arguments.
+ *
+ * @param local_mesh Mesh info.
+ * @param weights Set of weights and their derivatives.
+ * @param kernel The kernel to run.
+ */
+template <int cao, class Kernel>
+void p3m_interpolate_gradient(P3MLocalMesh const &local_mesh,
+                              InterpolationGradientWeights<cao> const &weights,
+                              Kernel kernel) {
+  auto q_ind = weights.ind;
+  for (int i0 = 0; i0 < cao; i0++) {
+    for (int i1 = 0; i1 < cao; i1++) {
+      auto const w_xy = weights.w_x[i0] * weights.w_y[i1];
+      auto const dw_xy = weights.dw_x[i0] * weights.w_y[i1];
+      auto const w_dxy = weights.w_x[i0] * weights.dw_y[i1];
+      for (int i2 = 0; i2 < cao; i2++) {
+        kernel(q_ind, Utils::Vector3d{dw_xy * weights.w_z[i2],
+                                      w_dxy * weights.w_z[i2],
+                                      w_xy * weights.dw_z[i2]});
+
+        q_ind++;
+      }
+      q_ind += local_mesh.q_2_off;
+    }
+    q_ind += local_mesh.q_21_off;
+  }
+}
+
+/**
+ * @brief Threaded P3M grid assignment of the points in a cache.
+ *
+ * The points are binned by the slab of @p cao mesh planes along the first
+ * mesh dimension that holds the corner of their interpolation cube. Cubes
+ * of points in slabs that are not adjacent never overlap, such that the
+ * even and then the odd slabs are assigned concurrently. Within a slab,
+ * points are assigned in the order of the cache, hence the result does
+ * not depend on the number of threads.
+ *
+ * @param local_mesh Mesh info.
+ * @param cache Interpolation weights of the points.
+ * @param n_threads Number of threads.
+ * @param kernel The kernel to run, with the index of the point in the cache,
+ *        the linear grid index and the weight as arguments.
+ */
+template <int cao, class Kernel>
+void p3m_parallel_assign(P3MLocalMesh const &local_mesh,
+                         p3m_interpolation_cache const &cache,
+                         [[maybe_unused]] int n_threads, Kernel kernel) {
+  auto const plane_size = local_mesh.dim[1] * local_mesh.dim[2];
+  auto const n_slabs = (local_mesh.dim[0] + cao - 1) / cao;
+  auto const slab = [&](std::size_t i) {
+    return static_cast<std::size_t>(cache.corner(i) / plane_size / cao);
+  };
+
+  /* counting sort of the points by slab */
+  std::vector<std::size_t> offsets(static_cast<std::size_t>(n_slabs) + 1u);
+  for (std::size_t i = 0; i < cache.size(); ++i) {
+    ++offsets[slab(i) + 1u];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<std::size_t> order(cache.size());
+  auto next = offsets;
+  for (std::size_t i = 0; i < cache.size(); ++i) {
+    order[next[slab(i)]++] = i;
+  }
+
+  for (int color = 0; color < 2; ++color) {
+#ifdef OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(n_threads)
+#endif
+    for (int s = color; s < n_slabs; s += 2) {
+      auto const begin = offsets[static_cast<std::size_t>(s)];
+      auto const end = offsets[static_cast<std::size_t>(s) + 1u];
+      for (auto k = begin; k < end; ++k) {
+        auto const i = order[k];
+        p3m_interpolate(local_mesh, cache.load<cao>(i),
+                        [i, &kernel](int ind, double w) { kernel(i, ind, w); });
+      }
+    }
+  }
+}
+
 #endif
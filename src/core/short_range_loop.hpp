@@ -35,21 +35,216 @@ struct True {
 };
 } // namespace detail
 
+/**
+ * @brief Bonded kernel whose bonds can also be evaluated from the
+ * bond tables, see @ref CellStructure::bond_table_loop.
+ */
+template <class BondKernel, class TableKernel, class Accept>
+struct TabulatedBondKernel {
+  /** Kernel for single bonds, see @ref CellStructure::bond_loop */
+  BondKernel bond_kernel;
+  /** Kernel for all bonds of a @ref BondTable */
+  TableKernel table_kernel;
+  /** Whether the bonds of a bond id can be handed to @ref table_kernel */
+  Accept accept;
+  /** Whether to evaluate the bonds from the bond tables */
+  bool use_tables;
+};
+
+template <class BondKernel, class TableKernel, class Accept>
+TabulatedBondKernel(BondKernel, TableKernel, Accept, bool)
+    -> TabulatedBondKernel<BondKernel, TableKernel, Accept>;
+
+namespace detail {
+template <class BondKernel> void bond_loop(BondKernel const &bond_kernel) {
+  cell_structure.bond_loop(bond_kernel);
+}
+
+template <class BondKernel, class TableKernel, class Accept>
+void bond_loop(
+    TabulatedBondKernel<BondKernel, TableKernel, Accept> const &kernel) {
+  if (kernel.use_tables) {
+    cell_structure.bond_table_loop(kernel.accept, kernel.table_kernel,
+                                   kernel.bond_kernel);
+  } else {
+    cell_structure.bond_loop(kernel.bond_kernel);
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Run the bonded and non-bonded kernels over all local particles.
+ *
+ * @param bond_kernel       Bonded kernel
+ * @param pair_kernel       Non-bonded kernel
+ * @param pair_cutoff       Non-bonded cutoff
+ * @param bond_cutoff       Bonded cutoff
+ * @param verlet_criterion  Filter for Verlet lists
+ * @param thread_safe       Whether the non-bonded kernel can be called
+ *                          concurrently on disjoint particle pairs, see
+ *                          @ref CellStructure::parallel_non_bonded_loop
+ */
 template <class BondKernel, class PairKernel,
           class VerletCriterion = detail::True>
 void short_range_loop(BondKernel bond_kernel, PairKernel pair_kernel,
                       double pair_cutoff, double bond_cutoff,
-                      const VerletCriterion &verlet_criterion = {}) {
+                      const VerletCriterion &verlet_criterion = {},
+                      bool thread_safe = false) {
   ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
 
   assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
 
+  cell_structure.ghosts_wait();
+
   if (bond_cutoff >= 0.) {
-    cell_structure.bond_loop(bond_kernel);
+    detail::bond_loop(bond_kernel);
   }
 
   if (pair_cutoff > 0.) {
-    cell_structure.non_bonded_loop(pair_kernel, verlet_criterion);
+    if (thread_safe) {
+      cell_structure.parallel_non_bonded_loop(pair_kernel, verlet_criterion);
+    } else {
+      cell_structure.non_bonded_loop(pair_kernel, verlet_criterion);
+    }
+  }
+}
+
+namespace detail {
+/**
+ * @brief Run the bonded kernel over all local particles and a
+ * non-bonded loop over the hot particle data.
+ *
+ * The forces accumulated in the hot particle data are added to the
+ * particles at the end of the loop. A pending ghost update is overlapped
+ * with the non-bonded loop, see
+ * @ref CellStructure::overlapped_hot_non_bonded_loop.
+ *
+ * @param bond_kernel       Bonded kernel
+ * @param non_bonded_loop   Loop over the hot particle data, called
+ *                          without arguments
+ * @param pair_cutoff       Non-bonded cutoff
+ * @param bond_cutoff       Bonded cutoff
+ */
+template <class BondKernel, class NonBondedLoop>
+void hot_short_range_loop(BondKernel const &bond_kernel,
+                          NonBondedLoop const &non_bonded_loop,
+                          double pair_cutoff, double bond_cutoff) {
+  ESPRESSO_PROFILER_CXX_MARK_FUNCTION;
+
+  assert(cell_structure.get_resort_particles() == Cells::RESORT_NONE);
+
+  auto const bond_loop = [&]() {
+    if (bond_cutoff >= 0.) {
+      detail::bond_loop(bond_kernel);
+    }
+  };
+
+  if (pair_cutoff > 0.) {
+    cell_structure.overlapped_hot_non_bonded_loop(non_bonded_loop, bond_loop);
+    cell_structure.scatter_hot_particle_forces();
+  } else {
+    cell_structure.ghosts_wait();
+    bond_loop();
   }
 }
+} // namespace detail
+
+/**
+ * @brief Run the bonded kernel over all local particles and the
+ * non-bonded kernel over the hot particle data.
+ *
+ * See @ref detail::hot_short_range_loop.
+ *
+ * @param bond_kernel       Bonded kernel
+ * @param pair_kernel       Non-bonded kernel, see
+ *                          @ref CellStructure::hot_non_bonded_loop
+ * @param pair_cutoff       Non-bonded cutoff
+ * @param bond_cutoff       Bonded cutoff
+ * @param verlet_criterion  Filter for Verlet lists
+ */
+template <class BondKernel, class HotPairKernel,
+          class VerletCriterion = detail::True>
+void hot_short_range_loop(BondKernel bond_kernel, HotPairKernel pair_kernel,
+                          double pair_cutoff, double bond_cutoff,
+                          const VerletCriterion &verlet_criterion = {}) {
+  detail::hot_short_range_loop(
+      bond_kernel,
+      [&]() {
+        cell_structure.hot_non_bonded_loop(pair_kernel, verlet_criterion);
+      },
+      pair_cutoff, bond_cutoff);
+}
+
+/**
+ * @brief Run the bonded kernel over all local particles and the
+ * non-bonded kernel over pairs of particle clusters in the hot
+ * particle data.
+ *
+ * See @ref detail::hot_short_range_loop.
+ *
+ * @param bond_kernel       Bonded kernel
+ * @param cluster_kernel    Non-bonded kernel, see
+ *                          @ref CellStructure::cluster_non_bonded_loop
+ * @param pair_cutoff       Non-bonded cutoff
+ * @param bond_cutoff       Bonded cutoff
+ * @param range             Range of the cluster pair lists
+ */
+template <class BondKernel, class ClusterKernel>
+void cluster_short_range_loop(BondKernel bond_kernel,
+                              ClusterKernel const &cluster_kernel,
+                              double pair_cutoff, double bond_cutoff,
+                              double range) {
+  detail::hot_short_range_loop(
+      bond_kernel,
+      [&]() { cell_structure.cluster_non_bonded_loop(cluster_kernel, range); },
+      pair_cutoff, bond_cutoff);
+}
+
+/**
+ * @brief Run the bonded kernel over all local particles and the
+ * non-bonded kernel over all pairs of particle clusters in the hot
+ * particle data, in tiles and without pair lists.
+ *
+ * Same as @ref cluster_short_range_loop, but with
+ * @ref CellStructure::tiled_non_bonded_loop.
+ *
+ * @param bond_kernel       Bonded kernel
+ * @param cluster_kernel    Non-bonded kernel, see
+ *                          @ref CellStructure::tiled_non_bonded_loop
+ * @param pair_cutoff       Non-bonded cutoff
+ * @param bond_cutoff       Bonded cutoff
+ */
+template <class BondKernel, class ClusterKernel>
+void tiled_short_range_loop(BondKernel bond_kernel,
+                            ClusterKernel const &cluster_kernel,
+                            double pair_cutoff, double bond_cutoff) {
+  detail::hot_short_range_loop(
+      bond_kernel,
+      [&]() { cell_structure.tiled_non_bonded_loop(cluster_kernel); },
+      pair_cutoff, bond_cutoff);
+}
+
+/**
+ * @brief Run the bonded kernel over all local particles and the
+ * non-bonded kernel over all pairs of particles in the hot particle
+ * data, in tiles and without pair lists.
+ *
+ * Same as @ref hot_short_range_loop, but with
+ * @ref CellStructure::hot_tiled_non_bonded_loop.
+ *
+ * @param bond_kernel       Bonded kernel
+ * @param pair_kernel       Non-bonded kernel, see
+ *                          @ref CellStructure::hot_tiled_non_bonded_loop
+ * @param pair_cutoff       Non-bonded cutoff
+ * @param bond_cutoff       Bonded cutoff
+ */
+template <class BondKernel, class HotPairKernel>
+void hot_tiled_short_range_loop(BondKernel bond_kernel,
+                                HotPairKernel const &pair_kernel,
+                                double pair_cutoff, double bond_cutoff) {
+  detail::hot_short_range_loop(
+      bond_kernel,
+      [&]() { cell_structure.hot_tiled_non_bonded_loop(pair_kernel); },
+      pair_cutoff, bond_cutoff);
+}
 #endif
@@ -21,6 +21,7 @@
 
 #include "tuning.hpp"
 
+#include "adaptive_skin.hpp"
 #include "cells.hpp"
 #include "communication.hpp"
 #include "errorhandling.hpp"
@@ -129,6 +130,28 @@ static double time_calc(int int_steps) {
   return 1000. * (tock - tick) / int_steps;
 }
 
+namespace {
+/** @brief RAII guard that disables the adaptive skin
+ *
+ * The parameters of the adaptive skin are restored on destruction,
+ * also when the integration throws.
+ */
+class AdaptiveSkinSuspension {
+  AdaptiveSkin::Parameters m_parameters;
+
+public:
+  AdaptiveSkinSuspension(AdaptiveSkinSuspension &&) = delete;
+  AdaptiveSkinSuspension &operator=(AdaptiveSkinSuspension &&) = delete;
+  AdaptiveSkinSuspension(AdaptiveSkinSuspension const &) = delete;
+  AdaptiveSkinSuspension &operator=(AdaptiveSkinSuspension const &) = delete;
+
+  AdaptiveSkinSuspension() : m_parameters(AdaptiveSkin::get_parameters()) {
+    AdaptiveSkin::set_parameters({});
+  }
+  ~AdaptiveSkinSuspension() { AdaptiveSkin::set_parameters(m_parameters); }
+};
+} // namespace
+
 void tune_skin(double min_skin, double max_skin, double tol, int int_steps,
                bool adjust_max_skin) {
 
@@ -146,6 +169,9 @@ void tune_skin(double min_skin, double max_skin, double tol, int int_steps,
   if (adjust_max_skin and max_skin > max_permissible_skin)
     b = max_permissible_skin;
 
+  /* the adaptive skin would interfere with the bisection */
+  AdaptiveSkinSuspension const adaptive_skin_suspension{};
+
   while (fabs(a - b) > tol) {
     mpi_set_skin_local(a);
     auto const time_a = time_calc(int_steps);
@@ -276,8 +276,9 @@ BOOST_FIXTURE_TEST_CASE(espresso_system_stand_alone, ParticleFactory) {
                              5,
                              0.615,
                              1e-3};
-    auto solver =
-        std::make_shared<CoulombP3M>(std::move(p3m), prefactor, 1, false, true);
+    auto solver = std::make_shared<CoulombP3M>(
+        std::move(p3m), prefactor, 1, false, true, P3MDifferentiation::ik,
+        false, "");
     ::Coulomb::add_actor(solver);
 
     // measure energies
@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE HotParticleData test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config/config.hpp"
+
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+#include "cell_system/HotParticleData.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <cstddef>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(layout_gather_scatter) {
+  auto const n_part_per_cell = std::vector<std::size_t>{3, 0, 2};
+  std::vector<Cell> cells(n_part_per_cell.size());
+  std::vector<Cell *> cell_ptrs;
+
+  auto id = 0;
+  for (std::size_t i = 0; i < cells.size(); ++i) {
+    cells[i].particles().resize(n_part_per_cell[i]);
+    for (auto &p : cells[i].particles()) {
+      p.id() = id;
+      p.type() = id % 2;
+      p.pos() = Utils::Vector3d{1. * id, 2. * id, 3. * id};
+      p.force() = Utils::Vector3d{1., 1., 1.};
+#ifdef ELECTROSTATICS
+      p.q() = -1. * id;
+#endif
+      ++id;
+    }
+    cell_ptrs.push_back(&cells[i]);
+  }
+#ifdef EXCLUSIONS
+  cells[2].particles().begin()->exclusions().push_back(0);
+#endif
+
+  HotParticleData data;
+  data.set_layout(cell_ptrs);
+
+  BOOST_REQUIRE_EQUAL(data.size(), 5u);
+  BOOST_CHECK_EQUAL(cells[0].m_hot_offset, 0u);
+  BOOST_CHECK_EQUAL(cells[1].m_hot_offset, 3u);
+  BOOST_CHECK_EQUAL(cells[2].m_hot_offset, 3u);
+
+  data.gather();
+
+  /* particles are stored contiguously in cell order */
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    auto const &p = *data.particles[i];
+    BOOST_CHECK_EQUAL(p.id(), static_cast<int>(i));
+    BOOST_CHECK_EQUAL(data.type[i], p.type());
+    BOOST_CHECK_EQUAL(data.position(i), p.pos());
+#ifdef ELECTROSTATICS
+    BOOST_CHECK_EQUAL(data.q[i], p.q());
+#endif
+#ifdef EXCLUSIONS
+    BOOST_CHECK_EQUAL(static_cast<bool>(data.has_exclusions[i]), i == 3);
+#endif
+    for (std::size_t k = 0; k < 3; ++k) {
+      BOOST_CHECK_EQUAL(data.force[k][i], 0.);
+    }
+  }
+
+  /* forces are added to the particle forces */
+  data.add_force(0, {1., 2., 3.});
+  data.add_force(4, {-1., -2., -3.});
+  data.add_force(4, {-1., -2., -3.});
+  data.scatter_forces();
+
+  BOOST_CHECK_EQUAL(data.particles[0]->force(), Utils::Vector3d({2., 3., 4.}));
+  BOOST_CHECK_EQUAL(data.particles[1]->force(), Utils::Vector3d({1., 1., 1.}));
+  BOOST_CHECK_EQUAL(data.particles[4]->force(),
+                    Utils::Vector3d({-1., -3., -5.}));
+}
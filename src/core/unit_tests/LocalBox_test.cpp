@@ -63,6 +63,11 @@ BOOST_AUTO_TEST_CASE(constructors) {
     BOOST_CHECK(box.length() == local_box_length);
     BOOST_CHECK(boost::equal(boundaries, box.boundary()));
     BOOST_CHECK(box.cell_structure_type() == type);
+    BOOST_CHECK(box.uniform());
     check_length(box);
+
+    auto const non_uniform = LocalBox<double>(lower_corner, local_box_length,
+                                              boundaries, type, false);
+    BOOST_CHECK(not non_uniform.uniform());
   }
 }
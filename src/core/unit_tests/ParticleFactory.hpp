@@ -26,6 +26,7 @@
 
 #include <utils/Vector.hpp>
 
+#include <random>
 #include <vector>
 
 /** Fixture to create particles during a test and remove them at the end. */
@@ -45,6 +46,39 @@ struct ParticleFactory {
     particle_cache.emplace_back(p_id);
   }
 
+  /**
+   * @brief Create particles on a perturbed cubic lattice, with random
+   * velocities drawn from a fixed seed.
+   * @param n        Number of lattice sites per direction
+   * @param spacing  Lattice constant
+   * @param noise    Largest displacement from the lattice sites
+   * @param v_sigma  Standard deviation of the velocity components
+   * @param type     Particle type
+   * @return Number of particles, which have the ids 0 to n^3 - 1.
+   */
+  int create_perturbed_lattice(int n, double spacing, double noise,
+                               double v_sigma, int type = 0) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> displacement(-noise, noise);
+    std::normal_distribution<double> velocity(0., v_sigma);
+    auto pid = 0;
+    for (int i = 0; i < n; ++i) {
+      for (int j = 0; j < n; ++j) {
+        for (int k = 0; k < n; ++k) {
+          auto const pos =
+              Utils::Vector3d{spacing * (i + 0.5) + displacement(gen),
+                              spacing * (j + 0.5) + displacement(gen),
+                              spacing * (k + 0.5) + displacement(gen)};
+          create_particle(pos, pid, type);
+          set_particle_v(pid, Utils::Vector3d{velocity(gen), velocity(gen),
+                                              velocity(gen)});
+          ++pid;
+        }
+      }
+    }
+    return pid;
+  }
+
   void set_particle_type(int p_id, int type) const {
     set_particle_property(p_id, &Particle::type, type);
     on_particle_type_change(p_id, type_tracking::any_type, type);
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE adaptive skin test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "adaptive_skin.hpp"
+#include "cells.hpp"
+#include "config/config.hpp"
+#include "event.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+BOOST_AUTO_TEST_CASE(skin_search) {
+  using AdaptiveSkin::Action;
+  auto params = AdaptiveSkin::Parameters{};
+  params.interval = 1;
+  params.min_skin = 0.1;
+  params.max_skin = 1.1;
+  params.tolerance = 0.01;
+  params.drift = 0.2;
+
+  // convex cost with a minimum at skin 0.7
+  auto optimum = 0.7;
+  auto const cost = [&optimum](double skin) {
+    return 1. + (skin - optimum) * (skin - optimum);
+  };
+
+  AdaptiveSkin::SkinSearch search(0.2, params);
+  int n_updates = 0;
+  while (not search.converged()) {
+    auto const skin = search.skin();
+    auto const decision = search.update(cost(skin));
+    BOOST_REQUIRE_GE(decision.first, params.min_skin);
+    BOOST_REQUIRE_LE(decision.first, params.max_skin);
+    BOOST_REQUIRE_EQUAL(decision.first, search.skin());
+    BOOST_REQUIRE_LT(++n_updates, 100);
+  }
+  BOOST_CHECK_SMALL(search.skin() - optimum, 2. * params.tolerance);
+
+  // the skin is kept while the cost doesn't change
+  auto const skin = search.skin();
+  BOOST_CHECK(search.update(cost(skin)).second == Action::KEEP);
+  BOOST_CHECK(search.update(cost(skin)).second == Action::KEEP);
+  BOOST_CHECK_EQUAL(search.skin(), skin);
+
+  // the search restarts when the optimum moves
+  optimum = 0.3;
+  BOOST_CHECK(search.update(1.5 * cost(skin)).second == Action::RESTART);
+  while (not search.converged()) {
+    search.update(cost(search.skin()));
+  }
+  BOOST_CHECK_SMALL(search.skin() - optimum, 2. * params.tolerance);
+
+  // the skin is limited by the cell system
+  optimum = 1.1;
+  AdaptiveSkin::SkinSearch limited(0.2, params);
+  limited.set_max_skin(0.5);
+  while (not limited.converged()) {
+    BOOST_REQUIRE_LE(limited.update(cost(limited.skin())).first, 0.5);
+  }
+  BOOST_CHECK_SMALL(limited.skin() - 0.5, 2. * params.tolerance);
+
+  // the search stops when there is no room to move
+  params.max_skin = params.min_skin;
+  AdaptiveSkin::SkinSearch fixed(0.1, params);
+  BOOST_CHECK(fixed.update(1.).second == Action::CONVERGED);
+  BOOST_CHECK_EQUAL(fixed.skin(), 0.1);
+}
+
+BOOST_AUTO_TEST_CASE(parameters) {
+  using AdaptiveSkin::Parameters;
+  using AdaptiveSkin::set_parameters;
+  BOOST_CHECK_THROW(set_parameters({-1}), std::domain_error);
+  BOOST_CHECK_THROW(set_parameters({1, -0.1, 1.}), std::domain_error);
+  BOOST_CHECK_THROW(set_parameters({1, 0.5, 0.4}), std::domain_error);
+  BOOST_CHECK_THROW(set_parameters({1, 0.1, 1., 0.}), std::domain_error);
+  BOOST_CHECK_THROW(set_parameters({1, 0.1, 1., 0.01, 0.}),
+                    std::domain_error);
+  BOOST_CHECK_EQUAL(AdaptiveSkin::get_parameters().interval, 0);
+}
+
+#ifdef LENNARD_JONES
+BOOST_FIXTURE_TEST_CASE(integration, ParticleFactory) {
+  espresso::system->set_box_l({10., 10., 10.});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+
+  make_particle_type_exist(0);
+  ::nonbonded_ia_params[get_ia_param_key(0, 0)]->lj =
+      LJ_Parameters{1., 1., 1.12246, 0., 0., 0.25};
+  on_non_bonded_ia_change();
+
+  // particles on a lattice with random velocities
+  create_perturbed_lattice(8, 1.2, 0., 1.);
+
+  auto const n_decisions = AdaptiveSkin::get_decisions().size();
+  AdaptiveSkin::set_parameters({10, 0.05, 1., 0.02, 0.2});
+  integrate(200, 0);
+  AdaptiveSkin::set_parameters({});
+
+  auto const &decisions = AdaptiveSkin::get_decisions();
+  BOOST_REQUIRE_EQUAL(decisions.size(), n_decisions + 20u);
+  auto expected_skin = 0.4;
+  for (auto k = n_decisions; k < decisions.size(); ++k) {
+    auto const &decision = decisions[k];
+    BOOST_CHECK_EQUAL(decision.step,
+                      static_cast<int>(10u * (k - n_decisions + 1u)));
+    BOOST_CHECK_EQUAL(decision.skin, expected_skin);
+    BOOST_CHECK_GT(decision.time_per_step, 0.);
+    BOOST_CHECK_GE(decision.new_skin, 0.05);
+    BOOST_CHECK_LE(decision.new_skin, 1.);
+    expected_skin = decision.new_skin;
+  }
+  BOOST_CHECK_EQUAL(::skin, expected_skin);
+
+  // the cells are large enough for the adapted skin
+  auto const cell_size = cell_structure.max_range();
+  BOOST_CHECK_CLOSE(interaction_range(), 1.12246 + ::skin, 1e-10);
+  BOOST_CHECK_GE(*std::min_element(cell_size.begin(), cell_size.end()),
+                 interaction_range());
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE atom decomposition tiles test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+#include "gather_particles.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "config/config.hpp"
+#include "electrostatics/mmm1d.hpp"
+#include "electrostatics/registration.hpp"
+#include "energy.hpp"
+#include "event.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+#ifdef LENNARD_JONES
+namespace {
+auto constexpr box_l = 7.7;
+
+/**
+ * @brief Compute the forces of particles on a jittered lattice.
+ * @return Forces of all particles, on all ranks.
+ */
+auto run(boost::mpi::communicator const &comm, CellStructureType type) {
+  cells_re_init(type);
+  ParticleFactory factory;
+
+  // more particles than fit in a few tiles, with a partial cluster
+  auto constexpr n_part = 301;
+  auto constexpr n_sites = 7;
+  auto constexpr spacing = box_l / n_sites;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> jitter(-0.1, 0.1);
+  for (int pid = 0; pid < n_part; ++pid) {
+    auto const site = Utils::Vector3d{
+        static_cast<double>(pid % n_sites),
+        static_cast<double>(pid / n_sites % n_sites),
+        static_cast<double>(pid / (n_sites * n_sites))};
+    auto const pos =
+        spacing * site + Utils::Vector3d{jitter(gen), jitter(gen), jitter(gen)};
+    factory.create_particle(pos, pid, 0);
+  }
+
+  integrate(0, -1);
+
+  auto const forces = gather_forces(comm);
+  BOOST_REQUIRE_EQUAL(forces.size(), static_cast<std::size_t>(n_part));
+  return forces;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(tiled_forces) {
+  auto const comm = boost::mpi::communicator();
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  espresso::system->set_time_step(0.005);
+  espresso::system->set_skin(0.3);
+  ::cell_structure.use_hot_particle_data = true;
+
+  // long cutoff, such that each particle interacts with many tiles
+  make_particle_type_exist(0);
+  ::nonbonded_ia_params[get_ia_param_key(0, 0)]->lj =
+      LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+  on_non_bonded_ia_change();
+
+  // the cluster pair lists of the regular decomposition are the reference,
+  // the atom decomposition visits all pairs in tiles with and without
+  // verlet lists
+  auto const ref = run(comm, CellStructureType::CELL_STRUCTURE_REGULAR);
+  for (auto const use_verlet_list : {true, false}) {
+    ::cell_structure.use_verlet_list = use_verlet_list;
+    auto const res = run(comm, CellStructureType::CELL_STRUCTURE_NSQUARE);
+    check_forces(ref, res, 1e-10);
+  }
+  ::cell_structure.use_verlet_list = true;
+
+  // single precision force factors
+  ::cell_structure.use_mixed_precision = true;
+  auto const ref_sp = run(comm, CellStructureType::CELL_STRUCTURE_REGULAR);
+  auto const res_sp = run(comm, CellStructureType::CELL_STRUCTURE_NSQUARE);
+  check_forces(ref, ref_sp, 1e-4);
+  check_forces(ref, res_sp, 1e-4);
+  ::cell_structure.use_mixed_precision = false;
+}
+#endif // LENNARD_JONES
+
+#ifdef ELECTROSTATICS
+BOOST_AUTO_TEST_CASE(tiled_mmm1d_forces) {
+  auto const comm = boost::mpi::communicator();
+  espresso::system->set_box_l({10., 10., 10.});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.4);
+  box_geo.set_periodic(0, false);
+  box_geo.set_periodic(1, false);
+  on_periodicity_change();
+  cells_re_init(CellStructureType::CELL_STRUCTURE_NSQUARE);
+
+  {
+    // a neutral system that fills a few tiles, without short-range
+    // interactions
+    ParticleFactory factory;
+    make_particle_type_exist(1);
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<double> coord(0., 10.);
+    for (int pid = 0; pid < 100; ++pid) {
+      factory.create_particle({coord(gen), coord(gen), coord(gen)}, pid, 1);
+      factory.set_particle_property(pid, &Particle::q, pid % 2 ? 1. : -1.);
+    }
+    on_particle_charge_change();
+
+    auto const solver =
+        std::make_shared<CoulombMMM1D>(1., 1e-10, 3., 1, false, false);
+    ::Coulomb::add_actor(solver);
+
+    // cutoff-free electrostatics visit all pairs in tiles on the
+    // hot particle data, the particle loop is the reference
+    auto const run_mmm1d = [&comm](bool use_hot_particle_data,
+                                   int n_threads) {
+      ::cell_structure.use_hot_particle_data = use_hot_particle_data;
+      ::cell_structure.set_n_threads(n_threads);
+      integrate(0, -1);
+      auto const energy = calculate_energy()->coulomb[0];
+      return std::make_pair(gather_forces(comm), energy);
+    };
+    auto const ref = run_mmm1d(false, 1);
+    auto const res = run_mmm1d(true, 1);
+    check_forces(ref.first, res.first, 1e-10);
+    if (comm.rank() == 0) {
+      BOOST_CHECK_CLOSE(res.second, ref.second, 1e-10);
+    }
+#ifdef OPENMP
+    // the traversal order doesn't depend on the number of threads
+    auto const res_threads = run_mmm1d(true, 4);
+    for (auto const &kv : res.first) {
+      BOOST_CHECK_EQUAL((res_threads.first.at(kv.first) - kv.second).norm(),
+                        0.);
+    }
+    if (comm.rank() == 0) {
+      BOOST_CHECK_EQUAL(res_threads.second, res.second);
+    }
+#endif
+    ::cell_structure.use_hot_particle_data = false;
+    ::cell_structure.set_n_threads(1);
+    ::Coulomb::remove_actor(solver);
+  }
+
+  box_geo.set_periodic(0, true);
+  box_geo.set_periodic(1, true);
+  on_periodicity_change();
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+}
+#endif // ELECTROSTATICS
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
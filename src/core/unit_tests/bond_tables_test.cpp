@@ -0,0 +1,273 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE bond tables test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+#include "gather_particles.hpp"
+
+#include "BondList.hpp"
+#include "EspressoSystemStandAlone.hpp"
+#include "Particle.hpp"
+#include "bond_breakage/bond_breakage.hpp"
+#include "bond_error.hpp"
+#include "bonded_interactions/angle_harmonic.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "bonded_interactions/dihedral.hpp"
+#include "bonded_interactions/fene.hpp"
+#include "bonded_interactions/harmonic.hpp"
+#include "bonded_interactions/quartic.hpp"
+#include "cell_system/BondTables.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "config/config.hpp"
+#include "errorhandling.hpp"
+#include "event.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Span.hpp>
+#include <utils/Vector.hpp>
+
+#include <boost/container/static_vector.hpp>
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+BOOST_AUTO_TEST_CASE(table_layout) {
+  std::vector<Particle> particles(4);
+  for (int i = 0; i < 4; ++i) {
+    particles[static_cast<std::size_t>(i)].id() = i;
+  }
+  auto const add_bond = [&particles](int pid, int bond_id,
+                                     std::vector<int> const &partner_ids) {
+    particles[static_cast<std::size_t>(pid)].bonds().insert(
+        BondView(bond_id, partner_ids));
+  };
+  add_bond(0, 0, {1});
+  add_bond(0, 1, {1, 2});
+  add_bond(1, 0, {2});
+  add_bond(2, 2, {3}); // rejected bond id
+  add_bond(3, 0, {7}); // partner cannot be resolved
+  add_bond(3, 1, {0, 1});
+
+  auto const resolve = [&particles](Utils::Span<const int> partner_ids) {
+    boost::container::static_vector<Particle *, 4> partners;
+    for (auto const pid : partner_ids) {
+      if (pid >= 4) {
+        throw BondResolutionError{};
+      }
+      partners.push_back(&particles[static_cast<std::size_t>(pid)]);
+    }
+    return partners;
+  };
+
+  BondTables bond_tables;
+  bond_tables.build(particles, [](int bond_id) { return bond_id != 2; },
+                    resolve);
+
+  auto const &tables = bond_tables.tables();
+  BOOST_REQUIRE_EQUAL(tables.size(), 2u);
+  BOOST_CHECK(bond_tables.is_tabulated(0));
+  BOOST_CHECK(bond_tables.is_tabulated(1));
+  BOOST_CHECK(not bond_tables.is_tabulated(2));
+  BOOST_CHECK(not bond_tables.is_tabulated(5));
+
+  // bonds are stored bond after bond, the owner first
+  auto const &pair_table = tables[0];
+  BOOST_CHECK_EQUAL(pair_table.bond_id, 0);
+  BOOST_CHECK_EQUAL(pair_table.stride, 2u);
+  BOOST_REQUIRE_EQUAL(pair_table.size(), 2u);
+  BOOST_CHECK_EQUAL(pair_table[0][0], &particles[0]);
+  BOOST_CHECK_EQUAL(pair_table[0][1], &particles[1]);
+  BOOST_CHECK_EQUAL(pair_table[1][0], &particles[1]);
+  BOOST_CHECK_EQUAL(pair_table[1][1], &particles[2]);
+  auto const &angle_table = tables[1];
+  BOOST_CHECK_EQUAL(angle_table.bond_id, 1);
+  BOOST_CHECK_EQUAL(angle_table.stride, 3u);
+  BOOST_REQUIRE_EQUAL(angle_table.size(), 2u);
+  BOOST_CHECK_EQUAL(angle_table[0][2], &particles[2]);
+  BOOST_CHECK_EQUAL(angle_table[1][0], &particles[3]);
+  BOOST_CHECK_EQUAL(angle_table[1][1], &particles[0]);
+
+  // particles with bonds outside of the tables
+  auto const &untabulated = bond_tables.untabulated();
+  BOOST_REQUIRE_EQUAL(untabulated.size(), 2u);
+  BOOST_CHECK_EQUAL(untabulated[0], &particles[2]);
+  BOOST_CHECK_EQUAL(untabulated[1], &particles[3]);
+
+  // rebuilding discards the previous tables
+  bond_tables.build(particles, [](int) { return false; }, resolve);
+  BOOST_CHECK(bond_tables.tables().empty());
+  BOOST_CHECK(not bond_tables.is_tabulated(0));
+  BOOST_CHECK_EQUAL(bond_tables.untabulated().size(), 4u);
+}
+
+namespace {
+/**
+ * @brief Integrate bead-spring chains with pair, angle and dihedral bonds.
+ * @return Positions and forces after the integration.
+ */
+auto run(boost::mpi::communicator const &comm, bool bond_tables) {
+  ParticleFactory factory;
+  ::cell_structure.use_bond_tables = bond_tables;
+
+  // self-avoiding random walks with a constant step length
+  auto constexpr n_chains = 20;
+  auto constexpr chain_length = 12;
+  auto constexpr box_l = 16.;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> uniform(0., box_l);
+  std::normal_distribution<double> normal(0., 1.);
+  std::normal_distribution<double> velocity(0., 0.1);
+  std::vector<Utils::Vector3d> positions;
+  auto const is_free = [&positions](Utils::Vector3d const &pos) {
+    return std::none_of(positions.begin(), positions.end(),
+                        [&pos](Utils::Vector3d const &other) {
+                          auto d = pos - other;
+                          for (auto &x : d) {
+                            x -= box_l * std::round(x / box_l);
+                          }
+                          return d.norm() < 0.9;
+                        });
+  };
+  for (int i = 0; i < n_chains; ++i) {
+    Utils::Vector3d pos;
+    do {
+      pos = Utils::Vector3d{uniform(gen), uniform(gen), uniform(gen)};
+    } while (not is_free(pos));
+    positions.push_back(pos);
+    for (int j = 1; j < chain_length; ++j) {
+      Utils::Vector3d next;
+      do {
+        auto const step =
+            Utils::Vector3d{normal(gen), normal(gen), normal(gen)};
+        next = pos + 0.97 * step / step.norm();
+      } while (not is_free(next));
+      pos = next;
+      positions.push_back(pos);
+    }
+  }
+
+  auto pid = 0;
+  for (int i = 0; i < n_chains; ++i) {
+    for (int j = 0; j < chain_length; ++j) {
+      factory.create_particle(positions[static_cast<std::size_t>(pid)], pid,
+                              0);
+      factory.set_particle_v(
+          pid, Utils::Vector3d{velocity(gen), velocity(gen), velocity(gen)});
+      if (j >= 1) {
+        factory.insert_particle_bond(pid, 0, {pid - 1});
+      }
+      if (j >= 2) {
+        factory.insert_particle_bond(pid - 1, 1, {pid - 2, pid});
+        factory.insert_particle_bond(pid, 3, {pid - 2});
+      }
+      if (j >= 3) {
+        factory.insert_particle_bond(pid - 2, 2, {pid - 3, pid - 1, pid});
+        factory.insert_particle_bond(pid - 1, 4, {pid - 2});
+      }
+      ++pid;
+    }
+  }
+
+  integrate(20, -1);
+
+  ::cell_structure.use_bond_tables = false;
+  return gather_positions_and_forces(comm);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(bonded_forces) {
+  auto const comm = boost::mpi::communicator();
+  espresso::system->set_box_l({16., 16., 16.});
+  espresso::system->set_time_step(0.005);
+  espresso::system->set_skin(0.3);
+  ::cell_structure.use_hot_particle_data = true;
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+
+#ifdef LENNARD_JONES
+  make_particle_type_exist(0);
+  ::nonbonded_ia_params[get_ia_param_key(0, 0)]->lj =
+      LJ_Parameters{1., 1., std::pow(2., 1. / 6.), 0., 0., 0.25};
+  on_non_bonded_ia_change();
+#endif
+  // the quartic bond is not tabulated
+  bonded_ia_params.insert(
+      0, std::make_shared<Bonded_IA_Parameters>(FeneBond(30., 1.5, 0.)));
+  bonded_ia_params.insert(
+      1, std::make_shared<Bonded_IA_Parameters>(AngleHarmonicBond(5., 2.)));
+  bonded_ia_params.insert(
+      2, std::make_shared<Bonded_IA_Parameters>(DihedralBond(3, 1., 0.5)));
+  bonded_ia_params.insert(
+      3, std::make_shared<Bonded_IA_Parameters>(HarmonicBond(2., 1.6, 2.2)));
+  bonded_ia_params.insert(
+      4, std::make_shared<Bonded_IA_Parameters>(QuarticBond(1., 1., 0.9, 1.5)));
+  on_short_range_ia_change();
+
+  // cluster pair lists and plain cell pairs
+  for (auto const use_verlet_list : {true, false}) {
+    ::cell_structure.use_verlet_list = use_verlet_list;
+    // the forces are summed in a different order
+    check_positions_and_forces(run(comm, false), run(comm, true), 1e-9, 1e-7);
+  }
+  ::cell_structure.use_verlet_list = true;
+
+  // the FENE bonds break in the same way
+  auto const spec = BondBreakage::BreakageSpec{
+      0.98, BondBreakage::ActionType::DELETE_BOND};
+  BondBreakage::insert_spec(
+      0, std::make_shared<BondBreakage::BreakageSpec>(spec));
+  check_positions_and_forces(run(comm, false), run(comm, true), 1e-9, 1e-7);
+  BondBreakage::erase_spec(0);
+
+  // overstretched bonds are reported
+  {
+    ParticleFactory factory;
+    ::cell_structure.use_bond_tables = true;
+    factory.create_particle({1., 1., 1.}, 0, 0);
+    factory.create_particle({1., 1., 2.6}, 1, 0);
+    factory.insert_particle_bond(1, 0, {0});
+    integrate(0, -1);
+    BOOST_CHECK_EQUAL(check_runtime_errors(comm), 1);
+    flush_runtime_errors_local();
+    ::cell_structure.use_bond_tables = false;
+  }
+}
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
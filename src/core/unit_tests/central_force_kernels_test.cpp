@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE central force kernels test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config/config.hpp"
+
+#include "forces_inline.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <cstddef>
+#include <functional>
+
+namespace {
+/** Set up the interactions of type 0 and check the selected kernel
+ *  against the sum of all potentials.
+ */
+void check_kernel(std::function<void(IA_parameters &)> const &setup,
+                  CentralForceKernel::Kernel expected) {
+  make_particle_type_exist(0);
+  auto &ia_params = get_ia_param(0, 0);
+  ia_params = IA_parameters{};
+  setup(ia_params);
+  maximal_cutoff_nonbonded();
+  BOOST_REQUIRE_EQUAL(ia_params.central_force_kernel, expected);
+  for (int k = 1; k <= 300; ++k) {
+    auto const dist = 0.01 * k;
+    auto const ref = calc_central_radial_force_factor(ia_params, dist);
+    auto const value = dispatch_central_radial_force_factor(ia_params, dist);
+    BOOST_CHECK_EQUAL(value, ref);
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(kernel_selection) {
+  using namespace CentralForceKernel;
+  BOOST_CHECK_EQUAL(central_force_kernels.size(),
+                    static_cast<std::size_t>(N_KERNELS));
+  check_kernel([](IA_parameters &) {}, KERNEL_NONE);
+#ifdef LENNARD_JONES
+  check_kernel(
+      [](IA_parameters &p) { p.lj = LJ_Parameters{1., 1., 2.5, 0.1, 0., 0.}; },
+      KERNEL_LJ);
+#endif
+#ifdef WCA
+  check_kernel([](IA_parameters &p) { p.wca = WCA_Parameters{1.2, 1.}; },
+               KERNEL_WCA);
+#endif
+#ifdef GAUSSIAN
+  check_kernel(
+      [](IA_parameters &p) { p.gaussian = Gaussian_Parameters{1., 1., 2.}; },
+      KERNEL_GAUSSIAN);
+#endif
+#ifdef HERTZIAN
+  check_kernel(
+      [](IA_parameters &p) { p.hertzian = Hertzian_Parameters{1., 1.5}; },
+      KERNEL_HERTZIAN);
+#endif
+#ifdef SOFT_SPHERE
+  check_kernel(
+      [](IA_parameters &p) {
+        p.soft_sphere = SoftSphere_Parameters{0.5, 3., 1.5, 0.};
+      },
+      KERNEL_SOFT_SPHERE);
+#endif
+#ifdef HAT
+  check_kernel([](IA_parameters &p) { p.hat = Hat_Parameters{1., 1.2}; },
+               KERNEL_HAT);
+#endif
+#ifdef LJCOS
+  check_kernel(
+      [](IA_parameters &p) { p.ljcos = LJcos_Parameters{1., 1., 1.5, 0.}; },
+      KERNEL_LJCOS);
+#endif
+#ifdef MORSE
+  check_kernel(
+      [](IA_parameters &p) { p.morse = Morse_Parameters{1., 2., 1.1, 2.5}; },
+      KERNEL_MORSE);
+#endif
+#if defined(LENNARD_JONES) and defined(WCA)
+  // several potentials need the generic kernel
+  check_kernel(
+      [](IA_parameters &p) {
+        p.lj = LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+        p.wca = WCA_Parameters{1.2, 0.8};
+      },
+      KERNEL_GENERIC);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(default_kernel) {
+  // parameters that were not set up yet use the generic kernel
+  BOOST_CHECK_EQUAL(IA_parameters{}.central_force_kernel,
+                    CentralForceKernel::KERNEL_GENERIC);
+}
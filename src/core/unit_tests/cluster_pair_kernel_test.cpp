@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE cluster pair kernel test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config/config.hpp"
+
+#include "BoxGeometry.hpp"
+#include "Particle.hpp"
+#include "cell_system/Cell.hpp"
+#include "cell_system/HotParticleData.hpp"
+#include "forces_inline.hpp"
+#include "nonbonded_interactions/cluster_pair_kernel.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#if defined(LENNARD_JONES) and defined(WCA) and defined(SOFT_SPHERE)
+
+namespace {
+/** Reference forces from the scalar force factors. */
+auto reference_forces(HotParticleData const &data) {
+  std::vector<Utils::Vector3d> forces(data.size());
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    for (std::size_t j = i + 1; j < data.size(); ++j) {
+      auto const d = data.position(i) - data.position(j);
+      auto const dist = d.norm();
+      auto const &ia_params = get_ia_param(data.type[i], data.type[j]);
+      auto const f = calc_central_radial_force_factor(ia_params, dist) * d;
+      forces[i] += f;
+      forces[j] -= f;
+    }
+  }
+  return forces;
+}
+
+/** All cluster pairs of a single cell. */
+auto cluster_pairs(std::uint32_t n_part) {
+  auto constexpr size = ClusterPair::size;
+  std::vector<ClusterPair> pairs;
+  for (std::uint32_t i = 0; i < n_part; i += size) {
+    for (std::uint32_t j = i; j < n_part; j += size) {
+      pairs.push_back(
+          {i, j, std::min(size, n_part - i), std::min(size, n_part - j)});
+    }
+  }
+  return pairs;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(cluster_pair_kernel) {
+  make_particle_type_exist(2);
+  get_ia_param(0, 0).lj = LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+  get_ia_param(0, 1).lj = LJ_Parameters{0.8, 0.9, 2.2, 0.1, 0., 0.};
+  get_ia_param(0, 1).soft_sphere = SoftSphere_Parameters{0.5, 3., 1.5, 0.};
+  get_ia_param(1, 1).wca = WCA_Parameters{1.2, 1.};
+  maximal_cutoff_nonbonded();
+
+  /* 11 particles in a small box, i.e. 3 clusters with a partial one */
+  auto const n_part = 11u;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(0., 2.);
+  Cell cell;
+  cell.particles().resize(n_part);
+  auto id = 0;
+  for (auto &p : cell.particles()) {
+    p.id() = id;
+    p.type() = id % 2;
+    p.pos() = Utils::Vector3d{1.2 * id, dist(gen), dist(gen)};
+    ++id;
+  }
+
+  HotParticleData data;
+  data.set_layout(std::vector<Cell *>{&cell});
+
+  BoxGeometry box;
+  box.set_length(Utils::Vector3d{20., 20., 20.});
+
+  auto n_pair_kernel_calls = 0;
+  auto const pair_kernel = [&n_pair_kernel_calls](
+                               HotParticleData &hot_data, std::size_t i,
+                               std::size_t j, Utils::Vector3d const &d,
+                               double dist2) {
+    ++n_pair_kernel_calls;
+    add_non_bonded_pair_force(hot_data, i, j, d, std::sqrt(dist2), dist2,
+                              nullptr);
+  };
+
+  // supported potentials only
+  {
+    data.gather();
+    auto const kernel =
+        ClusterPairKernel<decltype(pair_kernel)>{pair_kernel, box};
+    for (auto const &pair : cluster_pairs(n_part)) {
+      kernel(data, pair);
+    }
+    auto const ref = reference_forces(data);
+    for (std::size_t i = 0; i < n_part; ++i) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        BOOST_CHECK_CLOSE(data.force[k][i] + 1., ref[i][k] + 1., 1e-10);
+      }
+    }
+    BOOST_CHECK_EQUAL(n_pair_kernel_calls, 0);
+  }
+
+  // supported potentials, with particles at different periodic images
+  {
+    data.gather();
+    auto const ref = reference_forces(data);
+    for (auto &p : cell.particles()) {
+      p.pos() += box.length() * static_cast<double>(p.id() % 3 - 1);
+    }
+    data.gather();
+    auto const kernel =
+        ClusterPairKernel<decltype(pair_kernel)>{pair_kernel, box};
+    for (auto const &pair : cluster_pairs(n_part)) {
+      kernel(data, pair);
+    }
+    for (auto &p : cell.particles()) {
+      p.pos() -= box.length() * static_cast<double>(p.id() % 3 - 1);
+    }
+    for (std::size_t i = 0; i < n_part; ++i) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        BOOST_CHECK_CLOSE(data.force[k][i] + 1., ref[i][k] + 1., 1e-10);
+      }
+    }
+    BOOST_CHECK_EQUAL(n_pair_kernel_calls, 0);
+  }
+
+  // supported potentials in mixed precision, far from the origin
+  {
+    for (auto &p : cell.particles()) {
+      p.pos() += Utils::Vector3d{1e4, -1e4, 1e4};
+    }
+    data.gather();
+    auto const kernel =
+        ClusterPairKernel<decltype(pair_kernel), float>{pair_kernel, box};
+    for (auto const &pair : cluster_pairs(n_part)) {
+      kernel(data, pair);
+    }
+    auto const ref = reference_forces(data);
+    for (std::size_t i = 0; i < n_part; ++i) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        BOOST_CHECK_SMALL(data.force[k][i] - ref[i][k],
+                          1e-5 * (1. + ref[i].norm()));
+      }
+    }
+    BOOST_CHECK_EQUAL(n_pair_kernel_calls, 0);
+  }
+
+#ifdef GAUSSIAN
+  // unsupported potential between particles of type 1
+  {
+    get_ia_param(1, 1).gaussian = Gaussian_Parameters{1., 1., 2.};
+    maximal_cutoff_nonbonded();
+    data.gather();
+    auto const kernel =
+        ClusterPairKernel<decltype(pair_kernel)>{pair_kernel, box};
+    for (auto const &pair : cluster_pairs(n_part)) {
+      kernel(data, pair);
+    }
+    auto const ref = reference_forces(data);
+    for (std::size_t i = 0; i < n_part; ++i) {
+      for (std::size_t k = 0; k < 3; ++k) {
+        BOOST_CHECK_CLOSE(data.force[k][i] + 1., ref[i][k] + 1., 1e-10);
+      }
+    }
+    auto const n_pairs = static_cast<int>(n_part * (n_part - 1u) / 2u);
+    BOOST_CHECK_EQUAL(n_pair_kernel_calls, n_pairs);
+  }
+#endif
+}
+
+#else
+BOOST_AUTO_TEST_CASE(cluster_pair_kernel) {}
+#endif
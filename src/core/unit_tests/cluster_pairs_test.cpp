@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE cluster pairs test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+#include "gather_particles.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "cell_system/Cell.hpp"
+#include "cell_system/CellStructure.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "config/config.hpp"
+#include "event.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <random>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+#ifdef LENNARD_JONES
+namespace {
+auto constexpr box_l = 6.;
+
+/** @brief Compute the forces of all particles, on all ranks. */
+auto calc_forces(boost::mpi::communicator const &comm) {
+  integrate(0, -1);
+  return gather_forces(comm);
+}
+
+/** @brief Number of cluster pairs in the lists of all cells. */
+auto count_cluster_pairs(boost::mpi::communicator const &comm) {
+  return boost::mpi::all_reduce(comm, cell_structure.n_cluster_pairs(),
+                                 std::plus<std::size_t>());
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(cluster_pairs_force_calc, ParticleFactory) {
+  auto const comm = boost::mpi::communicator();
+  espresso::system->set_box_l(Utils::Vector3d::broadcast(box_l));
+  espresso::system->set_time_step(0.005);
+  espresso::system->set_skin(0.3);
+  ::cell_structure.use_hot_particle_data = true;
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+
+  make_particle_type_exist(0);
+  get_ia_param(0, 0).lj = LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+  on_non_bonded_ia_change();
+
+  // particles close to the box boundaries interact with periodic images
+  auto constexpr n_part = 150;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> coord(0., box_l);
+  for (int pid = 0; pid < n_part; ++pid) {
+    create_particle({coord(gen), coord(gen), coord(gen)}, pid, 0);
+  }
+
+  // without Verlet lists, the pairs are found by the link cells
+  ::cell_structure.use_verlet_list = false;
+  auto const ref = calc_forces(comm);
+  BOOST_REQUIRE_EQUAL(count_cluster_pairs(comm), 0u);
+
+  // with Verlet lists, the force calculation takes the cluster pair path
+  ::cell_structure.use_verlet_list = true;
+  auto const res = calc_forces(comm);
+  BOOST_CHECK_GT(count_cluster_pairs(comm), 0u);
+
+  BOOST_REQUIRE_EQUAL(ref.size(), static_cast<std::size_t>(n_part));
+  check_forces(ref, res, 1e-10);
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Unit tests for the distributed real-to-complex 3D-FFT. */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE fft test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config/config.hpp"
+#include "p3m/fft.hpp"
+
+#include <utils/Vector.hpp>
+#include <utils/constants.hpp>
+#include <utils/index.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <mpi.h>
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace {
+/** Real test signal on the global mesh. */
+double signal(Utils::Vector3i const &x) {
+  return std::sin(1. + 0.3 * x[0] - 0.7 * x[1] + 1.1 * x[2]) +
+         0.1 * x[0] * x[1] - 0.05 * x[2];
+}
+
+/** Cartesian communicator with the MPI default node grid. */
+boost::mpi::communicator make_cart_comm(Utils::Vector3i &node_grid) {
+  boost::mpi::communicator world;
+  node_grid = Utils::Vector3i{};
+  MPI_Dims_create(world.size(), 3, node_grid.data());
+  int const periodic[3] = {1, 1, 1};
+  MPI_Comm cart;
+  MPI_Cart_create(world, 3, node_grid.data(), periodic, 0, &cart);
+  return {cart, boost::mpi::comm_take_ownership};
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(forward_backward) {
+  Utils::Vector3i node_grid;
+  auto const comm = make_cart_comm(node_grid);
+  Utils::Vector3i node_pos;
+  MPI_Cart_coords(comm, comm.rank(), 3, node_pos.data());
+
+  // even and odd mesh sizes along the rows of the first FFT
+  auto const meshes = {Utils::Vector3i{8, 12, 10}, Utils::Vector3i{8, 4, 7},
+                       Utils::Vector3i{6, 8, 5}};
+  for (auto const &mesh : meshes) {
+    // no margins, the node grid divides the mesh
+    Utils::Vector3i local_dim;
+    for (int i = 0; i < 3; i++) {
+      BOOST_REQUIRE_EQUAL(mesh[i] % node_grid[i], 0);
+      local_dim[i] = mesh[i] / node_grid[i];
+    }
+    auto const local_start = Utils::hadamard_product(node_pos, local_dim);
+    int const margin[6] = {0, 0, 0, 0, 0, 0};
+    auto const mesh_off = Utils::Vector3d::broadcast(0.5);
+
+    fft_data_struct fft;
+    int ks_pnum;
+    auto const size = fft_init(local_dim, margin, mesh, mesh_off, ks_pnum, fft,
+                               node_grid, comm);
+
+    fft_vector<double> data(size);
+    std::vector<double> ref(Utils::product(local_dim));
+    Utils::Vector3i x;
+    for (x[0] = 0; x[0] < local_dim[0]; x[0]++) {
+      for (x[1] = 0; x[1] < local_dim[1]; x[1]++) {
+        for (x[2] = 0; x[2] < local_dim[2]; x[2]++) {
+          auto const ind = Utils::get_linear_index(
+              x, local_dim, Utils::MemoryOrder::ROW_MAJOR);
+          ref[ind] = data[ind] = signal(x + local_start);
+        }
+      }
+    }
+
+    fft_perform_forw(data.data(), fft, comm);
+
+    // compare the half spectrum to a direct DFT
+    auto const &plan = fft.plan[3];
+    auto const k_start = Utils::Vector3i{plan.start};
+    auto n_modes = 0.;
+    Utils::Vector3i j;
+    int ind = 0;
+    for (j[0] = 0; j[0] < plan.new_mesh[0]; j[0]++) {
+      for (j[1] = 0; j[1] < plan.new_mesh[1]; j[1]++) {
+        for (j[2] = 0; j[2] < plan.new_mesh[2]; j[2]++) {
+          // wave vector in real space order
+          Utils::Vector3d k;
+          for (int d = 0; d < 3; d++) {
+            auto const d_rs = (d + ks_pnum) % 3;
+            k[d_rs] = 2. * Utils::pi() * (j[d] + k_start[d]) / mesh[d_rs];
+          }
+          std::complex<double> expected = 0.;
+          for (x[0] = 0; x[0] < mesh[0]; x[0]++) {
+            for (x[1] = 0; x[1] < mesh[1]; x[1]++) {
+              for (x[2] = 0; x[2] < mesh[2]; x[2]++) {
+                auto const phase = k[0] * x[0] + k[1] * x[1] + k[2] * x[2];
+                expected += signal(x) * std::polar(1., -phase);
+              }
+            }
+          }
+          auto const value = std::complex<double>(data[2 * ind + 0],
+                                                  data[2 * ind + 1]);
+          BOOST_CHECK_SMALL(std::abs(value - expected), 1e-9);
+          n_modes += fft.mode_multiplicity(j + k_start);
+          ind++;
+        }
+      }
+    }
+
+    // the half spectrum represents all modes exactly once
+    auto const total_modes =
+        boost::mpi::all_reduce(comm, n_modes, std::plus<>());
+    BOOST_CHECK_EQUAL(total_modes, static_cast<double>(Utils::product(mesh)));
+
+    // the backward transform is not normalized
+    fft_perform_back(data.data(), true, fft, comm);
+    auto const norm = static_cast<double>(Utils::product(mesh));
+    for (std::size_t i = 0; i < ref.size(); i++) {
+      BOOST_CHECK_SMALL(data[i] / norm - ref[i], 1e-10);
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  boost::mpi::environment mpi_env(argc, argv);
+
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
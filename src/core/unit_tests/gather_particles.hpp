@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef CORE_UNIT_TESTS_GATHER_PARTICLES_HPP
+#define CORE_UNIT_TESTS_GATHER_PARTICLES_HPP
+
+/* Helpers to compare the particles of a reference run and of a run with
+ * an alternative algorithm, on all MPI ranks. */
+
+#include <boost/test/unit_test.hpp>
+
+#include "Particle.hpp"
+#include "cells.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi/collectives/all_gather.hpp>
+#include <boost/mpi/communicator.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/** Two vector properties of each particle, by particle id. */
+using ParticleVectors =
+    std::map<int, std::pair<Utils::Vector3d, Utils::Vector3d>>;
+
+/**
+ * @brief Gather a property of all particles, on all ranks.
+ * @param comm     MPI communicator
+ * @param getter   Function returning the property of a particle
+ * @return The property of each particle, by particle id.
+ */
+template <typename Getter>
+auto gather_particles(boost::mpi::communicator const &comm, Getter getter) {
+  using Value =
+      std::decay_t<decltype(getter(std::declval<Particle const &>()))>;
+  std::vector<std::pair<int, Value>> local;
+  for (auto const &p : ::cell_structure.local_particles()) {
+    local.emplace_back(p.id(), getter(p));
+  }
+  std::vector<std::vector<std::pair<int, Value>>> global;
+  boost::mpi::all_gather(comm, local, global);
+  std::map<int, Value> particles;
+  for (auto const &buffer : global) {
+    particles.insert(buffer.begin(), buffer.end());
+  }
+  return particles;
+}
+
+/** Positions and forces of all particles, on all ranks. */
+inline ParticleVectors
+gather_positions_and_forces(boost::mpi::communicator const &comm) {
+  return gather_particles(comm, [](Particle const &p) {
+    return std::make_pair(p.pos(), p.force());
+  });
+}
+
+/** Forces of all particles, on all ranks. */
+inline std::map<int, Utils::Vector3d>
+gather_forces(boost::mpi::communicator const &comm) {
+  return gather_particles(comm, [](Particle const &p) { return p.force(); });
+}
+
+/**
+ * @brief Compare the positions and forces of two runs.
+ * @param ref      Positions and forces of the reference run
+ * @param res      Positions and forces to check
+ * @param pos_tol  Absolute tolerance of the positions
+ * @param f_tol    Tolerance of the forces, relative to 1 + |f|
+ */
+inline void check_positions_and_forces(ParticleVectors const &ref,
+                                       ParticleVectors const &res,
+                                       double pos_tol, double f_tol) {
+  BOOST_REQUIRE_EQUAL(res.size(), ref.size());
+  for (auto const &kv : ref) {
+    auto const &pos_ref = kv.second.first;
+    auto const &f_ref = kv.second.second;
+    auto const &p = res.at(kv.first);
+    BOOST_CHECK_SMALL((p.first - pos_ref).norm(), pos_tol);
+    BOOST_CHECK_SMALL((p.second - f_ref).norm(), f_tol * (1. + f_ref.norm()));
+  }
+}
+
+/**
+ * @brief Compare the forces of two runs.
+ * @param ref      Forces of the reference run
+ * @param res      Forces to check
+ * @param tol      Tolerance, relative to 1 + |f|
+ */
+inline void check_forces(std::map<int, Utils::Vector3d> const &ref,
+                         std::map<int, Utils::Vector3d> const &res,
+                         double tol) {
+  BOOST_REQUIRE_EQUAL(res.size(), ref.size());
+  for (auto const &kv : ref) {
+    auto const &f_ref = kv.second;
+    BOOST_CHECK_SMALL((res.at(kv.first) - f_ref).norm(),
+                      tol * (1. + f_ref.norm()));
+  }
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE ghost communication overlap test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+#include "gather_particles.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "bonded_interactions/harmonic.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "config/config.hpp"
+#include "event.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+#ifdef LENNARD_JONES
+namespace {
+/**
+ * @brief Integrate a bonded Lennard-Jones system.
+ * @return Positions and forces after the integration.
+ */
+auto run(boost::mpi::communicator const &comm, bool overlap) {
+  ParticleFactory factory;
+  ::cell_structure.use_ghost_overlap = overlap;
+
+  // chains of particles along x on a perturbed lattice
+  auto constexpr n = 13;
+  auto const n_part = factory.create_perturbed_lattice(n, 16. / n, 0.05, 0.1);
+  for (int p = n * n; p < n_part; ++p) {
+    factory.insert_particle_bond(p, 0, {p - n * n});
+  }
+
+  integrate(0, -1);
+  // the ghost update of the next step is only started
+  cells_update_ghosts(global_ghost_flags(), overlap);
+  BOOST_CHECK_EQUAL(::cell_structure.ghosts_pending(), overlap);
+  ::cell_structure.ghosts_wait();
+  BOOST_CHECK(not ::cell_structure.ghosts_pending());
+
+  integrate(20, 0);
+  BOOST_CHECK(not ::cell_structure.ghosts_pending());
+
+  ::cell_structure.use_ghost_overlap = false;
+  return gather_positions_and_forces(comm);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ghost_overlap) {
+  auto const comm = boost::mpi::communicator();
+  espresso::system->set_box_l({16., 16., 16.});
+  espresso::system->set_node_grid({2, 2, 1});
+  espresso::system->set_time_step(0.005);
+  espresso::system->set_skin(0.3);
+  ::cell_structure.use_hot_particle_data = true;
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+
+  make_particle_type_exist(0);
+  ::nonbonded_ia_params[get_ia_param_key(0, 0)]->lj =
+      LJ_Parameters{1., 1., std::pow(2., 1. / 6.), 0., 0., 0.25};
+  on_non_bonded_ia_change();
+  auto const bond = HarmonicBond(10., 16. / 13., 2.);
+  bonded_ia_params.insert(0, std::make_shared<Bonded_IA_Parameters>(bond));
+  on_short_range_ia_change();
+
+  // cluster pair lists, compact Verlet lists and plain cell pairs
+  for (auto const &lists : {std::make_pair(true, false),
+                            std::make_pair(true, true),
+                            std::make_pair(false, false)}) {
+    ::cell_structure.use_verlet_list = lists.first;
+    ::cell_structure.use_compact_verlet_list = lists.second;
+    // the forces are summed in a different order
+    check_positions_and_forces(run(comm, false), run(comm, true), 1e-9, 1e-7);
+  }
+  ::cell_structure.use_verlet_list = true;
+  ::cell_structure.use_compact_verlet_list = false;
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  // the test case only works for 4 MPI ranks
+  boost::mpi::communicator world;
+  int error_code = 0;
+  if (world.size() == 4) {
+    error_code = boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+  }
+  return error_code;
+}
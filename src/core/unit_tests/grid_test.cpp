@@ -25,9 +25,12 @@
 
 #include <utils/Vector.hpp>
 
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 template <class T> static auto epsilon = std::numeric_limits<T>::epsilon();
 
@@ -308,3 +311,30 @@ BOOST_AUTO_TEST_CASE(regular_decomposition_test) {
         }
   }
 }
+
+BOOST_AUTO_TEST_CASE(regular_decomposition_boundaries_test) {
+  auto const box_l = Utils::Vector3d{10, 20, 30};
+  auto box = BoxGeometry();
+  box.set_length(box_l);
+  auto const node_grid = Utils::Vector3i{1, 2, 3};
+  auto const boundaries = std::array<std::vector<double>, 3>{
+      {{0., 1.}, {0., 0.25, 1.}, {0., 0.5, 0.6, 1.}}};
+
+  Utils::Vector3i node_pos;
+  for (node_pos[0] = 0; node_pos[0] < node_grid[0]; node_pos[0]++)
+    for (node_pos[1] = 0; node_pos[1] < node_grid[1]; node_pos[1]++)
+      for (node_pos[2] = 0; node_pos[2] < node_grid[2]; node_pos[2]++) {
+        auto const result =
+            regular_decomposition(box, node_pos, node_grid, boundaries);
+        for (std::size_t i = 0; i < 3; i++) {
+          auto const lower = boundaries[i][node_pos[i]] * box_l[i];
+          auto const upper = boundaries[i][node_pos[i] + 1] * box_l[i];
+          BOOST_CHECK_CLOSE(result.my_left()[i], lower, 1e-12);
+          BOOST_CHECK_CLOSE(result.my_right()[i], upper, 1e-12);
+          BOOST_CHECK_CLOSE(result.length()[i], upper - lower, 1e-12);
+          BOOST_CHECK_EQUAL(result.boundary()[2 * i], node_pos[i] == 0);
+          BOOST_CHECK_EQUAL(result.boundary()[2 * i + 1],
+                            -(node_pos[i] == node_grid[i] - 1));
+        }
+      }
+}
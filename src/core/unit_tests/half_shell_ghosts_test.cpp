@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE half shell ghost import test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+#include "gather_particles.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "bonded_interactions/bonded_interaction_data.hpp"
+#include "bonded_interactions/harmonic.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "config/config.hpp"
+#include "energy.hpp"
+#include "errorhandling.hpp"
+#include "event.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+#ifdef LENNARD_JONES
+namespace {
+/**
+ * @brief Integrate a Lennard-Jones fluid.
+ * @return Positions and forces after the integration, and the total
+ * number of ghosts after the first force calculation.
+ */
+auto run(boost::mpi::communicator const &comm, bool half_shell) {
+  ParticleFactory factory;
+  ::cell_structure.use_half_shell_ghosts = half_shell;
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+  BOOST_CHECK_EQUAL(::cell_structure.has_half_shell_ghosts(), half_shell);
+
+  factory.create_perturbed_lattice(10, 1.2, 0.1, 0.5);
+
+  integrate(0, -1);
+  auto const n_ghosts = boost::mpi::all_reduce(
+      comm, static_cast<int>(::cell_structure.ghost_particles().size()),
+      std::plus<int>());
+  integrate(20, 0);
+
+  ::cell_structure.use_half_shell_ghosts = false;
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+  return std::make_pair(gather_positions_and_forces(comm), n_ghosts);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(half_shell_ghosts) {
+  auto const comm = boost::mpi::communicator();
+  espresso::system->set_box_l({12., 12., 12.});
+  espresso::system->set_time_step(0.005);
+  espresso::system->set_skin(0.4);
+
+  make_particle_type_exist(0);
+  ::nonbonded_ia_params[get_ia_param_key(0, 0)]->lj =
+      LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+  on_non_bonded_ia_change();
+
+  // the half shell spans different directions of the node grid
+  for (auto const &node_grid :
+       {Utils::Vector3i{2, 2, 1}, Utils::Vector3i{1, 2, 2},
+        Utils::Vector3i{2, 1, 2}, Utils::Vector3i{4, 1, 1},
+        Utils::Vector3i{1, 1, 4}}) {
+    espresso::system->set_node_grid(node_grid);
+    auto const reference = run(comm, false);
+    auto const half_shell = run(comm, true);
+    // roughly half of the ghosts are imported
+    BOOST_CHECK_LT(half_shell.second, 0.7 * reference.second);
+    // the forces are summed in a different order
+    check_positions_and_forces(reference.first, half_shell.first, 1e-9, 1e-7);
+  }
+
+  // neighbor searches are incomplete at the boundaries of the local box
+  {
+    ParticleFactory factory;
+    factory.create_particle({1., 1., 1.}, 0, 0);
+    ::cell_structure.use_half_shell_ghosts = true;
+    cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+    BOOST_CHECK_THROW(particle_short_range_energy_contribution(0),
+                      std::runtime_error);
+    ::cell_structure.use_half_shell_ghosts = false;
+    cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+    BOOST_CHECK(not ::cell_structure.has_half_shell_ghosts());
+  }
+
+  // bonds across the boundaries of the local box need the lower half shell
+  {
+    ParticleFactory factory;
+    factory.create_particle({1., 1., 1.}, 0, 0);
+    ::cell_structure.use_half_shell_ghosts = true;
+    cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+    bonded_ia_params.insert(
+        0, std::make_shared<Bonded_IA_Parameters>(HarmonicBond(1., 1., 2.)));
+    on_short_range_ia_change();
+    integrate(0, -1);
+    BOOST_CHECK_EQUAL(check_runtime_errors(comm), comm.size());
+    flush_runtime_errors_local();
+    bonded_ia_params.erase(0);
+    on_short_range_ia_change();
+    integrate(0, -1);
+    BOOST_CHECK_EQUAL(check_runtime_errors(comm), 0);
+    ::cell_structure.use_half_shell_ghosts = false;
+    cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+  }
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  // the test case only works for 4 MPI ranks
+  boost::mpi::communicator world;
+  int error_code = 0;
+  if (world.size() == 4) {
+    error_code = boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+  }
+  return error_code;
+}
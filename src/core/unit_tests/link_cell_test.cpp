@@ -21,11 +21,14 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include "algorithm/color_cells.hpp"
 #include "algorithm/link_cell.hpp"
 
 #include "Particle.hpp"
 #include "cell_system/Cell.hpp"
 
+#include <algorithm>
+#include <set>
 #include <utility>
 #include <vector>
 
@@ -72,3 +75,54 @@ BOOST_AUTO_TEST_CASE(link_cell) {
       ++it;
     }
 }
+
+BOOST_AUTO_TEST_CASE(color_cells) {
+  /* 1D chain of cells, each cell writes to itself and its right neighbor */
+  auto const n_cells = 11;
+  std::vector<Cell> cells(n_cells);
+  std::vector<Cell *> cell_ptrs;
+  for (int i = 0; i < n_cells; ++i) {
+    std::vector<Cell *> red;
+    if (i + 1 < n_cells)
+      red.push_back(&cells[i + 1]);
+    cells[i].m_neighbors = Neighbors<Cell *>(red, {});
+    cell_ptrs.push_back(&cells[i]);
+  }
+
+  auto const colors = Algorithm::color_cells(cell_ptrs);
+
+  /* alternating colors */
+  BOOST_REQUIRE_EQUAL(colors.size(), 2);
+  BOOST_CHECK_EQUAL(colors[0].size(), 6);
+  BOOST_CHECK_EQUAL(colors[1].size(), 5);
+
+  /* every cell appears exactly once, in input order within a color */
+  std::set<Cell *> visited;
+  for (auto const &color : colors) {
+    BOOST_CHECK(std::is_sorted(color.begin(), color.end()));
+    /* write sets within a color are disjoint */
+    std::set<Cell *> written;
+    for (auto cell : color) {
+      BOOST_CHECK(visited.insert(cell).second);
+      BOOST_CHECK(written.insert(cell).second);
+      for (auto neighbor : cell->neighbors().red()) {
+        BOOST_CHECK(written.insert(neighbor).second);
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(visited.size(), n_cells);
+
+  /* fully connected cells can't be processed concurrently */
+  std::vector<Cell> clique(4);
+  std::vector<Cell *> clique_ptrs;
+  for (auto &c : clique) {
+    std::vector<Cell *> red;
+    for (auto &n : clique) {
+      if (&n > &c)
+        red.push_back(&n);
+    }
+    c.m_neighbors = Neighbors<Cell *>(red, {});
+    clique_ptrs.push_back(&c);
+  }
+  BOOST_CHECK_EQUAL(Algorithm::color_cells(clique_ptrs).size(), 4);
+}
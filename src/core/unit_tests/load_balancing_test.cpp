@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE load balancing test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+#include "gather_particles.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "cells.hpp"
+#include "communication.hpp"
+#include "config/config.hpp"
+#include "event.hpp"
+#include "grid.hpp"
+#include "integrate.hpp"
+#include "load_balancing.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+namespace {
+void check_boundaries(std::vector<double> const &boundaries,
+                      std::vector<double> const &reference) {
+  BOOST_REQUIRE_EQUAL(boundaries.size(), reference.size());
+  for (std::size_t k = 0; k < reference.size(); ++k) {
+    BOOST_CHECK_SMALL(boundaries[k] - reference[k], 1e-12);
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(balance_slabs) {
+  using LoadBalancing::balance_slabs;
+  auto const boundaries = std::vector<double>{0., 4., 8., 12.};
+
+  // evenly loaded slabs are kept
+  check_boundaries(balance_slabs(boundaries, {2., 2., 2.}, 0.), boundaries);
+
+  // the load is assumed to be spread evenly within a slab
+  check_boundaries(balance_slabs(boundaries, {3., 0., 0.}, 0.),
+                   {0., 4. / 3., 8. / 3., 12.});
+  check_boundaries(balance_slabs(boundaries, {1., 1., 4.}, 0.),
+                   {0., 8., 10., 12.});
+
+  // slabs are kept wider than the minimal width
+  check_boundaries(balance_slabs(boundaries, {3., 0., 0.}, 3.),
+                   {0., 3., 6., 12.});
+  check_boundaries(balance_slabs(boundaries, {0., 0., 3.}, 3.),
+                   {0., 6., 9., 12.});
+
+  // no balancing without load or with too large minimal width
+  check_boundaries(balance_slabs(boundaries, {0., 0., 0.}, 0.), boundaries);
+  check_boundaries(balance_slabs(boundaries, {3., 0., 0.}, 5.), boundaries);
+}
+
+BOOST_AUTO_TEST_CASE(imbalance) {
+  using LoadBalancing::imbalance;
+  BOOST_CHECK_EQUAL(imbalance({}), 0.);
+  BOOST_CHECK_EQUAL(imbalance({0., 0.}), 0.);
+  BOOST_CHECK_CLOSE(imbalance({1., 1., 1., 1.}), 0., 1e-12);
+  BOOST_CHECK_CLOSE(imbalance({4., 0., 0., 0.}), 3., 1e-12);
+  BOOST_CHECK_CLOSE(imbalance({2., 1., 1., 0.}), 1., 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(parameters) {
+  using LoadBalancing::Parameters;
+  BOOST_CHECK_THROW(LoadBalancing::set_parameters({-1}), std::domain_error);
+  BOOST_CHECK_THROW(
+      LoadBalancing::set_parameters({1, LoadBalancing::Metric::NPART, -0.1}),
+      std::domain_error);
+  BOOST_CHECK_EQUAL(LoadBalancing::get_parameters().interval, 0);
+}
+
+#ifdef LENNARD_JONES
+BOOST_FIXTURE_TEST_CASE(rebalance_regular_decomposition, ParticleFactory) {
+  auto const comm = boost::mpi::communicator();
+  espresso::system->set_box_l({16., 8., 8.});
+  espresso::system->set_node_grid({4, 1, 1});
+  espresso::system->set_time_step(0.01);
+  espresso::system->set_skin(0.2);
+
+  make_particle_type_exist(0);
+  ::nonbonded_ia_params[get_ia_param_key(0, 0)]->lj =
+      LJ_Parameters{1., 0.8, 2., 0., 0., 0.};
+  on_non_bonded_ia_change();
+
+  // a slab of particles in the left quarter of the box
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> noise(-0.05, 0.05);
+  auto pid = 0;
+  for (int i = 0; i < 6; ++i) {
+    for (int j = 0; j < 8; ++j) {
+      for (int k = 0; k < 8; ++k) {
+        auto const pos = Utils::Vector3d{0.5 + i + noise(gen),
+                                         0.5 + j + noise(gen),
+                                         0.5 + k + noise(gen)};
+        create_particle(pos, pid++, 0);
+      }
+    }
+  }
+  auto const n_part = pid;
+
+  integrate(0, -1);
+  auto const forces_ref = gather_forces(comm);
+  BOOST_REQUIRE(has_uniform_node_domains());
+  BOOST_REQUIRE(local_geo.uniform());
+  auto const comm_cart_ref = ::comm_cart;
+
+  // local particles of the ranks: 256, 128, 0, 0
+  auto const imbalance = LoadBalancing::rebalance();
+  BOOST_CHECK_CLOSE(imbalance, 256. / 96. - 1., 1e-10);
+  BOOST_REQUIRE(not has_uniform_node_domains());
+  BOOST_CHECK(not local_geo.uniform());
+  // only the local boxes change, the Cartesian communicator is kept
+  BOOST_CHECK(::comm_cart == comm_cart_ref);
+
+  // boundaries are shifted to the dense region
+  auto const boundaries = get_node_domain_boundaries();
+  auto const min_width = interaction_range() / 16.;
+  BOOST_REQUIRE_EQUAL(boundaries[0].size(), 5u);
+  BOOST_CHECK_EQUAL(boundaries[1].size(), 2u);
+  BOOST_CHECK_EQUAL(boundaries[2].size(), 2u);
+  for (std::size_t k = 0; k < 4; ++k) {
+    BOOST_CHECK_GE(boundaries[0][k + 1] - boundaries[0][k], min_width);
+  }
+  BOOST_CHECK_LT(boundaries[0][3], 0.5);
+  BOOST_CHECK_CLOSE(local_geo.length()[0],
+                    16. * (boundaries[0][comm.rank() + 1] -
+                           boundaries[0][comm.rank()]),
+                    1e-10);
+
+  // forces don't depend on the decomposition
+  integrate(0, -1);
+  auto const forces = gather_forces(comm);
+  BOOST_REQUIRE_EQUAL(forces.size(), static_cast<std::size_t>(n_part));
+  check_forces(forces_ref, forces, 1e-10);
+
+  // the load is more even than before
+  auto const n_local = static_cast<double>(
+      cell_structure.local_particles().size());
+  std::vector<double> loads;
+  boost::mpi::all_gather(comm, n_local, loads);
+  BOOST_CHECK_LT(LoadBalancing::imbalance(loads), imbalance);
+
+  // periodic balancing during integration keeps all particles
+  LoadBalancing::set_parameters({5, LoadBalancing::Metric::NPART, 0.1});
+  integrate(20, 0);
+  auto const n_part_total = boost::mpi::all_reduce(
+      comm, static_cast<int>(cell_structure.local_particles().size()),
+      std::plus<>());
+  BOOST_CHECK_EQUAL(n_part_total, n_part);
+  LoadBalancing::set_parameters({});
+
+  // a new node grid divides the box evenly
+  espresso::system->set_node_grid({4, 1, 1});
+  BOOST_CHECK(has_uniform_node_domains());
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  // the test case only works for 4 MPI ranks
+  boost::mpi::communicator world;
+  int error_code = 0;
+  if (world.size() == 4) {
+    error_code = boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+  }
+  return error_code;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE mixed precision test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "config/config.hpp"
+#include "energy.hpp"
+#include "event.hpp"
+#include "integrate.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <boost/mpi.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+#ifdef LENNARD_JONES
+namespace {
+/**
+ * @brief Energy fluctuation and drift of a Lennard-Jones fluid in the NVE
+ * ensemble, per particle.
+ * @return The largest deviation from the initial energy and the
+ * difference between the initial and final energy.
+ */
+auto energy_drift(bool mixed_precision) {
+  ParticleFactory factory;
+  ::cell_structure.use_mixed_precision = mixed_precision;
+
+  // particles on a perturbed lattice with random velocities
+  auto const n_part =
+      static_cast<double>(factory.create_perturbed_lattice(8, 1.125, 0.05, 1.));
+
+  auto const total_energy = []() { return calculate_energy()->accumulate(); };
+  integrate(0, -1);
+  auto const initial_energy = total_energy();
+  auto max_deviation = 0.;
+  auto energy = initial_energy;
+  for (int i = 0; i < 20; ++i) {
+    integrate(100, 0);
+    energy = total_energy();
+    max_deviation = std::max(max_deviation, std::abs(energy - initial_energy));
+  }
+
+  ::cell_structure.use_mixed_precision = false;
+  return std::make_pair(max_deviation / n_part,
+                        std::abs(energy - initial_energy) / n_part);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(energy_conservation) {
+  espresso::system->set_box_l({9., 9., 9.});
+  espresso::system->set_time_step(0.005);
+  espresso::system->set_skin(0.4);
+  ::cell_structure.use_hot_particle_data = true;
+  // the cluster pair kernel requires the regular decomposition
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+
+  make_particle_type_exist(0);
+  // shifted potential, such that the energy is continuous at the cutoff
+  auto const shift = std::pow(2.5, -6) - std::pow(2.5, -12);
+  ::nonbonded_ia_params[get_ia_param_key(0, 0)]->lj =
+      LJ_Parameters{1., 1., 2.5, 0., 0., shift};
+  on_non_bonded_ia_change();
+
+  auto const reference = energy_drift(false);
+  auto const mixed = energy_drift(true);
+  if (boost::mpi::communicator().rank() == 0) {
+    BOOST_TEST_MESSAGE("double precision: fluctuation "
+                       << reference.first << ", drift " << reference.second);
+    BOOST_TEST_MESSAGE("mixed precision: fluctuation "
+                       << mixed.first << ", drift " << mixed.second);
+    // the integrator error dominates in both modes
+    BOOST_CHECK_LT(reference.first, 1e-3);
+    BOOST_CHECK_LT(mixed.first, 1e-3);
+    BOOST_CHECK_LT(mixed.second, 2. * reference.second + 1e-4);
+  }
+}
+#endif // LENNARD_JONES
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -21,14 +21,27 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include "config/config.hpp"
 #include "p3m/common.hpp"
+#if defined(P3M) || defined(DP3M)
+#include "p3m/TuningCache.hpp"
+#include "p3m/influence_function.hpp"
+#include "p3m/interpolation.hpp"
+#endif
 
 #include <utils/Vector.hpp>
+#include <utils/constants.hpp>
+#include <utils/math/sqr.hpp>
 
 #include <array>
+#include <cmath>
 #include <cstddef>
+#include <cstdio>
+#include <fstream>
 #include <limits>
+#include <random>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 BOOST_AUTO_TEST_CASE(calc_meshift_false) {
@@ -83,4 +96,219 @@ BOOST_AUTO_TEST_CASE(analytic_cotangent_sum) {
     BOOST_CHECK_THROW(kernel(1, 0., invalid_cao), std::logic_error);
   }
 }
+
+BOOST_AUTO_TEST_CASE(parallel_assign) {
+  auto constexpr cao = 3;
+  P3MLocalMesh local_mesh{};
+  local_mesh.dim = Utils::Vector3i{{11, 9, 8}};
+  local_mesh.size = local_mesh.dim[0] * local_mesh.dim[1] * local_mesh.dim[2];
+  local_mesh.q_2_off = local_mesh.dim[2] - cao;
+  local_mesh.q_21_off = local_mesh.dim[2] * (local_mesh.dim[1] - cao);
+  auto const ai = Utils::Vector3d::broadcast(1.);
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  auto const n_points = std::size_t{200};
+  std::vector<Utils::Vector3d> positions(n_points);
+  std::vector<double> charges(n_points);
+  for (std::size_t i = 0; i < n_points; ++i) {
+    for (std::size_t d = 0; d < 3; ++d) {
+      positions[i][d] = (local_mesh.dim[d] - cao + 1) * uniform(gen);
+    }
+    charges[i] = uniform(gen) - 0.5;
+  }
+
+  // reference: sequential assignment in the order of the points
+  p3m_interpolation_cache ref_cache;
+  ref_cache.reset(cao);
+  std::vector<double> ref_mesh(local_mesh.size);
+  for (std::size_t i = 0; i < n_points; ++i) {
+    auto const w = p3m_calculate_interpolation_weights<cao>(positions[i], ai,
+                                                            local_mesh);
+    ref_cache.store(w);
+    p3m_interpolate(local_mesh, w, [&](int ind, double w) {
+      ref_mesh[ind] += w * charges[i];
+    });
+  }
+
+  // weights stored at given indices are the same
+  p3m_interpolation_cache cache;
+  cache.reset(cao);
+  cache.resize(n_points);
+  BOOST_REQUIRE_EQUAL(cache.size(), n_points);
+  for (std::size_t i = n_points; i-- > 0;) {
+    cache.store(i, p3m_calculate_interpolation_weights<cao>(
+                       positions[i], ai, local_mesh));
+  }
+  for (std::size_t i = 0; i < n_points; ++i) {
+    auto const ref = ref_cache.load<cao>(i);
+    auto const w = cache.load<cao>(i);
+    BOOST_CHECK_EQUAL(cache.corner(i), ref.ind);
+    BOOST_CHECK_EQUAL(w.ind, ref.ind);
+    for (std::size_t j = 0; j < static_cast<std::size_t>(cao); ++j) {
+      BOOST_CHECK_EQUAL(w.w_x[j], ref.w_x[j]);
+      BOOST_CHECK_EQUAL(w.w_y[j], ref.w_y[j]);
+      BOOST_CHECK_EQUAL(w.w_z[j], ref.w_z[j]);
+    }
+  }
+
+  // every point is assigned exactly once, in a different order
+  for (auto const n_threads : {1, 4}) {
+    std::vector<double> mesh(local_mesh.size);
+    std::vector<int> visits(n_points);
+    p3m_parallel_assign<cao>(local_mesh, cache, n_threads,
+                             [&](std::size_t i, int ind, double w) {
+                               mesh[ind] += w * charges[i];
+                               ++visits[i];
+                             });
+    for (std::size_t i = 0; i < n_points; ++i) {
+      BOOST_CHECK_EQUAL(visits[i], cao * cao * cao);
+    }
+    for (std::size_t i = 0; i < mesh.size(); ++i) {
+      BOOST_CHECK_SMALL(mesh[i] - ref_mesh[i], 1e-14);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(interpolation_gradient) {
+  auto constexpr cao = 4;
+  P3MLocalMesh local_mesh{};
+  local_mesh.dim = Utils::Vector3i{{9, 8, 10}};
+  local_mesh.size = local_mesh.dim[0] * local_mesh.dim[1] * local_mesh.dim[2];
+  local_mesh.q_2_off = local_mesh.dim[2] - cao;
+  local_mesh.q_21_off = local_mesh.dim[2] * (local_mesh.dim[1] - cao);
+  local_mesh.ld_pos[0] = -0.3;
+  local_mesh.ld_pos[1] = 0.2;
+  local_mesh.ld_pos[2] = 0.1;
+  auto const ai = Utils::Vector3d{{2., 1.5, 1.}};
+
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::vector<double> field(local_mesh.size);
+  for (auto &value : field) {
+    value = uniform(gen) - 0.5;
+  }
+  auto const interpolate = [&](Utils::Vector3d const &pos) {
+    auto value = 0.;
+    p3m_interpolate(
+        local_mesh,
+        p3m_calculate_interpolation_weights<cao>(pos, ai, local_mesh),
+        [&](int ind, double w) { value += w * field[ind]; });
+    return value;
+  };
+
+  // the gradient weights are the derivatives of the interpolation weights
+  auto const h = 1e-6;
+  for (int i = 0; i < 20; ++i) {
+    Utils::Vector3d pos;
+    for (std::size_t d = 0; d < 3; ++d) {
+      pos[d] = local_mesh.ld_pos[d] +
+               (1. + (local_mesh.dim[d] - cao - 1) * uniform(gen)) / ai[d];
+    }
+    auto const w =
+        p3m_calculate_interpolation_gradient_weights<cao>(pos, ai, local_mesh);
+    auto const w_ref =
+        p3m_calculate_interpolation_weights<cao>(pos, ai, local_mesh);
+    BOOST_CHECK_EQUAL(w.ind, w_ref.ind);
+    Utils::Vector3d grad{};
+    p3m_interpolate_gradient(local_mesh, w,
+                             [&](int ind, Utils::Vector3d const &dw) {
+                               grad += dw * field[ind];
+                             });
+    grad = Utils::hadamard_product(grad, ai);
+    for (std::size_t d = 0; d < 3; ++d) {
+      auto shift = Utils::Vector3d{};
+      shift[d] = h;
+      auto const grad_ref =
+          (interpolate(pos + shift) - interpolate(pos - shift)) / (2. * h);
+      BOOST_CHECK_SMALL(grad[d] - grad_ref, 1e-7);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(influence_function_ad) {
+  auto constexpr tol = 8. * 100. * std::numeric_limits<double>::epsilon();
+  auto const h = Utils::Vector3d{{0.5, 0.4, 0.6}};
+  auto const k = Utils::Vector3d{{1.1, -0.7, 2.3}};
+
+  // without aliasing terms, ad and ik influence functions are the same
+  for (int cao = 2; cao <= 7; ++cao) {
+    BOOST_CHECK_CLOSE((G_opt_ad<0>(cao, 1.2, k, h)),
+                      (G_opt<1, 0>(cao, 1.2, k, h)), tol);
+    BOOST_CHECK_GT((G_opt_ad<1>(cao, 1.2, k, h)), 0.);
+  }
+  BOOST_CHECK_EQUAL((G_opt_ad<1>(5, 1.2, Utils::Vector3d{}, h)), 0.);
+}
+
+BOOST_AUTO_TEST_CASE(influence_function_box_scaling) {
+  auto constexpr tol = 1e-10;
+  auto const box_l = Utils::Vector3d{{5., 6., 7.}};
+  auto const mesh = Utils::Vector3d{{10., 12., 14.}};
+  auto const n = Utils::Vector3d{{3., -2., 5.}};
+  auto constexpr alpha_L = 4.;
+
+  // isotropic box scaling with fixed alpha_L scales G with the box length
+  auto const G = [&](double scale, int cao) {
+    auto const L = scale * box_l;
+    auto const k = 2. * Utils::pi() * Utils::hadamard_division(n, L);
+    auto const h = Utils::hadamard_division(L, mesh);
+    auto const alpha = alpha_L / L[0];
+    return std::array<double, 3>{{G_opt<0, 0>(cao, alpha, k, h),
+                                  G_opt<1, 0>(cao, alpha, k, h),
+                                  G_opt_ad<1>(cao, alpha, k, h)}};
+  };
+  for (int cao = 2; cao <= 7; ++cao) {
+    for (auto const scale : {0.9, 1.05}) {
+      auto const ref = G(scale, cao);
+      auto const res = G(1., cao);
+      for (std::size_t i = 0; i < ref.size(); ++i) {
+        BOOST_CHECK_CLOSE(Utils::sqr(scale) * res[i], ref[i], tol);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(tuning_cache) {
+  auto const path = std::string("p3m_tuning_cache_test.txt");
+  std::remove(path.c_str());
+  TuningCache const cache(path);
+  BOOST_CHECK(cache.load().empty());
+
+  auto signature = TuningCache::Entry{"CoulombP3M", {10., 0.1}, {8., 1.}, {}};
+  BOOST_CHECK(not cache.find(signature));
+
+  // values are read back exactly
+  auto entry = signature;
+  entry.parameters = {16., 5., 1. / 3., std::sqrt(2.)};
+  cache.store(entry);
+  entry.particles = {8., 2.};
+  entry.parameters = {24., 6., 0.1, 0.2};
+  cache.store(entry);
+  // lines that cannot be parsed are ignored
+  std::ofstream(path, std::ios::app) << "CoulombP3M | 10 | 8 1\n"
+                                     << "CoulombP3M | 10 0.1 | 8 1 | 4 x\n";
+  entry.name = "DipolarP3M";
+  entry.particles = {8., 1.};
+  cache.store(entry);
+  BOOST_REQUIRE_EQUAL(cache.load().size(), 3ul);
+
+  // exact match
+  auto const exact = cache.find(signature);
+  BOOST_REQUIRE(exact);
+  BOOST_CHECK_EQUAL(exact->name, "CoulombP3M");
+  BOOST_CHECK(exact->particles == signature.particles);
+  BOOST_CHECK((exact->parameters ==
+               std::vector<double>{16., 5., 1. / 3., std::sqrt(2.)}));
+
+  // matching system, most recent particle signature
+  signature.particles = {9., 1.};
+  auto const similar = cache.find(signature);
+  BOOST_REQUIRE(similar);
+  BOOST_CHECK((similar->particles == std::vector<double>{8., 2.}));
+
+  // different system
+  signature.system = {10., 0.2};
+  BOOST_CHECK(not cache.find(signature));
+  std::remove(path.c_str());
+}
 #endif // defined(P3M) || defined(DP3M)
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE spline tabulation test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "config/config.hpp"
+
+#include "energy_inline.hpp"
+#include "forces_inline.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+#include "nonbonded_interactions/spline_tabulation.hpp"
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(parameters) {
+  BOOST_CHECK_THROW(SplineTabulation_Parameters(-0.1, 1e-3), std::domain_error);
+  BOOST_CHECK_THROW(SplineTabulation_Parameters(0.5, 0.), std::domain_error);
+  BOOST_CHECK(not SplineTabulation_Parameters{}.is_tabulated());
+}
+
+#if defined(LENNARD_JONES) and defined(GAUSSIAN)
+BOOST_AUTO_TEST_CASE(tabulation) {
+  using namespace CentralForceKernel;
+  auto const accuracy = 1e-6;
+  IA_parameters ia_params{};
+  ia_params.lj = LJ_Parameters{1., 1., 2.5, 0., 0., 0.};
+  ia_params.gaussian = Gaussian_Parameters{2., 0.8, 2.5};
+
+  // disabled tabulation
+  tabulate_central_potentials(ia_params);
+  BOOST_CHECK(not ia_params.spline_tabulation.is_tabulated());
+
+  ia_params.spline_tabulation = SplineTabulation_Parameters{0.8, accuracy};
+  tabulate_central_potentials(ia_params);
+  auto const &spline = ia_params.spline_tabulation;
+  BOOST_REQUIRE(spline.is_tabulated());
+  BOOST_CHECK_EQUAL(spline.max, 2.5);
+  BOOST_CHECK_EQUAL(spline.force_coeffs.size(), spline.energy_coeffs.size());
+
+  // the spline kernel is selected for the pair of particle types
+  make_particle_type_exist(0);
+  get_ia_param(0, 0) = ia_params;
+  maximal_cutoff_nonbonded();
+  BOOST_CHECK_EQUAL(get_ia_param(0, 0).central_force_kernel, KERNEL_SPLINE);
+
+  // interpolation error between the nodes
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> noise(0.8, 2.5);
+  for (int i = 0; i < 10000; ++i) {
+    auto const dist = noise(gen);
+    auto const force = calc_central_radial_force_factor(ia_params, dist);
+    auto const energy = calc_central_radial_energy(ia_params, dist);
+    auto const force_spline =
+        dispatch_central_radial_force_factor(get_ia_param(0, 0), dist);
+    BOOST_CHECK_SMALL((force_spline - force) * dist, 2. * accuracy);
+    BOOST_CHECK_SMALL(spline.energy(dist) - energy, 2. * accuracy);
+  }
+
+  // analytic potentials below the table, no interaction beyond the cutoff
+  BOOST_CHECK_EQUAL(
+      dispatch_central_radial_force_factor(get_ia_param(0, 0), 0.7),
+      calc_central_radial_force_factor(ia_params, 0.7));
+  BOOST_CHECK_EQUAL(
+      dispatch_central_radial_force_factor(get_ia_param(0, 0), 2.5), 0.);
+  BOOST_CHECK_EQUAL(spline.energy(2.6), 0.);
+
+  // unreachable accuracy
+  ia_params.spline_tabulation = SplineTabulation_Parameters{0.05, 1e-12};
+  BOOST_CHECK_THROW(tabulate_central_potentials(ia_params),
+                    std::runtime_error);
+  BOOST_CHECK(not ia_params.spline_tabulation.is_tabulated());
+
+  // nothing to tabulate beyond the cutoff
+  ia_params.spline_tabulation = SplineTabulation_Parameters{3., accuracy};
+  tabulate_central_potentials(ia_params);
+  BOOST_CHECK(not ia_params.spline_tabulation.is_tabulated());
+}
+#endif
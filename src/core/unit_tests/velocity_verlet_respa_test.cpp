@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_NO_MAIN
+#define BOOST_TEST_MODULE multiple time step integrator test
+#define BOOST_TEST_ALTERNATIVE_INIT_API
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "ParticleFactory.hpp"
+#include "gather_particles.hpp"
+
+#include "EspressoSystemStandAlone.hpp"
+#include "cell_system/CellStructureType.hpp"
+#include "cells.hpp"
+#include "config/config.hpp"
+#include "event.hpp"
+#include "integrate.hpp"
+#include "integrators/velocity_verlet_respa.hpp"
+#include "magnetostatics/dipolar_direct_sum.hpp"
+#include "magnetostatics/registration.hpp"
+#include "nonbonded_interactions/lj.hpp"
+#include "nonbonded_interactions/nonbonded_interaction_data.hpp"
+
+#include <utils/Vector.hpp>
+
+#include <boost/mpi.hpp>
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace espresso {
+// ESPResSo system instance
+static std::unique_ptr<EspressoSystemStandAlone> system;
+} // namespace espresso
+
+BOOST_AUTO_TEST_CASE(long_range_weights) {
+  BOOST_CHECK_THROW(VelocityVerletRespaParameters{0}, std::domain_error);
+  BOOST_CHECK_THROW(VelocityVerletRespaParameters{-2}, std::domain_error);
+
+  // the long-range forces are applied as an impulse every third step
+  register_integrator(VelocityVerletRespaParameters{3});
+  BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(true), 3.);
+  for (int i = 0; i < 3; ++i) {
+    BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(false), 0.);
+    BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(false), 0.);
+    BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(false), 3.);
+  }
+  // a force recalculation starts a new outer time step
+  BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(false), 0.);
+  BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(true), 3.);
+  BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(false), 0.);
+
+  // without splitting, every step gets the full long-range force
+  register_integrator(VelocityVerletRespaParameters{1});
+  BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(true), 1.);
+  BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(false), 1.);
+  BOOST_CHECK_EQUAL(velocity_verlet_respa_long_range_weight(false), 1.);
+}
+
+#if defined(LENNARD_JONES) and defined(DIPOLES)
+namespace {
+/** Positions and velocities of all particles, on all ranks. */
+auto get_particles(boost::mpi::communicator const &comm) {
+  return gather_particles(comm, [](Particle const &p) {
+    return std::make_pair(p.pos(), p.v());
+  });
+}
+
+/**
+ * @brief Integrate a system of WCA dipoles.
+ * @param comm        MPI communicator
+ * @param interval    Multiple time step interval, 0 for velocity Verlet
+ * @param n_steps     Number of steps of each call to @ref integrate
+ * @param reuse       Whether forces are reused between calls
+ * @return Positions and velocities after 12 time steps.
+ */
+auto run(boost::mpi::communicator const &comm, int interval, int n_steps,
+         bool reuse) {
+  ParticleFactory factory;
+  if (interval == 0) {
+    set_integ_switch(INTEG_METHOD_NVT);
+  } else {
+    register_integrator(VelocityVerletRespaParameters{interval});
+    set_integ_switch(INTEG_METHOD_NVT_RESPA);
+  }
+
+  auto const n_part = factory.create_perturbed_lattice(4, 2., 0.1, 0.5);
+  for (int pid = 0; pid < n_part; ++pid) {
+    factory.set_particle_property(pid, &Particle::dipm,
+                                  (pid % 2 == 0) ? 1. : -1.);
+  }
+
+  auto const n_calls = 12 / n_steps;
+  for (int i = 0; i < n_calls; ++i) {
+    integrate(n_steps, (reuse and i != 0) ? 1 : -1);
+  }
+  return get_particles(comm);
+}
+
+void check_trajectories(ParticleVectors const &ref,
+                        ParticleVectors const &traj, double tol) {
+  BOOST_REQUIRE_EQUAL(traj.size(), ref.size());
+  for (auto const &kv : ref) {
+    auto const &p = traj.at(kv.first);
+    BOOST_CHECK_SMALL((p.first - kv.second.first).norm(), tol);
+    BOOST_CHECK_SMALL((p.second - kv.second.second).norm(), 10. * tol);
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(multiple_time_step_integration) {
+  auto const comm = boost::mpi::communicator();
+  espresso::system->set_box_l({8., 8., 8.});
+  espresso::system->set_time_step(0.005);
+  espresso::system->set_skin(0.4);
+  cells_re_init(CellStructureType::CELL_STRUCTURE_REGULAR);
+
+  make_particle_type_exist(0);
+  ::nonbonded_ia_params[get_ia_param_key(0, 0)]->lj =
+      LJ_Parameters{1., 1., std::pow(2., 1. / 6.), 0., 0., 0.25};
+  on_non_bonded_ia_change();
+  auto const solver = std::make_shared<DipolarDirectSum>(2., 0);
+  Dipoles::add_actor(solver);
+
+  auto const reference = run(comm, 0, 12, false);
+
+  // without splitting, the integrator reduces to velocity Verlet
+  check_trajectories(reference, run(comm, 1, 12, false), 1e-12);
+
+  // the outer time step is preserved across calls to the integrator,
+  // both when forces are recalculated at an outer step boundary and
+  // when they are reused in the middle of an outer step
+  for (auto const interval : {2, 3}) {
+    auto const respa = run(comm, interval, 12, false);
+    check_trajectories(respa, run(comm, interval, interval, false), 1e-10);
+    check_trajectories(respa, run(comm, interval, 4, true), 1e-10);
+    check_trajectories(respa, run(comm, interval, 2, true), 1e-10);
+    // the splitting changes the trajectory only slightly
+    auto deviation = 0.;
+    for (auto const &kv : reference) {
+      deviation += (respa.at(kv.first).first - kv.second.first).norm();
+    }
+    BOOST_CHECK_GT(deviation, 0.);
+    check_trajectories(reference, respa, 1e-4);
+  }
+
+  Dipoles::remove_actor(solver);
+  set_integ_switch(INTEG_METHOD_NVT);
+}
+#endif // LENNARD_JONES and DIPOLES
+
+int main(int argc, char **argv) {
+  espresso::system = std::make_unique<EspressoSystemStandAlone>(argc, argv);
+  return boost::unit_test::unit_test_main(init_unit_test, argc, argv);
+}
@@ -32,10 +32,56 @@ class CellSystem(ScriptInterfaceHelper):
         Name of the currently active particle decomposition.
     use_verlet_lists : :obj:`bool`
         Whether to use Verlet lists.
+    use_hot_particle_data : :obj:`bool`
+        Whether to run the short-range force loop on contiguous arrays of
+        the positions, types, charges and forces of the particles, which
+        are gathered once per force calculation. Required by the cluster
+        pair lists, the compact Verlet lists, the mixed precision and the
+        ghost overlap.
+    use_compact_verlet_lists : :obj:`bool`
+        Whether to store the Verlet lists of the short-range force loop
+        as compressed rows of 32-bit particle indices, which needs about
+        a quarter of the memory of a list of particle pairs. Requires
+        ``use_hot_particle_data`` and ``use_verlet_lists``, otherwise
+        the integration raises an error. The compact Verlet lists are
+        then used instead of the cluster pair lists and the tiles.
+    use_mixed_precision : :obj:`bool`
+        Whether to evaluate the pair distances and force factors of the
+        cluster pair kernel in single precision. Positions, velocities
+        and the force accumulation remain in double precision.
+    use_space_filling_curve : :obj:`bool`
+        Whether to order the cells of the regular decomposition, and the
+        particles within each cell, along the Z-order (Morton) curve, such
+        that particles close in space are also close in memory.
+    use_half_shell_ghosts : :obj:`bool`
+        Whether the regular decomposition imports only the ghosts of
+        the upper half of the neighboring cells, which roughly halves
+        the ghost communication. Bonds, virtual sites, collision
+        detection and neighbor searches are then not supported.
+    use_ghost_overlap : :obj:`bool`
+        Whether to overlap the ghost communication of the integration
+        steps with the force calculation: the forces between particles
+        of interior cells are computed while the ghost positions are in
+        flight, and the long-range forces while the ghost forces are
+        sent back.
+    use_bond_tables : :obj:`bool`
+        Whether to evaluate the bonded forces from flat tables of the
+        bonded particles, one per bonded interaction, which are rebuilt when
+        particles are resorted.
     skin : :obj:`float`
         Verlet list skin.
+    n_threads : :obj:`int`
+        Number of OpenMP threads used in the short-range force loop.
+        Values larger than 1 require the ``OPENMP`` feature.
     node_grid : (3,) array_like of :obj:`int`
         MPI repartition for the regular decomposition cell system.
+    node_domain_boundaries : (3,) :obj:`list` of (N,) array_like of :obj:`float`
+        Boundaries between the local boxes along each axis, as fractions
+        of the box length, see :meth:`set_load_balancing`.
+    load_balancing : :obj:`dict`
+        Parameters of the load balancing, see :meth:`set_load_balancing`.
+    adaptive_skin : :obj:`dict`
+        Parameters of the adaptive skin, see :meth:`set_adaptive_skin`.
     max_cut_bonded : :obj:`float`
         Maximal range from bonded interactions.
     max_cut_nonbonded : :obj:`float`
@@ -85,6 +131,46 @@ class CellSystem(ScriptInterfaceHelper):
         :obj:`float` :
             The :attr:`skin`
 
+    rebalance()
+        Move the boundaries between the local boxes of the regular
+        decomposition such that the load is shared evenly by the MPI ranks,
+        see :meth:`set_load_balancing`. The boundaries are only moved
+        if the load imbalance exceeds the tolerance.
+
+        Returns
+        -------
+        :obj:`float` :
+            The load imbalance before balancing, i.e. the ratio of the
+            largest to the mean load of the MPI ranks minus one.
+
+    get_verlet_list_memory()
+        Get the memory reserved by the neighbor lists, summed over
+        all MPI ranks.
+
+        Returns
+        -------
+        :obj:`dict` :
+            Memory in bytes of the Verlet lists of particle pairs
+            (``'particle_pairs'``), of index pairs (``'index_pairs'``),
+            in compressed row storage (``'compact'``) and of the cluster
+            pair lists (``'cluster_pairs'``).
+
+    get_adaptive_skin_log()
+        Get the decisions of the adaptive skin, see :meth:`set_adaptive_skin`.
+
+        Returns
+        -------
+        (N,) :obj:`list` of :obj:`dict` :
+            One entry per measurement with the number of integration steps
+            since the adaptive skin was enabled (``'step'``), the skin during
+            the measurement (``'skin'``), the wall time per integration step
+            in seconds (``'time_per_step'``), the Verlet list reuse
+            (``'verlet_reuse'``), the skin chosen for the next measurement
+            (``'new_skin'``), the decision (``'action'``, one of
+            ``'trial'``, ``'accept'``, ``'reject'``, ``'converged'``,
+            ``'keep'``, ``'restart'``) and whether the cell grid was
+            rebuilt (``'cell_grid_rebuilt'``).
+
     get_state()
         Get the current state of the cell system.
 
@@ -96,7 +182,9 @@ class CellSystem(ScriptInterfaceHelper):
     """
     _so_name = "CellSystem::CellSystem"
     _so_creation_policy = "GLOBAL"
-    _so_bind_methods = ("get_state", "tune_skin", "resort")
+    _so_bind_methods = ("get_state", "tune_skin", "resort",
+                        "get_verlet_list_memory", "rebalance",
+                        "get_adaptive_skin_log")
 
     def __reduce__(self):
         so_callback, so_callback_args = super().__reduce__()
@@ -151,6 +239,62 @@ class CellSystem(ScriptInterfaceHelper):
         """
         self.call_method("initialize", name="hybrid_decomposition", **kwargs)
 
+    def set_load_balancing(self, **kwargs):
+        """
+        Periodically balance the load of the regular decomposition.
+
+        The boundaries between the local boxes are moved along each axis
+        of the :attr:`node_grid`, such that all slabs of MPI ranks
+        perpendicular to that axis carry the same share of the load.
+
+        Parameters
+        ----------
+        interval : :obj:`int`
+            Number of integration steps between two balancing attempts.
+            A value of 0 disables the periodic load balancing.
+        metric : :obj:`str`, optional
+            Load estimate of an MPI rank: ``'particles'`` (default) for
+            the number of local particles, ``'time'`` for the time spent
+            in the short-range force loop since the last balancing.
+        tolerance : :obj:`float`, optional
+            Load imbalance below which the local boxes are kept.
+            Defaults to 0.1.
+
+        """
+        self.call_method("set_load_balancing", **kwargs)
+
+    def set_adaptive_skin(self, **kwargs):
+        """
+        Adapt the :attr:`skin` during integration.
+
+        The wall time of the integration is measured every ``interval``
+        steps, and the skin is moved towards lower cost by a pattern search.
+        Once the skin has converged, the search restarts when the cost
+        changes by more than ``drift``, e.g. when the density changes.
+        The cell grid is only rebuilt when the new skin doesn't fit into
+        the current cells, or when a finer cell grid becomes possible.
+        The decisions are reported by :meth:`get_adaptive_skin_log`.
+
+        Parameters
+        ----------
+        interval : :obj:`int`
+            Number of integration steps per measurement. Should be large
+            enough to include several Verlet list updates.
+            A value of 0 disables the adaptive skin.
+        min_skin : :obj:`float`
+            Smallest skin.
+        max_skin : :obj:`float`
+            Largest skin. Values larger than supported by the cell
+            system are reduced automatically.
+        tolerance : :obj:`float`, optional
+            Skin step size below which the search stops. Defaults to 0.01.
+        drift : :obj:`float`, optional
+            Relative change of the cost at the optimal skin that restarts
+            the search. Defaults to 0.2.
+
+        """
+        self.call_method("set_adaptive_skin", **kwargs)
+
     def get_pairs(self, distance, types='all'):
         """
         Get pairs of particles closer than threshold value.
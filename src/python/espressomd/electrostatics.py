@@ -17,6 +17,8 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 
+import os
+
 from . import utils
 from .script_interface import ScriptInterfaceHelper, script_interface_register
 from .code_features import has_features
@@ -151,7 +153,8 @@ class _P3MBase(ElectrostaticInteraction):
                 "check_complex_residuals": True,
                 "tune": True,
                 "timings": 10,
-                "verbose": True}
+                "verbose": True,
+                "tuning_cache": ""}
 
     def validate_params(self, params):
         super().validate_params(params)
@@ -182,6 +185,7 @@ class _P3MBase(ElectrostaticInteraction):
             raise TypeError("Parameter 'timings' has to be an integer")
         if not utils.is_valid_type(params["tune"], bool):
             raise TypeError("Parameter 'tune' has to be a boolean")
+        params["tuning_cache"] = os.fspath(params["tuning_cache"])
 
 
 @script_interface_register
@@ -227,6 +231,15 @@ class P3M(_P3MBase):
     check_complex_residuals: :obj:`bool`, optional
         Raise a warning if the backward Fourier transform has non-zero
         complex residuals when set to ``True`` (default).
+    tuning_cache : :obj:`str` or path-like, optional
+        File in which tuned parameters are stored and looked up, see
+        :ref:`Tuning Coulomb P3M`. Disabled by default.
+    differentiation : :obj:`str`, optional
+        Differentiation scheme of the mesh potential: ``'ik'`` (default)
+        for differentiation in k-space, ``'ad'`` for analytical
+        differentiation of the charge assignment function, which needs
+        two instead of four FFTs per force calculation, or ``'auto'``
+        to let the tuning choose the faster scheme.
 
     """
     _so_name = "Coulomb::CoulombP3M"
@@ -236,6 +249,11 @@ class P3M(_P3MBase):
         if not has_features("P3M"):
             raise NotImplementedError("Feature P3M not compiled in")
 
+    def default_params(self):
+        params = super().default_params()
+        params["differentiation"] = "ik"
+        return params
+
 
 @script_interface_register
 class P3MGPU(_P3MBase):
@@ -280,6 +298,9 @@ class P3MGPU(_P3MBase):
     check_complex_residuals: :obj:`bool`, optional
         Raise a warning if the backward Fourier transform has non-zero
         complex residuals when set to ``True`` (default).
+    tuning_cache : :obj:`str` or path-like, optional
+        File in which tuned parameters are stored and looked up, see
+        :ref:`Tuning Coulomb P3M`. Disabled by default.
 
     """
     _so_name = "Coulomb::CoulombP3MGPU"
@@ -394,6 +415,9 @@ class MMM1D(ElectrostaticInteraction):
         If ``False``, disable log output during tuning.
     timings : :obj:`int`, optional
         Number of force calculations during tuning.
+    tabulate : :obj:`bool`, optional
+        If ``True``, interpolate the near-field and far-field sums from
+        tables whose resolution is tuned to ``maxPWerror``.
     check_neutrality : :obj:`bool`, optional
         Raise a warning if the system is not electrically neutral when
         set to ``True`` (default).
@@ -406,6 +430,7 @@ class MMM1D(ElectrostaticInteraction):
         return {"far_switch_radius": -1.,
                 "verbose": True,
                 "timings": 15,
+                "tabulate": False,
                 "check_neutrality": True}
 
     def required_keys(self):
@@ -449,6 +474,47 @@ class MMM1DGPU(ElectrostaticInteraction):
         return {"prefactor", "maxPWerror"}
 
 
+@script_interface_register
+class FMM(ElectrostaticInteraction):
+    """
+    Electrostatics solver based on the fast multipole method for systems
+    with zero, one or two periodic directions.
+    See :ref:`Fast multipole method` for more details.
+
+    Parameters
+    ----------
+    prefactor : :obj:`float`
+        Electrostatics prefactor (see :eq:`coulomb_prefactor`).
+    accuracy : :obj:`float`
+        Target relative RMS force error of the tuning.
+    order : :obj:`int`, optional
+        Order of the multipole expansions. Tuned if not provided.
+    r_cut : :obj:`float`, optional
+        Cutoff of the short-range pair kernel. Chosen from the size
+        of the leaf cells if not provided.
+    leaf_size : :obj:`int`, optional
+        Average number of charges in a leaf cell of the octree.
+    verbose : :obj:`bool`, optional
+        If ``False``, disable log output during tuning.
+    check_neutrality : :obj:`bool`, optional
+        Raise a warning if the system is not electrically neutral when
+        set to ``True`` (default).
+
+    """
+    _so_name = "Coulomb::CoulombFMM"
+    _so_creation_policy = "GLOBAL"
+
+    def default_params(self):
+        return {"order": -1,
+                "r_cut": -1.,
+                "leaf_size": 32,
+                "verbose": True,
+                "check_neutrality": True}
+
+    def required_keys(self):
+        return {"prefactor", "accuracy"}
+
+
 @script_interface_register
 class Scafacos(ElectrostaticInteraction):
 
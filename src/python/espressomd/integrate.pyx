@@ -72,6 +72,15 @@ class IntegratorHandle(ScriptInterfaceHelper):
         """
         self.integrator = VelocityVerlet()
 
+    def set_vv_respa(self, **kwargs):
+        """
+        Set the integration method to a multiple time step velocity Verlet,
+        which evaluates the long-range forces less often than the other
+        forces (:class:`VelocityVerletRESPA`).
+
+        """
+        self.integrator = VelocityVerletRESPA(**kwargs)
+
     def set_isotropic_npt(self, **kwargs):
         """
         Set the integration method to a modified velocity Verlet designed for
@@ -196,6 +205,25 @@ class VelocityVerlet(Integrator):
     _so_creation_policy = "GLOBAL"
 
 
+@script_interface_register
+class VelocityVerletRESPA(Integrator):
+    """
+    Multiple time step velocity Verlet integrator (r-RESPA), suitable for
+    simulations in the NVT ensemble. The bonded and short-range forces are
+    evaluated every time step, the long-range forces of the electrostatics
+    and magnetostatics solvers only every ``long_range_interval`` time steps,
+    where they are applied as impulses.
+
+    Parameters
+    ----------
+    long_range_interval : :obj:`int`
+        Number of time steps per evaluation of the long-range forces.
+
+    """
+    _so_name = "Integrators::VelocityVerletRespa"
+    _so_creation_policy = "GLOBAL"
+
+
 @script_interface_register
 class VelocityVerletIsotropicNPT(Integrator):
     """
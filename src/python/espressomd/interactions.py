@@ -37,7 +37,9 @@ class NonBondedInteraction(ScriptInterfaceHelper, metaclass=abc.ABCMeta):
     _so_bind_methods = ("deactivate",)
 
     def __init__(self, **kwargs):
-        code_features.assert_features(self.__class__.__dict__["_so_feature"])
+        feature = self.__class__.__dict__.get("_so_feature")
+        if feature is not None:
+            code_features.assert_features(feature)
         if "sip" in kwargs:
             super().__init__(**kwargs)
         else:
@@ -673,6 +675,45 @@ class TholeInteraction(NonBondedInteraction):
         return {}
 
 
+@script_interface_register
+class SplineTabulation(NonBondedInteraction):
+    """Cubic spline tabulation of the central potentials.
+
+    Replaces the sum of the central potentials between two particle types,
+    e.g. Lennard-Jones, Morse or Buckingham, by a cubic spline. The number
+    of spline nodes is doubled until the interpolation error of the forces
+    and energies is below ``accuracy``. The Gay-Berne and Thole interactions
+    depend on more than the distance and are not tabulated.
+
+    Methods
+    -------
+    set_params()
+        Set new parameters for the interaction.
+
+        Parameters
+        ----------
+        min : :obj:`float`
+            Smallest tabulated distance. The potentials are evaluated
+            analytically at smaller distances.
+        accuracy : :obj:`float`
+            Maximal absolute error of the interpolated forces and energies.
+
+    get_n_intervals()
+        Number of spline intervals, 0 if the potentials are not tabulated.
+
+    """
+
+    _so_name = "Interactions::InteractionSplineTabulation"
+    _so_bind_methods = NonBondedInteraction._so_bind_methods + \
+        ("get_n_intervals",)
+
+    def default_params(self):
+        """Python dictionary of default parameters.
+
+        """
+        return {}
+
+
 @script_interface_register
 class NonBondedInteractionHandle(ScriptInterfaceHelper):
 
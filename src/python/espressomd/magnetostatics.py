@@ -195,6 +195,43 @@ class DipolarDirectSumCpu(MagnetostaticInteraction):
         return {"prefactor"}
 
 
+@script_interface_register
+class DipolarBarnesHutCpu(MagnetostaticInteraction):
+    """
+    Calculate magnetostatic interactions with a Barnes-Hut octree.
+    See :ref:`Barnes-Hut octree sum on CPU` for more details.
+
+    Periodic boundaries are treated like in :class:`DipolarDirectSumCpu`.
+
+    Parameters
+    ----------
+    prefactor : :obj:`float`
+        Magnetostatics prefactor (:math:`\\mu_0/(4\\pi)`)
+    opening_angle : :obj:`float`, optional
+        Opening angle of the octants. Smaller values are more accurate.
+    n_replicas : :obj:`int`, optional
+        Number of replicas to be taken into account at periodic boundaries.
+    accuracy : :obj:`float`, optional
+        Target relative RMS force error. When positive, the opening angle
+        is tuned on activation and ``opening_angle`` is ignored.
+
+    Methods
+    -------
+    estimate_error()
+        Estimate the relative RMS force error of the current opening angle.
+
+    """
+    _so_name = "Dipoles::DipolarBarnesHutCpu"
+    _so_bind_methods = MagnetostaticInteraction._so_bind_methods + \
+        ("estimate_error", )
+
+    def default_params(self):
+        return {"opening_angle": 0.5, "n_replicas": 0, "accuracy": -1.}
+
+    def required_keys(self):
+        return {"prefactor"}
+
+
 @script_interface_register
 class Scafacos(MagnetostaticInteraction):
 
@@ -87,7 +87,10 @@ Variant Analysis::do_call_method(std::string const &name,
   }
   if (name == "particle_energy") {
     auto const pid = get_value<int>(parameters, "pid");
-    auto const local = particle_short_range_energy_contribution(pid);
+    auto local = 0.;
+    context()->parallel_try_catch([&]() {
+      local = particle_short_range_energy_contribution(pid);
+    });
     return mpi_reduce_sum(context()->get_comm(), local);
   }
   if (name == "particle_neighbor_pids") {
@@ -20,7 +20,9 @@
 #include "CellSystem.hpp"
 
 #include "script_interface/ScriptInterface.hpp"
+#include "script_interface/communication.hpp"
 
+#include "core/adaptive_skin.hpp"
 #include "core/bonded_interactions/bonded_interaction_data.hpp"
 #include "core/cell_system/HybridDecomposition.hpp"
 #include "core/cell_system/RegularDecomposition.hpp"
@@ -28,6 +30,7 @@
 #include "core/event.hpp"
 #include "core/grid.hpp"
 #include "core/integrate.hpp"
+#include "core/load_balancing.hpp"
 #include "core/nonbonded_interactions/nonbonded_interaction_data.hpp"
 #include "core/particle_node.hpp"
 #include "core/tuning.hpp"
@@ -61,9 +64,48 @@ static auto const &get_hybrid_decomposition() {
       std::as_const(::cell_structure).decomposition());
 }
 
+static std::unordered_map<LoadBalancing::Metric, std::string> const
+    lb_metric_to_name = {
+        {LoadBalancing::Metric::NPART, "particles"},
+        {LoadBalancing::Metric::SHORT_RANGE_TIME, "time"},
+};
+
+static std::unordered_map<std::string, LoadBalancing::Metric> const
+    lb_name_to_metric = {
+        {"particles", LoadBalancing::Metric::NPART},
+        {"time", LoadBalancing::Metric::SHORT_RANGE_TIME},
+};
+
+static std::unordered_map<AdaptiveSkin::Action, std::string> const
+    adaptive_skin_action_to_name = {
+        {AdaptiveSkin::Action::TRIAL, "trial"},
+        {AdaptiveSkin::Action::ACCEPT, "accept"},
+        {AdaptiveSkin::Action::REJECT, "reject"},
+        {AdaptiveSkin::Action::CONVERGED, "converged"},
+        {AdaptiveSkin::Action::KEEP, "keep"},
+        {AdaptiveSkin::Action::RESTART, "restart"},
+};
+
 CellSystem::CellSystem() {
   add_parameters({
       {"use_verlet_lists", ::cell_structure.use_verlet_list},
+      {"use_hot_particle_data", ::cell_structure.use_hot_particle_data},
+      {"use_compact_verlet_lists", ::cell_structure.use_compact_verlet_list},
+      {"use_mixed_precision", ::cell_structure.use_mixed_precision},
+      {"use_ghost_overlap", ::cell_structure.use_ghost_overlap},
+      {"use_bond_tables", ::cell_structure.use_bond_tables},
+      {"use_space_filling_curve",
+       [](Variant const &v) {
+         ::cell_structure.use_space_filling_curve = get_value<bool>(v);
+         cells_re_init(::cell_structure.decomposition_type());
+       },
+       []() { return ::cell_structure.use_space_filling_curve; }},
+      {"use_half_shell_ghosts",
+       [](Variant const &v) {
+         ::cell_structure.use_half_shell_ghosts = get_value<bool>(v);
+         cells_re_init(::cell_structure.decomposition_type());
+       },
+       []() { return ::cell_structure.use_half_shell_ghosts; }},
       {"node_grid",
        [this](Variant const &v) {
          context()->parallel_try_catch([&v]() {
@@ -99,6 +141,13 @@ CellSystem::CellSystem() {
          mpi_set_skin_local(new_skin);
        },
        []() { return ::skin; }},
+      {"n_threads",
+       [this](Variant const &v) {
+         context()->parallel_try_catch([&v]() {
+           ::cell_structure.set_n_threads(get_value<int>(v));
+         });
+       },
+       []() { return ::cell_structure.get_n_threads(); }},
       {"decomposition_type", AutoParameter::read_only,
        [this]() {
          return cs_type_to_name.at(::cell_structure.decomposition_type());
@@ -122,6 +171,29 @@ CellSystem::CellSystem() {
          auto const hd = get_hybrid_decomposition();
          return Variant{hd.get_cutoff_regular()};
        }},
+      {"node_domain_boundaries", AutoParameter::read_only,
+       []() {
+         auto const boundaries = get_node_domain_boundaries();
+         return std::vector<Variant>(boundaries.begin(), boundaries.end());
+       }},
+      {"load_balancing", AutoParameter::read_only,
+       []() {
+         auto const &params = LoadBalancing::get_parameters();
+         return std::unordered_map<std::string, Variant>{
+             {"interval", params.interval},
+             {"metric", lb_metric_to_name.at(params.metric)},
+             {"tolerance", params.tolerance}};
+       }},
+      {"adaptive_skin", AutoParameter::read_only,
+       []() {
+         auto const &params = AdaptiveSkin::get_parameters();
+         return std::unordered_map<std::string, Variant>{
+             {"interval", params.interval},
+             {"min_skin", params.min_skin},
+             {"max_skin", params.max_skin},
+             {"tolerance", params.tolerance},
+             {"drift", params.drift}};
+       }},
       {"max_cut_nonbonded", AutoParameter::read_only, maximal_cutoff_nonbonded},
       {"max_cut_bonded", AutoParameter::read_only, maximal_cutoff_bonded},
       {"interaction_range", AutoParameter::read_only, interaction_range},
@@ -230,6 +302,65 @@ Variant CellSystem::do_call_method(std::string const &name,
               get_value_or<bool>(params, "adjust_max_skin", false));
     return ::skin;
   }
+  if (name == "get_verlet_list_memory") {
+    auto const &comm = context()->get_comm();
+    auto const memory = ::cell_structure.verlet_list_memory();
+    return std::unordered_map<std::string, Variant>{
+        {"particle_pairs", mpi_reduce_sum(comm, memory.particle_pairs)},
+        {"index_pairs", mpi_reduce_sum(comm, memory.index_pairs)},
+        {"compact", mpi_reduce_sum(comm, memory.compact)},
+        {"cluster_pairs", mpi_reduce_sum(comm, memory.cluster_pairs)}};
+  }
+  if (name == "set_load_balancing") {
+    context()->parallel_try_catch([&params]() {
+      auto const metric = get_value_or<std::string>(params, "metric",
+                                                    "particles");
+      if (lb_name_to_metric.count(metric) == 0) {
+        throw std::invalid_argument("Unknown load balancing metric '" +
+                                    metric + "'");
+      }
+      LoadBalancing::Parameters lb_params{};
+      lb_params.interval = get_value<int>(params, "interval");
+      lb_params.metric = lb_name_to_metric.at(metric);
+      lb_params.tolerance = get_value_or<double>(params, "tolerance", 0.1);
+      LoadBalancing::set_parameters(lb_params);
+    });
+    return {};
+  }
+  if (name == "rebalance") {
+    double imbalance = 0.;
+    context()->parallel_try_catch(
+        [&imbalance]() { imbalance = LoadBalancing::rebalance(); });
+    return imbalance;
+  }
+  if (name == "set_adaptive_skin") {
+    context()->parallel_try_catch([&params]() {
+      AdaptiveSkin::Parameters skin_params{};
+      skin_params.interval = get_value<int>(params, "interval");
+      skin_params.min_skin = get_value_or<double>(params, "min_skin", 0.);
+      skin_params.max_skin = get_value_or<double>(params, "max_skin", 0.);
+      skin_params.tolerance =
+          get_value_or<double>(params, "tolerance", skin_params.tolerance);
+      skin_params.drift =
+          get_value_or<double>(params, "drift", skin_params.drift);
+      AdaptiveSkin::set_parameters(skin_params);
+    });
+    return {};
+  }
+  if (name == "get_adaptive_skin_log") {
+    std::vector<Variant> log;
+    for (auto const &decision : AdaptiveSkin::get_decisions()) {
+      log.emplace_back(std::unordered_map<std::string, Variant>{
+          {"step", decision.step},
+          {"skin", decision.skin},
+          {"time_per_step", decision.time_per_step},
+          {"verlet_reuse", decision.verlet_reuse},
+          {"new_skin", decision.new_skin},
+          {"action", adaptive_skin_action_to_name.at(decision.action)},
+          {"cell_grid_rebuilt", decision.cell_grid_rebuilt}});
+    }
+    return log;
+  }
   if (name == "get_max_range") {
     return ::cell_structure.max_range();
   }
@@ -57,6 +57,9 @@ public:
       initialize(cs_type, params);
       do_set_parameter("skin", params.at("skin"));
       do_set_parameter("node_grid", params.at("node_grid"));
+      if (params.count("n_threads")) {
+        do_set_parameter("n_threads", params.at("n_threads"));
+      }
     }
   }
 
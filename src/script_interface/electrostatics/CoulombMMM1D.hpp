@@ -51,6 +51,10 @@ public:
          [this]() { return actor()->tune_timings; }},
         {"verbose", AutoParameter::read_only,
          [this]() { return actor()->tune_verbose; }},
+        {"tabulate", AutoParameter::read_only,
+         [this]() { return actor()->tabulate; }},
+        {"is_tabulated", AutoParameter::read_only,
+         [this]() { return actor()->is_tabulated(); }},
     });
   }
 
@@ -61,7 +65,8 @@ public:
           get_value<double>(params, "maxPWerror"),
           get_value<double>(params, "far_switch_radius"),
           get_value<int>(params, "timings"),
-          get_value<bool>(params, "verbose"));
+          get_value<bool>(params, "verbose"),
+          get_value<bool>(params, "tabulate"));
     });
     set_charge_neutrality_tolerance(params);
   }
@@ -30,18 +30,30 @@
 
 #include "script_interface/get_value.hpp"
 
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
 
 namespace ScriptInterface {
 namespace Coulomb {
 
 class CoulombP3M : public Actor<CoulombP3M, ::CoulombP3M> {
   bool m_tune;
+  std::unordered_map<P3MDifferentiation, std::string> const
+      differentiation_to_name = {
+          {P3MDifferentiation::ik, "ik"},
+          {P3MDifferentiation::ad, "ad"},
+      };
 
 public:
   CoulombP3M() {
     add_parameters({
+        {"differentiation", AutoParameter::read_only,
+         [this]() {
+           return differentiation_to_name.at(actor()->p3m.differentiation);
+         }},
         {"alpha_L", AutoParameter::read_only,
          [this]() { return actor()->p3m.params.alpha_L; }},
         {"r_cut_iL", AutoParameter::read_only,
@@ -71,12 +83,26 @@ public:
         {"tune", AutoParameter::read_only, [this]() { return m_tune; }},
         {"check_complex_residuals", AutoParameter::read_only,
          [this]() { return actor()->check_complex_residuals; }},
+        {"tuning_cache", AutoParameter::read_only,
+         [this]() { return actor()->tuning_cache; }},
     });
   }
 
   void do_construct(VariantMap const &params) override {
     m_tune = get_value<bool>(params, "tune");
     context()->parallel_try_catch([&]() {
+      auto const name = get_value<std::string>(params, "differentiation");
+      auto differentiation = P3MDifferentiation::ik;
+      if (name != "auto") {
+        auto const it = std::find_if(
+            differentiation_to_name.begin(), differentiation_to_name.end(),
+            [&name](auto const &kv) { return kv.second == name; });
+        if (it == differentiation_to_name.end()) {
+          throw std::invalid_argument(
+              "Parameter 'differentiation' must be 'ik', 'ad' or 'auto'");
+        }
+        differentiation = it->first;
+      }
       auto p3m = P3MParameters{!get_value_or<bool>(params, "is_tuned", !m_tune),
                                get_value<double>(params, "epsilon"),
                                get_value<double>(params, "r_cut"),
@@ -88,7 +114,9 @@ public:
       m_actor = std::make_shared<CoreActorClass>(
           std::move(p3m), get_value<double>(params, "prefactor"),
           get_value<int>(params, "timings"), get_value<bool>(params, "verbose"),
-          get_value<bool>(params, "check_complex_residuals"));
+          get_value<bool>(params, "check_complex_residuals"),
+          differentiation, name == "auto",
+          get_value<std::string>(params, "tuning_cache"));
     });
     set_charge_neutrality_tolerance(params);
   }
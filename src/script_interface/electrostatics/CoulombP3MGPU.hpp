@@ -72,6 +72,8 @@ public:
         {"tune", AutoParameter::read_only, [this]() { return m_tune; }},
         {"check_complex_residuals", AutoParameter::read_only,
          [this]() { return actor()->check_complex_residuals; }},
+        {"tuning_cache", AutoParameter::read_only,
+         [this]() { return actor()->tuning_cache; }},
     });
   }
 
@@ -89,7 +91,9 @@ public:
       m_actor = std::make_shared<CoreActorClass>(
           std::move(p3m), get_value<double>(params, "prefactor"),
           get_value<int>(params, "timings"), get_value<bool>(params, "verbose"),
-          get_value<bool>(params, "check_complex_residuals"));
+          get_value<bool>(params, "check_complex_residuals"),
+          P3MDifferentiation::ik, false,
+          get_value<std::string>(params, "tuning_cache"));
     });
     m_actor->request_gpu();
     set_charge_neutrality_tolerance(params);
@@ -25,6 +25,7 @@
 
 #include "Actor_impl.hpp"
 
+#include "CoulombFMM.hpp"
 #include "CoulombMMM1D.hpp"
 #include "CoulombMMM1DGpu.hpp"
 #include "CoulombP3M.hpp"
@@ -63,6 +64,7 @@ void initialize(Utils::Factory<ObjectHandle> *om) {
   om->register_new<CoulombMMM1DGpu>("Coulomb::CoulombMMM1DGpu");
 #endif
   om->register_new<CoulombMMM1D>("Coulomb::CoulombMMM1D");
+  om->register_new<CoulombFMM>("Coulomb::CoulombFMM");
 #ifdef SCAFACOS
   om->register_new<CoulombScafacos>("Coulomb::CoulombScafacos");
 #endif
@@ -26,6 +26,7 @@
 #include "StokesianDynamics.hpp"
 #include "VelocityVerlet.hpp"
 #include "VelocityVerletIsoNPT.hpp"
+#include "VelocityVerletRespa.hpp"
 
 #include "core/forcecap.hpp"
 #include "core/integrate.hpp"
@@ -53,6 +54,9 @@ IntegratorHandle::IntegratorHandle() {
            return Variant{
                std::dynamic_pointer_cast<VelocityVerletIsoNPT>(m_instance)};
 #endif
+         case INTEG_METHOD_NVT_RESPA:
+           return Variant{
+               std::dynamic_pointer_cast<VelocityVerletRespa>(m_instance)};
          case INTEG_METHOD_BD:
            return Variant{
                std::dynamic_pointer_cast<BrownianDynamics>(m_instance)};
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "VelocityVerletRespa.hpp"
+
+#include "script_interface/ScriptInterface.hpp"
+
+#include "core/integrate.hpp"
+#include "core/integrators/velocity_verlet_respa.hpp"
+
+#include <memory>
+
+namespace ScriptInterface {
+namespace Integrators {
+
+VelocityVerletRespa::VelocityVerletRespa() {
+  add_parameters({
+      {"long_range_interval", AutoParameter::read_only,
+       [this]() { return get_instance().long_range_interval; }},
+  });
+}
+
+void VelocityVerletRespa::do_construct(VariantMap const &params) {
+  auto const long_range_interval =
+      get_value<int>(params, "long_range_interval");
+
+  context()->parallel_try_catch([&]() {
+    m_instance =
+        std::make_shared<::VelocityVerletRespaParameters>(long_range_interval);
+  });
+}
+
+void VelocityVerletRespa::activate() const {
+  register_integrator(get_instance());
+  set_integ_switch(INTEG_METHOD_NVT_RESPA);
+}
+
+} // namespace Integrators
+} // namespace ScriptInterface
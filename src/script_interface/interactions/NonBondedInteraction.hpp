@@ -50,13 +50,12 @@ namespace Interactions {
 template <class CoreIA>
 class InteractionPotentialInterface
     : public AutoParameters<InteractionPotentialInterface<CoreIA>> {
-  /** @brief Particle type pair. */
-  std::array<int, 2> m_types = {-1, -1};
-
 public:
   using CoreInteraction = CoreIA;
 
 protected:
+  /** @brief Particle type pair. */
+  std::array<int, 2> m_types = {-1, -1};
   using AutoParameters<InteractionPotentialInterface<CoreIA>>::context;
   using AutoParameters<InteractionPotentialInterface<CoreIA>>::valid_parameters;
   /** @brief Managed object. */
@@ -742,6 +741,46 @@ private:
 };
 #endif // SMOOTH_STEP
 
+class InteractionSplineTabulation
+    : public InteractionPotentialInterface<::SplineTabulation_Parameters> {
+protected:
+  CoreInteraction IA_parameters::*get_ptr_offset() const override {
+    return &::IA_parameters::spline_tabulation;
+  }
+
+public:
+  InteractionSplineTabulation() {
+    add_parameters({
+        make_autoparameter(&CoreInteraction::min, "min"),
+        make_autoparameter(&CoreInteraction::accuracy, "accuracy"),
+    });
+  }
+
+private:
+  std::string inactive_parameter() const override { return "min"; }
+
+  void make_new_instance(VariantMap const &params) override {
+    m_ia_si = make_shared_from_args<CoreInteraction, double, double>(
+        params, "min", "accuracy");
+  }
+
+public:
+  Variant do_call_method(std::string const &name,
+                         VariantMap const &params) override {
+    if (name == "get_n_intervals") {
+      if (m_types[0] == -1) {
+        return 0;
+      }
+      auto const key = get_ia_param_key(m_types[0], m_types[1]);
+      return static_cast<int>(
+          ::nonbonded_ia_params[key]->spline_tabulation.force_coeffs.size() /
+          4u);
+    }
+    return InteractionPotentialInterface<CoreInteraction>::do_call_method(
+        name, params);
+  }
+};
+
 class NonBondedInteractionHandle
     : public AutoParameters<NonBondedInteractionHandle> {
   std::array<int, 2> m_types = {-1, -1};
@@ -797,6 +836,7 @@ class NonBondedInteractionHandle
 #ifdef SMOOTH_STEP
   std::shared_ptr<InteractionSmoothStep> m_smooth_step;
 #endif
+  std::shared_ptr<InteractionSplineTabulation> m_spline_tabulation;
 
   template <class T>
   auto make_autoparameter(std::shared_ptr<T> &member, const char *key) const {
@@ -866,6 +906,7 @@ public:
 #ifdef SMOOTH_STEP
         make_autoparameter(m_smooth_step, "smooth_step"),
 #endif
+        make_autoparameter(m_spline_tabulation, "spline_tabulation"),
     });
   }
 
@@ -964,6 +1005,8 @@ public:
     set_member(m_smooth_step, "smooth_step",
                "Interactions::InteractionSmoothStep", params);
 #endif
+    set_member(m_spline_tabulation, "spline_tabulation",
+               "Interactions::InteractionSplineTabulation", params);
   }
 
   auto get_ia() const { return m_interaction; }
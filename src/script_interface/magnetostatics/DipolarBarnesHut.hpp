@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ESPRESSO_SRC_SCRIPT_INTERFACE_MAGNETOSTATICS_DIPOLAR_BARNES_HUT_HPP
+#define ESPRESSO_SRC_SCRIPT_INTERFACE_MAGNETOSTATICS_DIPOLAR_BARNES_HUT_HPP
+
+#include "config/config.hpp"
+
+#ifdef DIPOLES
+
+#include "Actor.hpp"
+
+#include "core/magnetostatics/barnes_hut.hpp"
+
+#include "script_interface/get_value.hpp"
+
+#include <memory>
+#include <string>
+
+namespace ScriptInterface {
+namespace Dipoles {
+
+class DipolarBarnesHut : public Actor<DipolarBarnesHut, ::DipolarBarnesHut> {
+public:
+  DipolarBarnesHut() {
+    add_parameters({
+        {"opening_angle", AutoParameter::read_only,
+         [this]() { return actor()->opening_angle; }},
+        {"n_replicas", AutoParameter::read_only,
+         [this]() { return actor()->n_replicas; }},
+        {"accuracy", AutoParameter::read_only,
+         [this]() { return actor()->accuracy; }},
+    });
+  }
+
+  void do_construct(VariantMap const &params) override {
+    context()->parallel_try_catch([this, &params]() {
+      m_actor = std::make_shared<CoreActorClass>(
+          get_value<double>(params, "prefactor"),
+          get_value<double>(params, "opening_angle"),
+          get_value<int>(params, "n_replicas"),
+          get_value<double>(params, "accuracy"));
+    });
+  }
+
+  Variant do_call_method(std::string const &name,
+                         VariantMap const &params) override {
+    if (name == "estimate_error") {
+      return actor()->estimate_error();
+    }
+    return Actor<SIActorClass, CoreActorClass>::do_call_method(name, params);
+  }
+};
+
+} // namespace Dipoles
+} // namespace ScriptInterface
+
+#endif // DIPOLES
+#endif
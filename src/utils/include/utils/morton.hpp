@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_MORTON_HPP
+#define UTILS_MORTON_HPP
+
+#include "utils/Vector.hpp"
+
+#include <cstdint>
+
+namespace Utils {
+namespace detail {
+/** @brief Insert two zero bits after each of the lower 21 bits of @p x. */
+constexpr uint64_t spread_bits_3d(uint64_t x) {
+  x &= 0x1fffffull;
+  x = (x | (x << 32)) & 0x1f00000000ffffull;
+  x = (x | (x << 16)) & 0x1f0000ff0000ffull;
+  x = (x | (x << 8)) & 0x100f00f00f00f00full;
+  x = (x | (x << 4)) & 0x10c30c30c30c30c3ull;
+  x = (x | (x << 2)) & 0x1249249249249249ull;
+  return x;
+}
+} // namespace detail
+
+/**
+ * @brief Morton index of a point on a 3D grid.
+ *
+ * The bits of the three coordinates are interleaved, which orders the
+ * grid points along the Z-order space-filling curve. Points that are
+ * close on the curve are also close in space.
+ *
+ * @param ind Non-negative grid coordinates, smaller than 2^21.
+ * @return Position of the grid point on the curve.
+ */
+inline uint64_t morton_index(Vector3i const &ind) {
+  return detail::spread_bits_3d(static_cast<uint64_t>(ind[0])) |
+         (detail::spread_bits_3d(static_cast<uint64_t>(ind[1])) << 1) |
+         (detail::spread_bits_3d(static_cast<uint64_t>(ind[2])) << 2);
+}
+
+} // namespace Utils
+
+#endif
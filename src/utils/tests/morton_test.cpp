@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2022 The ESPResSo project
+ *
+ * This file is part of ESPResSo.
+ *
+ * ESPResSo is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * ESPResSo is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#define BOOST_TEST_MODULE Utils::morton_index test
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "utils/Vector.hpp"
+#include "utils/morton.hpp"
+
+#include <cstdint>
+#include <random>
+
+namespace {
+/** Interleave the coordinate bits one at a time. */
+uint64_t morton_index_reference(Utils::Vector3i const &ind) {
+  uint64_t result = 0u;
+  for (int bit = 0; bit < 21; ++bit) {
+    for (int i = 0; i < 3; ++i) {
+      auto const b = (static_cast<uint64_t>(ind[i]) >> bit) & 1u;
+      result |= b << (3 * bit + i);
+    }
+  }
+  return result;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(morton_index) {
+  using Utils::morton_index;
+  BOOST_CHECK_EQUAL(morton_index({0, 0, 0}), 0u);
+  BOOST_CHECK_EQUAL(morton_index({1, 0, 0}), 1u);
+  BOOST_CHECK_EQUAL(morton_index({0, 1, 0}), 2u);
+  BOOST_CHECK_EQUAL(morton_index({0, 0, 1}), 4u);
+  BOOST_CHECK_EQUAL(morton_index({1, 1, 1}), 7u);
+  BOOST_CHECK_EQUAL(morton_index({2, 0, 0}), 8u);
+  BOOST_CHECK_EQUAL(morton_index({3, 3, 3}), 63u);
+
+  auto constexpr max_coord = (1 << 21) - 1;
+  BOOST_CHECK_EQUAL(morton_index({max_coord, max_coord, max_coord}),
+                    (uint64_t{1} << 63) - 1u);
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, max_coord);
+  for (int k = 0; k < 1000; ++k) {
+    auto const ind = Utils::Vector3i{dist(gen), dist(gen), dist(gen)};
+    BOOST_CHECK_EQUAL(morton_index(ind), morton_index_reference(ind));
+  }
+}
@@ -0,0 +1,103 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class AdaptiveSkin(ut.TestCase):
+    """
+    Check that the adaptive skin changes the skin within the given bounds,
+    reports its decisions, and doesn't change the physics.
+    """
+    system = espressomd.System(box_l=[10.0, 10.0, 10.0])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def setUp(self):
+        np.random.seed(42)
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=2**(1. / 6.), shift="auto")
+        grid = np.mgrid[0:8, 0:8, 0:8].reshape((3, -1)).T
+        self.system.part.add(pos=1.2 * grid + 0.6,
+                             v=np.random.normal(size=(8**3, 3)))
+
+    def tearDown(self):
+        self.system.cell_system.set_adaptive_skin(interval=0)
+        self.system.part.clear()
+        self.system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        self.system.cell_system.skin = 0.4
+
+    def test_parameters(self):
+        cell_system = self.system.cell_system
+        cell_system.set_adaptive_skin(interval=100, min_skin=0.1,
+                                      max_skin=0.8, tolerance=0.05, drift=0.3)
+        params = cell_system.adaptive_skin
+        self.assertEqual(params["interval"], 100)
+        self.assertAlmostEqual(params["min_skin"], 0.1, delta=1e-12)
+        self.assertAlmostEqual(params["max_skin"], 0.8, delta=1e-12)
+        self.assertAlmostEqual(params["tolerance"], 0.05, delta=1e-12)
+        self.assertAlmostEqual(params["drift"], 0.3, delta=1e-12)
+        with self.assertRaisesRegex(ValueError, "Parameter 'interval' must be >= 0"):
+            cell_system.set_adaptive_skin(interval=-1)
+        with self.assertRaisesRegex(ValueError, "Parameter 'min_skin' must be >= 0"):
+            cell_system.set_adaptive_skin(interval=1, min_skin=-1.)
+        with self.assertRaisesRegex(ValueError, "Parameter 'max_skin' must be >= 'min_skin'"):
+            cell_system.set_adaptive_skin(interval=1, min_skin=1., max_skin=0.5)
+        with self.assertRaisesRegex(ValueError, "Parameter 'tolerance' must be > 0"):
+            cell_system.set_adaptive_skin(interval=1, max_skin=1., tolerance=0.)
+        with self.assertRaisesRegex(ValueError, "Parameter 'drift' must be > 0"):
+            cell_system.set_adaptive_skin(interval=1, max_skin=1., drift=0.)
+
+    def test_integration(self):
+        system = self.system
+        cell_system = system.cell_system
+        n_decisions = len(cell_system.get_adaptive_skin_log())
+        cell_system.set_adaptive_skin(interval=10, min_skin=0.05,
+                                      max_skin=1.0, tolerance=0.02)
+        system.integrator.run(200)
+        log = cell_system.get_adaptive_skin_log()[n_decisions:]
+        self.assertEqual(len(log), 20)
+        skin = 0.4
+        for k, decision in enumerate(log):
+            self.assertEqual(decision["step"], 10 * (k + 1))
+            self.assertAlmostEqual(decision["skin"], skin, delta=1e-12)
+            self.assertGreater(decision["time_per_step"], 0.)
+            self.assertIn(decision["action"], {"trial", "accept", "reject",
+                                               "converged", "keep", "restart"})
+            self.assertGreaterEqual(decision["new_skin"], 0.05)
+            self.assertLessEqual(decision["new_skin"], 1.0)
+            skin = decision["new_skin"]
+        self.assertAlmostEqual(cell_system.skin, skin, delta=1e-12)
+        # forces don't depend on the skin
+        f_ref = np.copy(system.part.all().f)
+        system.integrator.run(0, recalc_forces=True)
+        np.testing.assert_allclose(np.copy(system.part.all().f), f_ref,
+                                   atol=1e-10)
+        # setting the skin by hand restarts the search from that skin
+        cell_system.skin = 0.3
+        system.integrator.run(10)
+        decision = cell_system.get_adaptive_skin_log()[-1]
+        self.assertAlmostEqual(decision["skin"], 0.3, delta=1e-12)
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -17,7 +17,10 @@
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
 import unittest as ut
+import unittest_decorators as utx
 import espressomd
+import espressomd.interactions
+import espressomd.electrostatics
 import numpy as np
 import tests_common
 
@@ -61,6 +64,14 @@ class CellSystem(ut.TestCase):
             system.cell_system.skin = -2.
         self.assertAlmostEqual(system.cell_system.skin, 0.1, delta=1e-12)
 
+        with self.assertRaisesRegex(ValueError, "Parameter 'n_threads' must be >= 1"):
+            system.cell_system.n_threads = 0
+        self.assertEqual(system.cell_system.n_threads, 1)
+        if not espressomd.has_features("OPENMP"):
+            with self.assertRaisesRegex(RuntimeError, "Parameter 'n_threads' must be 1 when ESPResSo is compiled without OpenMP support"):
+                system.cell_system.n_threads = 2
+            self.assertEqual(system.cell_system.n_threads, 1)
+
         node_grid = system.cell_system.node_grid
         with self.assertRaisesRegex(RuntimeError, "Provided argument of type .+ is not convertible to 'Utils::Vector<int, 3>'"):
             system.cell_system.node_grid = [1, 2, 3, 4]
@@ -80,6 +91,266 @@ class CellSystem(ut.TestCase):
             n_square_types={1}, cutoff_regular=0)
         self.check_node_grid()
 
+    @utx.skipIfMissingFeatures(["LENNARD_JONES", "ELECTROSTATICS"])
+    def test_compact_verlet_lists(self):
+        system = self.system
+        system.cell_system.skin = 0.3
+        system.cell_system.use_hot_particle_data = True
+        system.cell_system.set_n_square(use_verlet_lists=True)
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.5, cutoff=1.2, shift="auto")
+        # short-range electrostatics keep the Verlet lists in use
+        system.actors.add(espressomd.electrostatics.DH(
+            prefactor=1., kappa=2., r_cut=1.2))
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((200, 3)) * system.box_l,
+                        q=np.repeat([-1., 1.], 100))
+
+        def get_forces(compact):
+            system.cell_system.use_compact_verlet_lists = compact
+            system.integrator.run(0, recalc_forces=True)
+            return np.copy(system.part.all().f)
+
+        try:
+            f_ref = get_forces(False)
+            memory_ref = system.cell_system.get_verlet_list_memory()
+            # rebuilt in compressed row storage, then reused
+            np.testing.assert_allclose(get_forces(True), f_ref, atol=1e-10)
+            np.testing.assert_allclose(get_forces(True), f_ref, atol=1e-10)
+            self.assertTrue(system.cell_system.use_compact_verlet_lists)
+            memory = system.cell_system.get_verlet_list_memory()
+            self.assertEqual(memory["index_pairs"], 0)
+            self.assertGreater(memory["compact"], 0)
+            self.assertLess(memory["compact"], memory_ref["index_pairs"])
+            self.assertEqual(memory_ref["compact"], 0)
+            # without electrostatics, they replace the cluster pair lists
+            system.actors.clear()
+            system.cell_system.set_regular_decomposition(use_verlet_lists=True)
+            f_ref = get_forces(False)
+            memory_ref = system.cell_system.get_verlet_list_memory()
+            self.assertGreater(memory_ref["cluster_pairs"], 0)
+            self.assertEqual(memory_ref["compact"], 0)
+            np.testing.assert_allclose(get_forces(True), f_ref, atol=1e-10)
+            memory = system.cell_system.get_verlet_list_memory()
+            self.assertGreater(memory["compact"], 0)
+            # the setting requires the hot particle data
+            system.cell_system.use_hot_particle_data = False
+            with self.assertRaisesRegex(Exception, "Compact Verlet lists"):
+                system.integrator.run(0, recalc_forces=True)
+        finally:
+            system.cell_system.use_compact_verlet_lists = False
+            system.cell_system.use_hot_particle_data = False
+            system.actors.clear()
+            system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+            system.part.clear()
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_space_filling_curve(self):
+        system = self.system
+        system.cell_system.skin = 0.3
+        system.time_step = 0.01
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.5, cutoff=1.2, shift="auto")
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((200, 3)) * system.box_l)
+
+        def get_forces(space_filling_curve):
+            system.cell_system.use_space_filling_curve = space_filling_curve
+            system.integrator.run(0, recalc_forces=True)
+            return np.copy(system.part.all().f)
+
+        try:
+            for setter, kwargs in [
+                    ("set_regular_decomposition", {}),
+                    ("set_hybrid_decomposition",
+                     {"n_square_types": {1}, "cutoff_regular": 1.2})]:
+                getattr(system.cell_system, setter)(**kwargs)
+                f_ref = get_forces(False)
+                np.testing.assert_allclose(get_forces(True), f_ref,
+                                           atol=1e-10)
+                self.assertTrue(system.cell_system.use_space_filling_curve)
+                self.assertEqual(system.cell_system.get_state()[
+                                 "decomposition_type"], setter[4:])
+                # particles are reordered when they are resorted
+                system.integrator.run(10)
+                system.cell_system.resort()
+                f = get_forces(True)
+                np.testing.assert_allclose(get_forces(False), f, atol=1e-10)
+        finally:
+            system.cell_system.use_space_filling_curve = False
+            system.cell_system.set_regular_decomposition()
+            system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+            system.part.clear()
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_hot_particle_data(self):
+        system = self.system
+        system.cell_system.skin = 0.3
+        system.cell_system.set_regular_decomposition(use_verlet_lists=True)
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.5, cutoff=1.2, shift="auto")
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((200, 3)) * system.box_l)
+
+        def get_forces(hot_particle_data):
+            system.cell_system.use_hot_particle_data = hot_particle_data
+            system.integrator.run(0, recalc_forces=True)
+            return np.copy(system.part.all().f)
+
+        try:
+            self.assertFalse(system.cell_system.use_hot_particle_data)
+            f_ref = get_forces(False)
+            memory_ref = system.cell_system.get_verlet_list_memory()
+            # the cluster pair lists replace the Verlet lists
+            np.testing.assert_allclose(get_forces(True), f_ref, atol=1e-10)
+            self.assertTrue(system.cell_system.use_hot_particle_data)
+            memory = system.cell_system.get_verlet_list_memory()
+            self.assertEqual(memory_ref["cluster_pairs"], 0)
+            self.assertGreater(memory["cluster_pairs"], 0)
+        finally:
+            system.cell_system.use_hot_particle_data = False
+            system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+            system.part.clear()
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_mixed_precision(self):
+        system = self.system
+        system.cell_system.skin = 0.3
+        system.cell_system.use_hot_particle_data = True
+        system.cell_system.set_regular_decomposition(use_verlet_lists=True)
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.5, cutoff=1.2, shift="auto")
+        np.random.seed(42)
+        system.part.add(pos=np.random.random((200, 3)) * system.box_l)
+
+        def get_forces(mixed_precision):
+            system.cell_system.use_mixed_precision = mixed_precision
+            system.integrator.run(0, recalc_forces=True)
+            return np.copy(system.part.all().f)
+
+        try:
+            f_ref = get_forces(False)
+            f = get_forces(True)
+            self.assertTrue(system.cell_system.use_mixed_precision)
+            np.testing.assert_allclose(f, f_ref, rtol=1e-5,
+                                       atol=1e-5 * np.max(np.abs(f_ref)))
+        finally:
+            system.cell_system.use_mixed_precision = False
+            system.cell_system.use_hot_particle_data = False
+            system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+            system.part.clear()
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_ghost_overlap(self):
+        system = self.system
+        system.cell_system.skin = 0.3
+        system.time_step = 0.01
+        system.cell_system.use_hot_particle_data = True
+        system.cell_system.set_regular_decomposition(use_verlet_lists=True)
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.5, cutoff=1.2, shift="auto")
+        np.random.seed(42)
+        pos = np.random.random((200, 3)) * system.box_l
+        vel = np.random.normal(scale=0.1, size=(200, 3))
+
+        def get_trajectory(overlap):
+            system.part.clear()
+            system.part.add(pos=pos, v=vel)
+            system.cell_system.use_ghost_overlap = overlap
+            system.integrator.run(0, recalc_forces=True)
+            system.integrator.run(10)
+            return np.copy(system.part.all().pos), np.copy(system.part.all().f)
+
+        try:
+            pos_ref, f_ref = get_trajectory(False)
+            pos_overlap, f_overlap = get_trajectory(True)
+            self.assertTrue(system.cell_system.use_ghost_overlap)
+            np.testing.assert_allclose(pos_overlap, pos_ref, atol=1e-10)
+            np.testing.assert_allclose(f_overlap, f_ref, atol=1e-8)
+        finally:
+            system.cell_system.use_ghost_overlap = False
+            system.cell_system.use_hot_particle_data = False
+            system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+            system.part.clear()
+
+    @utx.skipIfMissingFeatures(["LENNARD_JONES"])
+    def test_half_shell_ghosts(self):
+        system = self.system
+        system.cell_system.skin = 0.3
+        system.time_step = 0.01
+        system.cell_system.set_regular_decomposition(use_verlet_lists=True)
+        system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.5, cutoff=1.2, shift="auto")
+        np.random.seed(42)
+        pos = np.random.random((200, 3)) * system.box_l
+        vel = np.random.normal(scale=0.1, size=(200, 3))
+
+        def get_trajectory(half_shell):
+            system.part.clear()
+            system.cell_system.use_half_shell_ghosts = half_shell
+            system.part.add(pos=pos, v=vel)
+            system.integrator.run(0, recalc_forces=True)
+            system.integrator.run(10)
+            return np.copy(system.part.all().pos), np.copy(system.part.all().f)
+
+        try:
+            pos_ref, f_ref = get_trajectory(False)
+            pos_half, f_half = get_trajectory(True)
+            self.assertTrue(system.cell_system.use_half_shell_ghosts)
+            np.testing.assert_allclose(pos_half, pos_ref, atol=1e-10)
+            np.testing.assert_allclose(f_half, f_ref, atol=1e-8)
+            with self.assertRaisesRegex(RuntimeError, "half-shell ghost import"):
+                system.analysis.particle_energy(system.part.by_id(0))
+            harmonic = espressomd.interactions.HarmonicBond(k=1., r_0=1.)
+            system.bonded_inter.add(harmonic)
+            with self.assertRaisesRegex(Exception, "half-shell ghost import"):
+                system.integrator.run(0, recalc_forces=True)
+        finally:
+            system.cell_system.use_half_shell_ghosts = False
+            system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+            system.bonded_inter.clear()
+            system.part.clear()
+
+    def test_bond_tables(self):
+        system = self.system
+        system.cell_system.skin = 0.3
+        system.time_step = 0.01
+        system.cell_system.set_regular_decomposition(use_verlet_lists=True)
+        fene = espressomd.interactions.FeneBond(k=30., d_r_max=1.)
+        angle = espressomd.interactions.AngleHarmonic(bend=5., phi0=2.)
+        quartic = espressomd.interactions.QuarticBond(
+            k0=1., k1=1., r=0.5, r_cut=1.)
+        system.bonded_inter.add(fene)
+        system.bonded_inter.add(angle)
+        system.bonded_inter.add(quartic)
+        np.random.seed(42)
+        pos = np.cumsum(np.random.uniform(-0.4, 0.4, (40, 3)), axis=0)
+        vel = np.random.normal(scale=0.1, size=(40, 3))
+
+        def get_trajectory(bond_tables):
+            system.part.clear()
+            system.cell_system.use_bond_tables = bond_tables
+            partcls = system.part.add(pos=pos, v=vel)
+            for i in range(1, len(partcls)):
+                partcls[i].add_bond((fene, partcls[i - 1]))
+                partcls[i].add_bond((quartic, partcls[i - 1]))
+            for i in range(1, len(partcls) - 1):
+                partcls[i].add_bond((angle, partcls[i - 1], partcls[i + 1]))
+            system.integrator.run(0, recalc_forces=True)
+            system.integrator.run(10)
+            return np.copy(partcls.pos), np.copy(partcls.f)
+
+        try:
+            pos_ref, f_ref = get_trajectory(False)
+            pos_tab, f_tab = get_trajectory(True)
+            self.assertTrue(system.cell_system.use_bond_tables)
+            np.testing.assert_allclose(pos_tab, pos_ref, atol=1e-10)
+            np.testing.assert_allclose(f_tab, f_ref, atol=1e-8)
+        finally:
+            system.cell_system.use_bond_tables = False
+            system.part.clear()
+            system.bonded_inter.clear()
+
 
 if __name__ == "__main__":
     ut.main()
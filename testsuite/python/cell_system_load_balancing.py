@@ -0,0 +1,122 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import espressomd.electrostatics
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES"])
+class CellSystemLoadBalancing(ut.TestCase):
+    """
+    Check that the load balancing of the regular decomposition moves
+    the boundaries of the local boxes without changing the physics.
+    """
+    system = espressomd.System(box_l=[16.0, 8.0, 8.0])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.2
+    n_nodes = system.cell_system.get_state()["n_nodes"]
+
+    def setUp(self):
+        np.random.seed(42)
+        self.system.cell_system.set_regular_decomposition()
+        self.system.cell_system.node_grid = [self.n_nodes, 1, 1]
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=0.8, cutoff=2., shift="auto")
+        # a slab of particles in the left part of the box
+        grid = np.mgrid[0:6, 0:8, 0:8].reshape((3, -1)).T + 0.5
+        self.system.part.add(
+            pos=grid + 0.1 * (np.random.random(grid.shape) - 0.5))
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        self.system.cell_system.set_load_balancing(interval=0)
+        self.system.cell_system.node_grid = [self.n_nodes, 1, 1]
+
+    def get_forces(self):
+        self.system.integrator.run(0, recalc_forces=True)
+        return np.copy(self.system.part.all().f)
+
+    def test_parameters(self):
+        cell_system = self.system.cell_system
+        cell_system.set_load_balancing(interval=10, metric="time",
+                                       tolerance=0.2)
+        params = cell_system.load_balancing
+        self.assertEqual(params["interval"], 10)
+        self.assertEqual(params["metric"], "time")
+        self.assertAlmostEqual(params["tolerance"], 0.2, delta=1e-12)
+        with self.assertRaisesRegex(ValueError, "Parameter 'interval' must be >= 0"):
+            cell_system.set_load_balancing(interval=-1)
+        with self.assertRaisesRegex(ValueError, "Parameter 'tolerance' must be >= 0"):
+            cell_system.set_load_balancing(interval=1, tolerance=-1.)
+        with self.assertRaisesRegex(ValueError, "Unknown load balancing metric 'unknown'"):
+            cell_system.set_load_balancing(interval=1, metric="unknown")
+        boundaries = cell_system.node_domain_boundaries
+        np.testing.assert_allclose(
+            boundaries[0], np.linspace(0., 1., self.n_nodes + 1), atol=1e-12)
+        np.testing.assert_allclose(boundaries[1], [0., 1.], atol=1e-12)
+        np.testing.assert_allclose(boundaries[2], [0., 1.], atol=1e-12)
+
+    @ut.skipIf(n_nodes == 1, "Skipping test: only runs for n_nodes >= 2")
+    def test_rebalance(self):
+        cell_system = self.system.cell_system
+        f_ref = self.get_forces()
+        imbalance = cell_system.rebalance()
+        self.assertGreater(imbalance, 0.1)
+        boundaries = cell_system.node_domain_boundaries[0]
+        self.assertLess(boundaries[-2], 1. - 1. / self.n_nodes)
+        self.assertTrue(np.all(np.diff(boundaries) > 0.))
+        np.testing.assert_allclose(self.get_forces(), f_ref, atol=1e-10)
+        self.assertLess(cell_system.rebalance(), imbalance)
+        # periodic balancing during integration
+        cell_system.set_load_balancing(interval=5)
+        self.system.integrator.run(20)
+        self.assertEqual(len(self.system.part), 6 * 8 * 8)
+        # a new node grid divides the box evenly
+        cell_system.node_grid = [self.n_nodes, 1, 1]
+        np.testing.assert_allclose(
+            cell_system.node_domain_boundaries[0],
+            np.linspace(0., 1., self.n_nodes + 1), atol=1e-12)
+
+    @ut.skipIf(n_nodes == 1, "Skipping test: only runs for n_nodes >= 2")
+    def test_exceptions(self):
+        cell_system = self.system.cell_system
+        cell_system.set_n_square()
+        with self.assertRaisesRegex(RuntimeError, "Load balancing requires the regular decomposition cell system"):
+            cell_system.rebalance()
+
+    @utx.skipIfMissingFeatures(["P3M"])
+    @ut.skipIf(n_nodes == 1, "Skipping test: only runs for n_nodes >= 2")
+    def test_p3m(self):
+        cell_system = self.system.cell_system
+        cell_system.rebalance()
+        self.system.part.all().q = np.tile([1., -1.], 6 * 4 * 8)
+        p3m = espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=1e-3, mesh=16, cao=3, r_cut=1.5,
+            alpha=2., tune=False)
+        with self.assertRaisesRegex(Exception, "CoulombP3M: requires local boxes of equal size"):
+            self.system.actors.add(p3m)
+        self.assertEqual(len(self.system.actors), 0)
+        self.system.part.all().q = 0.
+
+
+if __name__ == "__main__":
+    ut.main()
@@ -0,0 +1,98 @@
+#
+# Copyright (C) 2022 The ESPResSo project
+#
+# This file is part of ESPResSo.
+#
+# ESPResSo is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# ESPResSo is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+import espressomd
+import numpy as np
+import unittest as ut
+import unittest_decorators as utx
+
+
+@utx.skipIfMissingFeatures(["LENNARD_JONES", "OPENMP"])
+class CellSystemThreads(ut.TestCase):
+    """
+    Check that the threaded short-range loop reproduces the forces
+    of the serial loop, and that its results don't depend on the
+    number of threads.
+    """
+    system = espressomd.System(box_l=[12.0, 12.0, 12.0])
+    system.time_step = 0.01
+    system.cell_system.skin = 0.4
+
+    def setUp(self):
+        np.random.seed(42)
+        self.system.non_bonded_inter[0, 0].lennard_jones.set_params(
+            epsilon=1., sigma=1., cutoff=2.5, shift="auto")
+        self.system.part.add(pos=np.random.random((800, 3)) * 12.)
+        self.system.integrator.set_steepest_descent(
+            f_max=0., gamma=0.1, max_displacement=0.05)
+        self.system.integrator.run(100)
+        self.system.integrator.set_vv()
+
+    def tearDown(self):
+        self.system.part.clear()
+        self.system.non_bonded_inter[0, 0].lennard_jones.deactivate()
+        self.system.cell_system.n_threads = 1
+
+    def get_forces(self, n_threads):
+        self.system.cell_system.n_threads = n_threads
+        self.system.integrator.run(0, recalc_forces=True)
+        return np.copy(self.system.part.all().f)
+
+    def check_forces(self):
+        f_serial = self.get_forces(1)
+        f_threads = self.get_forces(4)
+        np.testing.assert_allclose(f_threads, f_serial, rtol=1e-10, atol=1e-10)
+        # reproducible for any number of threads
+        np.testing.assert_array_equal(self.get_forces(2), f_threads)
+        np.testing.assert_array_equal(self.get_forces(3), f_threads)
+
+    def test_regular_decomposition(self):
+        self.system.cell_system.set_regular_decomposition(
+            use_verlet_lists=False)
+        self.check_forces()
+
+    def test_regular_decomposition_verlet(self):
+        self.system.cell_system.set_regular_decomposition(
+            use_verlet_lists=True)
+        self.check_forces()
+        # forces from reused Verlet lists
+        np.testing.assert_array_equal(self.get_forces(4), self.get_forces(2))
+
+    def test_n_square(self):
+        self.system.cell_system.set_n_square(use_verlet_lists=True)
+        self.check_forces()
+
+    def test_integration(self):
+        self.system.cell_system.set_regular_decomposition(
+            use_verlet_lists=True)
+        self.system.part.all().v = np.random.random((800, 3)) - 0.5
+        pos_ref = np.copy(self.system.part.all().pos)
+        v_ref = np.copy(self.system.part.all().v)
+        self.system.cell_system.n_threads = 1
+        self.system.integrator.run(50)
+        pos_serial = np.copy(self.system.part.all().pos)
+        self.system.part.all().pos = pos_ref
+        self.system.part.all().v = v_ref
+        self.system.cell_system.n_threads = 4
+        self.system.integrator.run(50)
+        np.testing.assert_allclose(
+            np.copy(self.system.part.all().pos), pos_serial, atol=1e-8)
+
+
+if __name__ == "__main__":
+    ut.main()
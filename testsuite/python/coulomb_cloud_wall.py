@@ -81,6 +81,15 @@ class CoulombCloudWall(ut.TestCase):
         self.system.integrator.run(0)
         self.compare("p3m", prefactor=3., force_tol=2e-3, energy_tol=1e-3)
 
+    @utx.skipIfMissingFeatures(["P3M"])
+    def test_p3m_cpu_ad(self):
+        self.system.actors.add(
+            espressomd.electrostatics.P3M(
+                **self.p3m_params, prefactor=3., tune=False,
+                differentiation="ad"))
+        self.system.integrator.run(0)
+        self.compare("p3m_ad", prefactor=3., force_tol=2e-3, energy_tol=1e-3)
+
     @utx.skipIfMissingGPU()
     @utx.skipIfMissingFeatures(["P3M"])
     def test_p3m_gpu(self):
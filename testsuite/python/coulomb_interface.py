@@ -66,6 +66,12 @@ class Test(ut.TestCase):
             dict(prefactor=2., epsilon=3., mesh_off=[0.6, 0.7, 0.8], r_cut=1.5,
                  cao=2, mesh=[8, 8, 8], alpha=12., accuracy=0.01, tune=False,
                  check_neutrality=True, charge_neutrality_tolerance=7e-12))
+        test_p3m_cpu_ad = tests_common.generate_test_for_actor_class(
+            system, espressomd.electrostatics.P3M,
+            dict(prefactor=2., epsilon=0., mesh_off=[0.6, 0.7, 0.8], r_cut=1.5,
+                 cao=2, mesh=[8, 10, 8], alpha=12., accuracy=0.01, tune=False,
+                 check_neutrality=True, charge_neutrality_tolerance=7e-12,
+                 check_complex_residuals=False, differentiation="ad"))
         test_p3m_cpu_elc = tests_common.generate_test_for_actor_class(
             system, espressomd.electrostatics.ELC,
             dict(gap_size=2., maxPWerror=1e-3, const_pot=True, pot_diff=-3.,
@@ -100,7 +106,7 @@ class Test(ut.TestCase):
         valid_params = dict(
             prefactor=1., maxPWerror=1e-3, far_switch_radius=1.,
             check_neutrality=True, charge_neutrality_tolerance=7e-12,
-            timings=5, verbose=False)
+            timings=5, verbose=False, tabulate=True)
         tests_common.generate_test_for_actor_class(
             self.system, espressomd.electrostatics.MMM1D, valid_params)(self)
 
@@ -110,6 +116,45 @@ class Test(ut.TestCase):
             with self.assertRaisesRegex(ValueError, f"Parameter '{key}' must be > 0"):
                 espressomd.electrostatics.MMM1D(**invalid_params)
 
+    def test_fmm(self):
+        self.system.periodicity = [False, True, False]
+        valid_params = dict(
+            prefactor=1., accuracy=1e-3, order=8, r_cut=1.5, leaf_size=16,
+            check_neutrality=True, charge_neutrality_tolerance=7e-12,
+            verbose=False)
+        tests_common.generate_test_for_actor_class(
+            self.system, espressomd.electrostatics.FMM, valid_params)(self)
+
+        for key in ["prefactor", "accuracy", "leaf_size"]:
+            invalid_params = valid_params.copy()
+            invalid_params[key] = -2
+            with self.assertRaisesRegex(ValueError, f"Parameter '{key}' must be > 0"):
+                espressomd.electrostatics.FMM(**invalid_params)
+        with self.assertRaisesRegex(ValueError, "Parameter 'order' must be between 1 and 20"):
+            espressomd.electrostatics.FMM(**{**valid_params, "order": 0})
+        with self.assertRaisesRegex(ValueError, "Parameter 'r_cut' must be >= 0"):
+            espressomd.electrostatics.FMM(**{**valid_params, "r_cut": -2.})
+
+    def test_fmm_exceptions(self):
+        actor = espressomd.electrostatics.FMM(
+            prefactor=1., accuracy=1e-3, order=8, r_cut=1.5)
+        with self.assertRaisesRegex(RuntimeError, "FMM requires at least one non-periodic direction"):
+            self.system.actors.add(actor)
+        self.assertEqual(len(self.system.actors), 0)
+        self.system.periodicity = [True, True, False]
+        actor = espressomd.electrostatics.FMM(
+            prefactor=1., accuracy=1e-3, order=8, r_cut=5.)
+        with self.assertRaisesRegex(RuntimeError, "FMM requires r_cut to be smaller than half the box length in periodic directions"):
+            self.system.actors.add(actor)
+        self.assertEqual(len(self.system.actors), 0)
+        actor = espressomd.electrostatics.FMM(prefactor=1., accuracy=1e-3)
+        self.assertFalse(actor.is_tuned)
+        self.system.actors.add(actor)
+        self.assertTrue(actor.is_tuned)
+        with self.assertRaisesRegex(Exception, "FMM requires at least one non-periodic direction"):
+            self.system.periodicity = [True, True, True]
+        self.system.periodicity = [True, True, False]
+
     @utx.skipIfMissingGPU()
     @utx.skipIfMissingFeatures(["CUDA", "MMM1D_GPU"])
     def test_mmm1d_gpu(self):
@@ -192,6 +237,10 @@ class Test(ut.TestCase):
             P3M(**{**p3m_params, 'timings': -2})
         with self.assertRaisesRegex(ValueError, "Parameter 'mesh' has to be an integer or integer list of length 3"):
             P3M(**{**p3m_params, 'mesh': [8, 8]})
+        with self.assertRaisesRegex(ValueError, "Parameter 'differentiation' must be 'ik', 'ad' or 'auto'"):
+            P3M(**{**p3m_params, 'differentiation': 'fd'})
+        with self.assertRaisesRegex(ValueError, "Parameter 'cao' must be > 1 for analytical differentiation"):
+            P3M(**{**p3m_params, 'cao': 1, 'differentiation': 'ad'})
         with self.assertRaisesRegex(ValueError, "Parameter 'actor' of type Coulomb::ElectrostaticLayerCorrection isn't supported by ELC"):
             ELC(gap_size=2., maxPWerror=1., actor=elc)
         with self.assertRaisesRegex(ValueError, "Parameter 'actor' of type Coulomb::DebyeHueckel isn't supported by ELC"):
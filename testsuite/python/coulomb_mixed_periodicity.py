@@ -113,6 +113,62 @@ class CoulombMixedPeriodicity(ut.TestCase):
         self.system.actors.add(elc)
         self.compare("elc", force_tol=1e-5, energy_tol=1e-4)
 
+    def test_fmm(self):
+        self.system.box_l = [10., 10., 10.]
+        self.system.periodicity = [True, True, False]
+        self.system.cell_system.set_regular_decomposition()
+
+        fmm = espressomd.electrostatics.FMM(
+            prefactor=1., accuracy=1e-5, order=16, r_cut=2.5)
+        self.system.actors.add(fmm)
+        self.compare("fmm", force_tol=2e-5, energy_tol=1e-4)
+
+    def check_fmm(self, ref_forces, ref_energy, accuracy):
+        # the leaves are small enough for the expansions to be used
+        fmm = espressomd.electrostatics.FMM(
+            prefactor=1., accuracy=accuracy, leaf_size=4)
+        self.system.actors.add(fmm)
+        self.system.integrator.run(0)
+        forces = np.copy(self.system.part.all().f)
+        energy = self.system.analysis.energy()["coulomb"]
+
+        # the tuned order meets the requested accuracy
+        self.assertGreater(fmm.order, 0)
+        rms_error = np.sqrt(np.sum(np.square(forces - ref_forces)) /
+                            np.sum(np.square(ref_forces)))
+        self.assertLessEqual(rms_error, accuracy)
+        np.testing.assert_allclose(energy, ref_energy, rtol=accuracy)
+
+    def test_fmm_open(self):
+        self.system.periodicity = [False, False, False]
+        self.system.cell_system.set_regular_decomposition()
+
+        # direct sum
+        pos = self.data[:, 1:4]
+        q = self.data[:, 4]
+        dist = pos[:, np.newaxis, :] - pos[np.newaxis, :, :]
+        r = np.linalg.norm(dist, axis=2)
+        np.fill_diagonal(r, np.inf)
+        qq = np.outer(q, q)
+        ref_forces = np.sum((qq / r**3)[:, :, np.newaxis] * dist, axis=1)
+        ref_energy = 0.5 * np.sum(qq / r)
+
+        self.check_fmm(ref_forces, ref_energy, accuracy=1e-4)
+
+    def test_fmm_wire(self):
+        self.system.periodicity = [False, False, True]
+        self.system.cell_system.set_n_square()
+
+        mmm1d = espressomd.electrostatics.MMM1D(
+            prefactor=1., maxPWerror=1e-10)
+        self.system.actors.add(mmm1d)
+        self.system.integrator.run(0)
+        ref_forces = np.copy(self.system.part.all().f)
+        ref_energy = self.system.analysis.energy()["coulomb"]
+        self.system.actors.clear()
+
+        self.check_fmm(ref_forces, ref_energy, accuracy=1e-4)
+
     @utx.skipIfMissingFeatures(["SCAFACOS"])
     @utx.skipIfMissingScafacosMethod("p2nfft")
     def test_scafacos_p2nfft(self):
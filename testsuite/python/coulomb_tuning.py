@@ -16,6 +16,8 @@
 # You should have received a copy of the GNU General Public License
 # along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #
+import os
+import tempfile
 import numpy as np
 import unittest as ut
 import unittest_decorators as utx
@@ -53,6 +55,39 @@ class CoulombCloudWallTune(ut.TestCase):
             prefactor=1., accuracy=5e-4, tune=True)
         self.compare(actor)
 
+    def test_p3m_cpu_differentiation(self):
+        actor = espressomd.electrostatics.P3M(
+            prefactor=1., accuracy=5e-4, tune=True, differentiation="auto")
+        self.compare(actor)
+        self.assertIn(actor.differentiation, ("ik", "ad"))
+
+    def test_p3m_cpu_tuning_cache(self):
+        keys = ("mesh", "cao", "r_cut", "alpha", "differentiation")
+        with tempfile.TemporaryDirectory() as tmp_directory:
+            path = os.path.join(tmp_directory, "p3m_tuning.txt")
+            params = {"prefactor": 1., "accuracy": 5e-4, "tune": True,
+                      "differentiation": "auto", "tuning_cache": path}
+            actor = espressomd.electrostatics.P3M(**params)
+            self.assertEqual(actor.tuning_cache, path)
+            self.compare(actor)
+            tuned = {key: actor.get_params()[key] for key in keys}
+            with open(path) as f:
+                self.assertEqual(len(f.readlines()), 1)
+            # same system: the cached parameters are re-used
+            self.system.actors.clear()
+            actor = espressomd.electrostatics.P3M(**params)
+            self.compare(actor)
+            for key in keys:
+                np.testing.assert_equal(actor.get_params()[key], tuned[key])
+            with open(path) as f:
+                self.assertEqual(len(f.readlines()), 1)
+            # different charges: the system is tuned again
+            self.system.actors.clear()
+            self.system.part.all().q = 0.5 * self.system.part.all().q
+            self.system.actors.add(espressomd.electrostatics.P3M(**params))
+            with open(path) as f:
+                self.assertEqual(len(f.readlines()), 2)
+
     @utx.skipIfMissingGPU()
     def test_p3m_gpu(self):
         actor = espressomd.electrostatics.P3MGPU(
@@ -81,6 +81,28 @@ class Test(ut.TestCase):
 
         return (ref_e, ref_f, ref_t)
 
+    def bh_cpu_data(self, **kwargs):
+        system = self.system
+
+        bh_cpu = espressomd.magnetostatics.DipolarBarnesHutCpu(
+            prefactor=1.2, **kwargs)
+        system.actors.add(bh_cpu)
+        # check MD cell reset has no impact
+        self.system.box_l = self.system.box_l
+        self.system.periodicity = self.system.periodicity
+        self.system.cell_system.node_grid = self.system.cell_system.node_grid
+
+        system.integrator.run(steps=0, recalc_forces=True)
+        ref_e = system.analysis.energy()["dipolar"]
+        ref_f = np.copy(self.particles.f)
+        ref_t = np.copy(self.particles.torque_lab)
+        self.bh_error = bh_cpu.estimate_error()
+        self.bh_opening_angle = bh_cpu.opening_angle
+
+        system.actors.clear()
+
+        return (ref_e, ref_f, ref_t)
+
     def fcs_data(self):
         system = self.system
 
@@ -174,6 +196,30 @@ class Test(ut.TestCase):
             force_tol=1E-12,
             torque_tol=1E-12)
 
+    def test_bh_cpu(self):
+        # vanishing opening angle: all octants are opened
+        self.check_open_bc(
+            lambda: self.bh_cpu_data(opening_angle=1e-8),
+            energy_tol=1E-12,
+            force_tol=1E-12,
+            torque_tol=1E-12)
+        self.assertAlmostEqual(self.bh_error, 0., delta=1e-14)
+
+    def test_bh_cpu_tuning(self):
+        array_data = np.load(OPEN_BOUNDARIES_REF_ARRAYS)
+        ref_f = array_data[:, 6:9]
+        self.particles = self.system.part.add(
+            pos=array_data[:, :3], dip=array_data[:, 3:6],
+            rotation=[[True, True, True]] * len(array_data))
+        for accuracy in [1e-2, 1e-4]:
+            _, bh_f, _ = self.bh_cpu_data(accuracy=accuracy)
+            # all forces are sampled by the error estimate
+            rms_error = np.sqrt(np.sum((bh_f - ref_f)**2) / np.sum(ref_f**2))
+            self.assertLessEqual(self.bh_error, accuracy)
+            self.assertAlmostEqual(rms_error, self.bh_error, delta=1e-12)
+            self.assertGreater(self.bh_opening_angle, 0.)
+            self.assertLessEqual(self.bh_opening_angle, 1.)
+
     @utx.skipIfMissingFeatures("DIPOLAR_DIRECT_SUM")
     @utx.skipIfMissingGPU()
     def test_dds_gpu(self):
@@ -251,6 +297,10 @@ class Test(ut.TestCase):
         solver = espressomd.magnetostatics.DipolarDirectSumCpu(prefactor=1.)
         self.check_min_image_convention(solver, rtol=1e-10)
 
+    def test_min_image_convention_bh_cpu(self):
+        solver = espressomd.magnetostatics.DipolarBarnesHutCpu(prefactor=1.)
+        self.check_min_image_convention(solver, rtol=1e-10)
+
     @utx.skipIfMissingFeatures("DIPOLAR_DIRECT_SUM")
     @utx.skipIfMissingGPU()
     def test_min_image_convention_gpu(self):
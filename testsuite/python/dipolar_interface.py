@@ -48,6 +48,11 @@ class Test(ut.TestCase):
             system, espressomd.magnetostatics.DipolarDirectSumCpu,
             dict(prefactor=3.4, n_replicas=3))
 
+    if espressomd.has_features("DIPOLES"):
+        test_bh_cpu = tests_common.generate_test_for_actor_class(
+            system, espressomd.magnetostatics.DipolarBarnesHutCpu,
+            dict(prefactor=3.4, opening_angle=0.3, n_replicas=1))
+
     if espressomd.has_features(
             "DIPOLAR_DIRECT_SUM") and espressomd.gpu_available():
         test_dds_gpu = tests_common.generate_test_for_actor_class(
@@ -104,6 +109,17 @@ class Test(ut.TestCase):
             DDSR(prefactor=1., n_replicas=-2)
         with self.assertRaisesRegex(ValueError, "Parameter 'prefactor' must be > 0"):
             DDSR(prefactor=-2., n_replicas=1)
+        BHC = espressomd.magnetostatics.DipolarBarnesHutCpu
+        with self.assertRaisesRegex(ValueError, "Parameter 'prefactor' must be > 0"):
+            BHC(prefactor=-2.)
+        with self.assertRaisesRegex(ValueError, "Parameter 'opening_angle' must be > 0"):
+            BHC(prefactor=1., opening_angle=0.)
+        with self.assertRaisesRegex(ValueError, "Parameter 'n_replicas' must be >= 0"):
+            BHC(prefactor=1., n_replicas=-2)
+        with self.assertRaisesRegex(ValueError, "Parameter 'accuracy' must be > 0 or -1"):
+            BHC(prefactor=1., accuracy=0.)
+        with self.assertRaisesRegex(ValueError, "Parameter 'actor' of type Dipoles::DipolarBarnesHutCpu isn't supported by DLC"):
+            MDLC(gap_size=2., maxPWerror=0.1, actor=BHC(prefactor=1.))
         # run sanity checks
         self.system.periodicity = [True, True, False]
         ddsr = DDSR(prefactor=1., n_replicas=1)
@@ -73,6 +73,19 @@ class Integrator_test(ut.TestCase):
         with self.assertRaisesRegex(Exception, self.msg + 'The VV integrator is incompatible with the currently active combination of thermostats'):
             self.system.integrator.run(0)
 
+    def test_vv_respa_integrator(self):
+        self.system.cell_system.skin = 0.4
+        with self.assertRaisesRegex(ValueError, "Parameter 'long_range_interval' must be >= 1"):
+            self.system.integrator.set_vv_respa(long_range_interval=0)
+        with self.assertRaisesRegex(RuntimeError, "Parameter 'long_range_interval' is missing"):
+            self.system.integrator.set_vv_respa()
+        self.system.thermostat.set_brownian(kT=1.0, gamma=1.0, seed=42)
+        self.system.integrator.set_vv_respa(long_range_interval=2)
+        self.assertEqual(
+            self.system.integrator.integrator.long_range_interval, 2)
+        with self.assertRaisesRegex(Exception, self.msg + 'The VV integrator is incompatible with the currently active combination of thermostats'):
+            self.system.integrator.run(0)
+
     def test_brownian_integrator(self):
         self.system.cell_system.skin = 0.4
         self.system.integrator.set_brownian_dynamics()
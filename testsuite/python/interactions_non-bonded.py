@@ -496,6 +496,41 @@ class InteractionsNonBondedTest(ut.TestCase):
                       energy_kernel=gaussian_potential,
                       n_steps=125)
 
+    # Test the spline tabulation of the isotropic potentials
+    @utx.skipIfMissingFeatures(["GAUSSIAN", "HERTZIAN"])
+    def test_spline_tabulation(self):
+
+        gaussian_params = {"eps": 6.92, "sig": 4.03, "cutoff": 1.243}
+        hertzian_params = {"eps": 2.92, "sig": 1.243}
+        accuracy = 1e-6
+        ia = self.system.non_bonded_inter[0, 0]
+        ia.gaussian.set_params(**gaussian_params)
+        ia.hertzian.set_params(**hertzian_params)
+        ia.spline_tabulation.set_params(min=0.1, accuracy=accuracy)
+        self.assertGreater(ia.spline_tabulation.get_n_intervals(), 0)
+
+        p0, p1 = self.system.part.all()
+        for _ in range(125):
+            p1.pos = p1.pos + self.step
+            d = np.linalg.norm(p1.pos - p0.pos)
+            self.system.integrator.run(recalc_forces=True, steps=0)
+            E_sim = self.system.analysis.energy()["non_bonded"]
+            E_ref = gaussian_potential(d, **gaussian_params) + \
+                hertzian_potential(d, **hertzian_params)
+            f1_ref = self.axis * (gaussian_force(d, **gaussian_params) +
+                                  hertzian_force(d, **hertzian_params))
+            self.assertAlmostEqual(E_sim, E_ref, delta=2. * accuracy)
+            np.testing.assert_allclose(
+                np.copy(p1.f), f1_ref, rtol=0., atol=2. * accuracy)
+
+        # unreachable accuracy falls back to the analytic potentials
+        ia.spline_tabulation.set_params(min=0.1, accuracy=1e-17)
+        with self.assertRaisesRegex(Exception, "Spline tabulation cannot reach"):
+            self.system.integrator.run(recalc_forces=True, steps=0)
+        self.assertEqual(ia.spline_tabulation.get_n_intervals(), 0)
+        ia.spline_tabulation.deactivate()
+        self.assertEqual(ia.spline_tabulation.get_n_intervals(), 0)
+
     # Test the Gay-Berne potential and the resulting force and torque
     @utx.skipIfMissingFeatures("GAY_BERNE")
     def test_gb(self):
@@ -336,6 +336,13 @@ class Test(ut.TestCase):
             ("eps", "sig", "cutoff")
         )
 
+    def test_spline_tabulation_exceptions(self):
+        self.check_potential_exceptions(
+            espressomd.interactions.SplineTabulation,
+            {"min": 0.8, "accuracy": 1e-6},
+            ("min", "accuracy")
+        )
+
     @utx.skipIfMissingFeatures("DPD")
     def test_dpd_exceptions(self):
         self.check_potential_exceptions(
@@ -139,6 +139,73 @@ class MMM1D_Test(ElectrostaticInteractionsTests, ut.TestCase):
     allowed_error = 2e-5
     MMM1D = espressomd.electrostatics.MMM1D
 
+    def test_tabulated(self):
+        self.system.part.add(pos=self.p_pos, q=self.p_q)
+        mmm1d = self.MMM1D(prefactor=1.0, maxPWerror=1e-10, tabulate=True)
+        self.system.actors.add(mmm1d)
+        self.assertTrue(mmm1d.tabulate)
+        self.assertTrue(mmm1d.is_tabulated)
+        self.system.integrator.run(steps=0, recalc_forces=True)
+        forces1 = np.copy(self.system.part.all().f)
+        np.testing.assert_allclose(forces1, self.forces_target,
+                                   atol=self.allowed_error)
+        measured_el_energy = self.system.analysis.energy()["coulomb"]
+        self.assertAlmostEqual(
+            measured_el_energy, self.energy_target, delta=self.allowed_error,
+            msg="Measured energy deviates too much from stored result")
+
+        # tables are rebuilt after a box change
+        self.system.box_l = [10.0, 10.0, 12.0]
+        self.system.box_l = [10.0] * 3
+        self.assertTrue(mmm1d.is_tabulated)
+        self.system.integrator.run(steps=0, recalc_forces=True)
+        forces2 = np.copy(self.system.part.all().f)
+        np.testing.assert_allclose(forces1, forces2, atol=1e-12, rtol=0.)
+
+    def test_hot_pair_tiles(self):
+        """
+        Check the loop over all pairs in tiles of the hot particle data
+        against the particle loop, with and without OpenMP threads.
+        """
+        self.system.part.add(pos=self.p_pos, q=self.p_q)
+        mmm1d = self.MMM1D(prefactor=1.0, maxPWerror=1e-10)
+        self.system.actors.add(mmm1d)
+
+        def get_forces_and_energy(use_hot_particle_data, n_threads):
+            cell_system = self.system.cell_system
+            cell_system.use_hot_particle_data = use_hot_particle_data
+            cell_system.n_threads = n_threads
+            self.system.integrator.run(steps=0, recalc_forces=True)
+            forces = np.copy(self.system.part.all().f)
+            energy = self.system.analysis.energy()["coulomb"]
+            return forces, energy
+
+        try:
+            ref_f, ref_energy = get_forces_and_energy(False, 1)
+            hot_f, hot_energy = get_forces_and_energy(True, 1)
+            np.testing.assert_allclose(hot_f, ref_f, atol=1e-10, rtol=0.)
+            self.assertAlmostEqual(hot_energy, ref_energy, delta=1e-10)
+            np.testing.assert_allclose(hot_f, self.forces_target,
+                                       atol=self.allowed_error)
+            if espressomd.has_features("OPENMP"):
+                # the traversal order doesn't depend on the number of threads
+                thr_f, thr_energy = get_forces_and_energy(True, 4)
+                np.testing.assert_array_equal(thr_f, hot_f)
+                self.assertEqual(thr_energy, hot_energy)
+        finally:
+            self.system.cell_system.use_hot_particle_data = False
+            self.system.cell_system.n_threads = 1
+
+    def test_tabulation_exceptions(self):
+        self.system.part.add(pos=[0, 0, 0], q=1)
+        self.system.part.add(pos=[0, 0, 1], q=-1)
+        mmm1d = self.MMM1D(prefactor=1.0, maxPWerror=1e-20, tabulate=True)
+        with self.assertRaisesRegex(RuntimeError, "MMM1D could not tabulate the pair interactions to the requested accuracy"):
+            self.system.actors.add(mmm1d)
+        self.assertEqual(len(self.system.actors), 0)
+        self.assertFalse(mmm1d.is_tuned)
+        self.assertFalse(mmm1d.is_tabulated)
+
 
 @utx.skipIfMissingFeatures(["ELECTROSTATICS", "MMM1D_GPU"])
 @utx.skipIfMissingGPU()